@@ -1132,6 +1132,15 @@ enum class Workaround : uint16_t {
     A8X_STATIC_TEXTURE_TARGET_ERROR
 };
 
+/**
+ * Number of objects held by the backend's internal pools and caches, which the Engine can't see
+ * otherwise.
+ */
+struct DriverCacheCounts {
+    uint32_t descriptorPools = 0;   //!< descriptor pools (Vulkan)
+    uint32_t pipelines = 0;         //!< pipeline state objects (Vulkan)
+};
+
 } // namespace filament::backend
 
 template<> struct utils::EnableBitMaskOperators<filament::backend::ShaderStageFlags>
@@ -857,6 +857,14 @@ bool MetalDriver::canGenerateMipmaps() {
     return true;
 }
 
+bool MetalDriver::isProgramReady(Handle<HwProgram> ph) {
+    return true;
+}
+
+DriverCacheCounts MetalDriver::getDriverCacheCounts() {
+    return {};
+}
+
 void MetalDriver::updateSamplerGroup(Handle<HwSamplerGroup> sbh, BufferDescriptor&& data) {
     ASSERT_PRECONDITION(!isInRenderPass(mContext),
             "updateSamplerGroup must be called outside of a render pass.");
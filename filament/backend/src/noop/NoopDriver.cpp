@@ -251,6 +251,14 @@ bool NoopDriver::canGenerateMipmaps() {
     return true;
 }
 
+bool NoopDriver::isProgramReady(Handle<HwProgram> ph) {
+    return true;
+}
+
+DriverCacheCounts NoopDriver::getDriverCacheCounts() {
+    return {};
+}
+
 void NoopDriver::updateSamplerGroup(Handle<HwSamplerGroup> sbh,
         BufferDescriptor&& data) {
     scheduleDestroy(std::move(data));
@@ -251,6 +251,7 @@ ShaderModel OpenGLDriver::getShaderModel() const noexcept {
 // ------------------------------------------------------------------------------------------------
 void OpenGLDriver::resetState(int) {
     mContext.resetState();
+    invalidateSamplerBindings();
 }
 
 void OpenGLDriver::bindSampler(GLuint unit, GLuint sampler) noexcept {
@@ -384,7 +385,12 @@ Handle<HwRenderPrimitive> OpenGLDriver::createRenderPrimitiveS() noexcept {
 }
 
 Handle<HwProgram> OpenGLDriver::createProgramS() noexcept {
-    return initHandle<OpenGLProgram>();
+    Handle<HwProgram> const ph = initHandle<OpenGLProgram>();
+    if (mContext.ext.KHR_parallel_shader_compile) {
+        // the program is not ready until it's done compiling in the background
+        mPendingPrograms.add(ph);
+    }
+    return ph;
 }
 
 Handle<HwSamplerGroup> OpenGLDriver::createSamplerGroupS() noexcept {
@@ -514,6 +520,10 @@ void OpenGLDriver::createProgramR(Handle<HwProgram> ph, Program&& program) {
     DEBUG_MARKER()
 
     construct<OpenGLProgram>(ph, *this, std::move(program));
+    if (mContext.ext.KHR_parallel_shader_compile) {
+        // the program is compiling in the background, it's polled in tick()
+        mPendingPrograms.track(ph);
+    }
     CHECK_GL_ERROR(utils::slog.e)
 }
 
@@ -1320,6 +1330,11 @@ void OpenGLDriver::destroyProgram(Handle<HwProgram> ph) {
     if (ph) {
         OpenGLProgram* p = handle_cast<OpenGLProgram*>(ph);
         cancelRunAtNextPassOp(p);
+        mPendingPrograms.remove(ph);
+        if (mBoundSamplers.program == p) {
+            // the handle could be reused by a program with different bindings
+            mBoundSamplers.program = nullptr;
+        }
         destruct(ph, p);
     }
 }
@@ -1328,6 +1343,7 @@ void OpenGLDriver::destroySamplerGroup(Handle<HwSamplerGroup> sbh) {
     DEBUG_MARKER()
     if (sbh) {
         GLSamplerGroup* sb = handle_cast<GLSamplerGroup*>(sbh);
+        invalidateSamplerBindings();
         destruct(sbh, sb);
     }
 }
@@ -1337,6 +1353,7 @@ void OpenGLDriver::destroyTexture(Handle<HwTexture> th) {
 
     if (th) {
         GLTexture* t = handle_cast<GLTexture*>(th);
+        invalidateSamplerBindings();
         if (UTILS_LIKELY(!t->gl.imported)) {
             auto& gl = mContext;
             if (UTILS_LIKELY(t->usage & TextureUsage::SAMPLEABLE)) {
@@ -1510,6 +1527,7 @@ void OpenGLDriver::updateStreams(DriverApi* driver) {
                         t->gl.id = t->externalTexture->id;
                         t->gl.targetIndex = (uint8_t)OpenGLContext::getIndexForTextureTarget(t->gl.target);
                         bindTexture(OpenGLContext::DUMMY_TEXTURE_BINDING, t);
+                        invalidateSamplerBindings();
                     }
                 }
 
@@ -1947,6 +1965,7 @@ void OpenGLDriver::updateSamplerGroup(Handle<HwSamplerGroup> sbh,
 
         sb->textureUnitEntries[i] = { t, samplerId };
     }
+    invalidateSamplerBindings();
     scheduleDestroy(std::move(data));
 }
 
@@ -2012,6 +2031,14 @@ bool OpenGLDriver::canGenerateMipmaps() {
     return true;
 }
 
+bool OpenGLDriver::isProgramReady(Handle<HwProgram> ph) {
+    return mPendingPrograms.isReady(ph);
+}
+
+DriverCacheCounts OpenGLDriver::getDriverCacheCounts() {
+    return {};
+}
+
 void OpenGLDriver::setTextureData(GLTexture* t, uint32_t level,
         uint32_t xoffset, uint32_t yoffset, uint32_t zoffset,
         uint32_t width, uint32_t height, uint32_t depth,
@@ -2221,6 +2248,7 @@ void OpenGLDriver::setExternalImage(Handle<HwTexture> th, void* image) {
         t->gl.id = t->externalTexture->id;
         t->gl.targetIndex = (uint8_t)OpenGLContext::getIndexForTextureTarget(t->gl.target);
         bindTexture(OpenGLContext::DUMMY_TEXTURE_BINDING, t);
+        invalidateSamplerBindings();
     }
 }
 
@@ -2264,6 +2292,7 @@ void OpenGLDriver::attachStream(GLTexture* t, GLStream* hwStream) noexcept {
             break;
     }
     t->hwStream = hwStream;
+    invalidateSamplerBindings();
 }
 
 UTILS_NOINLINE
@@ -2290,6 +2319,7 @@ void OpenGLDriver::detachStream(GLTexture* t) noexcept {
     glGenTextures(1, &t->gl.id);
 
     t->hwStream = nullptr;
+    invalidateSamplerBindings();
 }
 
 UTILS_NOINLINE
@@ -2320,6 +2350,7 @@ void OpenGLDriver::replaceStream(GLTexture* texture, GLStream* newStream) noexce
     }
 
     texture->hwStream = newStream;
+    invalidateSamplerBindings();
 }
 
 void OpenGLDriver::beginTimerQuery(Handle<HwTimerQuery> tqh) {
@@ -2655,7 +2686,10 @@ void OpenGLDriver::bindSamplers(uint32_t index, Handle<HwSamplerGroup> sbh) {
     DEBUG_MARKER()
     assert_invariant(index < Program::SAMPLER_BINDING_COUNT);
     GLSamplerGroup* sb = handle_cast<GLSamplerGroup *>(sbh);
-    mSamplerBindings[index] = sb;
+    if (mSamplerBindings[index] != sb) {
+        mSamplerBindings[index] = sb;
+        invalidateSamplerBindings();
+    }
     CHECK_GL_ERROR(utils::slog.e)
 }
 
@@ -2952,6 +2986,9 @@ void OpenGLDriver::tick(int) {
     DEBUG_MARKER()
     executeGpuCommandsCompleteOps();
     executeEveryNowAndThenOps();
+    mPendingPrograms.update([this](Handle<HwProgram> ph) {
+        return handle_cast<OpenGLProgram*>(ph)->isReady(mContext);
+    });
 }
 
 void OpenGLDriver::beginFrame(
@@ -3001,6 +3038,7 @@ void OpenGLDriver::endFrame(UTILS_UNUSED uint32_t frameId) {
     for (int unit = OpenGLContext::DUMMY_TEXTURE_BINDING; unit >= 0; unit--) {
         gl.bindTexture(unit, GL_TEXTURE_2D, 0);
     }
+    invalidateSamplerBindings();
     gl.disable(GL_CULL_FACE);
     gl.depthFunc(GL_LESS);
     gl.disable(GL_SCISSOR_TEST);
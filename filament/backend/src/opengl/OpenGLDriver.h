@@ -20,6 +20,7 @@
 #include "DriverBase.h"
 #include "GLUtils.h"
 #include "OpenGLContext.h"
+#include "PendingPrograms.h"
 
 #include "private/backend/Driver.h"
 #include "private/backend/HandleAllocator.h"
@@ -195,6 +196,18 @@ public:
     OpenGLDriver(OpenGLDriver const&) = delete;
     OpenGLDriver& operator=(OpenGLDriver const&) = delete;
 
+    // For testing: counts the texture and sampler set-ups performed when a program is used,
+    // debug builds only.
+    struct SamplerBindingStats {
+        uint32_t updates = 0;   // number of times textures and samplers were bound for a program
+        uint32_t skipped = 0;   // number of times nothing changed and the set-up was skipped
+        uint32_t binds = 0;     // number of texture + sampler binds requested by the set-ups
+    };
+
+    SamplerBindingStats const& getSamplerBindingStats() const noexcept {
+        return mSamplerBindingStats;
+    }
+
 private:
     OpenGLContext mContext;
 
@@ -343,6 +356,25 @@ private:
     // sampler buffer binding points (nullptr if not used)
     std::array<GLSamplerGroup*, Program::SAMPLER_BINDING_COUNT> mSamplerBindings = {};   // 4 pointers
 
+    // Must be called whenever the textures or samplers seen through mSamplerBindings may have
+    // changed, or the GL texture bindings were disturbed; this forces the next used program
+    // to bind its textures and samplers again.
+    void invalidateSamplerBindings() noexcept {
+        mSamplerBindingsVersion++;
+    }
+
+    // incremented each time the content of mSamplerBindings may have changed
+    uint32_t mSamplerBindingsVersion = 0;
+
+    // the program whose textures and samplers are currently bound, and the version of
+    // mSamplerBindings they were bound from.
+    struct {
+        OpenGLProgram const* program = nullptr;
+        uint32_t version = 0;
+    } mBoundSamplers;
+
+    SamplerBindingStats mSamplerBindingStats;
+
     mutable tsl::robin_map<uint32_t, GLuint> mSamplerMap;
 
     // this must be accessed from the driver thread only
@@ -377,6 +409,9 @@ private:
     // timer query implementation
     OpenGLTimerQueryInterface* mTimerQueryImpl = nullptr;
     bool mFrameTimeSupported = false;
+
+    // programs that may still be compiling in the background (KHR_parallel_shader_compile)
+    PendingPrograms mPendingPrograms;
 };
 
 // ------------------------------------------------------------------------------------------------
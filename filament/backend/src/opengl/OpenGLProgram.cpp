@@ -74,6 +74,13 @@ OpenGLProgram::OpenGLProgram(OpenGLDriver& gld, Program&& program) noexcept
             gl.shaders,
             mLazyInitializationData->shaderSourceCode);
 
+    if (context.ext.KHR_parallel_shader_compile) {
+        // compilation and linking happen in the background, so we can link right away, this
+        // doesn't block. Use isReady() to find out when the program can be used without stalling.
+        gl.program = OpenGLProgram::linkProgram(gl.shaders);
+        return;
+    }
+
     gld.runAtNextRenderPass(this, [this]() {
         // by this point we must not have a GL program
         assert_invariant(!gl.program);
@@ -288,6 +295,20 @@ GLuint OpenGLProgram::linkProgram(const GLuint shaderIds[Program::SHADER_TYPE_CO
     return program;
 }
 
+/*
+ * Queries GL_COMPLETION_STATUS_KHR, which doesn't block. Only valid with
+ * KHR_parallel_shader_compile.
+ */
+bool OpenGLProgram::isCompletionStatusSet() const noexcept {
+    if (UTILS_UNLIKELY(!gl.program)) {
+        // not linked yet
+        return false;
+    }
+    GLint status = GL_FALSE;
+    glGetProgramiv(gl.program, GL_COMPLETION_STATUS_KHR, &status);
+    return status == GL_TRUE;
+}
+
 /*
  * Checks a program link status and logs errors and frees resources on failure.
  * Returns true on success.
@@ -412,6 +433,22 @@ void OpenGLProgram::initializeProgramState(OpenGLContext& context, GLuint progra
     mUsedBindingsCount = usedBindingCount;
 }
 
+void OpenGLProgram::updateSamplersIfNeeded(OpenGLDriver* gld) const noexcept {
+    auto& bound = gld->mBoundSamplers;
+    if (UTILS_LIKELY(bound.program == this && bound.version == gld->mSamplerBindingsVersion)) {
+#ifndef NDEBUG
+        gld->mSamplerBindingStats.skipped++;
+#endif
+        return;
+    }
+    bound.program = this;
+    bound.version = gld->mSamplerBindingsVersion;
+#ifndef NDEBUG
+    gld->mSamplerBindingStats.updates++;
+#endif
+    updateSamplers(gld);
+}
+
 void OpenGLProgram::updateSamplers(OpenGLDriver* gld) const noexcept {
     using GLTexture = OpenGLDriver::GLTexture;
 
@@ -419,6 +456,9 @@ void OpenGLProgram::updateSamplers(OpenGLDriver* gld) const noexcept {
     auto const& UTILS_RESTRICT samplerBindings = gld->getSamplerBindings();
     auto const& UTILS_RESTRICT usedBindingPoints = mUsedSamplerBindingPoints;
 
+#ifndef NDEBUG
+    uint32_t binds = 0;
+#endif
     for (uint8_t i = 0, tmu = 0, n = mUsedBindingsCount; i < n; i++) {
         auto const binding = usedBindingPoints[i];
         auto const * const sb = samplerBindings[binding];
@@ -429,9 +469,15 @@ void OpenGLProgram::updateSamplers(OpenGLDriver* gld) const noexcept {
             if (t) { // program may not use all samplers of sampler group
                 gld->bindTexture(tmu, t);
                 gld->bindSampler(tmu, s);
+#ifndef NDEBUG
+                binds += 2;
+#endif
             }
         }
     }
+#ifndef NDEBUG
+    gld->mSamplerBindingStats.binds += binds;
+#endif
     CHECK_GL_ERROR(utils::slog.e)
 }
 
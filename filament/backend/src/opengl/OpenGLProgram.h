@@ -43,6 +43,15 @@ public:
 
     bool isValid() const noexcept { return mValid; }
 
+    // Returns whether use() can be called without waiting for the program to finish compiling.
+    // This can only be known with KHR_parallel_shader_compile, otherwise this always returns true.
+    bool isReady(OpenGLContext const& context) const noexcept {
+        if (UTILS_LIKELY(mInitialized || !context.ext.KHR_parallel_shader_compile)) {
+            return true;
+        }
+        return isCompletionStatusSet();
+    }
+
     void use(OpenGLDriver* const gld, OpenGLContext& context) noexcept {
         if (UTILS_UNLIKELY(!mInitialized)) {
             initialize(context);
@@ -50,19 +59,9 @@ public:
 
         context.useProgram(gl.program);
         if (UTILS_UNLIKELY(mUsedBindingsCount)) {
-            // We rely on GL state tracking to avoid unnecessary glBindTexture / glBindSampler
-            // calls.
-
-            // we need to do this if:
-            // - the content of mSamplerBindings has changed
-            // - the content of any bound sampler buffer has changed
-            // ... since last time we used this program
-
-            // turns out the former might be relatively cheap to check, the later requires
-            // a bit less. Compared to what updateSamplers() actually does, which is
-            // pretty little, I'm not sure if we'll get ahead.
-
-            updateSamplers(gld);
+            // Textures and samplers only need to be bound again if another program was used
+            // since, or if the sampler groups, their content or the GL state may have changed.
+            updateSamplersIfNeeded(gld);
         }
     }
 
@@ -94,6 +93,8 @@ private:
 
     static GLuint linkProgram(const GLuint shaderIds[Program::SHADER_TYPE_COUNT]) noexcept;
 
+    bool isCompletionStatusSet() const noexcept;
+
     static bool checkProgramStatus(const char* name,
             GLuint& program, GLuint shaderIds[Program::SHADER_TYPE_COUNT],
             std::array<utils::CString, Program::SHADER_TYPE_COUNT> const& shaderSourceCode) noexcept;
@@ -103,6 +104,8 @@ private:
     void initializeProgramState(OpenGLContext& context, GLuint program,
             LazyInitializationData const& lazyInitializationData) noexcept;
 
+    void updateSamplersIfNeeded(OpenGLDriver* gld) const noexcept;
+
     void updateSamplers(OpenGLDriver* gld) const noexcept;
 
     // number of bindings actually used by this program
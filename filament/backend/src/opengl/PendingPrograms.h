@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_BACKEND_OPENGL_PENDINGPROGRAMS_H
+#define TNT_FILAMENT_BACKEND_OPENGL_PENDINGPROGRAMS_H
+
+#include <backend/Handle.h>
+
+#include <tsl/robin_set.h>
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace filament::backend {
+
+/*
+ * Keeps track of the programs that are compiling in the background
+ * (KHR_parallel_shader_compile).
+ *
+ * add() is called on the user thread when the program handle is allocated, so that isReady()
+ * never reports a program ready before the driver has even started compiling it. isReady() can
+ * be called from any thread, all other methods are called on the driver thread.
+ */
+class PendingPrograms {
+public:
+    // marks a program as pending, until update() finds it ready or it's removed
+    void add(Handle<HwProgram> ph) {
+        std::lock_guard const lock(mLock);
+        mPendingIds.insert(ph.getId());
+    }
+
+    // starts polling a pending program, once it has been created
+    void track(Handle<HwProgram> ph) {
+        mTracked.push_back(ph);
+    }
+
+    // polls the tracked programs, isReady(ph) must not block
+    template<typename IsReady>
+    void update(IsReady&& isReady) {
+        auto& programs = mTracked;
+        if (programs.empty()) {
+            return;
+        }
+        std::lock_guard const lock(mLock);
+        programs.erase(std::remove_if(programs.begin(), programs.end(),
+                [this, &isReady](Handle<HwProgram> ph) {
+                    if (isReady(ph)) {
+                        mPendingIds.erase(ph.getId());
+                        return true;
+                    }
+                    return false;
+                }), programs.end());
+    }
+
+    // forgets a program, this must be called when it's destroyed because its handle can be reused
+    void remove(Handle<HwProgram> ph) {
+        auto& programs = mTracked;
+        auto const pos = std::find(programs.begin(), programs.end(), ph);
+        if (pos != programs.end()) {
+            programs.erase(pos);
+        }
+        std::lock_guard const lock(mLock);
+        mPendingIds.erase(ph.getId());
+    }
+
+    bool isReady(Handle<HwProgram> ph) const {
+        std::lock_guard const lock(mLock);
+        return mPendingIds.find(ph.getId()) == mPendingIds.end();
+    }
+
+    size_t getTrackedCount() const noexcept { return mTracked.size(); }
+
+private:
+    std::vector<Handle<HwProgram>> mTracked; // driver thread only
+    mutable std::mutex mLock;
+    tsl::robin_set<HandleBase::HandleId> mPendingIds;
+};
+
+} // namespace filament::backend
+
+#endif // TNT_FILAMENT_BACKEND_OPENGL_PENDINGPROGRAMS_H
@@ -54,17 +54,16 @@ void VulkanBuffer::terminate(VulkanContext& context) {
 
 void VulkanBuffer::loadFromCpu(VulkanContext& context, VulkanStagePool& stagePool,
         const void* cpuData, uint32_t byteOffset, uint32_t numBytes) const {
-    assert_invariant(byteOffset == 0);
     VulkanStage const* stage = stagePool.acquireStage(numBytes);
     void* mapped;
     vmaMapMemory(context.allocator, stage->memory, &mapped);
     memcpy(mapped, cpuData, numBytes);
     vmaUnmapMemory(context.allocator, stage->memory);
-    vmaFlushAllocation(context.allocator, stage->memory, byteOffset, numBytes);
+    vmaFlushAllocation(context.allocator, stage->memory, 0, numBytes);
 
     const VkCommandBuffer cmdbuffer = context.commands->get().cmdbuffer;
 
-    VkBufferCopy region{ .size = numBytes };
+    VkBufferCopy region{ .dstOffset = byteOffset, .size = numBytes };
     vkCmdCopyBuffer(cmdbuffer, stage->buffer, mGpuBuffer, 1, &region);
 
     // Firstly, ensure that the copy finishes before the next draw call.
@@ -79,4 +79,8 @@ constexpr static const int VK_MAX_PIPELINE_AGE = 10;
 // destroying any unused pipeline object.
 static_assert(VK_MAX_PIPELINE_AGE >= VK_MAX_COMMAND_BUFFERS);
 
+// Number of command buffer submissions that an empty VkDescriptorPool is kept around before it is
+// destroyed, so that the ring of descriptor pools shrinks back after a spike in descriptor usage.
+constexpr static const int VK_MAX_DESCRIPTOR_POOL_AGE = 60;
+
 #endif
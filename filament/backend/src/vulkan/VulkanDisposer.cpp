@@ -44,6 +44,14 @@ void VulkanDisposer::acquire(Key resource) noexcept {
     if (resource == nullptr) {
         return;
     }
+
+    // Until the next gc(), acquiring the same resource again would not change its refcount nor
+    // its remaining frames, so there is nothing to do.
+    Key& recent = mRecentlyAcquired[getRecentlyAcquiredIndex(resource)];
+    if (recent == resource) {
+        return;
+    }
+
     auto iter = mDisposables.find(resource);
     if (iter == mDisposables.end()) {
         return;
@@ -57,9 +65,13 @@ void VulkanDisposer::acquire(Key resource) noexcept {
     }
 
     disposable.remainingFrames = FRAMES_BEFORE_EVICTION;
+    recent = resource;
 }
 
 void VulkanDisposer::gc() noexcept {
+    // The remaining frames are about to change, resources must be acquired again.
+    mRecentlyAcquired.fill(nullptr);
+
     // First decrement the frame count of all resources that were held by a command buffer.
     // If any of these reaches zero, decrement its reference count.
     for (auto iter = mDisposables.begin(); iter != mDisposables.end(); ++iter) {
@@ -92,6 +104,7 @@ void VulkanDisposer::reset() noexcept {
         iter.second.destructor();
     }
     mDisposables.clear();
+    mRecentlyAcquired.fill(nullptr);
 }
 
 } // namespace filament::backend
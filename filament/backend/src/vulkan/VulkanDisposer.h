@@ -19,8 +19,11 @@
 
 #include <tsl/robin_map.h>
 
+#include <array>
 #include <functional>
 
+#include <stdint.h>
+
 namespace filament::backend {
 
 // VulkanDisposer tracks resources (such as textures or vertex buffers) that need deferred
@@ -38,6 +41,7 @@ public:
 
     // Increments the reference count and auto-decrements it after FRAMES_BEFORE_EVICTION frames.
     // This is used to indicate that the current command buffer has a reference to the resource.
+    // Acquiring a resource again before the next gc() has no effect, and is cheap.
     void acquire(Key resource) noexcept;
 
     // Invokes the destructor function for each disposable with a 0 refcount.
@@ -53,6 +57,17 @@ private:
         std::function<void()> destructor = []() {};
     };
     tsl::robin_map<Key, Disposable> mDisposables;
+
+    // Resources acquired since the last gc(), typically the programs, buffers and textures of the
+    // draws of the current frame. This is a direct-mapped cache that lets acquire() skip the hash
+    // map lookup when a resource is used by several draws; collisions only cost a lookup.
+    static constexpr size_t RECENTLY_ACQUIRED_COUNT = 64;
+    std::array<Key, RECENTLY_ACQUIRED_COUNT> mRecentlyAcquired = {};
+
+    static size_t getRecentlyAcquiredIndex(Key resource) noexcept {
+        uintptr_t const p = uintptr_t(resource);
+        return ((p >> 4u) ^ (p >> 10u)) % RECENTLY_ACQUIRED_COUNT;
+    }
 };
 
 } // namespace filament::backend
@@ -176,6 +176,21 @@ void VulkanDriver::endFrame(uint32_t frameId) {
     if (mContext.commands->flush()) {
         collectGarbage();
     }
+
+#if FILAMENT_VULKAN_VERBOSE
+    auto const& stats = mPipelineCache.getDescriptorStats();
+    utils::slog.d << "Descriptor sets in frame " << frameId << ": "
+            << stats.hits << " hits, "
+            << stats.reuses << " reuses, "
+            << stats.allocations << " allocations, "
+            << stats.poolResets << " pool resets, "
+            << stats.poolTrims << " pool trims, "
+            << stats.poolCount << " pools" << utils::io::endl;
+#endif
+    mPipelineCache.resetDescriptorStats();
+
+    mDescriptorPoolCount.store(mPipelineCache.getDescriptorPoolCount(), std::memory_order_relaxed);
+    mPipelineCount.store(mPipelineCache.getPipelineCount(), std::memory_order_relaxed);
 }
 
 void VulkanDriver::flush(int) {
@@ -729,7 +744,7 @@ void VulkanDriver::setVertexBufferObject(Handle<HwVertexBuffer> vbh, uint32_t in
     auto& vb = *handle_cast<VulkanVertexBuffer*>(vbh);
     auto& bo = *handle_cast<VulkanBufferObject*>(boh);
     assert_invariant(bo.bindingType == BufferObjectBinding::VERTEX);
-    vb.buffers[index] = &bo.buffer;
+    vb.setBuffer(&bo.buffer, index);
 }
 
 void VulkanDriver::updateIndexBuffer(Handle<HwIndexBuffer> ibh, BufferDescriptor&& p,
@@ -855,10 +870,29 @@ void VulkanDriver::setExternalImagePlane(Handle<HwTexture> th, void* image, uint
 void VulkanDriver::setExternalStream(Handle<HwTexture> th, Handle<HwStream> sh) {
 }
 
-void VulkanDriver::generateMipmaps(Handle<HwTexture> th) { }
+void VulkanDriver::generateMipmaps(Handle<HwTexture> th) {
+    if (UTILS_UNLIKELY(mContext.currentRenderPass.renderPass)) {
+        utils::slog.e << "generateMipmaps cannot be invoked inside a render pass."
+                << utils::io::endl;
+        return;
+    }
+    auto* texture = handle_cast<VulkanTexture*>(th);
+    texture->generateMipmaps(mContext.commands->get().cmdbuffer);
+}
 
 bool VulkanDriver::canGenerateMipmaps() {
-    return false;
+    return true;
+}
+
+bool VulkanDriver::isProgramReady(Handle<HwProgram> ph) {
+    return true;
+}
+
+DriverCacheCounts VulkanDriver::getDriverCacheCounts() {
+    // this is called from the user thread, the counts are updated by endFrame()
+    return {
+            .descriptorPools = mDescriptorPoolCount.load(std::memory_order_relaxed),
+            .pipelines = mPipelineCount.load(std::memory_order_relaxed) };
 }
 
 void VulkanDriver::updateSamplerGroup(Handle<HwSamplerGroup> sbh,
@@ -1594,81 +1628,61 @@ void VulkanDriver::draw(PipelineState pipelineState, Handle<HwRenderPrimitive> r
     }
 #endif
 
-    // Update the VK raster state.
+    const VulkanVertexBuffer& vertexBuffer = *prim.vertexBuffer;
+
+    // If the vertex buffer is missing a constituent buffer object, skip the draw call.
+    // There is no need to emit an error message because this is not explicitly forbidden.
+    if (UTILS_UNLIKELY(!vertexBuffer.hasAllBuffers())) {
+        return;
+    }
+
+    // Update the VK raster state. Consecutive draws often share the same raster state, in which
+    // case the conversion of the previous draw is reused.
 
     const VulkanRenderTarget* rt = mContext.currentRenderPass.renderTarget;
 
+    auto& cachedRaster = mRasterStateCache;
+    if (UTILS_UNLIKELY(!cachedRaster.valid || cachedRaster.rasterState != rasterState ||
+            cachedRaster.depthOffset.constant != depthOffset.constant ||
+            cachedRaster.depthOffset.slope != depthOffset.slope)) {
+        cachedRaster.valid = true;
+        cachedRaster.rasterState = rasterState;
+        cachedRaster.depthOffset = depthOffset;
+        auto& vkraster = cachedRaster.vkRasterState;
+        vkraster = mPipelineCache.getDefaultRasterState();
+        vkraster.cullMode = getCullMode(rasterState.culling);
+        vkraster.frontFace = getFrontFace(rasterState.inverseFrontFaces);
+        vkraster.depthBiasEnable = (depthOffset.constant || depthOffset.slope) ? true : false;
+        vkraster.depthBiasConstantFactor = depthOffset.constant;
+        vkraster.depthBiasSlopeFactor = depthOffset.slope;
+        vkraster.blendEnable = rasterState.hasBlending();
+        vkraster.srcColorBlendFactor = getBlendFactor(rasterState.blendFunctionSrcRGB);
+        vkraster.dstColorBlendFactor = getBlendFactor(rasterState.blendFunctionDstRGB);
+        vkraster.colorBlendOp = rasterState.blendEquationRGB;
+        vkraster.srcAlphaBlendFactor = getBlendFactor(rasterState.blendFunctionSrcAlpha);
+        vkraster.dstAlphaBlendFactor = getBlendFactor(rasterState.blendFunctionDstAlpha);
+        vkraster.alphaBlendOp =  rasterState.blendEquationAlpha;
+        vkraster.colorWriteMask = (VkColorComponentFlags) (rasterState.colorWrite ? 0xf : 0x0);
+        vkraster.depthWriteEnable = rasterState.depthWrite;
+        vkraster.depthCompareOp = rasterState.depthFunc;
+        vkraster.alphaToCoverageEnable = rasterState.alphaToCoverage;
+    }
+
+    // The render target dependent state can change without the raster state changing.
     auto& vkraster = mContext.rasterState;
-    vkraster.cullMode = getCullMode(rasterState.culling);
-    vkraster.frontFace = getFrontFace(rasterState.inverseFrontFaces);
-    vkraster.depthBiasEnable = (depthOffset.constant || depthOffset.slope) ? true : false;
-    vkraster.depthBiasConstantFactor = depthOffset.constant;
-    vkraster.depthBiasSlopeFactor = depthOffset.slope;
-    vkraster.blendEnable = rasterState.hasBlending();
-    vkraster.srcColorBlendFactor = getBlendFactor(rasterState.blendFunctionSrcRGB);
-    vkraster.dstColorBlendFactor = getBlendFactor(rasterState.blendFunctionDstRGB);
-    vkraster.colorBlendOp = rasterState.blendEquationRGB;
-    vkraster.srcAlphaBlendFactor = getBlendFactor(rasterState.blendFunctionSrcAlpha);
-    vkraster.dstAlphaBlendFactor = getBlendFactor(rasterState.blendFunctionDstAlpha);
-    vkraster.alphaBlendOp =  rasterState.blendEquationAlpha;
-    vkraster.colorWriteMask = (VkColorComponentFlags) (rasterState.colorWrite ? 0xf : 0x0);
-    vkraster.depthWriteEnable = rasterState.depthWrite;
-    vkraster.depthCompareOp = rasterState.depthFunc;
+    vkraster = cachedRaster.vkRasterState;
     vkraster.rasterizationSamples = rt->getSamples();
-    vkraster.alphaToCoverageEnable = rasterState.alphaToCoverage;
     vkraster.colorTargetCount = rt->getColorTargetCount(mContext.currentRenderPass);
 
-    // Declare fixed-size arrays that get passed to the pipeCache and to vkCmdBindVertexBuffers.
-    VulkanPipelineCache::VertexArray varray = {};
-    VkBuffer buffers[MAX_VERTEX_ATTRIBUTE_COUNT] = {};
-    VkDeviceSize offsets[MAX_VERTEX_ATTRIBUTE_COUNT] = {};
-
-    // For each attribute, append to each of the above lists.
-    const uint32_t bufferCount = prim.vertexBuffer->attributes.size();
-    for (uint32_t attribIndex = 0; attribIndex < bufferCount; attribIndex++) {
-        Attribute attrib = prim.vertexBuffer->attributes[attribIndex];
-
-        const bool isInteger = attrib.flags & Attribute::FLAG_INTEGER_TARGET;
-        const bool isNormalized = attrib.flags & Attribute::FLAG_NORMALIZED;
-
-        VkFormat vkformat = getVkFormat(attrib.type, isNormalized, isInteger);
-
-        // HACK: Re-use the positions buffer as a dummy buffer for disabled attributes. Filament's
-        // vertex shaders declare all attributes as either vec4 or uvec4 (the latter for bone
-        // indices), and positions are always at least 32 bits per element. Therefore we can assign
-        // a dummy type of either R8G8B8A8_UINT or R8G8B8A8_SNORM, depending on whether the shader
-        // expects to receive floats or ints.
-        if (attrib.buffer == Attribute::BUFFER_UNUSED) {
-            vkformat = isInteger ? VK_FORMAT_R8G8B8A8_UINT : VK_FORMAT_R8G8B8A8_SNORM;
-            attrib = prim.vertexBuffer->attributes[0];
-        }
-
-        const VulkanBuffer* buffer = prim.vertexBuffer->buffers[attrib.buffer];
-
-        // If the vertex buffer is missing a constituent buffer object, skip the draw call.
-        // There is no need to emit an error message because this is not explicitly forbidden.
-        if (buffer == nullptr) {
-            return;
-        }
-
-        buffers[attribIndex] = buffer->getGpuBuffer();
-        offsets[attribIndex] = attrib.offset;
-        varray.attributes[attribIndex] = {
-            .location = attribIndex, // matches the GLSL layout specifier
-            .binding = attribIndex,  // matches the position within vkCmdBindVertexBuffers
-            .format = vkformat,
-        };
-        varray.buffers[attribIndex] = {
-            .binding = attribIndex,
-            .stride = attrib.stride,
-        };
-    }
+    // The vertex input state and the vertex buffers were computed when the vertex buffer was
+    // created and its buffer objects set.
+    const VulkanVertexBuffer::VertexInput& vertexInput = *vertexBuffer.vertexInput;
 
     // Push state changes to the VulkanPipelineCache instance. This is fast and does not make VK calls.
     mPipelineCache.bindProgram(*program);
     mPipelineCache.bindRasterState(mContext.rasterState);
     mPipelineCache.bindPrimitiveTopology(prim.primitiveTopology);
-    mPipelineCache.bindVertexArray(varray);
+    mPipelineCache.bindVertexArray(vertexInput.varray);
 
     // Query the program for the mapping from (SamplerGroupBinding,Offset) to (SamplerBinding),
     // where "SamplerBinding" is the integer in the GLSL, and SamplerGroupBinding is the abstract
@@ -1765,7 +1779,8 @@ void VulkanDriver::draw(PipelineState pipelineState, Handle<HwRenderPrimitive> r
     // Next bind the vertex buffers and index buffer. One potential performance improvement is to
     // avoid rebinding these if they are already bound, but since we do not (yet) support subranges
     // it would be rare for a client to make consecutive draw calls with the same render primitive.
-    vkCmdBindVertexBuffers(cmdbuffer, 0, bufferCount, buffers, offsets);
+    vkCmdBindVertexBuffers(cmdbuffer, 0, MAX_VERTEX_ATTRIBUTE_COUNT,
+            vertexInput.buffers, vertexInput.offsets);
     vkCmdBindIndexBuffer(cmdbuffer, prim.indexBuffer->buffer.getGpuBuffer(), 0,
             prim.indexBuffer->indexType);
 
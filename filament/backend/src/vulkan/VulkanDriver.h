@@ -34,6 +34,8 @@
 #include <utils/compiler.h>
 #include <utils/Allocator.h>
 
+#include <atomic>
+
 namespace filament::backend {
 
 class VulkanPlatform;
@@ -151,6 +153,18 @@ private:
     VulkanSamplerCache mSamplerCache;
     VulkanBlitter mBlitter;
     VulkanSamplerGroup* mSamplerBindings[VulkanPipelineCache::SAMPLER_BINDING_COUNT] = {};
+
+    // The raster state and depth offset of the last draw, and their conversion to Vulkan.
+    struct {
+        RasterState rasterState;
+        PolygonOffset depthOffset;
+        VulkanPipelineCache::RasterState vkRasterState;
+        bool valid = false;
+    } mRasterStateCache;
+
+    // sizes of mPipelineCache as of the last endFrame(), see getDriverCacheCounts()
+    std::atomic<uint32_t> mDescriptorPoolCount = 0;
+    std::atomic<uint32_t> mPipelineCount = 0;
 };
 
 } // namespace filament::backend
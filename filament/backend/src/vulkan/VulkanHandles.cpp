@@ -256,7 +256,55 @@ VulkanVertexBuffer::VulkanVertexBuffer(VulkanContext& context, VulkanStagePool&
         uint8_t bufferCount, uint8_t attributeCount,
         uint32_t elementCount, AttributeArray const& attribs) :
         HwVertexBuffer(bufferCount, attributeCount, elementCount, attribs),
-        buffers(bufferCount, nullptr) {}
+        buffers(bufferCount, nullptr),
+        vertexInput(std::make_unique<VertexInput>()) {
+    VertexInput& vi = *vertexInput;
+    for (uint32_t attribIndex = 0; attribIndex < MAX_VERTEX_ATTRIBUTE_COUNT; attribIndex++) {
+        Attribute attrib = attribs[attribIndex];
+
+        const bool isInteger = attrib.flags & Attribute::FLAG_INTEGER_TARGET;
+        const bool isNormalized = attrib.flags & Attribute::FLAG_NORMALIZED;
+
+        VkFormat vkformat = getVkFormat(attrib.type, isNormalized, isInteger);
+
+        // HACK: Re-use the positions buffer as a dummy buffer for disabled attributes. Filament's
+        // vertex shaders declare all attributes as either vec4 or uvec4 (the latter for bone
+        // indices), and positions are always at least 32 bits per element. Therefore we can assign
+        // a dummy type of either R8G8B8A8_UINT or R8G8B8A8_SNORM, depending on whether the shader
+        // expects to receive floats or ints.
+        if (attrib.buffer == Attribute::BUFFER_UNUSED) {
+            vkformat = isInteger ? VK_FORMAT_R8G8B8A8_UINT : VK_FORMAT_R8G8B8A8_SNORM;
+            attrib = attribs[0];
+        }
+
+        assert_invariant(attrib.buffer < bufferCount);
+        missingBuffers |= 1u << attrib.buffer;
+
+        vi.bufferIndices[attribIndex] = attrib.buffer;
+        vi.offsets[attribIndex] = attrib.offset;
+        vi.varray.attributes[attribIndex] = {
+            .location = attribIndex, // matches the GLSL layout specifier
+            .binding = attribIndex,  // matches the position within vkCmdBindVertexBuffers
+            .format = vkformat,
+        };
+        vi.varray.buffers[attribIndex] = {
+            .binding = attribIndex,
+            .stride = attrib.stride,
+        };
+    }
+}
+
+void VulkanVertexBuffer::setBuffer(VulkanBuffer const* buffer, uint32_t index) noexcept {
+    assert_invariant(index < buffers.size());
+    buffers[index] = buffer;
+    VertexInput& vi = *vertexInput;
+    for (uint32_t attribIndex = 0; attribIndex < MAX_VERTEX_ATTRIBUTE_COUNT; attribIndex++) {
+        if (vi.bufferIndices[attribIndex] == index) {
+            vi.buffers[attribIndex] = buffer->getGpuBuffer();
+        }
+    }
+    missingBuffers &= ~(1u << index);
+}
 
 
 VulkanBufferObject::VulkanBufferObject(VulkanContext& context, VulkanStagePool& stagePool,
@@ -80,7 +80,28 @@ struct VulkanVertexBuffer : public HwVertexBuffer {
     VulkanVertexBuffer(VulkanContext& context, VulkanStagePool& stagePool,
             uint8_t bufferCount, uint8_t attributeCount, uint32_t elementCount,
             AttributeArray const& attributes);
+
+    void setBuffer(VulkanBuffer const* buffer, uint32_t index) noexcept;
+
+    // Whether a buffer object has been set for each attribute, otherwise draws are skipped.
+    bool hasAllBuffers() const noexcept { return !missingBuffers; }
+
+    // The vertex input state and the arguments of vkCmdBindVertexBuffers only depend on the
+    // attributes and the buffer objects, so they are computed once rather than for each draw.
+    struct VertexInput {
+        VulkanPipelineCache::VertexArray varray = {};
+        VkBuffer buffers[MAX_VERTEX_ATTRIBUTE_COUNT] = {};
+        VkDeviceSize offsets[MAX_VERTEX_ATTRIBUTE_COUNT] = {};
+        uint8_t bufferIndices[MAX_VERTEX_ATTRIBUTE_COUNT] = {}; // buffer object of each attribute
+    };
+
     utils::FixedCapacityVector<VulkanBuffer const*> buffers;
+
+    // NOTE: we use out-of-line allocation here because the size of a Handle<> is limited
+    std::unique_ptr<VertexInput> vertexInput;
+
+    // bit i is set if buffer object i is used by an attribute but hasn't been set yet
+    uint32_t missingBuffers = 0;
 };
 
 struct VulkanIndexBuffer : public HwIndexBuffer {
@@ -24,6 +24,8 @@
 #include "VulkanHandles.h"
 #include "VulkanUtility.h"
 
+#include <algorithm>
+
 // Vulkan functions often immediately dereference pointers, so it's fine to pass in a pointer
 // to a stack-allocated variable.
 #pragma clang diagnostic push
@@ -94,7 +96,12 @@ void VulkanPipelineCache::setDevice(VkDevice device, VmaAllocator allocator) {
     assert_invariant(mDevice == VK_NULL_HANDLE);
     mDevice = device;
     mAllocator = allocator;
-    mDescriptorPool = createDescriptorPool(mDescriptorPoolSize);
+    mDescriptorPools.push_back({
+        .handle = createDescriptorPool(DESCRIPTOR_SET_POOL_SIZE),
+        .lastUsed = mCurrentTime
+    });
+    mCurrentDescriptorPool = 0;
+    mDescriptorStats.poolCount = 1;
 
     // Formulate some dummy objects and dummy descriptor info used only for clearing out unused
     // bindings. This is especially crucial after a texture has been destroyed. Since core Vulkan
@@ -114,9 +121,10 @@ void VulkanPipelineCache::setDevice(VkDevice device, VmaAllocator allocator) {
 }
 
 bool VulkanPipelineCache::bindDescriptors(VkCommandBuffer cmdbuffer) noexcept {
-    DescriptorMap::iterator descriptorIter = mDescriptorSets.find(mDescriptorRequirements);
-
-    // Check if the required descriptors are already bound. If so, there's no need to do anything.
+    // Check if the required descriptors are already bound. If so, there's no need to do anything,
+    // not even to hash the requirements: the bound descriptors were marked as used when they were
+    // bound, and the time stamp cannot have changed since because onCommandBuffer() also resets
+    // the bindings.
     if (DescEqual equals; UTILS_LIKELY(equals(mBoundDescriptor, mDescriptorRequirements))) {
 
         // If the pipeline state during an app's first draw call happens to match the default state
@@ -124,17 +132,24 @@ bool VulkanPipelineCache::bindDescriptors(VkCommandBuffer cmdbuffer) noexcept {
         if (UTILS_LIKELY(!mDescriptorSets.empty())) {
 
             // Since the descriptors are already bound, they should be found in the cache.
-            assert_invariant(descriptorIter != mDescriptorSets.end());
-
-            // Update the LRU "time stamp" (really a count of cmd buf submissions) before returning.
-            descriptorIter.value().lastUsed = mCurrentTime;
+            assert_invariant(mDescriptorSets.find(mDescriptorRequirements) != mDescriptorSets.end());
+            assert_invariant(mDescriptorSets.find(mDescriptorRequirements).value().lastUsed
+                    == mCurrentTime);
+            mDescriptorStats.hits++;
             return true;
         }
     }
 
+    DescriptorMap::iterator descriptorIter = mDescriptorSets.find(mDescriptorRequirements);
+
     // If a cached object exists, re-use it, otherwise create a new one.
-    DescriptorCacheEntry* cacheEntry = UTILS_LIKELY(descriptorIter != mDescriptorSets.end()) ?
-            &descriptorIter.value() : createDescriptorSets();
+    DescriptorCacheEntry* cacheEntry;
+    if (UTILS_LIKELY(descriptorIter != mDescriptorSets.end())) {
+        cacheEntry = &descriptorIter.value();
+        mDescriptorStats.hits++;
+    } else {
+        cacheEntry = createDescriptorSets();
+    }
 
     // If a descriptor set overflow occurred, allow higher levels to handle it gracefully.
     assert_invariant(cacheEntry != nullptr);
@@ -153,15 +168,16 @@ bool VulkanPipelineCache::bindDescriptors(VkCommandBuffer cmdbuffer) noexcept {
 }
 
 bool VulkanPipelineCache::bindPipeline(VkCommandBuffer cmdbuffer) noexcept {
-    PipelineMap::iterator pipelineIter = mPipelines.find(mPipelineRequirements);
-
-    // Check if the required pipeline is already bound.
+    // Check if the required pipeline is already bound, in which case it was marked as used when
+    // it was bound (see bindDescriptors), and the requirements don't need to be hashed.
     if (PipelineEqual equals; UTILS_LIKELY(equals(mBoundPipeline, mPipelineRequirements))) {
-        assert_invariant(pipelineIter != mPipelines.end());
-        pipelineIter.value().lastUsed = mCurrentTime;
+        assert_invariant(mPipelines.find(mPipelineRequirements) != mPipelines.end());
+        assert_invariant(mPipelines.find(mPipelineRequirements).value().lastUsed == mCurrentTime);
         return true;
     }
 
+    PipelineMap::iterator pipelineIter = mPipelines.find(mPipelineRequirements);
+
     // If a cached object exists, re-use it, otherwise create a new one.
     PipelineCacheEntry* cacheEntry = UTILS_LIKELY(pipelineIter != mPipelines.end()) ?
             &pipelineIter.value() : createPipeline();
@@ -193,27 +209,18 @@ VulkanPipelineCache::DescriptorCacheEntry* VulkanPipelineCache::createDescriptor
 
     DescriptorCacheEntry descriptorCacheEntry = { .pipelineLayout = mPipelineRequirements.layout };
 
-    // Each of the arenas for this particular layout are guaranteed to have the same size. Check
-    // the first arena to see if any descriptor sets are available that can be re-claimed. If not,
-    // create brand new ones (one for each type). They will be added to the arena later, after they
-    // are no longer used. This occurs during the cleanup phase during command buffer submission.
-    auto& descriptorSetArenas = layoutCacheEntry->descriptorSetArenas;
-    if (descriptorSetArenas[0].empty()) {
-
-        // If allocating a new descriptor set from the pool would cause it to overflow, then
-        // recreate the pool. The number of descriptor sets that have already been allocated from
-        // the pool is the sum of the "active" descriptor sets (mDescriptorSets) and the "dormant"
-        // descriptor sets (mDescriptorArenasCount).
-        //
-        // NOTE: technically both sides of the inequality below should be multiplied by
-        // DESCRIPTOR_TYPE_COUNT to get the true number of descriptor sets.
-        if (mDescriptorSets.size() + mDescriptorArenasCount + 1 > mDescriptorPoolSize) {
-            growDescriptorPool();
-        }
+    // Check the arena of this particular layout to see if a bundle of descriptor sets is
+    // available that can be re-claimed. If not, allocate a brand new one (one set for each type).
+    // It will be added to the arena later, after it is no longer used. This occurs during the
+    // cleanup phase during command buffer submission.
+    auto& arena = layoutCacheEntry->descriptorSetArena;
+    if (arena.empty()) {
+        const uint32_t poolIndex = acquireDescriptorPool();
+        DescriptorPoolEntry& pool = mDescriptorPools[poolIndex];
 
         VkDescriptorSetAllocateInfo allocInfo = {};
         allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = mDescriptorPool;
+        allocInfo.descriptorPool = pool.handle;
         allocInfo.descriptorSetCount = DESCRIPTOR_TYPE_COUNT;
         allocInfo.pSetLayouts = layoutCacheEntry->descriptorSetLayouts.data();
         VkResult error = vkAllocateDescriptorSets(mDevice, &allocInfo,
@@ -222,13 +229,18 @@ VulkanPipelineCache::DescriptorCacheEntry* VulkanPipelineCache::createDescriptor
         if (error != VK_SUCCESS) {
             return nullptr;
         }
+        descriptorCacheEntry.pool = poolIndex;
+        pool.allocated++;
+        pool.alive++;
+        pool.lastUsed = mCurrentTime;
+        mDescriptorStats.allocations++;
     } else {
-        for (uint32_t i = 0; i < DESCRIPTOR_TYPE_COUNT; ++i) {
-            descriptorCacheEntry.handles[i] = descriptorSetArenas[i].back();
-            descriptorSetArenas[i].pop_back();
-        }
-        assert_invariant(mDescriptorArenasCount > 0);
-        mDescriptorArenasCount--;
+        descriptorCacheEntry.handles = arena.back().handles;
+        descriptorCacheEntry.pool = arena.back().pool;
+        arena.pop_back();
+        assert_invariant(mDescriptorPools[descriptorCacheEntry.pool].idle > 0);
+        mDescriptorPools[descriptorCacheEntry.pool].idle--;
+        mDescriptorStats.reuses++;
     }
 
     // Rewrite every binding in the new descriptor sets.
@@ -673,11 +685,8 @@ void VulkanPipelineCache::onCommandBuffer(const VulkanCommandBuffer& cmdbuffer)
     for (ConstDescIterator iter = mDescriptorSets.begin(); iter != mDescriptorSets.end();) {
         const DescriptorCacheEntry& cacheEntry = iter.value();
         if (cacheEntry.lastUsed + VK_MAX_PIPELINE_AGE < mCurrentTime) {
-            auto& arenas = mPipelineLayouts[cacheEntry.pipelineLayout].descriptorSetArenas;
-            for (uint32_t i = 0; i < DESCRIPTOR_TYPE_COUNT; ++i) {
-                arenas[i].push_back(cacheEntry.handles[i]);
-            }
-            ++mDescriptorArenasCount;
+            mPipelineLayouts[cacheEntry.pipelineLayout].descriptorSetArena.push_back(cacheEntry);
+            mDescriptorPools[cacheEntry.pool].idle++;
             iter = mDescriptorSets.erase(iter);
         } else {
             ++iter;
@@ -712,11 +721,13 @@ void VulkanPipelineCache::onCommandBuffer(const VulkanCommandBuffer& cmdbuffer)
 #endif
                 vkDestroyDescriptorSetLayout(mDevice, setLayout, VKALLOC);
             }
-            auto& arenas = iter->second.descriptorSetArenas;
-            assert_invariant(mDescriptorArenasCount >= arenas[0].size());
-            mDescriptorArenasCount -= arenas[0].size();
-            for (auto& arena : arenas) {
-                vkFreeDescriptorSets(mDevice, mDescriptorPool, arena.size(), arena.data());
+            // The descriptor sets of the arena are not freed individually, they are reclaimed
+            // when their pool gets reset.
+            for (auto const& bundle : iter->second.descriptorSetArena) {
+                DescriptorPoolEntry& pool = mDescriptorPools[bundle.pool];
+                assert_invariant(pool.alive > 0 && pool.idle > 0);
+                pool.alive--;
+                pool.idle--;
             }
             iter = mPipelineLayouts.erase(iter);
         } else {
@@ -724,21 +735,85 @@ void VulkanPipelineCache::onCommandBuffer(const VulkanCommandBuffer& cmdbuffer)
         }
     }
 
-    // If there are no descriptors from any extinct pool that are still in use, we can safely
-    // destroy the extinct pools, which implicitly frees their associated descriptor sets.
-    bool canPurgeExtinctPools = true;
-    for (auto& bundle : mExtinctDescriptorBundles) {
-        if (bundle.lastUsed + VK_MAX_PIPELINE_AGE >= mCurrentTime) {
-            canPurgeExtinctPools = false;
-            break;
+    recycleDescriptorPools();
+}
+
+uint32_t VulkanPipelineCache::acquireDescriptorPool() noexcept {
+    if (UTILS_LIKELY(mDescriptorPools[mCurrentDescriptorPool].allocated <
+            DESCRIPTOR_SET_POOL_SIZE)) {
+        return mCurrentDescriptorPool;
+    }
+
+    // The current pool is full, move on to the next pool of the ring that still has room. This
+    // is typically a pool that has been reset by recycleDescriptorPools().
+    const uint32_t count = mDescriptorPools.size();
+    for (uint32_t i = 1; i < count; i++) {
+        const uint32_t index = (mCurrentDescriptorPool + i) % count;
+        DescriptorPoolEntry& pool = mDescriptorPools[index];
+        if (pool.allocated < DESCRIPTOR_SET_POOL_SIZE) {
+            // This slot's pool may have been destroyed by recycleDescriptorPools().
+            if (pool.handle == VK_NULL_HANDLE) {
+                pool = {
+                    .handle = createDescriptorPool(DESCRIPTOR_SET_POOL_SIZE),
+                    .lastUsed = mCurrentTime
+                };
+                mDescriptorStats.poolCount++;
+            }
+            mCurrentDescriptorPool = index;
+            return index;
         }
     }
-    if (canPurgeExtinctPools) {
-        for (VkDescriptorPool pool : mExtinctDescriptorPools) {
-            vkDestroyDescriptorPool(mDevice, pool, VKALLOC);
+
+    // All pools are full, add a new one to the ring. Unlike re-creating a bigger pool, this does
+    // not orphan the descriptor sets that are still cached.
+    mDescriptorPools.push_back({
+        .handle = createDescriptorPool(DESCRIPTOR_SET_POOL_SIZE),
+        .lastUsed = mCurrentTime
+    });
+    mCurrentDescriptorPool = count;
+    mDescriptorStats.poolCount++;
+    return count;
+}
+
+void VulkanPipelineCache::recycleDescriptorPools() noexcept {
+    for (uint32_t index = 0, count = mDescriptorPools.size(); index < count; index++) {
+        DescriptorPoolEntry& pool = mDescriptorPools[index];
+
+        // Destroy the pools that have stayed empty for a while, so that the ring shrinks back
+        // after a spike. The current pool is always kept, and the slot itself remains because
+        // bundles refer to their pool by index.
+        if (pool.allocated == 0) {
+            if (pool.handle != VK_NULL_HANDLE && index != mCurrentDescriptorPool &&
+                    pool.lastUsed + VK_MAX_DESCRIPTOR_POOL_AGE < mCurrentTime) {
+                vkDestroyDescriptorPool(mDevice, pool.handle, VKALLOC);
+                pool.handle = VK_NULL_HANDLE;
+                mDescriptorStats.poolCount--;
+                mDescriptorStats.poolTrims++;
+            }
+            continue;
+        }
+
+        // A pool can be reset once none of its bundles are used by the cache anymore. Bundles
+        // only go to an arena after VK_MAX_PIPELINE_AGE flushes without use, so at this point
+        // no pending command buffer can reference them.
+        if (pool.alive != pool.idle) {
+            continue;
         }
-        mExtinctDescriptorPools.clear();
-        mExtinctDescriptorBundles.clear();
+
+        // Remove the bundles of this pool from the arenas, since they're about to become invalid.
+        if (pool.idle > 0) {
+            for (auto iter = mPipelineLayouts.begin(); iter != mPipelineLayouts.end(); ++iter) {
+                auto& arena = iter.value().descriptorSetArena;
+                arena.erase(std::remove_if(arena.begin(), arena.end(),
+                        [index](DescriptorCacheEntry const& bundle) {
+                            return bundle.pool == index;
+                        }), arena.end());
+            }
+        }
+
+        vkResetDescriptorPool(mDevice, pool.handle, 0);
+        pool = { .handle = pool.handle, .lastUsed = mCurrentTime };
+        mDescriptorStats.poolResets++;
     }
 }
 
@@ -747,7 +822,7 @@ VkDescriptorPool VulkanPipelineCache::createDescriptorPool(uint32_t size) const
     VkDescriptorPoolCreateInfo poolInfo {
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
         .pNext = nullptr,
-        .flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
+        .flags = 0,
         .maxSets = size * DESCRIPTOR_TYPE_COUNT,
         .poolSizeCount = DESCRIPTOR_TYPE_COUNT,
         .pPoolSizes = poolSizes
@@ -791,43 +866,17 @@ void VulkanPipelineCache::destroyLayoutsAndDescriptors() noexcept {
         // implicitly frees them.
     }
     mPipelineLayouts.clear();
-    vkDestroyDescriptorPool(mDevice, mDescriptorPool, VKALLOC);
-    mDescriptorPool = VK_NULL_HANDLE;
 
-    for (VkDescriptorPool pool : mExtinctDescriptorPools) {
-        vkDestroyDescriptorPool(mDevice, pool, VKALLOC);
-    }
-    mExtinctDescriptorPools.clear();
-    mExtinctDescriptorBundles.clear();
-
-    mBoundDescriptor = {};
-}
-
-void VulkanPipelineCache::growDescriptorPool() noexcept {
-    // We need to destroy the old VkDescriptorPool, but we can't do so immediately because many
-    // of its descriptors are still in use. So, stash it in an "extinct" list.
-    mExtinctDescriptorPools.push_back(mDescriptorPool);
-
-    // Create the new VkDescriptorPool, twice as big as the old one.
-    mDescriptorPoolSize *= 2;
-    mDescriptorPool = createDescriptorPool(mDescriptorPoolSize);
-
-    // Clear out all unused descriptor sets in the arena so they don't get reclaimed. There is no
-    // need to free them individually since the old VkDescriptorPool will be destroyed.
-    for (auto iter = mPipelineLayouts.begin(); iter != mPipelineLayouts.end(); ++iter) {
-        for (auto& arena : iter.value().descriptorSetArenas) {
-            arena.clear();
+    for (auto const& pool : mDescriptorPools) {
+        if (pool.handle != VK_NULL_HANDLE) {
+            vkDestroyDescriptorPool(mDevice, pool.handle, VKALLOC);
         }
     }
-    mDescriptorArenasCount = 0;
+    mDescriptorPools.clear();
+    mCurrentDescriptorPool = 0;
+    mDescriptorStats.poolCount = 0;
 
-    // Move all in-use descriptors from the primary cache into an "extinct" list, so that they will
-    // later be destroyed rather than reclaimed.
-    using DescIterator = decltype(mDescriptorSets)::iterator;
-    for (DescIterator iter = mDescriptorSets.begin(); iter != mDescriptorSets.end(); ++iter) {
-        mExtinctDescriptorBundles.push_back(iter.value());
-    }
-    mDescriptorSets.clear();
+    mBoundDescriptor = {};
 }
 
 size_t VulkanPipelineCache::PipelineLayoutKeyHashFn::operator()(
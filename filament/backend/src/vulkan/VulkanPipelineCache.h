@@ -64,7 +64,8 @@ public:
 
     // Three descriptor set layouts: uniforms, combined image samplers, and input attachments.
     static constexpr uint32_t DESCRIPTOR_TYPE_COUNT = 3;
-    static constexpr uint32_t INITIAL_DESCRIPTOR_SET_POOL_SIZE = 512;
+    // Number of descriptor set bundles (one set per type) that fit in each VkDescriptorPool.
+    static constexpr uint32_t DESCRIPTOR_SET_POOL_SIZE = 512;
 
     // The VertexArray POD is an array of buffer targets and an array of attributes that refer to
     // those targets. It does not include any references to actual buffers, so you can think of it
@@ -125,6 +126,16 @@ public:
         VkDeviceSize size;
     };
 
+    // Descriptor set counters, accumulated since the last call to resetDescriptorStats().
+    struct DescriptorStats {
+        uint32_t hits;          // bindDescriptors() found a cached bundle
+        uint32_t reuses;        // a bundle was recycled from the free list of its pipeline layout
+        uint32_t allocations;   // a bundle was allocated with vkAllocateDescriptorSets
+        uint32_t poolResets;    // a retired VkDescriptorPool was reset with vkResetDescriptorPool
+        uint32_t poolTrims;     // an empty VkDescriptorPool was destroyed
+        uint32_t poolCount;     // current number of VkDescriptorPool objects
+    };
+
     // Upon construction, the pipeCache initializes some internal state but does not make any Vulkan
     // calls. On destruction it will free any cached Vulkan objects that haven't already been freed.
     VulkanPipelineCache();
@@ -185,6 +196,15 @@ public:
         mDummyTargetInfo.imageView = imageView;
     }
 
+    const DescriptorStats& getDescriptorStats() const noexcept { return mDescriptorStats; }
+
+    void resetDescriptorStats() noexcept {
+        mDescriptorStats = { .poolCount = mDescriptorStats.poolCount };
+    }
+
+    uint32_t getDescriptorPoolCount() const noexcept { return mDescriptorStats.poolCount; }
+    uint32_t getPipelineCount() const noexcept { return uint32_t(mPipelines.size()); }
+
 private:
 
     // PIPELINE LAYOUT CACHE KEY
@@ -328,6 +348,7 @@ private:
         std::array<VkDescriptorSet, DESCRIPTOR_TYPE_COUNT> handles;
         Timestamp lastUsed;
         PipelineLayoutKey pipelineLayout;
+        uint32_t pool; // index into mDescriptorPools
     };
 
     struct PipelineCacheEntry {
@@ -341,19 +362,31 @@ private:
 
         std::array<VkDescriptorSetLayout, DESCRIPTOR_TYPE_COUNT> descriptorSetLayouts;
 
-        // Each pipeline layout has 3 arenas of unused descriptors (one for each binding type).
+        // Each pipeline layout has an arena of unused descriptor set bundles.
         //
-        // The difference between the "arenas" and the "pool" are as follows.
+        // The difference between the "arena" and the "pools" are as follows.
         //
-        // - The "pool" is a single, centralized factory for all descriptors (VkDescriptorPool).
+        // - The "pools" are a ring of fixed-size factories for all descriptors (VkDescriptorPool).
+        //   Descriptor sets are never freed individually, instead a pool is reset wholesale once
+        //   none of its descriptor sets are in use anymore.
         //
-        // - Each "arena" is a set of unused (but alive) descriptors that can only be used with a
-        //   specific pipeline layout and a specific binding type. We manually manage each arena.
-        //   The arenas are created in an empty state, and they are gradually populated as new
-        //   descriptors are reclaimed over time.  This is quite different from the pool, which is
-        //   given a fixed size when it is constructed.
+        // - The "arena" is a free list of unused (but alive) bundles that can only be used with a
+        //   specific pipeline layout. Arenas are created in an empty state, and they are gradually
+        //   populated as cache entries are retired over time.
         //
-        std::array<std::vector<VkDescriptorSet>, DESCRIPTOR_TYPE_COUNT> descriptorSetArenas;
+        std::vector<DescriptorCacheEntry> descriptorSetArena;
+    };
+
+    // Each VkDescriptorPool tracks how many of its bundles are alive, i.e. referenced by the
+    // cache or by an arena, and how many of those sit unused in an arena. A pool that stays empty
+    // for VK_MAX_DESCRIPTOR_POOL_AGE flushes is destroyed and its handle set to VK_NULL_HANDLE;
+    // the slot is kept (bundles refer to their pool by index) and re-created on demand.
+    struct DescriptorPoolEntry {
+        VkDescriptorPool handle;
+        uint32_t allocated; // bundles allocated since the last reset
+        uint32_t alive;     // bundles owned by mDescriptorSets or by an arena
+        uint32_t idle;      // bundles owned by an arena
+        Timestamp lastUsed; // last allocation from this pool, or when it was (re)created
     };
 
     // CACHE CONTAINERS
@@ -378,7 +411,8 @@ private:
     // Misc helper methods.
     void destroyLayoutsAndDescriptors() noexcept;
     VkDescriptorPool createDescriptorPool(uint32_t size) const;
-    void growDescriptorPool() noexcept;
+    uint32_t acquireDescriptorPool() noexcept;
+    void recycleDescriptorPools() noexcept;
 
     // Immutable state.
     VkDevice mDevice = VK_NULL_HANDLE;
@@ -397,27 +431,14 @@ private:
     // Current state for scissoring.
     VkRect2D mCurrentScissor = {};
 
-    // The descriptor set pool starts out with a decent number of descriptor sets.  The cache can
-    // grow the pool by re-creating it with a larger size.  See growDescriptorPool().
-    VkDescriptorPool mDescriptorPool;
-
-    // This describes the number of descriptor sets in mDescriptorPool. Note that this needs to be
-    // multiplied by DESCRIPTOR_TYPE_COUNT to get the actual number of descriptor sets. Also note
-    // that the number of low-level "descriptors" (not descriptor *sets*) is actually much more than
-    // this size. It can be computed only by factoring in UBUFFER_BINDING_COUNT etc.
-    uint32_t mDescriptorPoolSize = INITIAL_DESCRIPTOR_SET_POOL_SIZE;
-
-    // To get the actual number of descriptor sets that have been allocated from the pool,
-    // take the sum of mDescriptorArenasCount (these are inactive descriptor sets) and the
-    // number of entries in the mDescriptorPool map (active descriptor sets). Multiply the result by
-    // DESCRIPTOR_TYPE_COUNT.
-    uint32_t mDescriptorArenasCount = 0;
-
-    // After a growth event (i.e. when the VkDescriptorPool is replaced with a bigger version), all
-    // currently used descriptors are moved into the "extinct" sets so that they can be safely
-    // destroyed a few frames later.
-    std::vector<VkDescriptorPool> mExtinctDescriptorPools;
-    std::vector<DescriptorCacheEntry> mExtinctDescriptorBundles;
+    // Ring of descriptor pools, each holding DESCRIPTOR_SET_POOL_SIZE bundles. New bundles are
+    // allocated from mCurrentDescriptorPool; when it is full the cache moves on to a pool that
+    // has been reset, or creates a new one. See acquireDescriptorPool(). Pools that are no longer
+    // needed are destroyed by recycleDescriptorPools().
+    std::vector<DescriptorPoolEntry> mDescriptorPools;
+    uint32_t mCurrentDescriptorPool = 0;
+
+    DescriptorStats mDescriptorStats = {};
 
     VkDescriptorBufferInfo mDummyBufferInfo = {};
     VkWriteDescriptorSet mDummyBufferWriteInfo = {};
@@ -24,6 +24,8 @@
 
 #include <utils/Panic.h>
 
+#include <algorithm>
+
 using namespace bluevk;
 
 namespace filament::backend {
@@ -427,6 +429,54 @@ void VulkanTexture::transitionLayout(VkCommandBuffer commands, const VkImageSubr
     }
 }
 
+void VulkanTexture::generateMipmaps(VkCommandBuffer commands) {
+    const VkImageAspectFlags aspect = getImageAspect();
+    const uint32_t layers = mPrimaryViewRange.layerCount;
+
+    // Integer formats (and a few others) cannot be linearly filtered by a blit.
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(mContext.physicalDevice, mVkFormat, &props);
+    const VkFilter filter =
+            (props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+                    ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+
+    int32_t srcw = int32_t(width);
+    int32_t srch = int32_t(height);
+    int32_t srcd = target == SamplerType::SAMPLER_3D ? int32_t(depth) : 1;
+
+    transitionLayout(commands, { aspect, 0, 1, 0, layers }, VulkanLayout::TRANSFER_SRC);
+
+    for (uint32_t level = 1; level < levels; level++) {
+        const int32_t dstw = std::max(srcw >> 1, 1);
+        const int32_t dsth = std::max(srch >> 1, 1);
+        const int32_t dstd = std::max(srcd >> 1, 1);
+
+        const VkImageSubresourceRange dstRange = { aspect, level, 1, 0, layers };
+        transitionLayout(commands, dstRange, VulkanLayout::TRANSFER_DST);
+
+        const VkImageBlit region = {
+                .srcSubresource = { aspect, level - 1, 0, layers },
+                .srcOffsets = {{ 0, 0, 0 }, { srcw, srch, srcd }},
+                .dstSubresource = { aspect, level, 0, layers },
+                .dstOffsets = {{ 0, 0, 0 }, { dstw, dsth, dstd }},
+        };
+        vkCmdBlitImage(commands,
+                mTextureImage, ImgUtil::getVkLayout(VulkanLayout::TRANSFER_SRC),
+                mTextureImage, ImgUtil::getVkLayout(VulkanLayout::TRANSFER_DST),
+                1, &region, filter);
+
+        // This level becomes the source of the next blit.
+        transitionLayout(commands, dstRange, VulkanLayout::TRANSFER_SRC);
+
+        srcw = dstw;
+        srch = dsth;
+        srcd = dstd;
+    }
+
+    transitionLayout(commands, { aspect, 0, levels, 0, layers },
+            ImgUtil::getDefaultLayout(usage));
+}
+
 VulkanLayout VulkanTexture::getLayout(uint32_t layer, uint32_t level) const {
     assert_invariant(level <= 0xffff && layer <= 0xffff);
     const uint32_t key = (layer << 16) | level;
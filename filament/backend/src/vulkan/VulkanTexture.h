@@ -71,6 +71,11 @@ struct VulkanTexture : public HwTexture {
     void transitionLayout(VkCommandBuffer commands, const VkImageSubresourceRange& range,
             VulkanLayout newLayout);
 
+    // Fills miplevels 1 and above by successively downsampling the previous level with
+    // vkCmdBlitImage. Each blit covers all the array layers (or all the slices of a 3D texture)
+    // of a miplevel at once, so no render targets or attachment views are needed.
+    void generateMipmaps(VkCommandBuffer commands);
+
     // Returns the preferred data plane of interest for all image views.
     // For now this always returns either DEPTH or COLOR.
     VkImageAspectFlags getImageAspect() const;
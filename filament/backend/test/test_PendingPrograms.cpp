@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "opengl/PendingPrograms.h"
+
+#include <tsl/robin_set.h>
+
+using namespace filament::backend;
+
+namespace {
+
+using ProgramHandle = Handle<HwProgram>;
+
+// Stands in for the GL completion status of each program.
+struct CompletionStatus {
+    tsl::robin_set<HandleBase::HandleId> completed;
+    bool operator()(ProgramHandle ph) const {
+        return completed.find(ph.getId()) != completed.end();
+    }
+};
+
+} // anonymous namespace
+
+TEST(PendingPrograms, ReadyUntilAdded) {
+    PendingPrograms pending;
+    EXPECT_TRUE(pending.isReady(ProgramHandle(1)));
+}
+
+TEST(PendingPrograms, PendingBeforeCreation) {
+    // the handle is allocated on the user thread before the driver creates the program
+    PendingPrograms pending;
+    CompletionStatus status;
+    ProgramHandle const ph(1);
+    pending.add(ph);
+    EXPECT_FALSE(pending.isReady(ph));
+
+    // not tracked yet, update() must not poll it
+    status.completed.insert(ph.getId());
+    pending.update(status);
+    EXPECT_FALSE(pending.isReady(ph));
+    EXPECT_EQ(pending.getTrackedCount(), 0);
+}
+
+TEST(PendingPrograms, UpdateRetiresCompletedPrograms) {
+    PendingPrograms pending;
+    CompletionStatus status;
+    ProgramHandle const a(1);
+    ProgramHandle const b(2);
+    pending.add(a);
+    pending.add(b);
+    pending.track(a);
+    pending.track(b);
+
+    pending.update(status);
+    EXPECT_FALSE(pending.isReady(a));
+    EXPECT_FALSE(pending.isReady(b));
+    EXPECT_EQ(pending.getTrackedCount(), 2);
+
+    status.completed.insert(b.getId());
+    pending.update(status);
+    EXPECT_FALSE(pending.isReady(a));
+    EXPECT_TRUE(pending.isReady(b));
+    EXPECT_EQ(pending.getTrackedCount(), 1);
+
+    status.completed.insert(a.getId());
+    pending.update(status);
+    EXPECT_TRUE(pending.isReady(a));
+    EXPECT_EQ(pending.getTrackedCount(), 0);
+}
+
+TEST(PendingPrograms, RemoveForgetsProgram) {
+    PendingPrograms pending;
+    CompletionStatus status;
+    ProgramHandle const ph(1);
+    pending.add(ph);
+    pending.track(ph);
+
+    // destroyed while still compiling
+    pending.remove(ph);
+    EXPECT_TRUE(pending.isReady(ph));
+    EXPECT_EQ(pending.getTrackedCount(), 0);
+
+    // the handle is reused by a new program, which must not inherit the old state
+    pending.add(ph);
+    EXPECT_FALSE(pending.isReady(ph));
+    pending.track(ph);
+    EXPECT_EQ(pending.getTrackedCount(), 1);
+    status.completed.insert(ph.getId());
+    pending.update(status);
+    EXPECT_TRUE(pending.isReady(ph));
+}
+
+TEST(PendingPrograms, RemoveUntrackedProgram) {
+    PendingPrograms pending;
+    ProgramHandle const a(1);
+    ProgramHandle const b(2);
+    pending.add(a);
+    pending.track(a);
+    pending.remove(b);
+    EXPECT_FALSE(pending.isReady(a));
+    EXPECT_EQ(pending.getTrackedCount(), 1);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
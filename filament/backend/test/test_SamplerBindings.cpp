@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BackendTest.h"
+
+#include "ShaderGenerator.h"
+#include "TrianglePrimitive.h"
+
+#include "private/backend/SamplerGroup.h"
+
+#if defined(FILAMENT_SUPPORTS_OPENGL)
+#include "opengl/OpenGLDriver.h"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Shaders
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static std::string vertex = R"(#version 450 core
+layout(location = 0) in vec4 mesh_position;
+void main() {
+    gl_Position = vec4(mesh_position.xy, 0.0, 1.0);
+})";
+
+static std::string fragment = R"(#version 450 core
+precision mediump int; precision highp float;
+layout(location = 0) out vec4 fragColor;
+
+// Filament's Vulkan backend requires a descriptor set index of 1 for all samplers.
+// This parameter is ignored for other backends.
+layout(location = 0, set = 1) uniform sampler2D tex;
+
+void main() {
+    fragColor = texture(tex, vec2(0.5));
+})";
+
+namespace test {
+
+using namespace filament;
+using namespace filament::backend;
+
+// Draws many times with the same program and sampler group, and checks that the OpenGL backend
+// binds the textures and samplers only when they may have changed. The OpenGL backend only
+// counts them in debug builds.
+TEST_F(BackendTest, SamplerBindingsAreNotRepeated) {
+#if defined(FILAMENT_SUPPORTS_OPENGL) && !defined(NDEBUG)
+    if (sBackend != Backend::OPENGL) {
+        GTEST_SKIP();
+    }
+
+    constexpr size_t kDrawCount = 64;
+
+    auto& api = getDriverApi();
+    auto& driver = static_cast<OpenGLDriver&>(getDriver());
+
+    // The test is executed within this block scope to force destructors to run before
+    // executeCommands().
+    {
+        // Create a platform-specific SwapChain and make it current.
+        auto swapChain = createSwapChain();
+        api.makeCurrent(swapChain, swapChain);
+
+        // Create a program.
+        ProgramHandle program;
+        {
+            SamplerInterfaceBlock sib = filament::SamplerInterfaceBlock::Builder()
+                    .name("backend_test_sib")
+                    .stageFlags(backend::ShaderStageFlags::ALL_SHADER_STAGE_FLAGS)
+                    .add({{ "tex", SamplerType::SAMPLER_2D, SamplerFormat::FLOAT,
+                            Precision::HIGH }})
+                    .build();
+            ShaderGenerator shaderGen(vertex, fragment, sBackend, sIsMobilePlatform, &sib);
+            Program prog = shaderGen.getProgram(api);
+            Program::Sampler psamplers[] = { utils::CString("tex"), 0 };
+            prog.setSamplerGroup(0, ShaderStageFlags::ALL_SHADER_STAGE_FLAGS,
+                    psamplers, sizeof(psamplers) / sizeof(psamplers[0]));
+            program = api.createProgram(std::move(prog));
+        }
+
+        auto defaultRenderTarget = api.createDefaultRenderTarget(0);
+        TrianglePrimitive triangle(api);
+
+        Handle<HwTexture> texture = api.createTexture(SamplerType::SAMPLER_2D, 1,
+                TextureFormat::RGBA8, 1, 16, 16, 1, TextureUsage::SAMPLEABLE);
+
+        SamplerGroup samplers(1);
+        samplers.setSampler(0, { texture, {} });
+        auto sgroup = api.createSamplerGroup(samplers.getSize());
+        api.updateSamplerGroup(sgroup, samplers.toBufferDescriptor(api));
+
+        RenderPassParams params = {};
+        fullViewport(params);
+        params.flags.clear = TargetBufferFlags::COLOR;
+        params.flags.discardStart = TargetBufferFlags::ALL;
+        params.flags.discardEnd = TargetBufferFlags::NONE;
+
+        PipelineState state;
+        state.program = program;
+        state.rasterState.colorWrite = true;
+        state.rasterState.depthWrite = false;
+        state.rasterState.depthFunc = RasterState::DepthFunc::A;
+        state.rasterState.culling = CullingMode::NONE;
+
+        api.makeCurrent(swapChain, swapChain);
+        api.beginFrame(0, 0);
+        api.bindSamplers(0, sgroup);
+
+        api.beginRenderPass(defaultRenderTarget, params);
+        for (size_t i = 0; i < kDrawCount; i++) {
+            api.draw(state, triangle.getRenderPrimitive(), 1);
+        }
+        api.endRenderPass();
+        api.finish();
+
+        OpenGLDriver::SamplerBindingStats const before = driver.getSamplerBindingStats();
+        executeCommands();
+        OpenGLDriver::SamplerBindingStats const after = driver.getSamplerBindingStats();
+
+        // textures and samplers are bound for the first draw only
+        EXPECT_EQ(after.updates - before.updates, 1u);
+        EXPECT_EQ(after.skipped - before.skipped, kDrawCount - 1);
+        EXPECT_EQ(after.binds - before.binds, 2u);
+
+        // binding the same sampler group again doesn't cause a new set-up, but updating its
+        // content does.
+        params.flags.clear = TargetBufferFlags::NONE;
+        params.flags.discardStart = TargetBufferFlags::NONE;
+        api.bindSamplers(0, sgroup);
+        api.beginRenderPass(defaultRenderTarget, params);
+        api.draw(state, triangle.getRenderPrimitive(), 1);
+        api.updateSamplerGroup(sgroup, samplers.toBufferDescriptor(api));
+        for (size_t i = 0; i < kDrawCount; i++) {
+            api.draw(state, triangle.getRenderPrimitive(), 1);
+        }
+        api.endRenderPass();
+
+        api.flush();
+        api.commit(swapChain);
+        api.endFrame(0);
+        api.finish();
+
+        OpenGLDriver::SamplerBindingStats const before2 = driver.getSamplerBindingStats();
+        executeCommands();
+        OpenGLDriver::SamplerBindingStats const after2 = driver.getSamplerBindingStats();
+
+        EXPECT_EQ(after2.updates - before2.updates, 1u);
+        EXPECT_EQ(after2.skipped - before2.skipped, kDrawCount);
+
+        api.destroyProgram(program);
+        api.destroySwapChain(swapChain);
+        api.destroyRenderTarget(defaultRenderTarget);
+        api.destroySamplerGroup(sgroup);
+        api.destroyTexture(texture);
+    }
+
+    executeCommands();
+#else
+    GTEST_SKIP();
+#endif
+}
+
+} // namespace test
@@ -20,11 +20,23 @@
 
 
 #include <filament/Box.h>
+#include <filament/Engine.h>
+#include <filament/Fence.h>
 #include <filament/Frustum.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
 #include "Culler.h"
+#include "UniformBuffer.h"
+
+#include "details/Engine.h"
+
+#include "benchmark_resources.h"
 
 #include <utils/Allocator.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <random>
 
@@ -33,6 +45,34 @@ using namespace filament::math;
 using namespace utils;
 
 
+static void generateCullingData(size_t count, Frustum& frustum,
+        std::vector<float3>& boxesCenter, std::vector<float3>& boxesExtent,
+        std::vector<float4>& spheres) {
+    std::default_random_engine gen; // NOLINT
+    std::uniform_real_distribution<float> rand(-100.0f, 100.0f);
+
+    frustum = Frustum{ mat4f::perspective(45.0f, 1.0f, 0.1f, 100.0f) };
+
+    boxesCenter.resize(count);
+    boxesExtent.resize(count);
+    spheres.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        float4& sphere = spheres[i];
+        float z = std::fabs(rand(gen));
+        sphere.z = -z;
+        sphere.x = rand(gen, std::uniform_real_distribution<float>::param_type{ -z, z });
+        sphere.y = rand(gen, std::uniform_real_distribution<float>::param_type{ -z, z });
+        sphere.w = rand(gen, std::uniform_real_distribution<float>::param_type{ 0.11f, 25.0f });
+
+        boxesCenter[i] = sphere.xyz;
+        boxesExtent[i] = {
+                rand(gen, std::uniform_real_distribution<float>::param_type{ 0.11f, 25.0f }),
+                rand(gen, std::uniform_real_distribution<float>::param_type{ 0.11f, 25.0f }),
+                rand(gen, std::uniform_real_distribution<float>::param_type{ 0.11f, 25.0f })
+        };
+    }
+}
+
 class FilamentFixture : public benchmark::Fixture {
 protected:
     static constexpr size_t BATCH_SIZE = 512;
@@ -46,32 +86,8 @@ protected:
 
 public:
     FilamentFixture() {
-
-        std::default_random_engine gen; // NOLINT
-        std::uniform_real_distribution<float> rand(-100.0f, 100.0f);
-
         const size_t batch = BATCH_SIZE;
-        frustum = Frustum{ mat4f::perspective(45.0f, 1.0f, 0.1f, 100.0f) };
-
-        boxesCenter.resize(batch);
-        boxesExtent.resize(batch);
-        spheres.resize(batch);
-        for (size_t i = 0; i < batch; i++) {
-            float4& sphere = spheres[i];
-            float z = std::fabs(rand(gen));
-            sphere.z = -z;
-            sphere.x = rand(gen, std::uniform_real_distribution<float>::param_type{ -z, z });
-            sphere.y = rand(gen, std::uniform_real_distribution<float>::param_type{ -z, z });
-            sphere.w = rand(gen, std::uniform_real_distribution<float>::param_type{ 0.11f, 25.0f });
-
-            boxesCenter[i] = sphere.xyz;
-            boxesExtent[i] = {
-                    rand(gen, std::uniform_real_distribution<float>::param_type{ 0.11f, 25.0f }),
-                    rand(gen, std::uniform_real_distribution<float>::param_type{ 0.11f, 25.0f }),
-                    rand(gen, std::uniform_real_distribution<float>::param_type{ 0.11f, 25.0f })
-            };
-        }
-
+        generateCullingData(batch, frustum, boxesCenter, boxesExtent, spheres);
         visibles = (Culler::result_type*)utils::aligned_alloc(batch * sizeof(*visibles), 32);
     }
 
@@ -103,3 +119,278 @@ BENCHMARK_F(FilamentFixture, sphereCulling)(benchmark::State& state) {
         state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
     }
 }
+
+/*
+ * Large batches, for each instruction set the culler supports.
+ * arg 0 is the batch size, arg 1 the Culler::Isa.
+ */
+
+class CullingFixture : public benchmark::Fixture {
+protected:
+    Frustum frustum{};
+    std::vector<float3> boxesCenter;
+    std::vector<float3> boxesExtent;
+    std::vector<float4> spheres;
+    std::vector<Culler::result_type> visibles;
+
+public:
+    void SetUp(const benchmark::State& state) override {
+        const size_t batch = size_t(state.range(0));
+        generateCullingData(batch, frustum, boxesCenter, boxesExtent, spheres);
+        visibles.resize(Culler::round(batch));
+    }
+
+    void TearDown(const benchmark::State&) override {
+        boxesCenter = {};
+        boxesExtent = {};
+        spheres = {};
+        visibles = {};
+    }
+
+    // returns false if the instruction set isn't supported by this CPU
+    static bool setup(benchmark::State& state, Culler::Isa isa) {
+        if (!Culler::Test::isSupported(isa)) {
+            state.SkipWithError("instruction set not supported");
+            return false;
+        }
+        state.SetLabel(Culler::Test::getName(isa));
+        return true;
+    }
+
+    static void report(benchmark::State& state, size_t batch) {
+        const double items = double(state.iterations()) * double(batch);
+        state.SetItemsProcessed(int64_t(items));
+        state.counters["items/ns"] = benchmark::Counter(items * 1e-9, benchmark::Counter::kIsRate);
+    }
+};
+
+static void cullingArguments(benchmark::internal::Benchmark* b) {
+    for (auto isa : { Culler::Isa::GENERIC, Culler::Isa::NEON,
+                      Culler::Isa::AVX2, Culler::Isa::AVX512 }) {
+        for (int64_t batch : { 10'000, 100'000, 1'000'000 }) {
+            b->Args({ batch, int64_t(isa) });
+        }
+    }
+}
+
+BENCHMARK_DEFINE_F(CullingFixture, boxCullingBatch)(benchmark::State& state) {
+    const size_t batch = size_t(state.range(0));
+    const Culler::Isa isa = Culler::Isa(state.range(1));
+    if (setup(state, isa)) {
+        for (auto _ : state) {
+            Culler::Test::intersects(isa, visibles.data(), frustum,
+                    boxesCenter.data(), boxesExtent.data(), batch);
+        }
+        benchmark::ClobberMemory();
+        report(state, batch);
+    }
+}
+
+BENCHMARK_DEFINE_F(CullingFixture, sphereCullingBatch)(benchmark::State& state) {
+    const size_t batch = size_t(state.range(0));
+    const Culler::Isa isa = Culler::Isa(state.range(1));
+    if (setup(state, isa)) {
+        for (auto _ : state) {
+            Culler::Test::intersects(isa, visibles.data(), frustum, spheres.data(), batch);
+        }
+        benchmark::ClobberMemory();
+        report(state, batch);
+    }
+}
+
+BENCHMARK_REGISTER_F(CullingFixture, boxCullingBatch)->Apply(cullingArguments);
+BENCHMARK_REGISTER_F(CullingFixture, sphereCullingBatch)->Apply(cullingArguments);
+
+/*
+ * Fence stress test: each of `arg 0` threads waits on its own fence, while the driver thread
+ * signals all of them one after the other. Measures the time it takes for all the waiters to
+ * wake up.
+ */
+
+static void fenceMultipleWaiters(benchmark::State& state) {
+    const size_t waiterCount = size_t(state.range(0));
+    Engine* engine = Engine::create(Engine::Backend::NOOP);
+
+    std::vector<Fence*> fences(waiterCount);
+    std::mutex lock;
+    std::condition_variable condition;
+    uint32_t generation = 0;
+    size_t remaining = 0;
+    bool exit = false;
+
+    std::vector<std::thread> waiters;
+    waiters.reserve(waiterCount);
+    for (size_t i = 0; i < waiterCount; i++) {
+        waiters.emplace_back([&, i]() {
+            uint32_t seen = 0;
+            while (true) {
+                Fence* fence;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    condition.wait(guard, [&]() { return exit || generation != seen; });
+                    if (exit) {
+                        return;
+                    }
+                    seen = generation;
+                    fence = fences[i];
+                }
+                fence->wait(Fence::Mode::DONT_FLUSH, Fence::FENCE_WAIT_FOR_EVER);
+                std::lock_guard<std::mutex> guard(lock);
+                if (--remaining == 0) {
+                    condition.notify_all();
+                }
+            }
+        });
+    }
+
+    for (auto _ : state) {
+        for (auto& fence : fences) {
+            fence = engine->createFence();
+        }
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            remaining = waiterCount;
+            generation++;
+        }
+        condition.notify_all();
+        engine->flush();
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            condition.wait(guard, [&]() { return remaining == 0; });
+        }
+        for (auto fence : fences) {
+            engine->destroy(fence);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        exit = true;
+    }
+    condition.notify_all();
+    for (auto& waiter : waiters) {
+        waiter.join();
+    }
+    Engine::destroy(&engine);
+
+    state.SetItemsProcessed(int64_t(state.iterations() * waiterCount));
+}
+
+BENCHMARK(fenceMultipleWaiters)->Arg(1)->Arg(4)->Arg(16)->Arg(64)->UseRealTime();
+
+/*
+ * Uniform buffer commits: each of `arg 0` buffers of `arg 1` bytes gets a single float modified
+ * per iteration, then is committed. `arg 2` selects whether the whole buffer is uploaded (0) or
+ * only its dirty ranges (1). Reports the number of bytes pushed through the command stream.
+ */
+
+static void uniformBufferCommit(benchmark::State& state) {
+    const size_t count = size_t(state.range(0));
+    const size_t size = size_t(state.range(1));
+    const bool partial = state.range(2) != 0;
+
+    Engine* engine = Engine::create(Engine::Backend::NOOP);
+    FEngine::DriverApi& driver = downcast(engine)->getDriverApi();
+
+    std::vector<UniformBuffer> buffers;
+    std::vector<backend::Handle<backend::HwBufferObject>> handles;
+    buffers.reserve(count);
+    handles.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        buffers.emplace_back(size);
+        handles.push_back(driver.createBufferObject(size,
+                backend::BufferObjectBinding::UNIFORM, backend::BufferUsage::DYNAMIC));
+        buffers.back().commit(driver, handles.back(), false);
+    }
+    engine->flush();
+
+    size_t bytes = 0;
+    float time = 0.0f;
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; i++) {
+            UniformBuffer& ub = buffers[i];
+            ub.setUniform((i * 16) % size, time);
+            if (partial) {
+                bytes += ub.commit(driver, handles[i], true);
+            } else {
+                driver.updateBufferObject(handles[i], ub.toBufferDescriptor(driver), 0);
+                bytes += size;
+            }
+        }
+        engine->flush();
+        time += 1.0f;
+    }
+
+    for (auto handle : handles) {
+        driver.destroyBufferObject(handle);
+    }
+    Engine::destroy(&engine);
+
+    state.SetBytesProcessed(int64_t(bytes));
+    state.counters["bytes/commit"] =
+            double(bytes) / double(std::max(state.iterations() * count, size_t(1)));
+}
+
+BENCHMARK(uniformBufferCommit)
+        ->Args({ 1000, 256, 0 })->Args({ 1000, 256, 1 })
+        ->Args({ 1000, 1024, 0 })->Args({ 1000, 1024, 1 });
+
+/*
+ * Setting a parameter on `arg 0` instances of the same material: by name (arg 1 = 0), through
+ * a ParameterHandle (arg 1 = 1), or with the batch setter (arg 1 = 2).
+ */
+
+static void materialInstanceSetParameter(benchmark::State& state) {
+    const size_t count = size_t(state.range(0));
+    const int64_t mode = state.range(1);
+
+    Engine* engine = Engine::create(Engine::Backend::NOOP);
+    Material* material = Material::Builder()
+            .package(BENCHMARK_RESOURCES_SANDBOXLIT_DATA, BENCHMARK_RESOURCES_SANDBOXLIT_SIZE)
+            .build(*engine);
+
+    std::vector<MaterialInstance*> instances(count);
+    std::vector<float> values(count);
+    for (size_t i = 0; i < count; i++) {
+        instances[i] = material->createInstance();
+        values[i] = float(i) / float(count);
+    }
+
+    const auto handle = instances[0]->getParameterHandle("roughness");
+
+    switch (mode) {
+        case 0: state.SetLabel("name"); break;
+        case 1: state.SetLabel("handle"); break;
+        default: state.SetLabel("batch"); break;
+    }
+
+    for (auto _ : state) {
+        switch (mode) {
+            case 0:
+                for (size_t i = 0; i < count; i++) {
+                    instances[i]->setParameter("roughness", values[i]);
+                }
+                break;
+            case 1:
+                for (size_t i = 0; i < count; i++) {
+                    instances[i]->setParameter(handle, values[i]);
+                }
+                break;
+            default:
+                MaterialInstance::setParameters(handle, instances.data(), values.data(), count);
+                break;
+        }
+        benchmark::ClobberMemory();
+    }
+
+    for (auto instance : instances) {
+        engine->destroy(instance);
+    }
+    engine->destroy(material);
+    Engine::destroy(&engine);
+
+    state.SetItemsProcessed(int64_t(state.iterations() * count));
+}
+
+BENCHMARK(materialInstanceSetParameter)
+        ->Args({ 1000, 0 })->Args({ 1000, 1 })->Args({ 1000, 2 });
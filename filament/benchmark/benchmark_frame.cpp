@@ -0,0 +1,528 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include <filament/Camera.h>
+#include <filament/DebugRegistry.h>
+#include <filament/Engine.h>
+#include <filament/IndexBuffer.h>
+#include <filament/LightManager.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
+#include <filament/Renderer.h>
+#include <filament/Scene.h>
+#include <filament/StaticBatch.h>
+#include <filament/SwapChain.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+#include <filament/View.h>
+#include <filament/Viewport.h>
+
+#include "benchmark_resources.h"
+
+#include <utils/EntityManager.h>
+
+#include <math/mat4.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+#include <stddef.h>
+
+using namespace filament;
+using namespace filament::math;
+using namespace utils;
+
+/*
+ * Whole frames rendered on the NOOP backend, so that the CPU cost of the engine can be tracked
+ * without a GPU. Besides the total time, each benchmark reports the average time spent in each
+ * phase of a frame (in microseconds):
+ *
+ *  beginFrame_us   Renderer::beginFrame()
+ *  render_us       Renderer::render(), i.e. culling, shadow maps setup and command generation
+ *  endFrame_us     Renderer::endFrame(), i.e. submission to the driver thread
+ *  driver_us       time waiting for the driver thread to process the frame's commands
+ *
+ * as well as the number of draws of the color pass (colorDraws) and the number of shadow map render
+ * passes and draws (shadowPasses, shadowDraws).
+ */
+
+namespace {
+
+struct SceneConfig {
+    size_t renderableCount;
+    size_t pointLightCount;
+    size_t shadowCascades;      // 0 disables shadows
+    size_t skinnedCount;        // how many of the renderables are skinned
+    bool postProcessing;
+    size_t spotShadowCount = 0; // spot lights casting shadows, each has its own shadow map
+    size_t pointShadowCount = 0;// point lights casting shadows, each has six shadow maps
+    uint32_t width = 1920;      // size of the swap chain and viewport
+    uint32_t height = 1080;
+    bool staticBatch = false;   // the renderables are merged with a StaticBatch
+};
+
+struct Vertex {
+    float3 position;
+    short4 tangents;
+    ushort4 joints;
+    float4 weights;
+};
+
+constexpr size_t BONE_COUNT = 16;
+constexpr size_t MATERIAL_INSTANCE_COUNT = 16;
+
+// a unit cube, every vertex is attached to two bones
+constexpr Vertex CUBE_VERTICES[8] = {
+        { { -1, -1, -1 }, { 0, 0, 0, 0x7fff }, { 0, 1, 0, 0 }, { 0.5f, 0.5f, 0, 0 } },
+        { {  1, -1, -1 }, { 0, 0, 0, 0x7fff }, { 1, 2, 0, 0 }, { 0.5f, 0.5f, 0, 0 } },
+        { { -1,  1, -1 }, { 0, 0, 0, 0x7fff }, { 2, 3, 0, 0 }, { 0.5f, 0.5f, 0, 0 } },
+        { {  1,  1, -1 }, { 0, 0, 0, 0x7fff }, { 3, 4, 0, 0 }, { 0.5f, 0.5f, 0, 0 } },
+        { { -1, -1,  1 }, { 0, 0, 0, 0x7fff }, { 4, 5, 0, 0 }, { 0.5f, 0.5f, 0, 0 } },
+        { {  1, -1,  1 }, { 0, 0, 0, 0x7fff }, { 5, 6, 0, 0 }, { 0.5f, 0.5f, 0, 0 } },
+        { { -1,  1,  1 }, { 0, 0, 0, 0x7fff }, { 6, 7, 0, 0 }, { 0.5f, 0.5f, 0, 0 } },
+        { {  1,  1,  1 }, { 0, 0, 0, 0x7fff }, { 7, 8, 0, 0 }, { 0.5f, 0.5f, 0, 0 } },
+};
+
+constexpr uint16_t CUBE_INDICES[36] = {
+        0, 1, 2,  2, 1, 3,   4, 6, 5,  5, 6, 7,   0, 2, 4,  4, 2, 6,
+        1, 5, 3,  3, 5, 7,   0, 4, 1,  1, 4, 5,   2, 3, 6,  6, 3, 7,
+};
+
+class FrameScene {
+public:
+    FrameScene(Engine& engine, SceneConfig const& config);
+    ~FrameScene();
+
+    // updates the bones of the skinned renderables, as an animation system would
+    void animate(float time);
+
+    Renderer* getRenderer() const noexcept { return mRenderer; }
+    SwapChain* getSwapChain() const noexcept { return mSwapChain; }
+    View* getView() const noexcept { return mView; }
+
+private:
+    Engine& mEngine;
+    SwapChain* mSwapChain = nullptr;
+    Renderer* mRenderer = nullptr;
+    Scene* mScene = nullptr;
+    View* mView = nullptr;
+    Camera* mCamera = nullptr;
+    Entity mCameraEntity;
+    Material* mMaterial = nullptr;
+    std::vector<MaterialInstance*> mInstances;
+    VertexBuffer* mVertexBuffer = nullptr;
+    IndexBuffer* mIndexBuffer = nullptr;
+    std::vector<Entity> mRenderables;
+    StaticBatch* mStaticBatch = nullptr;
+    std::vector<Entity> mLights;
+    size_t mSkinnedCount = 0;
+    std::vector<mat4f> mBones;
+};
+
+FrameScene::FrameScene(Engine& engine, SceneConfig const& config)
+        : mEngine(engine), mSkinnedCount(config.skinnedCount), mBones(BONE_COUNT) {
+    EntityManager& em = EntityManager::get();
+
+    mSwapChain = engine.createSwapChain(config.width, config.height);
+    mRenderer = engine.createRenderer();
+    mScene = engine.createScene();
+    mView = engine.createView();
+    mCameraEntity = em.create();
+    mCamera = engine.createCamera(mCameraEntity);
+
+    // the renderables are laid out on a square grid, part of it is outside of the frustum
+    const size_t side = size_t(std::ceil(std::sqrt(double(config.renderableCount))));
+    const float extent = float(side) * 3.0f;
+
+    mCamera->setProjection(45.0, double(config.width) / double(config.height), 0.1, 2.0 * extent);
+    mCamera->lookAt({ 0, extent * 0.5, extent * 0.5 }, { 0, 0, -extent * 0.25 });
+
+    mView->setScene(mScene);
+    mView->setCamera(mCamera);
+    mView->setViewport({ 0, 0, config.width, config.height });
+    mView->setShadowingEnabled(config.shadowCascades > 0);
+    mView->setPostProcessingEnabled(config.postProcessing);
+    if (config.postProcessing) {
+        BloomOptions bloom;
+        bloom.enabled = true;
+        mView->setBloomOptions(bloom);
+        AmbientOcclusionOptions ao;
+        ao.enabled = true;
+        mView->setAmbientOcclusionOptions(ao);
+        mView->setAntiAliasing(View::AntiAliasing::FXAA);
+    }
+
+    mMaterial = Material::Builder()
+            .package(BENCHMARK_RESOURCES_SANDBOXLIT_DATA, BENCHMARK_RESOURCES_SANDBOXLIT_SIZE)
+            .build(engine);
+    for (size_t i = 0; i < MATERIAL_INSTANCE_COUNT; i++) {
+        MaterialInstance* mi = mMaterial->createInstance();
+        mi->setParameter("roughness", float(i) / float(MATERIAL_INSTANCE_COUNT));
+        mInstances.push_back(mi);
+    }
+
+    mVertexBuffer = VertexBuffer::Builder()
+            .vertexCount(8)
+            .bufferCount(1)
+            .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT3,
+                    offsetof(Vertex, position), sizeof(Vertex))
+            .attribute(VertexAttribute::TANGENTS, 0, VertexBuffer::AttributeType::SHORT4,
+                    offsetof(Vertex, tangents), sizeof(Vertex))
+            .normalized(VertexAttribute::TANGENTS)
+            .attribute(VertexAttribute::BONE_INDICES, 0, VertexBuffer::AttributeType::USHORT4,
+                    offsetof(Vertex, joints), sizeof(Vertex))
+            .attribute(VertexAttribute::BONE_WEIGHTS, 0, VertexBuffer::AttributeType::FLOAT4,
+                    offsetof(Vertex, weights), sizeof(Vertex))
+            .build(engine);
+    mVertexBuffer->setBufferAt(engine, 0, { CUBE_VERTICES, sizeof(CUBE_VERTICES) });
+
+    mIndexBuffer = IndexBuffer::Builder()
+            .indexCount(36)
+            .bufferType(IndexBuffer::IndexType::USHORT)
+            .build(engine);
+    mIndexBuffer->setBuffer(engine, { CUBE_INDICES, sizeof(CUBE_INDICES) });
+
+    const bool shadows = config.shadowCascades > 0;
+    auto gridTransform = [side](size_t i) {
+        const float x = (float(i % side) - float(side) * 0.5f) * 3.0f;
+        const float z = (float(i / side) - float(side) * 0.5f) * 3.0f;
+        return mat4f::translation(float3{ x, 0, z });
+    };
+
+    if (config.staticBatch) {
+        // the same grid, merged into a few renderables
+        float3 positions[8];
+        short4 tangents[8];
+        for (size_t i = 0; i < 8; i++) {
+            positions[i] = CUBE_VERTICES[i].position;
+            tangents[i] = CUBE_VERTICES[i].tangents;
+        }
+        uint32_t indices[36];
+        std::copy(std::begin(CUBE_INDICES), std::end(CUBE_INDICES), indices);
+        StaticBatch::Builder builder;
+        for (size_t i = 0; i < config.renderableCount; i++) {
+            builder.mesh({
+                    .materialInstance = mInstances[i % MATERIAL_INSTANCE_COUNT],
+                    .transform = gridTransform(i),
+                    .positions = positions,
+                    .tangents = tangents,
+                    .vertexCount = 8,
+                    .indices = indices,
+                    .indexCount = 36 });
+        }
+        mStaticBatch = builder.castShadows(shadows).receiveShadows(shadows).build(engine);
+        mScene->addEntities(mStaticBatch->getEntities(), mStaticBatch->getEntityCount());
+    }
+
+    mRenderables.resize(config.staticBatch ? 0 : config.renderableCount);
+    em.create(mRenderables.size(), mRenderables.data());
+    TransformManager& tcm = engine.getTransformManager();
+    for (size_t i = 0; i < mRenderables.size(); i++) {
+        RenderableManager::Builder builder(1);
+        builder.geometry(0, RenderableManager::PrimitiveType::TRIANGLES,
+                        mVertexBuffer, mIndexBuffer)
+                .material(0, mInstances[i % MATERIAL_INSTANCE_COUNT])
+                .boundingBox({{ 0, 0, 0 }, { 1, 1, 1 }})
+                .castShadows(shadows)
+                .receiveShadows(shadows);
+        if (i < config.skinnedCount) {
+            builder.skinning(BONE_COUNT);
+        }
+        builder.build(engine, mRenderables[i]);
+        tcm.create(mRenderables[i], {}, gridTransform(i));
+        mScene->addEntity(mRenderables[i]);
+    }
+
+    mLights.resize(config.pointLightCount + config.spotShadowCount + config.pointShadowCount + 1);
+    em.create(mLights.size(), mLights.data());
+    LightManager::ShadowOptions shadowOptions;
+    shadowOptions.shadowCascades = uint8_t(std::max(size_t(1), config.shadowCascades));
+    LightManager::Builder(LightManager::Type::SUN)
+            .direction({ 0.3f, -1.0f, -0.4f })
+            .intensity(100000.0f)
+            .castShadows(shadows)
+            .shadowOptions(shadowOptions)
+            .build(engine, mLights[0]);
+    mScene->addEntity(mLights[0]);
+    for (size_t i = 1; i < mLights.size(); i++) {
+        // a cheap deterministic scatter over the grid
+        const float x = (float((i * 7919) % 1000) / 1000.0f - 0.5f) * extent;
+        const float z = (float((i * 104729) % 1000) / 1000.0f - 0.5f) * extent;
+        if (i <= config.pointLightCount) {
+            LightManager::Builder(LightManager::Type::POINT)
+                    .position({ x, 2.0f, z })
+                    .intensity(10000.0f)
+                    .falloff(6.0f)
+                    .build(engine, mLights[i]);
+        } else if (i > config.pointLightCount + config.spotShadowCount) {
+            LightManager::Builder(LightManager::Type::POINT)
+                    .position({ x, 2.0f, z })
+                    .intensity(10000.0f)
+                    .falloff(10.0f)
+                    .castShadows(true)
+                    .build(engine, mLights[i]);
+        } else {
+            // spot lights pointing down, each one sees a few dozen renderables
+            LightManager::Builder(LightManager::Type::SPOT)
+                    .position({ x, 12.0f, z })
+                    .direction({ 0, -1, 0 })
+                    .spotLightCone(0.5f, 0.6f)
+                    .intensity(10000.0f)
+                    .falloff(20.0f)
+                    .castShadows(true)
+                    .build(engine, mLights[i]);
+        }
+        mScene->addEntity(mLights[i]);
+    }
+}
+
+FrameScene::~FrameScene() {
+    EntityManager& em = EntityManager::get();
+    for (Entity e : mRenderables) {
+        mEngine.destroy(e);
+    }
+    for (Entity e : mLights) {
+        mEngine.destroy(e);
+    }
+    em.destroy(mRenderables.size(), mRenderables.data());
+    em.destroy(mLights.size(), mLights.data());
+    if (mStaticBatch) {
+        mEngine.destroy(mStaticBatch);
+    }
+    mEngine.destroy(mVertexBuffer);
+    mEngine.destroy(mIndexBuffer);
+    for (MaterialInstance* mi : mInstances) {
+        mEngine.destroy(mi);
+    }
+    mEngine.destroy(mMaterial);
+    mEngine.destroyCameraComponent(mCameraEntity);
+    em.destroy(mCameraEntity);
+    mEngine.destroy(mView);
+    mEngine.destroy(mScene);
+    mEngine.destroy(mRenderer);
+    mEngine.destroy(mSwapChain);
+}
+
+void FrameScene::animate(float time) {
+    for (size_t i = 0; i < BONE_COUNT; i++) {
+        mBones[i] = mat4f::rotation(time + float(i) * 0.1f, float3{ 0, 1, 0 });
+    }
+    RenderableManager& rcm = mEngine.getRenderableManager();
+    for (size_t i = 0; i < mSkinnedCount; i++) {
+        rcm.setBones(rcm.getInstance(mRenderables[i]), mBones.data(), BONE_COUNT);
+    }
+}
+
+} // anonymous namespace
+
+static void renderFrames(benchmark::State& state, SceneConfig const& config,
+        Engine::Backend backend = Engine::Backend::NOOP) {
+    Engine* engine = Engine::create(backend);
+    if (!engine) {
+        state.SkipWithError("backend not available");
+        // the benchmark loop must still be entered, it ends immediately
+        for (auto _ : state) {
+        }
+        return;
+    }
+    {
+        FrameScene scene(*engine, config);
+        Renderer* renderer = scene.getRenderer();
+        SwapChain* swapChain = scene.getSwapChain();
+        View* view = scene.getView();
+
+        using clock = std::chrono::steady_clock;
+        auto elapsed = [](clock::time_point start) {
+            return std::chrono::duration<double, std::micro>(clock::now() - start).count();
+        };
+
+        // let the engine allocate and warm-up its caches
+        for (size_t i = 0; i < 4; i++) {
+            if (renderer->beginFrame(swapChain)) {
+                renderer->render(view);
+                renderer->endFrame();
+            }
+            engine->flushAndWait();
+        }
+
+        double beginFrameTime = 0;
+        double renderTime = 0;
+        double endFrameTime = 0;
+        double driverTime = 0;
+        float time = 0.0f;
+        for (auto _ : state) {
+            scene.animate(time);
+            time += 1.0f / 60.0f;
+
+            auto start = clock::now();
+            const bool draw = renderer->beginFrame(swapChain);
+            beginFrameTime += elapsed(start);
+            if (draw) {
+                start = clock::now();
+                renderer->render(view);
+                renderTime += elapsed(start);
+
+                start = clock::now();
+                renderer->endFrame();
+                endFrameTime += elapsed(start);
+            }
+
+            start = clock::now();
+            engine->flushAndWait();
+            driverTime += elapsed(start);
+        }
+
+        using benchmark::Counter;
+        state.counters["beginFrame_us"] = Counter(beginFrameTime, Counter::kAvgIterations);
+        state.counters["render_us"] = Counter(renderTime, Counter::kAvgIterations);
+        state.counters["endFrame_us"] = Counter(endFrameTime, Counter::kAvgIterations);
+        state.counters["driver_us"] = Counter(driverTime, Counter::kAvgIterations);
+        state.counters["driver_ns_per_renderable"] = Counter(
+                driverTime * 1000.0 / double(config.renderableCount), Counter::kAvgIterations);
+
+        // color pass draws, shadow map render passes and draws of the last frame
+        DebugRegistry& debugRegistry = engine->getDebugRegistry();
+        int const* colorDraws = debugRegistry.getPropertyAddress<int>("d.renderer.color_draw_count");
+        if (colorDraws) {
+            state.counters["colorDraws"] = Counter(*colorDraws);
+        }
+        int const* shadowPasses = debugRegistry.getPropertyAddress<int>("d.shadowmap.pass_count");
+        int const* shadowDraws = debugRegistry.getPropertyAddress<int>("d.shadowmap.draw_count");
+        if (shadowPasses && shadowDraws) {
+            state.counters["shadowPasses"] = Counter(*shadowPasses);
+            state.counters["shadowDraws"] = Counter(*shadowDraws);
+        }
+    }
+    Engine::destroy(&engine);
+}
+
+/*
+ * Args: { renderables, point lights, shadow cascades (0 = no shadows), skinned renderables,
+ *         post-processing }
+ */
+static void frame(benchmark::State& state) {
+    renderFrames(state, {
+            size_t(state.range(0)),
+            size_t(state.range(1)),
+            size_t(state.range(2)),
+            size_t(state.range(3)),
+            state.range(4) != 0 });
+}
+
+BENCHMARK(frame)
+        ->Args({    100,   0, 0,   0, 0 })
+        ->Args({   1000,   0, 0,   0, 0 })
+        ->Args({   1000,   0, 0,   0, 1 })
+        ->Args({   1000, 128, 0,   0, 1 })
+        ->Args({   1000, 128, 4,   0, 1 })
+        ->Args({   1000, 128, 4, 100, 1 })
+        ->Args({   5000, 256, 4,   0, 0 })
+        ->Args({   5000, 256, 4,   0, 1 })
+        ->Args({  10000, 256, 4, 500, 1 })
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+
+/*
+ * Scaling of the shadow maps' culling and command generation with the number of shadow maps.
+ * Args: { renderables, spot lights casting shadows }
+ */
+static void shadowMaps(benchmark::State& state) {
+    SceneConfig config{ size_t(state.range(0)), 0, 1, 0, false };
+    config.spotShadowCount = size_t(state.range(1));
+    renderFrames(state, config);
+}
+
+BENCHMARK(shadowMaps)
+        ->Args({  1000,  0 })
+        ->Args({  1000,  4 })
+        ->Args({  1000, 16 })
+        ->Args({  1000, 32 })
+        ->Args({ 10000,  0 })
+        ->Args({ 10000,  4 })
+        ->Args({ 10000, 16 })
+        ->Args({ 10000, 32 })
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+
+/*
+ * Point light shadows, each point light renders up to six shadow maps (one per cubemap face).
+ * Args: { renderables, point lights casting shadows }
+ */
+static void pointShadows(benchmark::State& state) {
+    SceneConfig config{ size_t(state.range(0)), 0, 1, 0, false };
+    config.pointShadowCount = size_t(state.range(1));
+    renderFrames(state, config);
+}
+
+BENCHMARK(pointShadows)
+        ->Args({  1000, 0 })
+        ->Args({  1000, 1 })
+        ->Args({  1000, 4 })
+        ->Args({  1000, 8 })
+        ->Args({ 10000, 1 })
+        ->Args({ 10000, 4 })
+        ->Args({ 10000, 8 })
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+
+/*
+ * Per-draw CPU cost of the Vulkan backend. The swap chain is tiny so that rasterization is
+ * negligible, which lets this run on a software implementation such as lavapipe; the driver_us
+ * and driver_ns_per_renderable counters are then dominated by the recording of the draws.
+ * Args: { renderables }
+ */
+static void vulkanDraws(benchmark::State& state) {
+    SceneConfig config{ size_t(state.range(0)), 0, 0, 0, false };
+    config.width = 64;
+    config.height = 36;
+    renderFrames(state, config, Engine::Backend::VULKAN);
+}
+
+BENCHMARK(vulkanDraws)
+        ->Arg(  1000)
+        ->Arg( 10000)
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+
+/*
+ * Many small static meshes sharing a few material instances, drawn as individual renderables or
+ * merged with a StaticBatch; compare colorDraws and render_us.
+ * Args: { renderables, static batching }
+ */
+static void staticBatching(benchmark::State& state) {
+    SceneConfig config{ size_t(state.range(0)), 0, 0, 0, false };
+    config.staticBatch = state.range(1) != 0;
+    renderFrames(state, config);
+}
+
+BENCHMARK(staticBatching)
+        ->Args({  1000, 0 })
+        ->Args({  1000, 1 })
+        ->Args({ 10000, 0 })
+        ->Args({ 10000, 1 })
+        ->Args({ 50000, 0 })
+        ->Args({ 50000, 1 })
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "MaterialParser.h"
+
+#include <filaflat/MaterialChunk.h>
+
+#include <backend/DriverEnums.h>
+
+#include <utils/Path.h>
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <stdlib.h>
+
+using namespace filament;
+using namespace utils;
+
+/*
+ * Parsing of the built-in materials, compiled with and without compression. Each iteration
+ * parses all the packages and loads one shader from each, like creating a material does. Besides
+ * the time, each benchmark reports (in bytes):
+ *
+ *  package     total size of the packages
+ *  resident    total memory kept alive by the parsers, see MaterialParser::getResidentSize()
+ *
+ * The packages are looked up in the directory given by the FILAMENT_BENCHMARK_PACKAGES
+ * environment variable, or in the one populated by the build.
+ */
+
+namespace {
+
+using Package = std::vector<char>;
+
+std::vector<Package> loadPackages(bool compressed) {
+    const char* dir = getenv("FILAMENT_BENCHMARK_PACKAGES");
+    Path const root = Path(dir ? dir : BENCHMARK_PACKAGE_DIR)
+            .concat(compressed ? "compressed" : "uncompressed");
+    std::vector<Package> packages;
+    for (Path const& path : root.listContents()) {
+        if (path.getExtension() != "filamat") {
+            continue;
+        }
+        std::ifstream in(path.getPath(), std::ios::binary);
+        packages.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    return packages;
+}
+
+} // anonymous namespace
+
+static void parseMaterials(benchmark::State& state, backend::Backend backend, bool compressed) {
+    std::vector<Package> const packages = loadPackages(compressed);
+    if (packages.empty()) {
+        state.SkipWithError("no material packages found");
+        // the benchmark loop must still be entered, it ends immediately
+        for (auto _ : state) {
+        }
+        return;
+    }
+
+    size_t packageSize = 0;
+    for (Package const& package : packages) {
+        packageSize += package.size();
+    }
+
+    size_t residentSize = 0;
+    size_t failures = 0;
+    for (auto _ : state) {
+        residentSize = 0;
+        failures = 0;
+        for (Package const& package : packages) {
+            MaterialParser parser(backend, package.data(), package.size());
+            if (parser.parse() != MaterialParser::ParseResult::SUCCESS) {
+                failures++;
+                continue;
+            }
+            bool first = true;
+            filaflat::ShaderContent shader;
+            parser.getMaterialChunk().visitShaders(
+                    [&](backend::ShaderModel model, Variant variant, backend::ShaderStage stage) {
+                        if (first) {
+                            parser.getShader(shader, model, variant, stage);
+                            first = false;
+                        }
+                    });
+            benchmark::DoNotOptimize(shader.data());
+            residentSize += parser.getResidentSize();
+        }
+    }
+
+    if (failures) {
+        // e.g. the backend isn't in the packages, or isn't supported by this build
+        state.SkipWithError("some packages could not be parsed");
+        return;
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * packages.size()));
+    state.counters["package"] = benchmark::Counter(double(packageSize));
+    state.counters["resident"] = benchmark::Counter(double(residentSize));
+}
+
+BENCHMARK_CAPTURE(parseMaterials, opengl, backend::Backend::OPENGL, false)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(parseMaterials, opengl_compressed, backend::Backend::OPENGL, true)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(parseMaterials, vulkan, backend::Backend::VULKAN, false)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(parseMaterials, vulkan_compressed, backend::Backend::VULKAN, true)
+        ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <filament/Engine.h>
+#include <filament/IndexBuffer.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+
+#include "benchmark_resources.h"
+
+#include <utils/EntityManager.h>
+
+#include <math/vec3.h>
+
+#include <vector>
+
+#include <stddef.h>
+
+using namespace filament;
+using namespace filament::math;
+using namespace utils;
+
+/*
+ * Creation and destruction of many renderables sharing the same geometry and material, on the
+ * NOOP backend. Each iteration creates all the renderables, then destroys them; the driver
+ * thread is flushed before the timer stops so that the cost of the commands is accounted for.
+ */
+
+namespace {
+
+constexpr float3 TRIANGLE_VERTICES[3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } };
+constexpr uint16_t TRIANGLE_INDICES[3] = { 0, 1, 2 };
+
+class RenderablesFixture {
+public:
+    explicit RenderablesFixture(size_t count) : mEntities(count) {
+        mEngine = Engine::create(Engine::Backend::NOOP);
+        mMaterial = Material::Builder()
+                .package(BENCHMARK_RESOURCES_SANDBOXLIT_DATA, BENCHMARK_RESOURCES_SANDBOXLIT_SIZE)
+                .build(*mEngine);
+        mVertexBuffer = VertexBuffer::Builder()
+                .vertexCount(3)
+                .bufferCount(1)
+                .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT3)
+                .build(*mEngine);
+        mVertexBuffer->setBufferAt(*mEngine, 0,
+                { TRIANGLE_VERTICES, sizeof(TRIANGLE_VERTICES) });
+        mIndexBuffer = IndexBuffer::Builder()
+                .indexCount(3)
+                .bufferType(IndexBuffer::IndexType::USHORT)
+                .build(*mEngine);
+        mIndexBuffer->setBuffer(*mEngine, { TRIANGLE_INDICES, sizeof(TRIANGLE_INDICES) });
+        EntityManager::get().create(mEntities.size(), mEntities.data());
+    }
+
+    ~RenderablesFixture() {
+        EntityManager::get().destroy(mEntities.size(), mEntities.data());
+        mEngine->destroy(mIndexBuffer);
+        mEngine->destroy(mVertexBuffer);
+        mEngine->destroy(mMaterial);
+        Engine::destroy(&mEngine);
+    }
+
+    RenderableManager::Builder builder() const {
+        RenderableManager::Builder builder(1);
+        builder.geometry(0, RenderableManager::PrimitiveType::TRIANGLES,
+                        mVertexBuffer, mIndexBuffer)
+                .material(0, mMaterial->getDefaultInstance())
+                .boundingBox({{ 0, 0, 0 }, { 1, 1, 1 }});
+        return builder;
+    }
+
+    Engine& engine() const noexcept { return *mEngine; }
+    std::vector<Entity> const& entities() const noexcept { return mEntities; }
+
+private:
+    Engine* mEngine = nullptr;
+    Material* mMaterial = nullptr;
+    VertexBuffer* mVertexBuffer = nullptr;
+    IndexBuffer* mIndexBuffer = nullptr;
+    std::vector<Entity> mEntities;
+};
+
+} // anonymous namespace
+
+/*
+ * One Builder::build() and one RenderableManager::destroy() call per renderable.
+ * Args: { renderables }
+ */
+static void createRenderables(benchmark::State& state) {
+    RenderablesFixture fixture(size_t(state.range(0)));
+    Engine& engine = fixture.engine();
+    RenderableManager& rcm = engine.getRenderableManager();
+    TransformManager& tcm = engine.getTransformManager();
+    auto const& entities = fixture.entities();
+    RenderableManager::Builder builder = fixture.builder();
+    for (auto _ : state) {
+        for (Entity e : entities) {
+            builder.build(engine, e);
+        }
+        for (Entity e : entities) {
+            rcm.destroy(e);
+            tcm.destroy(e);
+        }
+        engine.flushAndWait();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+/*
+ * A single bulk Builder::build() and RenderableManager::destroy() call for all renderables.
+ * Args: { renderables }
+ */
+static void createRenderablesBulk(benchmark::State& state) {
+    RenderablesFixture fixture(size_t(state.range(0)));
+    Engine& engine = fixture.engine();
+    RenderableManager& rcm = engine.getRenderableManager();
+    TransformManager& tcm = engine.getTransformManager();
+    auto const& entities = fixture.entities();
+    RenderableManager::Builder builder = fixture.builder();
+    for (auto _ : state) {
+        builder.build(engine, entities.data(), entities.size());
+        rcm.destroy(entities.data(), entities.size());
+        for (Entity e : entities) {
+            tcm.destroy(e);
+        }
+        engine.flushAndWait();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(createRenderables)
+        ->Arg(  1000)
+        ->Arg(100000)
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(createRenderablesBulk)
+        ->Arg(  1000)
+        ->Arg(100000)
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
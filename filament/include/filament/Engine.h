@@ -20,6 +20,10 @@
 #include <backend/Platform.h>
 
 #include <utils/compiler.h>
+#include <utils/Invocable.h>
+
+#include <stddef.h>
+#include <stdint.h>
 
 namespace utils {
 class Entity;
@@ -44,6 +48,7 @@ class Renderer;
 class RenderTarget;
 class Scene;
 class Skybox;
+class StaticBatch;
 class Stream;
 class SwapChain;
 class Texture;
@@ -263,6 +268,51 @@ public:
          * This value does not affect the application's memory usage.
          */
         uint32_t perFrameCommandsSizeMB = FILAMENT_PER_FRAME_COMMANDS_SIZE_IN_MB;
+
+
+        /**
+         * Size in MiB of the cache of render targets kept by Renderers for reuse across frames.
+         *
+         * When the cache is larger than this, the least recently used render targets are
+         * destroyed. See also Engine::setMemoryBudget().
+         *
+         * This value affects the application's memory usage.
+         */
+        uint32_t resourceAllocatorCacheSizeMB = 64;
+
+
+        /**
+         * Number of frames an unused render target is kept in the cache before it's destroyed.
+         */
+        uint32_t resourceAllocatorCacheMaxAge = 30;
+
+
+        /**
+         * Granularity in pixels of the dimensions of the render targets used by Renderers, or 0 to
+         * disable it.
+         *
+         * When not 0, the width and height of render targets that are never sampled (e.g. depth
+         * or multi-sample buffers) are rounded up to a multiple of this value, so they can be
+         * reused when the size of a View changes slightly, e.g. with dynamic resolution.
+         * Render targets that are sampled always have their exact size.
+         *
+         * This can increase the application's memory usage.
+         */
+        uint32_t resourceAllocatorSizeGranularity = 0;
+
+
+        /**
+         * Whether draw calls using a program that is still compiling are skipped.
+         *
+         * When the backend compiles programs asynchronously (currently OpenGL and OpenGL ES with
+         * KHR_parallel_shader_compile), the first draw call using a new program normally waits
+         * for its compilation to finish. When this is true, such draw calls are skipped until the
+         * program is ready instead, which avoids stalls the first time a material variant is used
+         * at the cost of objects missing for a few frames.
+         *
+         * @see Material::isReady()
+         */
+        bool skipDrawsWithPendingPrograms = false;
     };
 
     /**
@@ -604,6 +654,7 @@ public:
     bool destroy(const IndexBuffer* p);         //!< Destroys an IndexBuffer object.
     bool destroy(const SkinningBuffer* p);      //!< Destroys a SkinningBuffer object.
     bool destroy(const MorphTargetBuffer* p);   //!< Destroys a MorphTargetBuffer object.
+    bool destroy(const StaticBatch* p);         //!< Destroys a StaticBatch and its renderables.
     bool destroy(const IndirectLight* p);       //!< Destroys an IndirectLight object.
 
     /**
@@ -725,6 +776,103 @@ public:
       */
     utils::JobSystem& getJobSystem() noexcept;
 
+    /**
+     * Categories of memory accounted for by getMemoryReport().
+     *
+     * GPU sizes are estimates computed from the formats and dimensions of the resources, the
+     * actual usage depends on the driver (alignment, compression, etc...).
+     */
+    enum class MemoryCategory : uint8_t {
+        TEXTURE,                //!< Textures (GPU)
+        VERTEX_BUFFER,          //!< VertexBuffers, excluding their BufferObjects (GPU)
+        INDEX_BUFFER,           //!< IndexBuffers (GPU)
+        BUFFER_OBJECT,          //!< BufferObjects (GPU)
+        RENDER_TARGET,          //!< Render targets used by Renderers during a frame (GPU)
+        RENDER_TARGET_CACHE,    //!< Render targets kept for reuse by Renderers (GPU)
+        PROGRAM,                //!< Material programs, only counted (GPU)
+        COMMAND_BUFFER,         //!< Command buffers (CPU)
+        ARENA,                  //!< Per-render-pass and driver handle arenas (CPU)
+        UNIFORM_BUFFER_POOL,    //!< Uniform buffers pooled for MaterialInstances (GPU)
+        DRIVER_CACHE,           //!< Backend descriptor pools and pipelines, only counted (GPU)
+    };
+
+    static constexpr size_t MEMORY_CATEGORY_COUNT = 11;
+
+    /**
+     * Memory usage per category, see getMemoryReport().
+     */
+    struct MemoryReport {
+        struct Usage {
+            size_t size = 0;    //!< estimated size in bytes
+            size_t count = 0;   //!< number of objects
+        };
+
+        Usage categories[MEMORY_CATEGORY_COUNT];
+
+        Usage const& operator[](MemoryCategory category) const noexcept {
+            return categories[size_t(category)];
+        }
+
+        Usage& operator[](MemoryCategory category) noexcept {
+            return categories[size_t(category)];
+        }
+    };
+
+    /**
+     * Returns the memory currently held by this Engine, for each MemoryCategory.
+     *
+     * This is available in all builds and is reasonably cheap (it's proportional to the number
+     * of objects), but it's not meant to be called many times per frame.
+     *
+     * @param report MemoryReport to fill.
+     */
+    void getMemoryReport(MemoryReport& report) const noexcept;
+
+    /**
+     * Calls the given functor for each owner of memory in each MemoryCategory.
+     *
+     * Owners are materials for PROGRAM, framegraph resource names for RENDER_TARGET and
+     * RENDER_TARGET_CACHE (e.g. "Color Buffer"), the name of the arena or command buffer for
+     * ARENA and COMMAND_BUFFER, the kind of cache for DRIVER_CACHE (e.g. "DescriptorPool") and
+     * the kind of object for the other categories.
+     *
+     * @param functor called with the category, the name of the owner and its memory usage.
+     *                The name is only valid during the call.
+     */
+    void forEachMemoryOwner(utils::Invocable<void(MemoryCategory category, const char* owner,
+            MemoryReport::Usage const& usage)>&& functor) const noexcept;
+
+    /**
+     * Called when a MemoryCategory goes over its budget, see setMemoryBudget().
+     */
+    using MemoryBudgetCallback = utils::Invocable<void(MemoryCategory category,
+            MemoryReport::Usage const& usage, size_t budget)>;
+
+    /**
+     * Sets the budget of a MemoryCategory. Budgets are checked at the end of each frame (i.e.
+     * in Renderer::endFrame()), when the category is over budget:
+     *
+     * - RENDER_TARGET_CACHE: the least recently used render targets are destroyed until the cache
+     *   fits in its budget.
+     * - other categories: the callback is invoked, once each time the category goes over its
+     *   budget. The application can then free some resources, e.g. destroy unused Textures or
+     *   Materials.
+     *
+     * Budgets are in bytes, except for PROGRAM and DRIVER_CACHE which are numbers of objects.
+     *
+     * @param category  MemoryCategory to set the budget of.
+     * @param budget    Budget in bytes (or number of objects for PROGRAM and DRIVER_CACHE), 0 to
+     *                  remove the budget.
+     * @param callback  Called when the category goes over budget, can be empty.
+     */
+    void setMemoryBudget(MemoryCategory category, size_t budget,
+            MemoryBudgetCallback&& callback = {}) noexcept;
+
+    /**
+     * Returns the budget of a MemoryCategory, 0 if it doesn't have one.
+     */
+    size_t getMemoryBudget(MemoryCategory category) const noexcept;
+
 #if defined(__EMSCRIPTEN__)
     /**
       * WebGL only: Tells the driver to reset any internal state tracking if necessary.
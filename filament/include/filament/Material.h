@@ -253,6 +253,18 @@ public:
     //! Indicates whether an existing parameter is a sampler or not.
     bool isSampler(const char* name) const noexcept;
 
+    /**
+     * Indicates whether the backend is done compiling all the shader programs this material
+     * created so far. Programs are created the first time a variant of this material is needed
+     * to render, so a material that was never rendered is always ready.
+     *
+     * Programs only compile in the background on OpenGL and OpenGL ES with
+     * KHR_parallel_shader_compile, on other backends this always returns true.
+     *
+     * @see Engine::Config::skipDrawsWithPendingPrograms
+     */
+    bool isReady() const noexcept;
+
     /**
      * Sets the value of the given parameter on this material's default instance.
      *
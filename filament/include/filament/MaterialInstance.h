@@ -79,6 +79,22 @@ public:
             std::is_same<math::mat3f, T>::value
     >::type;
 
+    /**
+     * A parameter of a Material, resolved once by name with getParameterHandle().
+     *
+     * Setting a parameter through its handle doesn't need a name lookup, the handle is valid
+     * for all the instances of the same Material, and only for those.
+     */
+    struct ParameterHandle {
+        Material const* material = nullptr; //!< Material the handle was looked up from
+        uint32_t offset = 0;    //!< offset in bytes of a uniform, or binding of a sampler
+        uint16_t count = 0;     //!< number of array elements, 1 for scalars, 0 if invalid
+        backend::UniformType type = backend::UniformType::FLOAT; //!< type of a uniform
+        bool sampler = false;   //!< true if the parameter is a sampler
+        /** @return whether this handle refers to a parameter */
+        bool isValid() const noexcept { return count != 0; }
+    };
+
     /**
      * Creates a new MaterialInstance using another MaterialInstance as a template for initialization.
      * The new MaterialInstance is an instance of the same Material of the template instance and
@@ -222,6 +238,80 @@ public:
         setParameter(name, strlen(name), type, color);
     }
 
+    /**
+     * Looks up a parameter by name, for use with the setParameter() overloads taking a
+     * ParameterHandle.
+     *
+     * @param name          Name of the parameter as defined by Material. Cannot be nullptr.
+     * @param nameLength    Length in `char` of the name parameter.
+     * @return              A handle to the parameter, valid for all the instances of this
+     *                      instance's Material.
+     * @throws utils::PreConditionPanic if name doesn't exist or returns an invalid handle if
+     *         exceptions are disabled.
+     */
+    ParameterHandle getParameterHandle(const char* name, size_t nameLength) const;
+
+    /** inline helper to provide the name as a null-terminated string literal */
+    inline ParameterHandle getParameterHandle(StringLiteral name) const {
+        return getParameterHandle(name.data, name.size);
+    }
+
+    /** inline helper to provide the name as a null-terminated C string */
+    inline ParameterHandle getParameterHandle(const char* name) const {
+        return getParameterHandle(name, strlen(name));
+    }
+
+    /**
+     * Set a uniform through its handle. T must match the type of the parameter.
+     *
+     * @param handle        Handle of the parameter, from getParameterHandle().
+     * @param value         Value of the parameter to set.
+     * @throws utils::PreConditionPanic if handle was looked up from a different Material, is a
+     *         sampler, or doesn't match T.
+     */
+    template<typename T, typename = is_supported_parameter_t<T>>
+    void setParameter(ParameterHandle handle, T const& value);
+
+    /**
+     * Set a uniform array through its handle. T must match the type of the parameter.
+     *
+     * @param handle        Handle of the parameter array, from getParameterHandle().
+     * @param values        Array of values to set to the parameter array.
+     * @param count         Size of the array to set, at most handle.count.
+     * @throws utils::PreConditionPanic if handle was looked up from a different Material, is a
+     *         sampler, doesn't match T, or if count is larger than handle.count.
+     */
+    template<typename T, typename = is_supported_parameter_t<T>>
+    void setParameter(ParameterHandle handle, const T* values, size_t count);
+
+    /**
+     * Set a texture through the handle of a sampler parameter.
+     *
+     * @param handle        Handle of the parameter, from getParameterHandle().
+     * @param texture       Non nullptr Texture object pointer.
+     * @param sampler       Sampler parameters.
+     * @throws utils::PreConditionPanic if handle was looked up from a different Material or
+     *         isn't a sampler.
+     */
+    void setParameter(ParameterHandle handle, Texture const* texture,
+            TextureSampler const& sampler);
+
+    /**
+     * Set the same uniform on many instances at once, this is equivalent to calling
+     * instances[i]->setParameter(handle, values[i]) for each instance.
+     *
+     * @param handle        Handle of the parameter, from getParameterHandle().
+     * @param instances     Instances to update, all of them must be instances of the Material the
+     *                      handle was looked up from.
+     * @param values        One value per instance.
+     * @param count         Number of instances to update.
+     * @throws utils::PreConditionPanic if handle was looked up from a different Material, is a
+     *         sampler, or doesn't match T.
+     */
+    template<typename T, typename = is_supported_parameter_t<T>>
+    static void setParameters(ParameterHandle handle,
+            MaterialInstance* const* instances, const T* values, size_t count);
+
     /**
      * Set-up a custom scissor rectangle; by default it is disabled.
      *
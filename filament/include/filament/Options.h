@@ -93,6 +93,42 @@ struct DynamicResolutionOptions {
     QualityLevel quality = QualityLevel::LOW;
 };
 
+/**
+ * Options to control the quality governor, which lowers the quality of individual effects to
+ * keep the GPU frame time within a budget, and raises it back when there is headroom. This is
+ * often a better trade-off than lowering the resolution of the whole frame, and can be used
+ * together with dynamic resolution.
+ *
+ * Each effect has a priority, effects with a lower priority are degraded first, one step at a
+ * time, and restored last. A priority of 0 means the effect is left alone. The steps are:
+ *
+ * ambientOcclusion:        half resolution, then the fewest samples
+ * shadows:                 shadow maps of half size, then quarter size
+ * depthOfField:            half resolution and one ring less, then two rings less
+ * screenSpaceReflections:  disabled
+ * bloom:                   bloom buffer of half resolution, then quarter resolution
+ *
+ * The governor needs GPU frame times, it does nothing on platforms that don't report them.
+ *
+ * @see Renderer::FrameRateOptions
+ */
+struct QualityGovernorOptions {
+    /**
+     * Frame time budget in milliseconds. 0 means the target frame time set with
+     * Renderer::setFrameRateOptions() including its headroom, which is what dynamic resolution
+     * uses.
+     */
+    float frameBudget = 0.0f;
+    float hysteresis = 0.1f;                    //!< quality is raised only below frameBudget * (1 - hysteresis), between 0 and 0.5
+    uint8_t frameCount = 15;                    //!< number of frames averaged before each change, at least 1
+    uint8_t ambientOcclusionPriority = 3;       //!< priority of ambient occlusion, 0 to disable
+    uint8_t shadowsPriority = 4;                //!< priority of shadows, 0 to disable
+    uint8_t depthOfFieldPriority = 2;           //!< priority of depth of field, 0 to disable
+    uint8_t screenSpaceReflectionsPriority = 1; //!< priority of screen-space reflections, 0 to disable
+    uint8_t bloomPriority = 1;                  //!< priority of bloom, 0 to disable
+    bool enabled = false;                       //!< enable or disable the quality governor
+};
+
 /**
  * Options to control the bloom effect
  *
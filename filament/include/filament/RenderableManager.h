@@ -444,6 +444,28 @@ public:
          */
         Result build(Engine& engine, utils::Entity entity);
 
+        /**
+         * Adds the same Renderable component to several entities.
+         *
+         * This is equivalent to calling build(Engine&, utils::Entity) for each entity, but it is
+         * much faster when creating many renderables: the builder is validated once, the
+         * renderables' storage is allocated at once and their render primitives are shared.
+         * The renderables can still be modified and destroyed individually.
+         *
+         * The storage of these renderables, i.e. their primitives and morph targets, is a single
+         * allocation that is only freed once the last of them is destroyed. Destroying some of
+         * them, or building another Renderable component on some of their entities, doesn't
+         * free any memory. Only build renderables together if they have the same lifetime.
+         *
+         * @param engine Reference to the filament::Engine to associate the Renderables with.
+         * @param entities Array of entities to add the Renderable component to.
+         * @param count Number of entities in the array.
+         * @return Success if the components were created successfully, Error otherwise.
+         *
+         * @see build(Engine&, utils::Entity)
+         */
+        Result build(Engine& engine, utils::Entity const* entities, size_t count);
+
     private:
         friend class FEngine;
         friend class FRenderPrimitive;
@@ -472,6 +494,17 @@ public:
      */
     void destroy(utils::Entity e) noexcept;
 
+    /**
+     * Destroys the renderable components in the given entities.
+     *
+     * Render primitives shared by these renderables, e.g. because they were created by a single
+     * Builder::build() call, are released once for the whole array.
+     *
+     * @param entities Array of entities to remove the Renderable component from.
+     * @param count Number of entities in the array.
+     */
+    void destroy(utils::Entity const* entities, size_t count) noexcept;
+
     /**
      * Changes the bounding box used for frustum culling.
      *
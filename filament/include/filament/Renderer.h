@@ -573,6 +573,26 @@ public:
      * getUserTime()
      */
     void resetUserTime();
+
+    /**
+     * Returns the GPU time of a recent frame, in milliseconds.
+     *
+     * GPU timings are collected asynchronously, so the returned value is a few frames old,
+     * and it stays the same until the timing of another frame is known.
+     * It is 0 if the backend doesn't support timer queries or if no timing is known yet.
+     *
+     * @return The GPU time of the most recent frame whose timing is known, in milliseconds.
+     * @see getFrameGpuTimeCount()
+     */
+    float getLastFrameGpuTime() const noexcept;
+
+    /**
+     * Returns the number of frames whose GPU time has been collected so far. When this changes,
+     * getLastFrameGpuTime() returns the timing of a new frame.
+     *
+     * @return The number of GPU frame timings collected by this Renderer.
+     */
+    uint32_t getFrameGpuTimeCount() const noexcept;
 };
 
 } // namespace filament
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_STATICBATCH_H
+#define TNT_FILAMENT_STATICBATCH_H
+
+#include <filament/FilamentAPI.h>
+
+#include <utils/compiler.h>
+#include <utils/Entity.h>
+
+#include <math/mat4.h>
+#include <math/vec2.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+class Engine;
+class MaterialInstance;
+
+/**
+ * StaticBatch merges many small static meshes into a few renderables.
+ *
+ * The vertices and indices of all the meshes are copied into a single vertex buffer and a single
+ * index buffer, with the transform of each mesh baked in. Meshes sharing a material instance are
+ * then grouped into spatially coherent chunks, each chunk is a renderable that draws a contiguous
+ * range of the index buffer, i.e. a single draw call. Each chunk has its own bounding box so it
+ * can still be culled.
+ *
+ * The renderables of a StaticBatch can't be moved individually and their transform should be
+ * left to identity. They must be added to a Scene like any other renderable:
+ *
+ * ~~~~~~~~~~~{.cpp}
+ * StaticBatch::Builder builder;
+ * for (auto const& mesh : meshes) {
+ *     builder.mesh({
+ *             .materialInstance = mesh.materialInstance,
+ *             .transform = mesh.transform,
+ *             .positions = mesh.positions.data(),
+ *             .vertexCount = mesh.positions.size(),
+ *             .indices = mesh.indices.data(),
+ *             .indexCount = mesh.indices.size() });
+ * }
+ * StaticBatch* batch = builder.build(*engine);
+ * scene->addEntities(batch->getEntities(), batch->getEntityCount());
+ * ~~~~~~~~~~~
+ *
+ * Destroying the StaticBatch destroys its renderables and its buffers, the material instances
+ * are owned by the caller.
+ */
+class UTILS_PUBLIC StaticBatch : public FilamentAPI {
+    struct BuilderDetails;
+
+public:
+    /**
+     * A mesh to add to a batch.
+     */
+    struct Mesh {
+        //! Material instance of the mesh; meshes sharing a material instance can be merged.
+        MaterialInstance const* materialInstance = nullptr;
+
+        //! Transform from the mesh's space to world space. It can be a reflection (negative
+        //! determinant), the winding of the triangles is then reversed when they're baked.
+        math::mat4f transform;
+
+        //! Vertex positions, vertexCount elements.
+        math::float3 const* positions = nullptr;
+
+        //! Optional tangent frames as quaternions, vertexCount elements.
+        //! @see geometry::SurfaceOrientation
+        math::short4 const* tangents = nullptr;
+
+        //! Optional texture coordinates, vertexCount elements.
+        math::float2 const* uv0 = nullptr;
+
+        //! Number of vertices of the mesh.
+        size_t vertexCount = 0;
+
+        //! Triangle list, indexCount elements.
+        uint32_t const* indices = nullptr;
+
+        //! Number of indices of the mesh, must be a multiple of 3.
+        size_t indexCount = 0;
+    };
+
+    class Builder : public BuilderBase<BuilderDetails> {
+        friend struct BuilderDetails;
+    public:
+        Builder() noexcept;
+        Builder(Builder const& rhs) noexcept;
+        Builder(Builder&& rhs) noexcept;
+        ~Builder() noexcept;
+        Builder& operator=(Builder const& rhs) noexcept;
+        Builder& operator=(Builder&& rhs) noexcept;
+
+        /**
+         * Adds a mesh to the batch.
+         *
+         * The mesh's data is not copied, it must stay valid until build() returns.
+         * All meshes of a batch must provide the same vertex attributes.
+         *
+         * @param mesh The mesh to add.
+         * @return A reference to this Builder for chaining calls.
+         */
+        Builder& mesh(Mesh const& mesh) noexcept;
+
+        /**
+         * Maximum number of triangles of a chunk, 8192 by default. Smaller chunks are culled
+         * more precisely but need more draw calls. A mesh is never split, so a single mesh
+         * larger than this makes a chunk of its own.
+         *
+         * @param count Maximum number of triangles per chunk.
+         * @return A reference to this Builder for chaining calls.
+         */
+        Builder& maxChunkTriangleCount(uint32_t count) noexcept;
+
+        /**
+         * Controls if the renderables of the batch cast shadows, false by default.
+         *
+         * @see RenderableManager::Builder::castShadows()
+         */
+        Builder& castShadows(bool enable) noexcept;
+
+        /**
+         * Controls if the renderables of the batch receive shadows, true by default.
+         *
+         * @see RenderableManager::Builder::receiveShadows()
+         */
+        Builder& receiveShadows(bool enable) noexcept;
+
+        /**
+         * Creates the StaticBatch object, its buffers and its renderables.
+         *
+         * @param engine Reference to the filament::Engine to associate this StaticBatch with.
+         *
+         * @return pointer to the newly created object or nullptr if exceptions are disabled and
+         *         an error occurred.
+         *
+         * @exception utils::PostConditionPanic if a runtime error occurred, such as running out of
+         *            memory or other resources.
+         * @exception utils::PreConditionPanic if a parameter to a builder function was invalid.
+         */
+        StaticBatch* build(Engine& engine);
+
+    private:
+        friend class FStaticBatch;
+    };
+
+    /**
+     * Returns the number of renderables (chunks) of this batch.
+     */
+    size_t getEntityCount() const noexcept;
+
+    /**
+     * Returns the renderables (chunks) of this batch, getEntityCount() elements.
+     */
+    utils::Entity const* getEntities() const noexcept;
+
+    /**
+     * Returns the number of meshes merged in this batch.
+     */
+    size_t getMeshCount() const noexcept;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_STATICBATCH_H
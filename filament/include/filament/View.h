@@ -73,6 +73,7 @@ public:
     using ShadowType = ShadowType;
 
     using DynamicResolutionOptions = DynamicResolutionOptions;
+    using QualityGovernorOptions = QualityGovernorOptions;
     using BloomOptions = BloomOptions;
     using FogOptions = FogOptions;
     using DepthOfFieldOptions = DepthOfFieldOptions;
@@ -507,6 +508,22 @@ public:
      */
     DynamicResolutionOptions getDynamicResolutionOptions() const noexcept;
 
+    /**
+     * Sets the quality governor options for this view. The quality governor lowers the
+     * quality of individual effects, such as ambient occlusion or shadows, to keep the frame
+     * time within a budget.
+     *
+     * @param options The quality governor options to use on this view
+     * @see QualityGovernorOptions
+     */
+    void setQualityGovernorOptions(QualityGovernorOptions const& options) noexcept;
+
+    /**
+     * Returns the quality governor options associated with this view.
+     * @return value set by setQualityGovernorOptions().
+     */
+    QualityGovernorOptions getQualityGovernorOptions() const noexcept;
+
     /**
      * Sets the rendering quality for this view. Refer to RenderQuality for more
      * information about the different settings available.
@@ -18,8 +18,25 @@
 
 #include <filament/Box.h>
 
+#include <utils/debug.h>
+
 #include <math/fast.h>
 
+#if defined(__x86_64__) && (defined(__clang__) || defined(__GNUC__))
+#   define FILAMENT_CULLER_HAS_AVX 1
+#   include <immintrin.h>
+#   define FILAMENT_CULLER_TARGET(isa) __attribute__((target(isa)))
+#else
+#   define FILAMENT_CULLER_HAS_AVX 0
+#endif
+
+#if defined(__ARM_NEON)
+#   define FILAMENT_CULLER_HAS_NEON 1
+#   include <arm_neon.h>
+#else
+#   define FILAMENT_CULLER_HAS_NEON 0
+#endif
+
 using namespace filament::math;
 
 // use 8 if Culler::result_type is 8-bits, on ARMv8 it allows the compiler to write eight
@@ -31,15 +48,20 @@ namespace filament {
 static_assert(Culler::MODULO % FILAMENT_CULLER_VECTORIZE_HINT == 0,
         "MODULO m=must be a multiple of FILAMENT_CULLER_VECTORIZE_HINT");
 
-void Culler::intersects(
+using result_type = Culler::result_type;
+
+// ------------------------------------------------------------------------------------------------
+// Generic implementation
+// ------------------------------------------------------------------------------------------------
+
+static void intersectsGeneric(
         result_type* UTILS_RESTRICT results,
         Frustum const& UTILS_RESTRICT frustum,
         float4 const* UTILS_RESTRICT b,
         size_t count) noexcept {
 
-    float4 const * const UTILS_RESTRICT planes = frustum.mPlanes;
+    float4 const * const UTILS_RESTRICT planes = frustum.getNormalizedPlanes();
 
-    count = round(count);
     #pragma clang loop vectorize_width(FILAMENT_CULLER_VECTORIZE_HINT)
     for (size_t i = 0; i < count; i++) {
         int visible = ~0;
@@ -59,16 +81,15 @@ void Culler::intersects(
     }
 }
 
-void Culler::intersects(
+static void intersectsGeneric(
         result_type* UTILS_RESTRICT results,
         Frustum const& UTILS_RESTRICT frustum,
         float3 const* UTILS_RESTRICT center,
         float3 const* UTILS_RESTRICT extent,
         size_t count, size_t bit) noexcept {
 
-    float4 const * UTILS_RESTRICT const planes = frustum.mPlanes;
+    float4 const * UTILS_RESTRICT const planes = frustum.getNormalizedPlanes();
 
-    count = round(count);
     #pragma clang loop vectorize_width(FILAMENT_CULLER_VECTORIZE_HINT)
     for (size_t i = 0; i < count; i++) {
         int visible = ~0;
@@ -93,6 +114,400 @@ void Culler::intersects(
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// SIMD implementations
+//
+// These evaluate the plane equations in the same order as the generic code and don't use fused
+// multiply-adds, so they produce the same results (unless the compiler contracted the generic
+// code). Instead of comparing each dot product against zero, the sign bits are and'ed together,
+// which is what fast::signbit() does.
+// The few items that don't fill a whole vector are handled by the generic code.
+// ------------------------------------------------------------------------------------------------
+
+#if FILAMENT_CULLER_HAS_AVX
+
+// Each 128-bit lane of the AVX registers below processes 4 consecutive items, lane L of
+// register R holding item 4*L + R (spheres) or the R'th quarter of items [4*L, 4*L + 4) (boxes).
+// This lets us transpose the data with in-lane shuffles only.
+
+// [ x0 y0 z0 x1 ] [ y1 z1 x2 y2 ] [ z2 x3 y3 z3 ]  ->  [ x0 x1 x2 x3 ] [ y0 .. ] [ z0 .. ]
+#define FILAMENT_CULLER_DEINTERLEAVE3(PS, r0, r1, r2, x, y, z)                     \
+    {                                                                           \
+        auto const xy = _##PS##_shuffle_ps(r1, r2, _MM_SHUFFLE(2, 1, 3, 2));    \
+        auto const yz = _##PS##_shuffle_ps(r0, r1, _MM_SHUFFLE(1, 0, 2, 1));    \
+        x = _##PS##_shuffle_ps(r0, xy, _MM_SHUFFLE(2, 0, 3, 0));                \
+        y = _##PS##_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));                \
+        z = _##PS##_shuffle_ps(yz, r2, _MM_SHUFFLE(3, 0, 3, 1));                \
+    }
+
+// 4x4 transpose of each lane
+#define FILAMENT_CULLER_TRANSPOSE4(PS, r0, r1, r2, r3, x, y, z, w)                 \
+    {                                                                           \
+        auto const t0 = _##PS##_unpacklo_ps(r0, r1);                            \
+        auto const t1 = _##PS##_unpacklo_ps(r2, r3);                            \
+        auto const t2 = _##PS##_unpackhi_ps(r0, r1);                            \
+        auto const t3 = _##PS##_unpackhi_ps(r2, r3);                            \
+        x = _##PS##_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));                \
+        y = _##PS##_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));                \
+        z = _##PS##_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));                \
+        w = _##PS##_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));                \
+    }
+
+// loads two 128-bit lanes, `stride` floats apart
+FILAMENT_CULLER_TARGET("avx2") UTILS_ALWAYS_INLINE
+static inline __m256 loadLanesAvx2(float const* p, size_t stride) noexcept {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)),
+            _mm_loadu_ps(p + stride), 1);
+}
+
+FILAMENT_CULLER_TARGET("avx2")
+static void intersectsAvx2(
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float4 const* UTILS_RESTRICT b,
+        size_t count) noexcept {
+
+    float4 const * const UTILS_RESTRICT planes = frustum.getNormalizedPlanes();
+
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        float const* const p = &b[i].x;
+        __m256 const r0 = loadLanesAvx2(p +  0, 16);
+        __m256 const r1 = loadLanesAvx2(p +  4, 16);
+        __m256 const r2 = loadLanesAvx2(p +  8, 16);
+        __m256 const r3 = loadLanesAvx2(p + 12, 16);
+        __m256 sx, sy, sz, sw;
+        FILAMENT_CULLER_TRANSPOSE4(mm256, r0, r1, r2, r3, sx, sy, sz, sw)
+
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (size_t j = 0; j < 6; j++) {
+            __m256 dot = _mm256_mul_ps(_mm256_set1_ps(planes[j].x), sx);
+            dot = _mm256_add_ps(dot, _mm256_mul_ps(_mm256_set1_ps(planes[j].y), sy));
+            dot = _mm256_add_ps(dot, _mm256_mul_ps(_mm256_set1_ps(planes[j].z), sz));
+            dot = _mm256_add_ps(dot, _mm256_set1_ps(planes[j].w));
+            dot = _mm256_sub_ps(dot, sw);
+            visible = _mm256_and_ps(visible, dot);
+        }
+
+        // sign bit -> 0 or 1, narrowed to 16 bits
+        __m256i const v = _mm256_srli_epi32(_mm256_castps_si256(visible), 31);
+        _mm_storeu_si128((__m128i*)(results + i), _mm_packs_epi32(
+                _mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+    }
+    intersectsGeneric(results + n, frustum, b + n, count - n);
+}
+
+FILAMENT_CULLER_TARGET("avx2")
+static void intersectsAvx2(
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t count, size_t bit) noexcept {
+
+    float4 const * UTILS_RESTRICT const planes = frustum.getNormalizedPlanes();
+    __m256 const signMask = _mm256_set1_ps(-0.0f);
+    __m128i const bitMask = _mm_set1_epi16(int16_t(1u << bit));
+
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        float const* const c = &center[i].x;
+        float const* const e = &extent[i].x;
+        __m256 cx, cy, cz, ex, ey, ez;
+        __m256 const c0 = loadLanesAvx2(c + 0, 12);
+        __m256 const c1 = loadLanesAvx2(c + 4, 12);
+        __m256 const c2 = loadLanesAvx2(c + 8, 12);
+        __m256 const e0 = loadLanesAvx2(e + 0, 12);
+        __m256 const e1 = loadLanesAvx2(e + 4, 12);
+        __m256 const e2 = loadLanesAvx2(e + 8, 12);
+        FILAMENT_CULLER_DEINTERLEAVE3(mm256, c0, c1, c2, cx, cy, cz)
+        FILAMENT_CULLER_DEINTERLEAVE3(mm256, e0, e1, e2, ex, ey, ez)
+
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (size_t j = 0; j < 6; j++) {
+            __m256 const px = _mm256_set1_ps(planes[j].x);
+            __m256 const py = _mm256_set1_ps(planes[j].y);
+            __m256 const pz = _mm256_set1_ps(planes[j].z);
+            __m256 dot = _mm256_mul_ps(px, cx);
+            dot = _mm256_sub_ps(dot, _mm256_mul_ps(_mm256_andnot_ps(signMask, px), ex));
+            dot = _mm256_add_ps(dot, _mm256_mul_ps(py, cy));
+            dot = _mm256_sub_ps(dot, _mm256_mul_ps(_mm256_andnot_ps(signMask, py), ey));
+            dot = _mm256_add_ps(dot, _mm256_mul_ps(pz, cz));
+            dot = _mm256_sub_ps(dot, _mm256_mul_ps(_mm256_andnot_ps(signMask, pz), ez));
+            dot = _mm256_add_ps(dot, _mm256_set1_ps(planes[j].w));
+            visible = _mm256_and_ps(visible, dot);
+        }
+
+        // sign bit -> 0 or 0xFFFF, narrowed to 16 bits
+        __m256i const v = _mm256_srai_epi32(_mm256_castps_si256(visible), 31);
+        __m128i const bits = _mm_and_si128(bitMask, _mm_packs_epi32(
+                _mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+        __m128i const r = _mm_loadu_si128((__m128i const*)(results + i));
+        _mm_storeu_si128((__m128i*)(results + i), _mm_or_si128(_mm_andnot_si128(bitMask, r), bits));
+    }
+    intersectsGeneric(results + n, frustum, center + n, extent + n, count - n, bit);
+}
+
+// loads four 128-bit lanes, `stride` floats apart
+FILAMENT_CULLER_TARGET("avx2,avx512f") UTILS_ALWAYS_INLINE
+static inline __m512 loadLanesAvx512(float const* p, size_t stride) noexcept {
+    __m512 r = _mm512_castps128_ps512(_mm_loadu_ps(p));
+    r = _mm512_insertf32x4(r, _mm_loadu_ps(p + stride * 1), 1);
+    r = _mm512_insertf32x4(r, _mm_loadu_ps(p + stride * 2), 2);
+    r = _mm512_insertf32x4(r, _mm_loadu_ps(p + stride * 3), 3);
+    return r;
+}
+
+FILAMENT_CULLER_TARGET("avx2,avx512f")
+static void intersectsAvx512(
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float4 const* UTILS_RESTRICT b,
+        size_t count) noexcept {
+
+    float4 const * const UTILS_RESTRICT planes = frustum.getNormalizedPlanes();
+
+    size_t const n = count & ~size_t(15);
+    for (size_t i = 0; i < n; i += 16) {
+        float const* const p = &b[i].x;
+        __m512 const r0 = loadLanesAvx512(p +  0, 16);
+        __m512 const r1 = loadLanesAvx512(p +  4, 16);
+        __m512 const r2 = loadLanesAvx512(p +  8, 16);
+        __m512 const r3 = loadLanesAvx512(p + 12, 16);
+        __m512 sx, sy, sz, sw;
+        FILAMENT_CULLER_TRANSPOSE4(mm512, r0, r1, r2, r3, sx, sy, sz, sw)
+
+        __m512i visible = _mm512_set1_epi32(-1);
+        for (size_t j = 0; j < 6; j++) {
+            __m512 dot = _mm512_mul_ps(_mm512_set1_ps(planes[j].x), sx);
+            dot = _mm512_add_ps(dot, _mm512_mul_ps(_mm512_set1_ps(planes[j].y), sy));
+            dot = _mm512_add_ps(dot, _mm512_mul_ps(_mm512_set1_ps(planes[j].z), sz));
+            dot = _mm512_add_ps(dot, _mm512_set1_ps(planes[j].w));
+            dot = _mm512_sub_ps(dot, sw);
+            visible = _mm512_and_si512(visible, _mm512_castps_si512(dot));
+        }
+
+        // sign bit -> 0 or 1, narrowed to 16 bits
+        _mm256_storeu_si256((__m256i*)(results + i),
+                _mm512_cvtepi32_epi16(_mm512_srli_epi32(visible, 31)));
+    }
+    intersectsGeneric(results + n, frustum, b + n, count - n);
+}
+
+FILAMENT_CULLER_TARGET("avx2,avx512f")
+static void intersectsAvx512(
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t count, size_t bit) noexcept {
+
+    float4 const * UTILS_RESTRICT const planes = frustum.getNormalizedPlanes();
+    __m256i const bitMask = _mm256_set1_epi16(int16_t(1u << bit));
+
+    size_t const n = count & ~size_t(15);
+    for (size_t i = 0; i < n; i += 16) {
+        float const* const c = &center[i].x;
+        float const* const e = &extent[i].x;
+        __m512 cx, cy, cz, ex, ey, ez;
+        __m512 const c0 = loadLanesAvx512(c + 0, 12);
+        __m512 const c1 = loadLanesAvx512(c + 4, 12);
+        __m512 const c2 = loadLanesAvx512(c + 8, 12);
+        __m512 const e0 = loadLanesAvx512(e + 0, 12);
+        __m512 const e1 = loadLanesAvx512(e + 4, 12);
+        __m512 const e2 = loadLanesAvx512(e + 8, 12);
+        FILAMENT_CULLER_DEINTERLEAVE3(mm512, c0, c1, c2, cx, cy, cz)
+        FILAMENT_CULLER_DEINTERLEAVE3(mm512, e0, e1, e2, ex, ey, ez)
+
+        __m512i visible = _mm512_set1_epi32(-1);
+        for (size_t j = 0; j < 6; j++) {
+            __m512 const px = _mm512_set1_ps(planes[j].x);
+            __m512 const py = _mm512_set1_ps(planes[j].y);
+            __m512 const pz = _mm512_set1_ps(planes[j].z);
+            __m512 dot = _mm512_mul_ps(px, cx);
+            dot = _mm512_sub_ps(dot, _mm512_mul_ps(_mm512_abs_ps(px), ex));
+            dot = _mm512_add_ps(dot, _mm512_mul_ps(py, cy));
+            dot = _mm512_sub_ps(dot, _mm512_mul_ps(_mm512_abs_ps(py), ey));
+            dot = _mm512_add_ps(dot, _mm512_mul_ps(pz, cz));
+            dot = _mm512_sub_ps(dot, _mm512_mul_ps(_mm512_abs_ps(pz), ez));
+            dot = _mm512_add_ps(dot, _mm512_set1_ps(planes[j].w));
+            visible = _mm512_and_si512(visible, _mm512_castps_si512(dot));
+        }
+
+        // sign bit -> 0 or 0xFFFF, narrowed to 16 bits
+        __m256i const bits = _mm256_and_si256(bitMask,
+                _mm512_cvtepi32_epi16(_mm512_srai_epi32(visible, 31)));
+        __m256i const r = _mm256_loadu_si256((__m256i const*)(results + i));
+        _mm256_storeu_si256((__m256i*)(results + i),
+                _mm256_or_si256(_mm256_andnot_si256(bitMask, r), bits));
+    }
+    intersectsGeneric(results + n, frustum, center + n, extent + n, count - n, bit);
+}
+
+#undef FILAMENT_CULLER_DEINTERLEAVE3
+#undef FILAMENT_CULLER_TRANSPOSE4
+
+#endif // FILAMENT_CULLER_HAS_AVX
+
+#if FILAMENT_CULLER_HAS_NEON
+
+static void intersectsNeon(
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float4 const* UTILS_RESTRICT b,
+        size_t count) noexcept {
+
+    float4 const * const UTILS_RESTRICT planes = frustum.getNormalizedPlanes();
+
+    size_t const n = count & ~size_t(3);
+    for (size_t i = 0; i < n; i += 4) {
+        float32x4x4_t const s = vld4q_f32(&b[i].x);
+
+        uint32x4_t visible = vdupq_n_u32(~0u);
+        for (size_t j = 0; j < 6; j++) {
+            float32x4_t dot = vmulq_n_f32(s.val[0], planes[j].x);
+            dot = vaddq_f32(dot, vmulq_n_f32(s.val[1], planes[j].y));
+            dot = vaddq_f32(dot, vmulq_n_f32(s.val[2], planes[j].z));
+            dot = vaddq_f32(dot, vdupq_n_f32(planes[j].w));
+            dot = vsubq_f32(dot, s.val[3]);
+            visible = vandq_u32(visible, vreinterpretq_u32_f32(dot));
+        }
+
+        // sign bit -> 0 or 1, narrowed to 16 bits
+        vst1_u16(results + i, vmovn_u32(vshrq_n_u32(visible, 31)));
+    }
+    intersectsGeneric(results + n, frustum, b + n, count - n);
+}
+
+static void intersectsNeon(
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t count, size_t bit) noexcept {
+
+    float4 const * UTILS_RESTRICT const planes = frustum.getNormalizedPlanes();
+    uint16x4_t const bitMask = vdup_n_u16(uint16_t(1u << bit));
+    int16x4_t const shift = vdup_n_s16(int16_t(bit));
+
+    size_t const n = count & ~size_t(3);
+    for (size_t i = 0; i < n; i += 4) {
+        float32x4x3_t const c = vld3q_f32(&center[i].x);
+        float32x4x3_t const e = vld3q_f32(&extent[i].x);
+
+        uint32x4_t visible = vdupq_n_u32(~0u);
+        for (size_t j = 0; j < 6; j++) {
+            float32x4_t dot = vmulq_n_f32(c.val[0], planes[j].x);
+            dot = vsubq_f32(dot, vmulq_n_f32(e.val[0], std::abs(planes[j].x)));
+            dot = vaddq_f32(dot, vmulq_n_f32(c.val[1], planes[j].y));
+            dot = vsubq_f32(dot, vmulq_n_f32(e.val[1], std::abs(planes[j].y)));
+            dot = vaddq_f32(dot, vmulq_n_f32(c.val[2], planes[j].z));
+            dot = vsubq_f32(dot, vmulq_n_f32(e.val[2], std::abs(planes[j].z)));
+            dot = vaddq_f32(dot, vdupq_n_f32(planes[j].w));
+            visible = vandq_u32(visible, vreinterpretq_u32_f32(dot));
+        }
+
+        // sign bit -> 0 or 1, narrowed to 16 bits and moved to `bit`
+        uint16x4_t const bits = vshl_u16(vmovn_u32(vshrq_n_u32(visible, 31)), shift);
+        uint16x4_t const r = vld1_u16(results + i);
+        vst1_u16(results + i, vorr_u16(vbic_u16(r, bitMask), bits));
+    }
+    intersectsGeneric(results + n, frustum, center + n, extent + n, count - n, bit);
+}
+
+#endif // FILAMENT_CULLER_HAS_NEON
+
+// ------------------------------------------------------------------------------------------------
+// Runtime dispatch
+// ------------------------------------------------------------------------------------------------
+
+namespace {
+
+struct CullerKernels {
+    void (*spheres)(result_type*, Frustum const&, float4 const*, size_t) noexcept;
+    void (*boxes)(result_type*, Frustum const&, float3 const*, float3 const*,
+            size_t, size_t) noexcept;
+};
+
+bool isIsaSupported(Culler::Isa isa) noexcept {
+    switch (isa) {
+        case Culler::Isa::GENERIC:
+            return true;
+        case Culler::Isa::NEON:
+            return FILAMENT_CULLER_HAS_NEON;
+        case Culler::Isa::AVX2:
+#if FILAMENT_CULLER_HAS_AVX
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+        case Culler::Isa::AVX512:
+#if FILAMENT_CULLER_HAS_AVX
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("avx512f");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+CullerKernels getKernels(Culler::Isa isa) noexcept {
+    switch (isa) {
+#if FILAMENT_CULLER_HAS_AVX
+        case Culler::Isa::AVX2:
+            return { intersectsAvx2, intersectsAvx2 };
+        case Culler::Isa::AVX512:
+            return { intersectsAvx512, intersectsAvx512 };
+#endif
+#if FILAMENT_CULLER_HAS_NEON
+        case Culler::Isa::NEON:
+            return { intersectsNeon, intersectsNeon };
+#endif
+        default:
+            return { intersectsGeneric, intersectsGeneric };
+    }
+}
+
+Culler::Isa selectIsa() noexcept {
+    for (Culler::Isa isa : { Culler::Isa::AVX512, Culler::Isa::AVX2, Culler::Isa::NEON }) {
+        if (isIsaSupported(isa)) {
+            return isa;
+        }
+    }
+    return Culler::Isa::GENERIC;
+}
+
+CullerKernels const& getKernels() noexcept {
+    static const CullerKernels kernels = getKernels(Culler::getIsa());
+    return kernels;
+}
+
+} // anonymous namespace
+
+Culler::Isa Culler::getIsa() noexcept {
+    static const Isa isa = selectIsa();
+    return isa;
+}
+
+void Culler::intersects(
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float4 const* UTILS_RESTRICT b,
+        size_t count) noexcept {
+    getKernels().spheres(results, frustum, b, round(count));
+}
+
+void Culler::intersects(
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t count, size_t bit) noexcept {
+    getKernels().boxes(results, frustum, center, extent, round(count), bit);
+}
+
 /*
  * returns whether a box intersects with the frustum
  */
@@ -138,4 +553,36 @@ void Culler::Test::intersects(
     Culler::intersects(results, frustum, b, count);
 }
 
+void Culler::Test::intersects(Isa isa,
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float3 const* UTILS_RESTRICT c,
+        float3 const* UTILS_RESTRICT e,
+        size_t count) noexcept {
+    assert_invariant(isSupported(isa));
+    getKernels(isa).boxes(results, frustum, c, e, round(count), 0);
+}
+
+void Culler::Test::intersects(Isa isa,
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float4 const* UTILS_RESTRICT b, size_t count) noexcept {
+    assert_invariant(isSupported(isa));
+    getKernels(isa).spheres(results, frustum, b, round(count));
+}
+
+bool Culler::Test::isSupported(Isa isa) noexcept {
+    return isIsaSupported(isa);
+}
+
+const char* Culler::Test::getName(Isa isa) noexcept {
+    switch (isa) {
+        case Isa::GENERIC:  return "generic";
+        case Isa::NEON:     return "neon";
+        case Isa::AVX2:     return "avx2";
+        case Isa::AVX512:   return "avx512";
+    }
+    return "unknown";
+}
+
 } // namespace filament
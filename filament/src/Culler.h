@@ -25,6 +25,8 @@
 #include <math/vec4.h>
 #include <math/vec2.h>
 
+#include <stdint.h>
+
 namespace filament {
 
 /*
@@ -32,6 +34,8 @@ namespace filament {
  *
  * The implementation assumes 'count' below is multiple of MODULO
  *
+ * The batch versions of intersects() use explicit SIMD code when available. The instruction
+ * set is chosen at runtime, the first time culling is performed (see getIsa()).
  */
 
 class Culler {
@@ -44,6 +48,19 @@ public:
 
     using result_type = uint16_t;
 
+    // Instruction sets the batch culling routines are implemented with
+    enum class Isa : uint8_t {
+        GENERIC,    // portable C++, vectorized by the compiler
+        NEON,       // 4-wide, ARM NEON
+        AVX2,       // 8-wide, x86-64 AVX2
+        AVX512,     // 16-wide, x86-64 AVX-512F
+    };
+
+    /*
+     * returns the instruction set used by the batch culling routines on this CPU
+     */
+    static Isa getIsa() noexcept;
+
     /*
      * returns whether each AABB in an array intersects with the frustum
      */
@@ -88,6 +105,23 @@ public:
                 Frustum const& frustum,
                 math::float4 const* b,
                 size_t count) noexcept;
+
+        // same as above, but forces the given instruction set, which must be supported
+        static void intersects(Isa isa, result_type* results,
+                Frustum const& frustum,
+                math::float3 const* c,
+                math::float3 const* e,
+                size_t count) noexcept;
+
+        static void intersects(Isa isa, result_type* results,
+                Frustum const& frustum,
+                math::float4 const* b,
+                size_t count) noexcept;
+
+        // whether the given instruction set can be used on this CPU
+        static bool isSupported(Isa isa) noexcept;
+
+        static const char* getName(Isa isa) noexcept;
     };
 };
 
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DirtyRangeSet.h"
+
+#include <backend/BufferDescriptor.h>
+
+#include <utils/debug.h>
+
+#include <algorithm>
+#include <utility>
+
+#include <string.h>
+
+namespace filament {
+
+using namespace backend;
+
+UTILS_NOINLINE
+void DirtyRangeSet::addSlow(uint32_t begin, uint32_t end) noexcept {
+    assert_invariant(begin <= end);
+
+    // rebuild the sorted list, absorbing all the ranges that touch the new one
+    Range ranges[CAPACITY + 1];
+    size_t count = 0;
+    Range merged{ begin, end };
+    bool inserted = false;
+    for (size_t i = 0, c = mCount; i < c; i++) {
+        Range const& r = mRanges[i];
+        if (r.end + MERGE_DISTANCE < merged.begin) {
+            ranges[count++] = r;
+        } else if (merged.end + MERGE_DISTANCE < r.begin) {
+            if (!inserted) {
+                ranges[count++] = merged;
+                inserted = true;
+            }
+            ranges[count++] = r;
+        } else {
+            merged.begin = std::min(merged.begin, r.begin);
+            merged.end = std::max(merged.end, r.end);
+        }
+    }
+    if (!inserted) {
+        ranges[count++] = merged;
+    }
+
+    if (UTILS_UNLIKELY(count > CAPACITY)) {
+        // too many ranges, merge the two closest ones
+        size_t closest = 0;
+        for (size_t i = 1; i < count - 1; i++) {
+            if (ranges[i + 1].begin - ranges[i].end <
+                ranges[closest + 1].begin - ranges[closest].end) {
+                closest = i;
+            }
+        }
+        ranges[closest].end = ranges[closest + 1].end;
+        std::move(ranges + closest + 2, ranges + count, ranges + closest + 1);
+        count--;
+    }
+
+    std::copy(ranges, ranges + count, mRanges);
+    mCount = uint8_t(count);
+}
+
+size_t DirtyRangeSet::getByteCount() const noexcept {
+    size_t size = 0;
+    for (Range const& r : *this) {
+        size += r.end - r.begin;
+    }
+    return size;
+}
+
+size_t DirtyRangeSet::upload(DriverApi& driver, Handle<HwBufferObject> handle,
+        void const* data, size_t size, bool partial, uint32_t offset) const noexcept {
+    auto update = [&driver, handle, data, offset](uint32_t begin, size_t byteSize) {
+        BufferDescriptor p;
+        p.size = byteSize;
+        p.buffer = driver.allocate(p.size); // TODO: use out-of-line buffer if too large
+        memcpy(p.buffer, static_cast<char const*>(data) + begin, p.size); // inlined
+        driver.updateBufferObject(handle, std::move(p), offset + begin);
+    };
+
+    // A single update of the whole buffer is cheaper than several partial ones when most of it
+    // is dirty; it also lets the backend orphan the buffer instead of updating it in place.
+    size_t const byteCount = getByteCount();
+    if (!partial || byteCount * 2 > size) {
+        update(0, size);
+        return size;
+    }
+    for (Range const& r : *this) {
+        update(r.begin, r.end - r.begin);
+    }
+    return byteCount;
+}
+
+} // namespace filament
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_DIRTYRANGESET_H
+#define TNT_FILAMENT_DIRTYRANGESET_H
+
+#include "private/backend/DriverApi.h"
+
+#include <backend/Handle.h>
+
+#include <utils/compiler.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * A small set of sorted, disjoint byte ranges of a buffer that need to be uploaded.
+ *
+ * Ranges closer than MERGE_DISTANCE bytes are merged, and when more than CAPACITY ranges are
+ * needed, the two closest ones are merged. This bounds the number of updateBufferObject()
+ * commands issued per upload.
+ *
+ * Only the per-view and shadow UBOs, and the MaterialInstance uniforms too large to be pooled
+ * (see UniformBufferPool), are uploaded partially, and only on the backends that prefer it
+ * (see FEngine::prefersPartialBufferUpdates()). Pooled MaterialInstance blocks are orphaned and
+ * always written entirely.
+ */
+class DirtyRangeSet {
+public:
+    // an update costs about this many bytes in the command stream, so it's not worth
+    // splitting ranges separated by less than that.
+    static constexpr uint32_t MERGE_DISTANCE = 64;
+    static constexpr size_t CAPACITY = 4;
+
+    struct Range {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    bool empty() const noexcept { return mCount == 0; }
+
+    void clear() noexcept { mCount = 0; }
+
+    Range const* begin() const noexcept { return mRanges; }
+    Range const* end() const noexcept { return mRanges + mCount; }
+
+    // marks [begin, end) as dirty
+    void add(uint32_t begin, uint32_t end) noexcept {
+        // fast path: the range is already dirty (e.g. the same uniform is set several times)
+        for (size_t i = 0, c = mCount; i < c; i++) {
+            if (mRanges[i].begin <= begin && end <= mRanges[i].end) {
+                return;
+            }
+        }
+        addSlow(begin, end);
+    }
+
+    // number of dirty bytes
+    size_t getByteCount() const noexcept;
+
+    // Uploads the dirty ranges of `data` (of `size` bytes) into `handle`, at `offset`. The whole
+    // buffer is uploaded instead when most of it is dirty or when `partial` is false, which lets
+    // the GL backend orphan it. Returns the number of bytes uploaded.
+    size_t upload(backend::DriverApi& driver, backend::Handle<backend::HwBufferObject> handle,
+            void const* data, size_t size, bool partial, uint32_t offset = 0) const noexcept;
+
+private:
+    void addSlow(uint32_t begin, uint32_t end) noexcept;
+
+    Range mRanges[CAPACITY];
+    uint8_t mCount = 0;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_DIRTYRANGESET_H
@@ -26,6 +26,7 @@
 #include "details/Scene.h"
 #include "details/SkinningBuffer.h"
 #include "details/Skybox.h"
+#include "details/StaticBatch.h"
 #include "details/Stream.h"
 #include "details/SwapChain.h"
 #include "details/Texture.h"
@@ -145,6 +146,10 @@ bool Engine::destroy(const MorphTargetBuffer* p) {
     return downcast(this)->destroy(downcast(p));
 }
 
+bool Engine::destroy(const StaticBatch* p) {
+    return downcast(this)->destroy(downcast(p));
+}
+
 bool Engine::destroy(const IndirectLight* p) {
     return downcast(this)->destroy(downcast(p));
 }
@@ -245,6 +250,24 @@ utils::JobSystem& Engine::getJobSystem() noexcept {
     return downcast(this)->getJobSystem();
 }
 
+void Engine::getMemoryReport(MemoryReport& report) const noexcept {
+    downcast(this)->getMemoryReport(report);
+}
+
+void Engine::forEachMemoryOwner(utils::Invocable<void(MemoryCategory category, const char* owner,
+        MemoryReport::Usage const& usage)>&& functor) const noexcept {
+    downcast(this)->forEachMemoryOwner(std::move(functor));
+}
+
+void Engine::setMemoryBudget(MemoryCategory category, size_t budget,
+        MemoryBudgetCallback&& callback) noexcept {
+    downcast(this)->setMemoryBudget(category, budget, std::move(callback));
+}
+
+size_t Engine::getMemoryBudget(MemoryCategory category) const noexcept {
+    return downcast(this)->getMemoryBudget(category);
+}
+
 DebugRegistry& Engine::getDebugRegistry() noexcept {
     return downcast(this)->getDebugRegistry();
 }
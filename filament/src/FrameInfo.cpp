@@ -56,6 +56,7 @@ void FrameInfoManager::beginFrame(DriverApi& driver,Config const& config, uint32
     uint64_t elapsed = 0;
     if (driver.getTimerQueryValue(mQueries[mLast], &elapsed)) {
         mLast = (mLast + 1) % POOL_COUNT;
+        mFrameTimeCount++;
         // conversion to our duration happens here
         mFrameTime = std::chrono::duration<uint64_t, std::nano>(elapsed);
     }
@@ -65,12 +65,18 @@ public:
         return getLastFrameInfo().frameTime;
     }
 
+    // number of frame times read back from the GPU so far
+    uint32_t getFrameTimeCount() const noexcept {
+        return mFrameTimeCount;
+    }
+
 private:
     void update(Config const& config, duration lastFrameTime) noexcept;
     backend::Handle<backend::HwTimerQuery> mQueries[POOL_COUNT];
     duration mFrameTime{};
     uint32_t mIndex = 0;
     uint32_t mLast = 0;
+    uint32_t mFrameTimeCount = 0;
 
     std::array<FrameInfo, MAX_FRAMETIME_HISTORY> mFrameTimeHistory;
     uint32_t mFrameTimeHistorySize = 0;
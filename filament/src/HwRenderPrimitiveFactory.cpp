@@ -100,7 +100,14 @@ RenderPrimitiveHandle HwRenderPrimitiveFactory::create(DriverApi& driver,
     return pos->handle;
 }
 
-void HwRenderPrimitiveFactory::destroy(DriverApi& driver, RenderPrimitiveHandle rph) noexcept {
+void HwRenderPrimitiveFactory::retain(RenderPrimitiveHandle rph, uint32_t count) noexcept {
+    auto pos = mMap.find(rph.getId());
+    assert_invariant(pos != mMap.end());
+    pos->second->refs += count;
+}
+
+void HwRenderPrimitiveFactory::destroy(DriverApi& driver, RenderPrimitiveHandle rph,
+        uint32_t count) noexcept {
     // look for this handle in our map
     auto pos = mMap.find(rph.getId());
 
@@ -109,7 +116,9 @@ void HwRenderPrimitiveFactory::destroy(DriverApi& driver, RenderPrimitiveHandle
 
     // check the refcount and destroy if needed
     auto ipos = pos->second;
-    if (--ipos->refs == 0) {
+    assert_invariant(ipos->refs >= count);
+    ipos->refs -= count;
+    if (ipos->refs == 0) {
         mSet.erase(ipos);
         mMap.erase(pos);
         driver.destroyRenderPrimitive(rph);
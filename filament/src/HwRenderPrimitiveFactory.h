@@ -56,8 +56,13 @@ public:
             uint32_t maxIndex,
             uint32_t count) noexcept;
 
+    // adds `count` references to a RenderPrimitive returned by create(), each must be released
+    // with destroy().
+    void retain(backend::RenderPrimitiveHandle rph, uint32_t count) noexcept;
+
+    // releases `count` references to a RenderPrimitive
     void destroy(backend::DriverApi& driver,
-            backend::RenderPrimitiveHandle rph) noexcept;
+            backend::RenderPrimitiveHandle rph, uint32_t count = 1) noexcept;
 
 private:
     struct Key { // 20 bytes
@@ -128,6 +128,10 @@ bool Material::isSampler(const char* name) const noexcept {
     return downcast(this)->isSampler(name);
 }
 
+bool Material::isReady() const noexcept {
+    return downcast(this)->isReady();
+}
+
 MaterialInstance* Material::getDefaultInstance() noexcept {
     return downcast(this)->getDefaultInstance();
 }
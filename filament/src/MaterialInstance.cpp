@@ -181,6 +181,201 @@ template UTILS_PUBLIC void MaterialInstance::setParameter<float3>  (const char*
 template UTILS_PUBLIC void MaterialInstance::setParameter<float4>  (const char* name, size_t nameLength, const float4   *v, size_t c);
 template UTILS_PUBLIC void MaterialInstance::setParameter<mat4f>   (const char* name, size_t nameLength, const mat4f    *v, size_t c);
 
+// ------------------------------------------------------------------------------------------------
+// Setting parameters through a ParameterHandle
+
+template<size_t Size>
+UTILS_NOINLINE
+void FMaterialInstance::setParameterUntypedImpl(ParameterHandle handle, const void* value) {
+    if (UTILS_LIKELY(handle.isValid())) {
+        mUniforms.setUniformUntyped<Size>(handle.offset, value);
+    }
+}
+
+template<size_t Size>
+UTILS_NOINLINE
+void FMaterialInstance::setParameterUntypedImpl(ParameterHandle handle,
+        const void* value, size_t count) {
+    if (UTILS_LIKELY(handle.isValid())) {
+        mUniforms.setUniformArrayUntyped<Size>(handle.offset, value, count);
+    }
+}
+
+template<typename T>
+UTILS_ALWAYS_INLINE
+inline void FMaterialInstance::setParameterImpl(ParameterHandle handle, T const& value) {
+    static_assert(!std::is_same_v<T, math::mat3f>);
+    setParameterUntypedImpl<sizeof(T)>(handle, &value);
+}
+
+// specialization for mat3f
+template<>
+inline void FMaterialInstance::setParameterImpl(ParameterHandle handle, mat3f const& value) {
+    if (UTILS_LIKELY(handle.isValid())) {
+        mUniforms.setUniform(handle.offset, value);
+    }
+}
+
+template<typename T>
+UTILS_ALWAYS_INLINE
+inline void FMaterialInstance::setParameterImpl(ParameterHandle handle,
+        const T* value, size_t count) {
+    static_assert(!std::is_same_v<T, math::mat3f>);
+    setParameterUntypedImpl<sizeof(T)>(handle, value, count);
+}
+
+// booleans are stored as unsigned integers
+template<typename T> struct StorageType { using type = T; };
+template<> struct StorageType<bool> { using type = uint32_t; };
+template<> struct StorageType<bool2> { using type = uint2; };
+template<> struct StorageType<bool3> { using type = uint3; };
+template<> struct StorageType<bool4> { using type = uint4; };
+
+template<typename T>
+static constexpr UniformType getUniformType() noexcept {
+    if constexpr (std::is_same_v<T, bool>)          return UniformType::BOOL;
+    else if constexpr (std::is_same_v<T, bool2>)    return UniformType::BOOL2;
+    else if constexpr (std::is_same_v<T, bool3>)    return UniformType::BOOL3;
+    else if constexpr (std::is_same_v<T, bool4>)    return UniformType::BOOL4;
+    else if constexpr (std::is_same_v<T, float>)    return UniformType::FLOAT;
+    else if constexpr (std::is_same_v<T, float2>)   return UniformType::FLOAT2;
+    else if constexpr (std::is_same_v<T, float3>)   return UniformType::FLOAT3;
+    else if constexpr (std::is_same_v<T, float4>)   return UniformType::FLOAT4;
+    else if constexpr (std::is_same_v<T, int32_t>)  return UniformType::INT;
+    else if constexpr (std::is_same_v<T, int2>)     return UniformType::INT2;
+    else if constexpr (std::is_same_v<T, int3>)     return UniformType::INT3;
+    else if constexpr (std::is_same_v<T, int4>)     return UniformType::INT4;
+    else if constexpr (std::is_same_v<T, uint32_t>) return UniformType::UINT;
+    else if constexpr (std::is_same_v<T, uint2>)    return UniformType::UINT2;
+    else if constexpr (std::is_same_v<T, uint3>)    return UniformType::UINT3;
+    else if constexpr (std::is_same_v<T, uint4>)    return UniformType::UINT4;
+    else if constexpr (std::is_same_v<T, mat3f>)    return UniformType::MAT3;
+    else                                            return UniformType::MAT4;
+}
+
+// whether a value of type T can be set on the parameter, this is only used for validation
+template<typename T>
+static bool isCompatible(MaterialInstance::ParameterHandle handle) noexcept {
+    if (handle.type == getUniformType<T>()) {
+        return true;
+    }
+    // boolean parameters can also be set with unsigned integers
+    if constexpr (std::is_same_v<T, uint32_t>)  return handle.type == UniformType::BOOL;
+    else if constexpr (std::is_same_v<T, uint2>) return handle.type == UniformType::BOOL2;
+    else if constexpr (std::is_same_v<T, uint3>) return handle.type == UniformType::BOOL3;
+    else if constexpr (std::is_same_v<T, uint4>) return handle.type == UniformType::BOOL4;
+    else return false;
+}
+
+// number of bytes written in the uniform buffer by an array of `count` T, see UniformBuffer
+template<typename T>
+static constexpr size_t getUniformArraySize(size_t count) noexcept {
+    if constexpr (std::is_same_v<T, mat3f>) {
+        // each mat3 is stored as 3 float3
+        return getUniformArraySize<float3>(count * 3);
+    } else {
+        using U = typename StorageType<T>::type;
+        constexpr size_t stride = (sizeof(U) + 0xFu) & ~0xFu;
+        return count ? stride * (count - 1) + sizeof(U) : 0;
+    }
+}
+
+template<typename T, typename>
+void MaterialInstance::setParameter(ParameterHandle handle, T const& value) {
+    downcast(this)->checkUniformParameterHandle(handle,
+            isCompatible<T>(handle), getUniformArraySize<T>(1));
+    using U = typename StorageType<T>::type;
+    downcast(this)->setParameterImpl(handle, U(value));
+}
+
+template UTILS_PUBLIC void MaterialInstance::setParameter<bool>    (ParameterHandle handle, bool const&     v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<bool2>   (ParameterHandle handle, bool2 const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<bool3>   (ParameterHandle handle, bool3 const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<bool4>   (ParameterHandle handle, bool4 const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<float>   (ParameterHandle handle, float const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<int32_t> (ParameterHandle handle, int32_t const&  v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint32_t>(ParameterHandle handle, uint32_t const& v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<int2>    (ParameterHandle handle, int2 const&     v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<int3>    (ParameterHandle handle, int3 const&     v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<int4>    (ParameterHandle handle, int4 const&     v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint2>   (ParameterHandle handle, uint2 const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint3>   (ParameterHandle handle, uint3 const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint4>   (ParameterHandle handle, uint4 const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<float2>  (ParameterHandle handle, float2 const&   v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<float3>  (ParameterHandle handle, float3 const&   v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<float4>  (ParameterHandle handle, float4 const&   v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<mat3f>   (ParameterHandle handle, mat3f const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<mat4f>   (ParameterHandle handle, mat4f const&    v);
+
+template<typename T, typename>
+void MaterialInstance::setParameter(ParameterHandle handle, const T* values, size_t count) {
+    downcast(this)->checkUniformParameterHandle(handle,
+            isCompatible<T>(handle) && count <= handle.count, getUniformArraySize<T>(count));
+    using U = typename StorageType<T>::type;
+    if constexpr (std::is_same_v<T, mat3f>) {
+        // pretend each mat3 is an array of 3 float3
+        downcast(this)->setParameterImpl(handle,
+                reinterpret_cast<math::float3 const*>(values), count * 3);
+    } else if constexpr (std::is_same_v<T, U>) {
+        downcast(this)->setParameterImpl(handle, values, count);
+    } else {
+        auto* p = new U[count];
+        std::copy_n(values, count, p);
+        downcast(this)->setParameterImpl(handle, p, count);
+        delete [] p;
+    }
+}
+
+template UTILS_PUBLIC void MaterialInstance::setParameter<bool>    (ParameterHandle handle, const bool     *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<bool2>   (ParameterHandle handle, const bool2    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<bool3>   (ParameterHandle handle, const bool3    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<bool4>   (ParameterHandle handle, const bool4    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<float>   (ParameterHandle handle, const float    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<int32_t> (ParameterHandle handle, const int32_t  *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint32_t>(ParameterHandle handle, const uint32_t *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<int2>    (ParameterHandle handle, const int2     *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<int3>    (ParameterHandle handle, const int3     *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<int4>    (ParameterHandle handle, const int4     *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint2>   (ParameterHandle handle, const uint2    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint3>   (ParameterHandle handle, const uint3    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint4>   (ParameterHandle handle, const uint4    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<float2>  (ParameterHandle handle, const float2   *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<float3>  (ParameterHandle handle, const float3   *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<float4>  (ParameterHandle handle, const float4   *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<mat3f>   (ParameterHandle handle, const mat3f    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameter<mat4f>   (ParameterHandle handle, const mat4f    *v, size_t c);
+
+template<typename T, typename>
+void MaterialInstance::setParameters(ParameterHandle handle,
+        MaterialInstance* const* instances, const T* values, size_t count) {
+    bool const compatible = isCompatible<T>(handle);
+    constexpr size_t size = getUniformArraySize<T>(1);
+    using U = typename StorageType<T>::type;
+    for (size_t i = 0; i < count; i++) {
+        downcast(instances[i])->checkUniformParameterHandle(handle, compatible, size);
+        downcast(instances[i])->setParameterImpl(handle, U(values[i]));
+    }
+}
+
+template UTILS_PUBLIC void MaterialInstance::setParameters<bool>    (ParameterHandle handle, MaterialInstance* const* i, const bool     *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<bool2>   (ParameterHandle handle, MaterialInstance* const* i, const bool2    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<bool3>   (ParameterHandle handle, MaterialInstance* const* i, const bool3    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<bool4>   (ParameterHandle handle, MaterialInstance* const* i, const bool4    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<float>   (ParameterHandle handle, MaterialInstance* const* i, const float    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<int32_t> (ParameterHandle handle, MaterialInstance* const* i, const int32_t  *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<uint32_t>(ParameterHandle handle, MaterialInstance* const* i, const uint32_t *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<int2>    (ParameterHandle handle, MaterialInstance* const* i, const int2     *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<int3>    (ParameterHandle handle, MaterialInstance* const* i, const int3     *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<int4>    (ParameterHandle handle, MaterialInstance* const* i, const int4     *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<uint2>   (ParameterHandle handle, MaterialInstance* const* i, const uint2    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<uint3>   (ParameterHandle handle, MaterialInstance* const* i, const uint3    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<uint4>   (ParameterHandle handle, MaterialInstance* const* i, const uint4    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<float2>  (ParameterHandle handle, MaterialInstance* const* i, const float2   *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<float3>  (ParameterHandle handle, MaterialInstance* const* i, const float3   *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<float4>  (ParameterHandle handle, MaterialInstance* const* i, const float4   *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<mat3f>   (ParameterHandle handle, MaterialInstance* const* i, const mat3f    *v, size_t c);
+template UTILS_PUBLIC void MaterialInstance::setParameters<mat4f>   (ParameterHandle handle, MaterialInstance* const* i, const mat4f    *v, size_t c);
+
 // ------------------------------------------------------------------------------------------------
 
 Material const* MaterialInstance::getMaterial() const noexcept {
@@ -206,6 +401,16 @@ void MaterialInstance::setParameter(
     downcast(this)->setParameterImpl<float4>({ name, nameLength }, Color::toLinear(type, color));
 }
 
+MaterialInstance::ParameterHandle MaterialInstance::getParameterHandle(
+        const char* name, size_t nameLength) const {
+    return downcast(this)->getParameterHandle({ name, nameLength });
+}
+
+void MaterialInstance::setParameter(ParameterHandle handle, Texture const* texture,
+        TextureSampler const& sampler) {
+    downcast(this)->setParameterImpl(handle, downcast(texture), sampler);
+}
+
 void MaterialInstance::setScissor(
         uint32_t left, uint32_t bottom, uint32_t width, uint32_t height) noexcept {
     downcast(this)->setScissor(left, bottom, width, height);
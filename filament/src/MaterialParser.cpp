@@ -34,6 +34,7 @@
 #include <utils/CString.h>
 
 #include <stdlib.h>
+#include <string.h>
 
 using namespace utils;
 using namespace filament::backend;
@@ -44,31 +45,126 @@ namespace filament {
 
 // ------------------------------------------------------------------------------------------------
 
-MaterialParser::MaterialParserDetails::MaterialParserDetails(Backend backend, const void* data, size_t size)
-        : mManagedBuffer(data, size),
-          mChunkContainer(mManagedBuffer.data(), mManagedBuffer.size()),
-          mMaterialChunk(mChunkContainer) {
+static ChunkType getMaterialTag(Backend backend) noexcept {
     switch (backend) {
-        case Backend::OPENGL:
-            mMaterialTag = ChunkType::MaterialGlsl;
-            mDictionaryTag = ChunkType::DictionaryText;
-            break;
         case Backend::METAL:
-            mMaterialTag = ChunkType::MaterialMetal;
-            mDictionaryTag = ChunkType::DictionaryText;
-            break;
+            return ChunkType::MaterialMetal;
         case Backend::VULKAN:
-            mMaterialTag = ChunkType::MaterialSpirv;
-            mDictionaryTag = ChunkType::DictionarySpirv;
-            break;
+            return ChunkType::MaterialSpirv;
         default:
-            // this is for testing purpose -- for e.g.: with the NoopDriver
-            mMaterialTag = ChunkType::MaterialGlsl;
-            mDictionaryTag = ChunkType::DictionaryText;
-            break;
+            // OPENGL, and for testing purpose -- for e.g.: with the NoopDriver
+            return ChunkType::MaterialGlsl;
+    }
+}
+
+static ChunkType getDictionaryTag(Backend backend) noexcept {
+    return backend == Backend::VULKAN ? ChunkType::DictionarySpirv : ChunkType::DictionaryText;
+}
+
+static void writeChunkHeader(uint8_t* dst, uint64_t type, uint32_t size) noexcept {
+    for (size_t i = 0; i < 8; i++) {
+        dst[i] = uint8_t(type >> (i * 8));
+    }
+    for (size_t i = 0; i < 4; i++) {
+        dst[8 + i] = uint8_t(size >> (i * 8));
     }
 }
 
+/*
+ * Copies the chunks of a package into dst, leaving out the shader and dictionary chunks that
+ * don't match materialTag and dictionaryTag, and returns the size of the copy. dst can be null,
+ * in which case only the size is computed. Returns 0 if the package can't be stripped.
+ *
+ * The SPIR-V dictionary relies on the alignment of its content, so the offset modulo 8 of each
+ * chunk is preserved by filling the gaps with Unknown chunks.
+ */
+static size_t stripPackage(uint8_t* dst, uint8_t const* src, size_t size,
+        ChunkType materialTag, ChunkType dictionaryTag) noexcept {
+    if (intptr_t(src) % 8) {
+        return 0;
+    }
+
+    constexpr size_t HEADER_SIZE = 12;
+    size_t written = 0;
+    Unflattener unflattener(src, src + size);
+    while (unflattener.hasData()) {
+        uint64_t type;
+        uint32_t chunkSize;
+        if (!unflattener.read(&type) || !unflattener.read(&chunkSize)) {
+            return 0;
+        }
+        uint8_t const* const content = unflattener.getCursor();
+        if (size_t(src + size - content) < chunkSize) {
+            return 0;
+        }
+        unflattener.setCursor(content + chunkSize);
+
+        // compressed chunks are kept or dropped based on the type of the chunk they contain
+        uint64_t contentType = type;
+        if (type == ChunkType::CompressedZstd) {
+            Unflattener header(content, content + chunkSize);
+            if (!header.read(&contentType)) {
+                return 0;
+            }
+        }
+        switch (contentType) {
+            case ChunkType::MaterialGlsl:
+            case ChunkType::MaterialSpirv:
+            case ChunkType::MaterialMetal:
+                if (contentType != materialTag) {
+                    continue;
+                }
+                break;
+            case ChunkType::DictionaryText:
+            case ChunkType::DictionarySpirv:
+                if (contentType != dictionaryTag) {
+                    continue;
+                }
+                break;
+            default:
+                break;
+        }
+
+        size_t const offset = content - HEADER_SIZE - src;
+        if ((offset - written) % 8) {
+            size_t const padding = HEADER_SIZE + (offset - written - HEADER_SIZE) % 8;
+            if (dst) {
+                writeChunkHeader(dst + written, ChunkType::Unknown, padding - HEADER_SIZE);
+                memset(dst + written + HEADER_SIZE, 0, padding - HEADER_SIZE);
+            }
+            written += padding;
+        }
+        if (dst) {
+            memcpy(dst + written, src + offset, HEADER_SIZE + chunkSize);
+        }
+        written += HEADER_SIZE + chunkSize;
+    }
+    return written;
+}
+
+MaterialParser::MaterialParserDetails::ManagedBuffer::ManagedBuffer(const void* start, size_t size,
+        ChunkType materialTag, ChunkType dictionaryTag) {
+    uint8_t const* const src = static_cast<uint8_t const*>(start);
+    mSize = stripPackage(nullptr, src, size, materialTag, dictionaryTag);
+    if (mSize) {
+        mStart = malloc(mSize);
+        stripPackage(static_cast<uint8_t*>(mStart), src, size, materialTag, dictionaryTag);
+    } else {
+        // the package is misaligned or invalid, keep all of it, parse() will validate it
+        mStart = malloc(size);
+        mSize = size;
+        memcpy(mStart, start, size);
+    }
+}
+
+MaterialParser::MaterialParserDetails::MaterialParserDetails(Backend backend, const void* data, size_t size)
+        : mMaterialTag(getMaterialTag(backend)),
+          mDictionaryTag(getDictionaryTag(backend)),
+          mManagedBuffer(data, size, mMaterialTag, mDictionaryTag),
+          mChunkContainer(mManagedBuffer.data(), mManagedBuffer.size()),
+          mMaterialChunk(mChunkContainer) {
+}
+
 template<typename T>
 UTILS_NOINLINE
 bool MaterialParser::MaterialParserDetails::getFromSimpleChunk(
@@ -109,12 +205,22 @@ MaterialParser::ParseResult MaterialParser::parse() noexcept {
     if (UTILS_UNLIKELY(!DictionaryReader::unflatten(cc, dictTag, mImpl.mBlobDictionary))) {
         return ParseResult::ERROR_OTHER;
     }
+    // the dictionary is copied, its chunk is not needed anymore
+    cc.releaseDecompressedChunk(dictTag);
     if (UTILS_UNLIKELY(!mImpl.mMaterialChunk.initialize(matTag))) {
         return ParseResult::ERROR_OTHER;
     }
     return ParseResult::SUCCESS;
 }
 
+size_t MaterialParser::getResidentSize() const noexcept {
+    size_t size = mImpl.mManagedBuffer.size() + mImpl.mChunkContainer.getDecompressedSize();
+    for (auto const& blob : mImpl.mBlobDictionary) {
+        size += blob.size();
+    }
+    return size;
+}
+
 // Accessors
 bool MaterialParser::getMaterialVersion(uint32_t* value) const noexcept {
     return mImpl.getFromSimpleChunk(ChunkType::MaterialVersion, value);
@@ -107,6 +107,10 @@ public:
 
     filaflat::MaterialChunk const& getMaterialChunk() const noexcept { return mImpl.mMaterialChunk; }
 
+    // Memory in bytes kept alive by the parser: the resident copy of the package, the shader
+    // dictionary and the decompressed chunks.
+    size_t getResidentSize() const noexcept;
+
 private:
     struct MaterialParserDetails {
         MaterialParserDetails(backend::Backend backend, const void* data, size_t size);
@@ -121,10 +125,10 @@ private:
             void* mStart = nullptr;
             size_t mSize = 0;
         public:
-            explicit ManagedBuffer(const void* start, size_t size)
-                    : mStart(malloc(size)), mSize(size) {
-                memcpy(mStart, start, size);
-            }
+            // Copies the package, without the shader and dictionary chunks that aren't of the
+            // given types, which are never used.
+            ManagedBuffer(const void* start, size_t size,
+                    filamat::ChunkType materialTag, filamat::ChunkType dictionaryTag);
             ~ManagedBuffer() noexcept { free(mStart); }
             ManagedBuffer(ManagedBuffer const& rhs) = delete;
             ManagedBuffer& operator=(ManagedBuffer const& rhs) = delete;
@@ -134,14 +138,15 @@ private:
             size_t size() const noexcept { return mSize; }
         };
 
+        // the tags must be initialized before mManagedBuffer
+        filamat::ChunkType mMaterialTag = filamat::ChunkType::Unknown;
+        filamat::ChunkType mDictionaryTag = filamat::ChunkType::Unknown;
         ManagedBuffer mManagedBuffer;
         filaflat::ChunkContainer mChunkContainer;
 
         // Keep MaterialChunk alive between calls to getShader to avoid reload the shader index.
         filaflat::MaterialChunk mMaterialChunk;
         filaflat::BlobDictionary mBlobDictionary;
-        filamat::ChunkType mMaterialTag = filamat::ChunkType::Unknown;
-        filamat::ChunkType mDictionaryTag = filamat::ChunkType::Unknown;
     };
 
     filaflat::ChunkContainer& getChunkContainer() noexcept;
@@ -40,7 +40,8 @@ using namespace backend;
 using namespace math;
 
 PerViewUniforms::PerViewUniforms(FEngine& engine) noexcept
-        : mSamplers(PerViewSib::SAMPLER_COUNT) {
+        : mSamplers(PerViewSib::SAMPLER_COUNT),
+          mPartialUpdates(engine.prefersPartialBufferUpdates()) {
     DriverApi& driver = engine.getDriverApi();
 
     mSamplerGroupHandle = driver.createSamplerGroup(mSamplers.getSize());
@@ -353,7 +354,7 @@ void PerViewUniforms::prepareShadowPCSS(Handle<HwTexture> texture,
 
 void PerViewUniforms::commit(backend::DriverApi& driver) noexcept {
     if (mUniforms.isDirty()) {
-        driver.updateBufferObject(mUniformBufferHandle, mUniforms.toBufferDescriptor(driver), 0);
+        mUniforms.commit(driver, mUniformBufferHandle, mPartialUpdates);
     }
     if (mSamplers.isDirty()) {
         driver.updateSamplerGroup(mSamplerGroupHandle, mSamplers.toBufferDescriptor(driver));
@@ -185,6 +185,10 @@ PostProcessManager::PostProcessManager(FEngine& engine) noexcept
 
 PostProcessManager::~PostProcessManager() noexcept = default;
 
+uint8_t PostProcessManager::getDefaultDofRingCount() noexcept {
+    return DOF_DEFAULT_RING_COUNT;
+}
+
 UTILS_NOINLINE
 void PostProcessManager::registerPostProcessMaterial(std::string_view name, uint8_t const* data, int size) {
     mMaterialRegistry.try_emplace(name, mEngine, data, size);
@@ -136,6 +136,9 @@ public:
             FrameGraphId<FrameGraphTexture> output,
             bool needInputDuplication, ScreenSpaceRefConfig const& config) noexcept;
 
+    // Number of rings of the depth-of-field kernels when DepthOfFieldOptions leaves it to 0
+    static uint8_t getDefaultDofRingCount() noexcept;
+
     // Depth-of-field
     FrameGraphId<FrameGraphTexture> dof(FrameGraph& fg,
             FrameGraphId<FrameGraphTexture> input,
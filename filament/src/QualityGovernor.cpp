@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QualityGovernor.h"
+
+#include <utils/debug.h>
+
+#include <algorithm>
+
+namespace filament {
+
+static constexpr uint8_t MAX_REDUCTIONS[QualityGovernor::EFFECT_COUNT] = {
+        2,  // AMBIENT_OCCLUSION
+        2,  // SHADOWS
+        2,  // DEPTH_OF_FIELD
+        1,  // SCREEN_SPACE_REFLECTIONS
+        2,  // BLOOM
+};
+
+QualityGovernor::QualityGovernor() noexcept {
+    reset();
+}
+
+void QualityGovernor::setConfig(Config const& config) noexcept {
+    mConfig = config;
+    mConfig.frameCount = std::max(mConfig.frameCount, uint8_t(1));
+}
+
+void QualityGovernor::reset() noexcept {
+    mReductions = {};
+    for (auto& costs : mStepCosts) {
+        costs.fill(-1.0f);
+    }
+    mPending = {};
+    mFrameTimeSum = 0.0f;
+    mFrameTimeCount = 0;
+}
+
+uint8_t QualityGovernor::getMaxReduction(Effect effect) noexcept {
+    assert_invariant(size_t(effect) < EFFECT_COUNT);
+    return MAX_REDUCTIONS[size_t(effect)];
+}
+
+float QualityGovernor::getStepCost(Effect effect, uint8_t reduction) const noexcept {
+    assert_invariant(reduction >= 1 && reduction <= getMaxReduction(effect));
+    return mStepCosts[size_t(effect)][reduction - 1];
+}
+
+bool QualityGovernor::update(float frameTime, EffectMask active) noexcept {
+    mFrameTimeSum += frameTime;
+    mFrameTimeCount++;
+    if (mFrameTimeCount < mConfig.frameCount) {
+        return false;
+    }
+
+    const float average = mFrameTimeSum / float(mFrameTimeCount);
+    mFrameTimeSum = 0.0f;
+    mFrameTimeCount = 0;
+
+    if (mPending.valid) {
+        // This window is the first one entirely rendered after the last change, which gives us
+        // the cost of that step. Noise can make it negative, in which case it's just free.
+        const bool reduced = mReductions[size_t(mPending.effect)] == mPending.reduction;
+        const float delta = reduced ?
+                mPending.frameTimeBefore - average : average - mPending.frameTimeBefore;
+        float& cost = mStepCosts[size_t(mPending.effect)][mPending.reduction - 1];
+        cost = cost < 0.0f ? std::max(delta, 0.0f) : (cost + std::max(delta, 0.0f)) * 0.5f;
+        mPending.valid = false;
+    }
+
+    if (average > mConfig.budget) {
+        return reduce(active, average);
+    }
+    if (average < mConfig.budget * (1.0f - mConfig.hysteresis)) {
+        return restore(average);
+    }
+    return false;
+}
+
+bool QualityGovernor::reduce(EffectMask active, float frameTime) noexcept {
+    // pick the active effect with the lowest priority that can still be reduced, the first one
+    // in case of a tie.
+    size_t candidate = EFFECT_COUNT;
+    for (size_t i = 0; i < EFFECT_COUNT; i++) {
+        const uint8_t priority = mConfig.priorities[i];
+        if (!priority || !active[i] || mReductions[i] >= MAX_REDUCTIONS[i]) {
+            continue;
+        }
+        if (candidate == EFFECT_COUNT || priority < mConfig.priorities[candidate]) {
+            candidate = i;
+        }
+    }
+    if (candidate == EFFECT_COUNT) {
+        // nothing left to reduce
+        return false;
+    }
+    mReductions[candidate]++;
+    mPending = { frameTime, Effect(candidate), mReductions[candidate], true };
+    return true;
+}
+
+bool QualityGovernor::restore(float frameTime) noexcept {
+    // pick the reduced effect with the highest priority, the last one in case of a tie, i.e.
+    // the reverse of the order effects are reduced in.
+    size_t candidate = EFFECT_COUNT;
+    for (size_t i = 0; i < EFFECT_COUNT; i++) {
+        if (!mReductions[i]) {
+            continue;
+        }
+        if (candidate == EFFECT_COUNT || mConfig.priorities[i] >= mConfig.priorities[candidate]) {
+            candidate = i;
+        }
+    }
+    if (candidate == EFFECT_COUNT) {
+        // already at full quality
+        return false;
+    }
+
+    // Only restore if we expect to stay under the budget, otherwise we'd just reduce the
+    // quality again in the next window. A step that hasn't been measured yet is always
+    // tried, after which its cost is known.
+    const uint8_t reduction = mReductions[candidate];
+    const float cost = mStepCosts[candidate][reduction - 1];
+    if (cost >= 0.0f && frameTime + cost > mConfig.budget) {
+        return false;
+    }
+    mReductions[candidate]--;
+    mPending = { frameTime, Effect(candidate), reduction, true };
+    return true;
+}
+
+} // namespace filament
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_QUALITYGOVERNOR_H
+#define TNT_FILAMENT_QUALITYGOVERNOR_H
+
+#include <utils/bitset.h>
+
+#include <array>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * QualityGovernor lowers the quality of individual effects, one step at a time, to keep the
+ * frame time within a budget, and raises it back when there is enough headroom.
+ *
+ * - Effects are reduced in increasing priority order and restored in the reverse order.
+ * - Decisions are taken once per window of `frameCount` frames, using the window's average
+ *   frame time, which lets each change settle before it is judged.
+ * - The cost of each step is measured as the difference between the average frame time of the
+ *   windows before and after it. Quality is only raised when the frame time is under
+ *   budget * (1 - hysteresis) and adding back the measured cost of the step keeps it under the
+ *   budget, which prevents oscillations.
+ *
+ * This class doesn't know anything about the GPU, the frame times are given by the caller,
+ * which makes it testable with synthetic timings.
+ */
+class QualityGovernor {
+public:
+    enum class Effect : uint8_t {
+        AMBIENT_OCCLUSION,          // 1: half resolution, 2: fewest samples
+        SHADOWS,                    // n: shadow maps are 2^n times smaller
+        DEPTH_OF_FIELD,             // n: half resolution and n rings less
+        SCREEN_SPACE_REFLECTIONS,   // 1: disabled
+        BLOOM,                      // n: bloom buffer is 2^n times smaller
+    };
+
+    static constexpr size_t EFFECT_COUNT = 5;
+
+    using EffectMask = utils::bitset32;
+
+    struct Config {
+        // frame time budget in ms
+        float budget = 16.0f;
+        // width of the band under the budget in which nothing is changed, as a fraction of the
+        // budget.
+        float hysteresis = 0.1f;
+        // number of frames averaged for each decision
+        uint8_t frameCount = 8;
+        // priority of each effect, lower priority effects are reduced first; 0 means the effect
+        // is never changed.
+        std::array<uint8_t, EFFECT_COUNT> priorities = {};
+    };
+
+    QualityGovernor() noexcept;
+
+    // Sets the configuration, this doesn't change the current reductions.
+    void setConfig(Config const& config) noexcept;
+
+    Config const& getConfig() const noexcept { return mConfig; }
+
+    // Restores full quality for all effects and forgets everything that was measured.
+    void reset() noexcept;
+
+    /*
+     * Accounts for a new frame, `frameTime` is its duration in ms and `active` the set of
+     * effects that were enabled during that frame; reducing inactive effects doesn't save
+     * anything so they're skipped.
+     * Returns true if the reductions changed.
+     */
+    bool update(float frameTime, EffectMask active) noexcept;
+
+    // Number of steps the quality of an effect is currently reduced by.
+    uint8_t getReduction(Effect effect) const noexcept {
+        return mReductions[size_t(effect)];
+    }
+
+    // Maximum number of steps the quality of an effect can be reduced by.
+    static uint8_t getMaxReduction(Effect effect) noexcept;
+
+    // Measured cost in ms of the step that reduced `effect` to `reduction`, or a negative value
+    // if it hasn't been measured yet.
+    float getStepCost(Effect effect, uint8_t reduction) const noexcept;
+
+private:
+    static constexpr size_t MAX_REDUCTION = 2;
+
+    struct PendingStep {
+        float frameTimeBefore = 0.0f;
+        Effect effect = {};
+        uint8_t reduction = 0;  // the step that changed, from reduction - 1 to reduction
+        bool valid = false;
+    };
+
+    bool reduce(EffectMask active, float frameTime) noexcept;
+    bool restore(float frameTime) noexcept;
+
+    Config mConfig;
+    std::array<uint8_t, EFFECT_COUNT> mReductions = {};
+    std::array<std::array<float, MAX_REDUCTION>, EFFECT_COUNT> mStepCosts = {};
+    PendingStep mPending;
+    float mFrameTimeSum = 0.0f;
+    uint32_t mFrameTimeCount = 0;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_QUALITYGOVERNOR_H
@@ -62,8 +62,13 @@ RenderPass::Command* RenderPass::append(size_t count) noexcept {
 
 void RenderPass::resize(size_t count) noexcept {
     if (mCommandBegin) {
-        mCommandEnd = mCommandBegin + count;
-        mCommandArena.rewind(mCommandEnd);
+        Command* const end = mCommandBegin + count;
+        // the memory can only be given back if nothing was allocated after our commands,
+        // which isn't the case when several passes reserve their commands up-front.
+        if (mCommandArena.getCurrent() == mCommandEnd) {
+            mCommandArena.rewind(end);
+        }
+        mCommandEnd = end;
     }
 }
 
@@ -87,9 +92,24 @@ void RenderPass::setScissorViewport(backend::Viewport viewport) noexcept {
 
 void RenderPass::appendCommands(FEngine& engine, CommandTypeFlags const commandTypeFlags) noexcept {
     SYSTRACE_CALL();
+
+    reserveCommands(engine, commandTypeFlags);
+
+    Command const* const first = mReservedCommands;
+    Command const* const last = mReservedCommands + mReservedCommandCount;
+    generateReservedCommandsImpl(engine);
+
+    // Go over all the commands and call prepareProgram().
+    // This must be done from the main thread.
+    prepareProgram(first, last);
+}
+
+void RenderPass::reserveCommands(FEngine&, CommandTypeFlags const commandTypeFlags) noexcept {
+    SYSTRACE_CALL();
     SYSTRACE_CONTEXT();
 
     assert_invariant(mRenderableSoa);
+    assert_invariant(!mReservedCommands);
 
     utils::Range<uint32_t> const vr = mVisibleRenderables;
     // trace the number of visible renderables
@@ -98,11 +118,6 @@ void RenderPass::appendCommands(FEngine& engine, CommandTypeFlags const commandT
         return;
     }
 
-    JobSystem& js = engine.getJobSystem();
-    const RenderFlags renderFlags = mFlags;
-    const Variant variant = mVariant;
-    const FScene::VisibleMaskType visibilityMask = mVisibilityMask;
-
     // up-to-date summed primitive counts needed for generateCommands()
     FScene::RenderableSoa const& soa = *mRenderableSoa;
     updateSummedPrimitiveCounts(const_cast<FScene::RenderableSoa&>(soa), vr);
@@ -114,16 +129,56 @@ void RenderPass::appendCommands(FEngine& engine, CommandTypeFlags const commandT
     const bool depthPass  = bool(commandTypeFlags & CommandTypeFlags::DEPTH);
     commandCount *= uint32_t(colorPass * 2 + depthPass);
     commandCount += 1; // for the sentinel
-    Command* const curr = append(commandCount);
+
+    mReservedCommands = append(commandCount);
+    mReservedCommandCount = commandCount;
+    mReservedCommandTypeFlags = commandTypeFlags;
+}
+
+void RenderPass::generateReservedCommands(FEngine& engine) noexcept {
+    generateReservedCommandsImpl(engine);
+    std::sort(mCommandBegin, mCommandEnd);
+}
+
+void RenderPass::finalizeCommands(FEngine& engine) noexcept {
+    SYSTRACE_CALL();
+
+    // Go over all the commands and call prepareProgram().
+    // This must be done from the main thread.
+    prepareProgram(mCommandBegin, mCommandEnd);
+
+    // the commands are already sorted by generateReservedCommands()
+    trimCommands(engine);
+}
+
+void RenderPass::generateReservedCommandsImpl(FEngine& engine) noexcept {
+    SYSTRACE_CALL();
+
+    Command* const curr = mReservedCommands;
+    uint32_t const commandCount = mReservedCommandCount;
+    mReservedCommands = nullptr;
+    mReservedCommandCount = 0;
+    if (UTILS_UNLIKELY(!curr)) {
+        return;
+    }
+
+    JobSystem& js = engine.getJobSystem();
+    const CommandTypeFlags commandTypeFlags = mReservedCommandTypeFlags;
+    const RenderFlags renderFlags = mFlags;
+    const Variant variant = mVariant;
+    const FScene::VisibleMaskType visibilityMask = mVisibilityMask;
+    FScene::VisibleMaskType const* const visibleMasks = mVisibleMasks;
+    utils::Range<uint32_t> const vr = mVisibleRenderables;
+    FScene::RenderableSoa const& soa = *mRenderableSoa;
 
     const float3 cameraPosition(mCameraPosition);
     const float3 cameraForwardVector(mCameraForwardVector);
-    auto work = [commandTypeFlags, curr, &soa, variant, renderFlags, visibilityMask, cameraPosition,
-                 cameraForwardVector]
+    auto work = [commandTypeFlags, curr, &soa, variant, renderFlags, visibilityMask, visibleMasks,
+                 cameraPosition, cameraForwardVector]
             (uint32_t startIndex, uint32_t indexCount) {
         RenderPass::generateCommands(commandTypeFlags, curr,
-                soa, { startIndex, startIndex + indexCount }, variant, renderFlags, visibilityMask,
-                cameraPosition, cameraForwardVector);
+                soa, { startIndex, startIndex + indexCount }, variant, renderFlags,
+                visibilityMask, visibleMasks, cameraPosition, cameraForwardVector);
     };
 
     if (vr.size() <= JOBS_PARALLEL_FOR_COMMANDS_COUNT) {
@@ -138,10 +193,11 @@ void RenderPass::appendCommands(FEngine& engine, CommandTypeFlags const commandT
     // "eof" command. these commands are guaranteed to be sorted last in the
     // command buffer.
     curr[commandCount - 1].key = uint64_t(Pass::SENTINEL);
+}
 
-    // Go over all the commands and call prepareProgram().
-    // This must be done from the main thread.
-    for (Command const* first = curr, *last = curr + commandCount ; first != last ; ++first) {
+/* static */
+void RenderPass::prepareProgram(Command const* first, Command const* last) noexcept {
+    for (; first != last ; ++first) {
         if (UTILS_LIKELY((first->key & CUSTOM_MASK) == uint64_t(CustomCommand::PASS))) {
             auto ma = first->primitive.mi->getMaterial();
             ma->prepareProgram(first->primitive.materialVariant);
@@ -174,6 +230,10 @@ void RenderPass::sortCommands(FEngine& engine) noexcept {
 
     std::sort(mCommandBegin, mCommandEnd);
 
+    trimCommands(engine);
+}
+
+void RenderPass::trimCommands(FEngine& engine) noexcept {
     // find the last command
     Command const* const last = std::partition_point(mCommandBegin, mCommandEnd,
             [](Command const& c) {
@@ -373,7 +433,7 @@ UTILS_NOINLINE
 void RenderPass::generateCommands(uint32_t commandTypeFlags, Command* const commands,
         FScene::RenderableSoa const& soa, Range<uint32_t> range,
         Variant variant, RenderFlags renderFlags,
-        FScene::VisibleMaskType visibilityMask,
+        FScene::VisibleMaskType visibilityMask, FScene::VisibleMaskType const* visibleMasks,
         float3 cameraPosition, float3 cameraForward) noexcept {
 
     SYSTRACE_CALL();
@@ -405,11 +465,13 @@ void RenderPass::generateCommands(uint32_t commandTypeFlags, Command* const comm
     switch (commandTypeFlags & (CommandTypeFlags::COLOR | CommandTypeFlags::DEPTH)) {
         case CommandTypeFlags::COLOR:
             curr = generateCommandsImpl<CommandTypeFlags::COLOR>(commandTypeFlags, curr,
-                    soa, range, variant, renderFlags, visibilityMask, cameraPosition, cameraForward);
+                    soa, range, variant, renderFlags, visibilityMask, visibleMasks,
+                    cameraPosition, cameraForward);
             break;
         case CommandTypeFlags::DEPTH:
             curr = generateCommandsImpl<CommandTypeFlags::DEPTH>(commandTypeFlags, curr,
-                    soa, range, variant, renderFlags, visibilityMask, cameraPosition, cameraForward);
+                    soa, range, variant, renderFlags, visibilityMask, visibleMasks,
+                    cameraPosition, cameraForward);
             break;
         default:
             // we should never end-up here
@@ -432,6 +494,7 @@ RenderPass::Command* RenderPass::generateCommandsImpl(uint32_t extraFlags,
         Command* UTILS_RESTRICT curr,
         FScene::RenderableSoa const& UTILS_RESTRICT soa, Range<uint32_t> range,
         Variant variant, RenderFlags renderFlags, FScene::VisibleMaskType visibilityMask,
+        FScene::VisibleMaskType const* visibleMasks,
         float3 cameraPosition, float3 cameraForward) noexcept {
 
     // generateCommands() writes both the draw and depth commands simultaneously such that
@@ -453,7 +516,8 @@ RenderPass::Command* RenderPass::generateCommandsImpl(uint32_t extraFlags,
     auto const* const UTILS_RESTRICT soaPrimitives      = soa.data<FScene::PRIMITIVES>();
     auto const* const UTILS_RESTRICT soaSkinning        = soa.data<FScene::SKINNING_BUFFER>();
     auto const* const UTILS_RESTRICT soaMorphing        = soa.data<FScene::MORPHING_BUFFER>();
-    auto const* const UTILS_RESTRICT soaVisibilityMask  = soa.data<FScene::VISIBLE_MASK>();
+    auto const* const UTILS_RESTRICT soaVisibilityMask  =
+            visibleMasks ? visibleMasks : soa.data<FScene::VISIBLE_MASK>();
     auto const* const UTILS_RESTRICT soaInstanceCount   = soa.data<FScene::INSTANCE_COUNT>();
 
     const bool hasShadowing = renderFlags & HAS_SHADOWING;
@@ -719,15 +783,18 @@ void RenderPass::Executor::overrideScissor(backend::Viewport const& scissor) noe
 }
 
 void RenderPass::Executor::execute(FEngine& engine, const char*) const noexcept {
-    execute(engine.getDriverApi(), mCommands.begin(), mCommands.end());
+    execute(engine, mCommands.begin(), mCommands.end());
 }
 
 UTILS_NOINLINE // no need to be inlined
-void RenderPass::Executor::execute(backend::DriverApi& driver,
+void RenderPass::Executor::execute(FEngine& engine,
         const Command* first, const Command* last) const noexcept {
     SYSTRACE_CALL();
     SYSTRACE_CONTEXT();
 
+    DriverApi& driver = engine.getDriverApi();
+    bool const skipPendingPrograms = engine.getConfig().skipDrawsWithPendingPrograms;
+
     if (first != last) {
         SYSTRACE_VALUE32("commandCount", last - first);
 
@@ -747,6 +814,10 @@ void RenderPass::Executor::execute(backend::DriverApi& driver,
         FMaterial const* UTILS_RESTRICT ma = nullptr;
         auto const* UTILS_RESTRICT pCustomCommands = mCustomCommands.data();
 
+        // per-renderable uniform range bound by the previous command
+        Handle<HwBufferObject> boundUboHandle;
+        uint32_t boundUboOffset = 0;
+
         first--;
         while (++first != last) {
             assert_invariant(first->key != uint64_t(Pass::SENTINEL));
@@ -759,6 +830,9 @@ void RenderPass::Executor::execute(backend::DriverApi& driver,
                 uint32_t const index = (first->key & CUSTOM_INDEX_MASK) >> CUSTOM_INDEX_SHIFT;
                 assert_invariant(index < mCustomCommands.size());
                 pCustomCommands[index]();
+                // a custom command may bind anything
+                mi = nullptr;
+                boundUboHandle.clear();
                 continue;
             }
 
@@ -808,20 +882,30 @@ void RenderPass::Executor::execute(backend::DriverApi& driver,
                 mi->use(driver);
             }
 
+            // don't wait for a program that is still compiling in the background, if allowed
+            if (UTILS_UNLIKELY(skipPendingPrograms && !ma->isProgramReady(info.materialVariant))) {
+                continue;
+            }
+
             pipeline.program = ma->getProgram(info.materialVariant);
 
-            // bind per-renderable uniform block. there is no need to attempt to skip this command
-            // because the backends already do this.
+            // bind per-renderable uniform block, unless the previous command (e.g. another
+            // primitive of the same renderable) already did.
             bool const userInstancing = (info.instanceCount & PrimitiveInfo::USER_INSTANCE_MASK) != 0u;
             uint16_t const instanceCount = info.instanceCount & PrimitiveInfo::INSTANCE_COUNT_MASK;
             auto const perObjectUboHandle = (!userInstancing && instanceCount > 1)
                                       ? mInstancedUboHandle : uboHandle;
             assert_invariant(perObjectUboHandle);
-            driver.bindBufferRange(BufferObjectBinding::UNIFORM,
-                    +UniformBindingPoints::PER_RENDERABLE,
-                    perObjectUboHandle,
-                    info.index * sizeof(PerRenderableData),
-                    sizeof(PerRenderableUib));
+            uint32_t const perObjectUboOffset = info.index * sizeof(PerRenderableData);
+            if (perObjectUboHandle != boundUboHandle || perObjectUboOffset != boundUboOffset) {
+                boundUboHandle = perObjectUboHandle;
+                boundUboOffset = perObjectUboOffset;
+                driver.bindBufferRange(BufferObjectBinding::UNIFORM,
+                        +UniformBindingPoints::PER_RENDERABLE,
+                        perObjectUboHandle,
+                        perObjectUboOffset,
+                        sizeof(PerRenderableUib));
+            }
 
             if (UTILS_UNLIKELY(info.skinningHandle)) {
                 // note: we can't bind less than sizeof(PerRenderableBoneUib) due to glsl limitations
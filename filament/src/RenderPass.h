@@ -306,6 +306,11 @@ public:
     // Defaults to all 1's, which means all renderables in this render pass will be rendered.
     void setVisibilityMask(FScene::VisibleMaskType mask) noexcept { mVisibilityMask = mask; }
 
+    // Uses the given array instead of the SoA's VISIBLE_MASK, this allows passes sharing the same
+    // renderables to have their own visibility (e.g. shadow maps). The array is indexed like the
+    // SoA and must stay valid until the commands are generated. nullptr restores the default.
+    void setVisibleMasks(FScene::VisibleMaskType const* masks) noexcept { mVisibleMasks = masks; }
+
     Command const* begin() const noexcept { return mCommandBegin; }
     Command const* end() const noexcept { return mCommandEnd; }
     bool empty() const noexcept { return begin() == end(); }
@@ -317,6 +322,15 @@ public:
     // sorts and instanceify commands then trims sentinels
     void sortCommands(FEngine& engine) noexcept;
 
+    // appendCommands() followed by sortCommands(), split in three steps so that the commands of
+    // several RenderPasses sharing the same Arena can be generated concurrently:
+    // - reserveCommands() allocates the commands from the Arena, must be called on the main thread
+    // - generateReservedCommands() generates and sorts them, can be called from any thread
+    // - finalizeCommands() must be called on the main thread, it replaces sortCommands()
+    void reserveCommands(FEngine& engine, CommandTypeFlags commandTypeFlags) noexcept;
+    void generateReservedCommands(FEngine& engine) noexcept;
+    void finalizeCommands(FEngine& engine) noexcept;
+
     // Helper to execute all the commands generated by this RenderPass
     void execute(FEngine& engine, const char* name,
             backend::Handle<backend::HwRenderTarget> renderTarget,
@@ -343,7 +357,7 @@ public:
 
         Executor(RenderPass const* pass, Command const* b, Command const* e) noexcept;
 
-        void execute(backend::DriverApi& driver,
+        void execute(FEngine& engine,
                 const Command* first, const Command* last) const noexcept;
 
     public:
@@ -391,6 +405,9 @@ private:
     Command* append(size_t count) noexcept;
     void resize(size_t count) noexcept;
     void instanceify(FEngine& engine) noexcept;
+    void trimCommands(FEngine& engine) noexcept;
+    void generateReservedCommandsImpl(FEngine& engine) noexcept;
+    static void prepareProgram(Command const* first, Command const* last) noexcept;
 
     // we choose the command count per job to minimize JobSystem overhead.
     // on a Pixel 4, 2048 commands is about half a millisecond of processing.
@@ -404,13 +421,14 @@ private:
     static inline void generateCommands(uint32_t commandTypeFlags, Command* commands,
             FScene::RenderableSoa const& soa, utils::Range<uint32_t> range,
             Variant variant, RenderFlags renderFlags,
-            FScene::VisibleMaskType visibilityMask,
+            FScene::VisibleMaskType visibilityMask, FScene::VisibleMaskType const* visibleMasks,
             math::float3 cameraPosition, math::float3 cameraForward) noexcept;
 
     template<uint32_t commandTypeFlags>
     static inline Command* generateCommandsImpl(uint32_t extraFlags, Command* curr,
             FScene::RenderableSoa const& soa, utils::Range<uint32_t> range,
             Variant variant, RenderFlags renderFlags, FScene::VisibleMaskType visibilityMask,
+            FScene::VisibleMaskType const* visibleMasks,
             math::float3 cameraPosition, math::float3 cameraForward) noexcept;
 
     static void setupColorCommand(Command& cmdDraw, Variant variant,
@@ -453,6 +471,14 @@ private:
     // Additional visibility mask
     FScene::VisibleMaskType mVisibilityMask = std::numeric_limits<FScene::VisibleMaskType>::max();
 
+    // Overrides the SoA's VISIBLE_MASK if not null
+    FScene::VisibleMaskType const* mVisibleMasks = nullptr;
+
+    // commands allocated by reserveCommands(), waiting to be generated
+    Command* mReservedCommands = nullptr;
+    uint32_t mReservedCommandCount = 0;
+    CommandTypeFlags mReservedCommandTypeFlags{};
+
     backend::Viewport mScissorViewport{ 0, 0,
             std::numeric_limits<int32_t>::max(),
             std::numeric_limits<int32_t>::max() };
@@ -40,6 +40,10 @@ void RenderableManager::destroy(utils::Entity e) noexcept {
     return downcast(this)->destroy(e);
 }
 
+void RenderableManager::destroy(utils::Entity const* entities, size_t count) noexcept {
+    downcast(this)->destroy(entities, count);
+}
+
 void RenderableManager::setAxisAlignedBoundingBox(Instance instance, const Box& aabb) noexcept {
     downcast(this)->setAxisAlignedBoundingBox(instance, aabb);
 }
@@ -69,6 +69,14 @@ void Renderer::resetUserTime() {
     downcast(this)->resetUserTime();
 }
 
+float Renderer::getLastFrameGpuTime() const noexcept {
+    return downcast(this)->getLastFrameGpuTime();
+}
+
+uint32_t Renderer::getFrameGpuTimeCount() const noexcept {
+    return downcast(this)->getFrameGpuTimeCount();
+}
+
 void Renderer::setDisplayInfo(const DisplayInfo& info) noexcept {
     downcast(this)->setDisplayInfo(info);
 }
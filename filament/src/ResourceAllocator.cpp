@@ -20,12 +20,9 @@
 
 #include "details/Texture.h"
 
-#include <utils/FixedCapacityVector.h>
 #include <utils/Log.h>
 #include <utils/debug.h>
 
-#include <iterator>
-
 using namespace utils;
 
 namespace filament {
@@ -78,24 +75,13 @@ void ResourceAllocator::AssociativeContainer<K, V, H>::emplace(ARGS&& ... args)
 ResourceAllocatorInterface::~ResourceAllocatorInterface() = default;
 
 size_t ResourceAllocator::TextureKey::getSize() const noexcept {
-    size_t pixelCount = width * height * depth;
-    size_t size = pixelCount * FTexture::getFormatSize(format);
-    size_t s = std::max(uint8_t(1), samples);
-    if (s > 1) {
-        // if we have MSAA, we assume N times the storage
-        size *= s;
-    }
-    if (levels > 1) {
-        // if we have mip-maps we assume the full pyramid
-        size += size / 3;
-    }
     // TODO: this is not taking into account the potential sidecar MS buffer
     //  but we have no way to know about its existence at this point.
-    return size;
+    return FTexture::computeMemorySize(target, levels, format, samples, width, height, depth);
 }
 
-ResourceAllocator::ResourceAllocator(DriverApi& driverApi) noexcept
-        : mBackend(driverApi) {
+ResourceAllocator::ResourceAllocator(DriverApi& driverApi, Config const& config) noexcept
+        : mBackend(driverApi), mConfig(config) {
 }
 
 ResourceAllocator::~ResourceAllocator() noexcept {
@@ -140,6 +126,18 @@ backend::TextureHandle ResourceAllocator::createTexture(const char* name,
     // do we have a suitable texture in the cache?
     TextureHandle handle;
     if constexpr (mEnabled) {
+        // Textures that are never sampled can be larger than requested, because they're only
+        // accessed through render targets of the requested size. Round their size up, so they
+        // can be reused when the requested size changes a bit.
+        constexpr TextureUsage sampledUsage =
+                TextureUsage::SAMPLEABLE | TextureUsage::UPLOADABLE | TextureUsage::SUBPASS_INPUT;
+        uint32_t const granularity = mConfig.sizeGranularity;
+        if (granularity && none(usage & sampledUsage) &&
+                target == SamplerType::SAMPLER_2D && levels == 1) {
+            width  = ((width  + granularity - 1) / granularity) * granularity;
+            height = ((height + granularity - 1) / granularity) * granularity;
+        }
+
         auto& textureCache = mTextureCache;
         const TextureKey key{ name, target, levels, format, samples, width, height, depth, usage, swizzle };
         auto it = textureCache.find(key);
@@ -147,8 +145,11 @@ backend::TextureHandle ResourceAllocator::createTexture(const char* name,
             // we do, move the entry to the in-use list, and remove from the cache
             handle = it->second.handle;
             mCacheSize -= it->second.size;
+            mInUseSize += it->second.size;
             textureCache.erase(it);
+            mStats.hits++;
         } else {
+            mStats.misses++;
             // we don't, allocate a new texture and populate the in-use list
             if (swizzle == defaultSwizzle) {
                 handle = mBackend.createTexture(
@@ -158,6 +159,7 @@ backend::TextureHandle ResourceAllocator::createTexture(const char* name,
                         target, levels, format, samples, width, height, depth, usage,
                         swizzle[0], swizzle[1], swizzle[2], swizzle[3]);
             }
+            mInUseSize += key.getSize();
         }
         mInUseTextures.emplace(handle, key);
     } else {
@@ -185,6 +187,7 @@ void ResourceAllocator::destroyTexture(TextureHandle h) noexcept {
 
         mTextureCache.emplace(key, TextureCachePayload{ h, mAge, size });
         mCacheSize += size;
+        mInUseSize -= size;
 
         // remove it from the in-use list
         mInUseTextures.erase(it);
@@ -204,55 +207,36 @@ void ResourceAllocator::gc() noexcept {
     //      - remove only one entry per gc(),
     //      - unless we're at capacity
     // - remove LRU entries until we're below capacity
+    //
+    // The cache is sorted by age, so all of this happens at its front.
 
     auto& textureCache = mTextureCache;
-    for (auto it = textureCache.begin(); it != textureCache.end();) {
-        const size_t ageDiff = age - it->second.age;
-        if (ageDiff >= CACHE_MAX_AGE) {
-            it = purge(it);
-            if (mCacheSize < CACHE_CAPACITY) {
-                // if we're not at capacity, only purge a single entry per gc, trying to
-                // avoid a burst of work.
-                break;
-            }
-        } else {
-            ++it;
+    if (!textureCache.empty()) {
+        const size_t ageDiff = age - textureCache.begin()->second.age;
+        if (ageDiff >= mConfig.cacheMaxAge) {
+            // only purge a single entry per gc, trying to avoid a burst of work.
+            purge(textureCache.begin());
         }
     }
 
-    if (UTILS_UNLIKELY(mCacheSize >= CACHE_CAPACITY)) {
-        // make a copy of our CacheContainer to a vector
-        using Vector = FixedCapacityVector<std::pair<TextureKey, TextureCachePayload>>;
-        auto cache = Vector::with_capacity(textureCache.size());
-        std::copy(textureCache.begin(), textureCache.end(), std::back_insert_iterator<Vector>(cache));
-
-        // sort by least recently used
-        std::sort(cache.begin(), cache.end(), [](auto const& lhs, auto const& rhs) {
-            return lhs.second.age < rhs.second.age;
-        });
-
-        // now remove entries until we're at capacity
-        auto curr = cache.begin();
-        while (mCacheSize >= CACHE_CAPACITY) {
-            // by construction this entry must exist
-            purge(textureCache.find(curr->first));
-            ++curr;
-        }
+    evict(mConfig.cacheCapacity);
+    //if (mAge % 60 == 0) dump();
+}
 
-        // Since we're sorted already, reset the oldestAge of the whole system
-        size_t oldestAge = cache.front().second.age;
-        for (auto& it : textureCache) {
-            it.second.age -= oldestAge;
-        }
-        mAge -= oldestAge;
+void ResourceAllocator::evict(size_t capacity) noexcept {
+    // the cache is sorted from least to most recently used
+    auto& textureCache = mTextureCache;
+    while (mCacheSize > capacity) {
+        assert_invariant(!textureCache.empty());
+        purge(textureCache.begin());
     }
-    //if (mAge % 60 == 0) dump();
 }
 
 UTILS_NOINLINE
 void ResourceAllocator::dump(bool brief) const noexcept {
     slog.d << "# entries=" << mTextureCache.size() << ", sz=" << mCacheSize / float(1u << 20u)
-           << " MiB" << io::endl;
+           << " MiB, hits=" << mStats.hits << ", misses=" << mStats.misses
+           << ", evictions=" << mStats.evictions << io::endl;
     if (!brief) {
         for (auto const& it : mTextureCache) {
             auto w = it.first.width;
@@ -269,6 +253,7 @@ ResourceAllocator::CacheContainer::iterator ResourceAllocator::purge(
     //slog.d << "purging " << pos->second.handle.getId() << ", age=" << pos->second.age << io::endl;
     mBackend.destroyTexture(pos->second.handle);
     mCacheSize -= pos->second.size;
+    mStats.evictions++;
     return mTextureCache.erase(pos);
 }
 
@@ -62,7 +62,19 @@ protected:
 
 class ResourceAllocator final : public ResourceAllocatorInterface {
 public:
-    explicit ResourceAllocator(backend::DriverApi& driverApi) noexcept;
+    struct Config {
+        size_t cacheCapacity;       // in bytes
+        size_t cacheMaxAge;         // in number of gc() calls, i.e. frames
+        uint32_t sizeGranularity;   // in pixels, 0 to disable (see Engine::Config)
+    };
+
+    struct Stats {
+        size_t hits = 0;            // textures found in the cache
+        size_t misses = 0;          // textures that had to be created
+        size_t evictions = 0;       // cached textures destroyed because of their age or size
+    };
+
+    ResourceAllocator(backend::DriverApi& driverApi, Config const& config) noexcept;
     ~ResourceAllocator() noexcept override;
 
     void terminate() noexcept;
@@ -88,11 +100,32 @@ public:
 
     void gc() noexcept;
 
-private:
-    // TODO: these should be settings of the engine
-    static constexpr size_t CACHE_CAPACITY = 64u << 20u;   // 64 MiB
-    static constexpr size_t CACHE_MAX_AGE  = 30u;
+    // Destroys the least recently used textures of the cache until it's no larger than
+    // `capacity` bytes.
+    void evict(size_t capacity) noexcept;
+
+    Config const& getConfig() const noexcept { return mConfig; }
 
+    Stats const& getStats() const noexcept { return mStats; }
+
+    // Estimated GPU memory held by the cached textures and by the textures in use
+    size_t getCacheSize() const noexcept { return mCacheSize; }
+    size_t getCacheCount() const noexcept { return mTextureCache.size(); }
+    size_t getInUseSize() const noexcept { return mInUseSize; }
+    size_t getInUseCount() const noexcept { return mInUseTextures.size(); }
+
+    // Calls func(const char* name, size_t size, bool cached) for each texture we own
+    template<typename F>
+    void forEachTexture(F func) const noexcept {
+        for (auto const& [key, payload] : mTextureCache) {
+            func(key.name, size_t(payload.size), true);
+        }
+        for (auto const& [handle, key] : mInUseTextures) {
+            func(key.name, key.getSize(), false);
+        }
+    }
+
+private:
     struct TextureKey {
         const char* name; // doesn't participate in the hash
         backend::SamplerType target;
@@ -176,6 +209,7 @@ private:
         using value_type = typename Container::value_type::second_type;
 
         size_t size() const { return mContainer.size(); }
+        bool empty() const { return mContainer.empty(); }
         iterator begin() { return mContainer.begin(); }
         const_iterator begin() const { return mContainer.begin(); }
         iterator end() { return mContainer.end(); }
@@ -193,10 +227,15 @@ private:
     CacheContainer::iterator purge(CacheContainer::iterator const& pos);
 
     backend::DriverApi& mBackend;
+    const Config mConfig;
+    Stats mStats;
+    // Textures are appended to the cache when they're released, and removed from anywhere when
+    // they're reused, so it's always sorted from least to most recently used.
     CacheContainer mTextureCache;
     InUseContainer mInUseTextures;
     size_t mAge = 0;
     uint32_t mCacheSize = 0;
+    uint32_t mInUseSize = 0;
     static constexpr bool mEnabled = true;
 };
 
@@ -73,6 +73,7 @@ void ShadowMap::initialize(size_t lightIndex, ShadowType shadowType,
     mLightIndex = lightIndex;
     mShadowIndex = shadowIndex;
     mOptions = options;
+    mTextureDimension = uint16_t(options->mapSize);
     mShadowType = shadowType;
     mFace = face;
 }
@@ -115,6 +116,10 @@ ShadowMap::ShaderParameters ShadowMap::updateDirectional(FEngine& engine,
         ShadowMapInfo const& shadowMapInfo,
         SceneInfo const& sceneInfo) noexcept {
 
+    // the quality governor may render the shadow map smaller than requested
+    assert_invariant(shadowMapInfo.textureDimension <= shadowMapInfo.atlasDimension);
+    mTextureDimension = shadowMapInfo.textureDimension;
+
     // Note: we keep the polygon offset even with VSM as it seems to help.
     auto& lcm = engine.getLightManager();
     FLightManager::Instance const li = lightData.elementAt<FScene::LIGHT_INSTANCE>(index);
@@ -430,7 +435,9 @@ ShadowMap::ShaderParameters ShadowMap::updatePunctual(
         const ShadowMapInfo& shadowMapInfo, const FLightManager::ShadowParams& params) noexcept {
     const mat4f Mp = mat4f::perspective(outerConeAngle * f::RAD_TO_DEG * 2.0f, 1.0f, nearPlane, farPlane);
 
-    assert_invariant(shadowMapInfo.textureDimension == mOptions->mapSize);
+    // the quality governor may render the shadow map smaller than requested
+    assert_invariant(shadowMapInfo.textureDimension <= shadowMapInfo.atlasDimension);
+    mTextureDimension = shadowMapInfo.textureDimension;
 
     // Final shadow transform
     const backend::Viewport viewport = getViewport();
@@ -524,15 +531,14 @@ ShadowMap::ShaderParameters ShadowMap::updateSpot(FEngine& engine,
 
 ShadowMap::ShaderParameters ShadowMap::updatePoint(FEngine& engine,
         const FScene::LightSoa& lightData, size_t index, filament::CameraInfo const&,
-        const ShadowMapInfo& shadowMapInfo, FScene const& scene, uint8_t face) noexcept {
+        const ShadowMapInfo& shadowMapInfo, FScene::VisibleMaskType const* visibleMasks,
+        utils::Range<uint32_t> range, uint8_t face) noexcept {
 
     // check if this shadow map has anything to render
     mHasVisibleShadows = false;
-    FScene::RenderableSoa const& UTILS_RESTRICT soa = scene.getRenderableData();
-    auto const* const UTILS_RESTRICT visibleMasks = soa.data<FScene::VISIBLE_MASK>();
-    size_t const c = soa.size();
-    for (size_t i = 0; i < c; i++) {
-        if (visibleMasks[i] & VISIBLE_DYN_SHADOW_RENDERABLE) {
+    FScene::VisibleMaskType const faceMask = FScene::VisibleMaskType(1u << face);
+    for (uint32_t i = range.first; i < range.last; i++) {
+        if (visibleMasks[i] & faceMask) {
             mHasVisibleShadows = true;
             break;
         }
@@ -1219,7 +1225,7 @@ void ShadowMap::updateSceneInfoSpot(mat4f const& Mv, FScene const& scene,
 backend::Viewport ShadowMap::getViewport() const noexcept {
     // We set a viewport with a 1-texel border for when we index outside the
     // texture. This can only happen for the directional light when "focus shadow casters is used".
-    const uint32_t dim = mOptions->mapSize;
+    const uint32_t dim = mTextureDimension;
     const uint16_t border = 1u;
     return { border, border, dim - 2u * border, dim - 2u * border };
 }
@@ -1227,7 +1233,7 @@ backend::Viewport ShadowMap::getViewport() const noexcept {
 backend::Viewport ShadowMap::getScissor() const noexcept {
     // We set a viewport with a 1-texel border for when we index outside the
     // texture. This can only happen for the directional light when "focus shadow casters is used".
-    const uint32_t dim = mOptions->mapSize;
+    const uint32_t dim = mTextureDimension;
     const uint16_t border = 1u;
 
     switch (mShadowType) {
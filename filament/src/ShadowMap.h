@@ -149,9 +149,12 @@ public:
             const ShadowMapInfo& shadowMapInfo, FScene const& scene,
             SceneInfo sceneInfo) noexcept;
 
+    // visibleMasks holds the cubemap faces each renderable in range is visible from (one bit
+    // per face), indexed like the scene's RenderableSoa. It's shared by the six faces.
     ShadowMap::ShaderParameters updatePoint(FEngine& engine,
             const FScene::LightSoa& lightData, size_t index, filament::CameraInfo const& camera,
-            const ShadowMapInfo& shadowMapInfo, FScene const& scene, uint8_t face) noexcept;
+            const ShadowMapInfo& shadowMapInfo, FScene::VisibleMaskType const* visibleMasks,
+            utils::Range<uint32_t> range, uint8_t face) noexcept;
 
     // Do we have visible shadows. Valid after calling update().
     bool hasVisibleShadows() const noexcept { return mHasVisibleShadows; }
@@ -174,6 +177,7 @@ public:
     uint16_t getShadowIndex() const { return mShadowIndex; }
     void setLayer(uint8_t layer) noexcept { mLayer = layer; }
     uint8_t getLayer() const noexcept { return mLayer; }
+    // viewport and scissor within our layer, which has the size given to the last update*() call
     backend::Viewport getViewport() const noexcept;
     backend::Viewport getScissor() const noexcept;
 
@@ -313,6 +317,7 @@ private:
     LightManager::ShadowOptions const* mOptions = nullptr;                  // 8
     uint32_t mLightIndex = 0;   // which light are we shadowing             // 4
     uint16_t mShadowIndex = 0;  // our index in the shadowMap vector        // 2
+    uint16_t mTextureDimension = 0; // our size in the shadowMap texture    // 2
     uint8_t mLayer = 0;         // our layer in the shadowMap texture       // 1
     ShadowType mShadowType  : 2;                                            // :2
     bool mHasVisibleShadows : 2;                                            // :2
@@ -26,6 +26,9 @@
 
 #include <utils/debug.h>
 #include <utils/FixedCapacityVector.h>
+#include <utils/JobSystem.h>
+
+#include <algorithm>
 
 namespace filament {
 
@@ -48,6 +51,10 @@ ShadowMapManager::ShadowMapManager(FEngine& engine)
             &engine.debug.shadowmap.visualize_cascades);
     debugRegistry.registerProperty("d.shadowmap.tightly_bound_scene",
             &engine.debug.shadowmap.tightly_bound_scene);
+    debugRegistry.registerProperty("d.shadowmap.pass_count",
+            &engine.debug.shadowmap.pass_count);
+    debugRegistry.registerProperty("d.shadowmap.draw_count",
+            &engine.debug.shadowmap.draw_count);
 }
 
 ShadowMapManager::~ShadowMapManager() {
@@ -210,84 +217,177 @@ FrameGraphId<FrameGraphTexture> ShadowMapManager::render(FEngine& engine, FrameG
                 scene, mainCameraInfo, userTime, passTemplate = pass](
                     FrameGraphResources const&, auto const& data, DriverApi& driver) {
 
-                // Note: we could almost parallel_for the loop below, the problem currently is
-                // that updatePrimitivesLod() updates temporary global state.
-                // prepareSpotShadowMap() also update the visibility of renderable. These two
-                // pieces of state are needed only until shadowMap.render() returns.
-                // Conceptually, we could store this out-of-band.
+                utils::JobSystem& js = engine.getJobSystem();
+                FScene::RenderableSoa& renderableData = scene->getRenderableData();
+                auto const& passList = data.passList;
+
+                // updatePrimitivesLod must be run before RenderPass::appendCommands. It doesn't
+                // depend on the shadow map (yet), so it's done once for each range of casters,
+                // otherwise it would need to be stored out-of-band like the visibility below.
+                utils::Range<uint32_t> lodRange{};
+                for (auto const& entry : passList) {
+                    if (entry.range.first != lodRange.first || entry.range.last != lodRange.last) {
+                        lodRange = entry.range;
+                        view.updatePrimitivesLod(engine, mainCameraInfo, renderableData, lodRange);
+                    }
+                }
 
-                // Generate a RenderPass for each shadow map
-                for (auto const& entry : data.passList) {
-                    ShadowMap& shadowMap = *entry.shadowMap;
+                // Cull and update the spot and point shadow maps. Each spot light, and each point
+                // light (its six faces are culled at once), has its own visibility mask array and
+                // UBO entries, so they're all processed in parallel.
+                // The directional shadow maps come first in passList and are already up-to-date.
+                auto const firstSpot = std::find_if(passList.begin(), passList.end(),
+                        [](auto const& entry) {
+                            return !entry.shadowMap->isDirectionalShadow();
+                        });
+                size_t const spotCount = passList.end() - firstSpot;
+                size_t const visibleMasksStride = spotCount ? firstSpot->range.first +
+                        FScene::RenderableSoa::getPaddedSize(firstSpot->range.size()) : 0;
+
+                // the faces of a point light are consecutive, they form a single group and share
+                // the same visibility masks (one bit per face).
+                auto groups = utils::FixedCapacityVector<uint32_t>::with_capacity(spotCount + 1);
+                auto groupOfSpot = utils::FixedCapacityVector<uint32_t>::with_capacity(spotCount);
+                for (size_t i = 0; i < spotCount; i++) {
+                    ShadowMap const& shadowMap = *firstSpot[i].shadowMap;
+                    bool const isSameLight = !groups.empty() &&
+                            shadowMap.getShadowType() == ShadowType::POINT &&
+                            firstSpot[groups.back()].shadowMap->getShadowType() ==
+                                    ShadowType::POINT &&
+                            firstSpot[groups.back()].shadowMap->getLightIndex() ==
+                                    shadowMap.getLightIndex();
+                    if (!isSameLight) {
+                        groups.push_back(uint32_t(i));
+                    }
+                    groupOfSpot.push_back(uint32_t(groups.size() - 1));
+                }
+                size_t const groupCount = groups.size();
+                groups.push_back(uint32_t(spotCount));
+
+                if (groupCount) {
+                    if (mSpotVisibleMasks.size() < groupCount * visibleMasksStride) {
+                        mSpotVisibleMasks.resize(groupCount * visibleMasksStride);
+                    }
+                    ShadowUib& shadowUib = mShadowUb.edit();
+                    auto work = [this, &engine, &view, &mainCameraInfo, &renderableData,
+                            &shadowUib, &groups, scene, firstSpot, visibleMasksStride](
+                            uint32_t first, uint32_t count) {
+                        auto const& lightData = scene->getLightData();
+                        for (uint32_t g = first; g < first + count; g++) {
+                            FScene::VisibleMaskType* const visibleMasks =
+                                    mSpotVisibleMasks.data() + g * visibleMasksStride;
+                            auto const& entry = firstSpot[groups[g]];
+                            ShadowMap& shadowMap = *entry.shadowMap;
+                            if (shadowMap.getShadowType() == ShadowType::SPOT) {
+                                prepareSpotShadowMap(shadowMap, engine, view, mainCameraInfo,
+                                        renderableData, entry.range, lightData,
+                                        mSceneInfo, visibleMasks, shadowUib);
+                                continue;
+                            }
+                            const size_t lightIndex = shadowMap.getLightIndex();
+                            const float4 positionRadius =
+                                    lightData.elementAt<FScene::POSITION_RADIUS>(lightIndex);
+                            cullPointShadowCasters(positionRadius.xyz, positionRadius.w,
+                                    view.getVisibleLayers(), renderableData, entry.range,
+                                    visibleMasks);
+                            for (uint32_t i = groups[g]; i < groups[g + 1]; i++) {
+                                preparePointShadowMap(*firstSpot[i].shadowMap, engine, view,
+                                        mainCameraInfo, entry.range, lightData,
+                                        visibleMasks, shadowUib);
+                            }
+                        }
+                    };
+                    auto* jobCullShadowMaps = utils::jobs::parallel_for(js, nullptr,
+                            0, uint32_t(groupCount), std::cref(work),
+                            utils::jobs::CountSplitter<1, 5>());
+                    js.runAndWait(jobCullShadowMaps);
+                }
 
-                    // for spot shadow map, we need to do the culling
-                    switch (shadowMap.getShadowType()) {
-                        case ShadowType::DIRECTIONAL:
-                            break;
-                        case ShadowType::SPOT:
-                            prepareSpotShadowMap(shadowMap, engine, view, mainCameraInfo,
-                                    scene->getRenderableData(), entry.range,
-                                    scene->getLightData(), mSceneInfo);
-                            break;
-                        case ShadowType::POINT:
-                            preparePointShadowMap(shadowMap, engine, view, mainCameraInfo,
-                                    scene->getRenderableData(), entry.range,
-                                    scene->getLightData(), mSceneInfo);
-                            break;
+                // Reserve the commands of each shadow map's RenderPass and update their UBOs,
+                // this must be done on this thread.
+                // Note: this can generate a lot of commands that come out of the
+                //       "per frame command arena". The allocation persists until the
+                //       end of the frame.
+                //       One way to possibly mitigate this, would be to always use the
+                //       same command buffer for all shadow map, but then we'd generate
+                //       a lot of unneeded draw calls.
+                //       To do this efficiently, we'd need a way to cull draw calls already
+                //       recorded in the command buffer, per shadow map.
+                auto passes = utils::FixedCapacityVector<RenderPass>::with_capacity(
+                        passList.size());
+                auto passEntries = utils::FixedCapacityVector<size_t>::with_capacity(
+                        passList.size());
+                for (size_t i = 0, c = passList.size(); i < c; i++) {
+                    auto const& entry = passList[i];
+                    ShadowMap& shadowMap = *entry.shadowMap;
+                    if (!shadowMap.hasVisibleShadows()) {
+                        continue;
                     }
 
-                    if (shadowMap.hasVisibleShadows()) {
-                        // Note: this loop can generate a lot of commands that come out of the
-                        //       "per frame command arena". The allocation persists until the
-                        //       end of the frame.
-                        //       One way to possibly mitigate this, would be to always use the
-                        //       same command buffer for all shadow map, but then we'd generate
-                        //       a lot of unneeded draw calls.
-                        //       To do this efficiently, we'd need a way to cull draw calls already
-                        //       recorded in the command buffer, per shadow map.
-
-
-                        // cameraInfo only valid after calling update
-                        const CameraInfo cameraInfo{ shadowMap.getCamera() };
-
-                        auto transaction = ShadowMap::open(driver);
-                        ShadowMap::prepareCamera(transaction, engine, cameraInfo);
-                        ShadowMap::prepareViewport(transaction, shadowMap.getViewport());
-                        ShadowMap::prepareTime(transaction, engine, userTime);
-                        ShadowMap::prepareShadowMapping(transaction,
-                                vsmShadowOptions.highPrecision);
-                        shadowMap.commit(transaction, driver);
-
-                        // updatePrimitivesLod must be run before RenderPass::appendCommands.
-                        view.updatePrimitivesLod(engine,
-                                cameraInfo, scene->getRenderableData(), entry.range);
-
-                        // generate and sort the commands for rendering the shadow map
-                        RenderPass pass(passTemplate);
-                        pass.setCamera(cameraInfo);
-                        pass.setVisibilityMask(entry.visibilityMask);
-                        pass.setGeometry(scene->getRenderableData(),
-                                entry.range, scene->getRenderableUBO());
-                        pass.appendCommands(engine, RenderPass::SHADOW);
-                        pass.sortCommands(engine);
-
-                        entry.executor = pass.getExecutor();
-
-                        if (!view.hasVSM()) {
-                            auto const* options = shadowMap.getShadowOptions();
-                            const PolygonOffset polygonOffset = { // handle reversed Z
-                                    .slope    = -options->polygonOffsetSlope,
-                                    .constant = -options->polygonOffsetConstant
-                            };
-                            entry.executor.overridePolygonOffset(&polygonOffset);
+                    // cameraInfo only valid after calling update
+                    const CameraInfo cameraInfo{ shadowMap.getCamera() };
+
+                    auto transaction = ShadowMap::open(driver);
+                    ShadowMap::prepareCamera(transaction, engine, cameraInfo);
+                    ShadowMap::prepareViewport(transaction, shadowMap.getViewport());
+                    ShadowMap::prepareTime(transaction, engine, userTime);
+                    ShadowMap::prepareShadowMapping(transaction,
+                            vsmShadowOptions.highPrecision);
+                    shadowMap.commit(transaction, driver);
+
+                    RenderPass& pass = passes.emplace_back(passTemplate);
+                    pass.setCamera(cameraInfo);
+                    pass.setVisibilityMask(entry.visibilityMask);
+                    if (!shadowMap.isDirectionalShadow()) {
+                        size_t const group = groupOfSpot[&entry - firstSpot];
+                        pass.setVisibleMasks(
+                                mSpotVisibleMasks.data() + group * visibleMasksStride);
+                        if (shadowMap.getShadowType() == ShadowType::POINT) {
+                            pass.setVisibilityMask(
+                                    FScene::VisibleMaskType(1u << shadowMap.getFace()));
                         }
                     }
+                    pass.setGeometry(renderableData, entry.range, scene->getRenderableUBO());
+                    pass.reserveCommands(engine, RenderPass::SHADOW);
+                    passEntries.push_back(i);
                 }
 
+                // generate and sort the commands for rendering all the shadow maps in parallel
+                auto generateWork = [&engine, &passes](uint32_t first, uint32_t count) {
+                    for (uint32_t i = first; i < first + count; i++) {
+                        passes[i].generateReservedCommands(engine);
+                    }
+                };
+                auto* jobGenerateCommands = utils::jobs::parallel_for(js, nullptr,
+                        0, uint32_t(passes.size()), std::cref(generateWork),
+                        utils::jobs::CountSplitter<1, 5>());
+                js.runAndWait(jobGenerateCommands);
+
+                size_t drawCount = 0;
+                for (size_t i = 0, c = passes.size(); i < c; i++) {
+                    auto const& entry = passList[passEntries[i]];
+                    RenderPass& pass = passes[i];
+                    pass.finalizeCommands(engine);
+                    drawCount += pass.end() - pass.begin();
+
+                    entry.executor = pass.getExecutor();
+
+                    if (!view.hasVSM()) {
+                        auto const* options = entry.shadowMap->getShadowOptions();
+                        const PolygonOffset polygonOffset = { // handle reversed Z
+                                .slope    = -options->polygonOffsetSlope,
+                                .constant = -options->polygonOffsetConstant
+                        };
+                        entry.executor.overridePolygonOffset(&polygonOffset);
+                    }
+                }
+
+                engine.debug.shadowmap.pass_count = int(passes.size());
+                engine.debug.shadowmap.draw_count = int(drawCount);
+
                 // Finally update our UBO in one batch
                 if (mShadowUb.isDirty()) {
-                    driver.updateBufferObject(mShadowUbh,
-                            mShadowUb.toBufferDescriptor(driver), 0);
+                    mShadowUb.commit(driver, mShadowUbh, engine.prefersPartialBufferUpdates());
                 }
             });
 
@@ -443,11 +543,12 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::updateCascadeShadowMaps(FEng
     FLightManager::Instance const directionalLight = lightData.elementAt<FScene::LIGHT_INSTANCE>(0);
     FLightManager::ShadowOptions const& options = lcm.getShadowOptions(directionalLight);
     FLightManager::ShadowParams const& params = lcm.getShadowParams(directionalLight);
+    const uint32_t mapSize = getShadowMapSize(view, options);
 
     const ShadowMap::ShadowMapInfo shadowMapInfo{
             .atlasDimension      = mTextureAtlasRequirements.size,
-            .textureDimension    = uint16_t(options.mapSize),
-            .shadowDimension     = uint16_t(options.mapSize - 2u),
+            .textureDimension    = uint16_t(mapSize),
+            .shadowDimension     = uint16_t(mapSize - 2u),
             .textureSpaceFlipped = engine.getBackend() == Backend::METAL ||
                                    engine.getBackend() == Backend::VULKAN,
             .vsm                 = view.hasVSM()
@@ -603,7 +704,7 @@ void ShadowMapManager::updateSpotVisibilityMasks(
     // __restrict__ seems to only be taken into account as function parameters. This is very
     // important here, otherwise, this loop doesn't get vectorized.
     // This is vectorized 16x.
-    count = (count + 0xFu) & ~0xFu; // capacity guaranteed to be multiple of 16
+    count = FScene::RenderableSoa::getPaddedSize(count); // always within the SoA's capacity
     for (size_t i = 0; i < count; ++i) {
         const Culler::result_type mask = visibleMask[i];
         const FRenderableManager::Visibility v = visibility[i];
@@ -619,10 +720,63 @@ void ShadowMapManager::updateSpotVisibilityMasks(
     }
 }
 
+void ShadowMapManager::cullSpotShadowCasters(Frustum const& frustum, uint8_t visibleLayers,
+        FScene::RenderableSoa const& renderableData, utils::Range<uint32_t> range,
+        FScene::VisibleMaskType* visibleMasks) noexcept {
+    // start from the renderables' visibility computed by the view, the culler and
+    // updateSpotVisibilityMasks() only update the VISIBLE_DYN_SHADOW_RENDERABLE bit.
+    std::copy_n(renderableData.data<FScene::VISIBLE_MASK>() + range.first, range.size(),
+            visibleMasks + range.first);
+
+    // Cull shadow casters
+    float3 const* worldAABBCenter = renderableData.data<FScene::WORLD_AABB_CENTER>();
+    float3 const* worldAABBExtent = renderableData.data<FScene::WORLD_AABB_EXTENT>();
+    Culler::intersects(
+            visibleMasks + range.first,
+            frustum,
+            worldAABBCenter + range.first,
+            worldAABBExtent + range.first,
+            range.size(),
+            VISIBLE_DYN_SHADOW_RENDERABLE_BIT);
+
+    // update their visibility mask
+    uint8_t const* layers = renderableData.data<FScene::LAYERS>();
+    auto const* visibility = renderableData.data<FScene::VISIBILITY_STATE>();
+    updateSpotVisibilityMasks(
+            visibleLayers,
+            layers + range.first,
+            visibility + range.first,
+            visibleMasks + range.first,
+            range.size());
+}
+
+void ShadowMapManager::updateShadowData(ShadowUib::ShadowData& shadowData,
+        ShadowMap const& shadowMap, ShadowMap::ShaderParameters const& shaderParameters, bool vsm,
+        SoftShadowOptions const& softShadowOptions) noexcept {
+    FLightManager::ShadowOptions const* const options = shadowMap.getShadowOptions();
+    const float wsTexelSizeAtOneMeter = shaderParameters.texelSizeAtOneMeterWs;
+    // note: normalBias is set to zero for VSM
+    const float normalBias = vsm ? 0.0f : options->normalBias;
+
+    const double n = shadowMap.getCamera().getNear();
+    const double f = shadowMap.getCamera().getCullingFar();
+    shadowData.layer = shadowMap.getLayer();
+    shadowData.lightFromWorldMatrix = shaderParameters.lightSpace;
+    shadowData.scissorNormalized = shaderParameters.scissorNormalized;
+    shadowData.normalBias = normalBias * wsTexelSizeAtOneMeter;
+    shadowData.lightFromWorldZ = shaderParameters.lightFromWorldZ;
+    shadowData.texelSizeAtOneMeter = wsTexelSizeAtOneMeter;
+    shadowData.nearOverFarMinusNear = float(n / (f - n));
+    shadowData.elvsm = options->vsm.elvsm;
+    shadowData.bulbRadiusLs =
+            softShadowOptions.penumbraScale * options->shadowBulbRadius / wsTexelSizeAtOneMeter;
+}
+
 void ShadowMapManager::prepareSpotShadowMap(ShadowMap& shadowMap,
-        FEngine& engine, FView& view, CameraInfo const& mainCameraInfo,
-        FScene::RenderableSoa& renderableData, utils::Range<uint32_t> range,
-        FScene::LightSoa& lightData, ShadowMap::SceneInfo const& sceneInfo) noexcept {
+        FEngine& engine, FView const& view, CameraInfo const& mainCameraInfo,
+        FScene::RenderableSoa const& renderableData, utils::Range<uint32_t> range,
+        FScene::LightSoa const& lightData, ShadowMap::SceneInfo const& sceneInfo,
+        FScene::VisibleMaskType* visibleMasks, ShadowUib& shadowUib) const noexcept {
     auto& lcm = engine.getLightManager();
 
     const size_t lightIndex = shadowMap.getLightIndex();
@@ -643,33 +797,14 @@ void ShadowMapManager::prepareSpotShadowMap(ShadowMap& shadowMap,
     const mat4f MpMv = math::highPrecisionMultiply(Mp, Mv);
     const Frustum frustum(MpMv);
 
-    // Cull shadow casters
-    float3 const* worldAABBCenter = renderableData.data<FScene::WORLD_AABB_CENTER>();
-    float3 const* worldAABBExtent = renderableData.data<FScene::WORLD_AABB_EXTENT>();
-    FScene::VisibleMaskType* visibleArray = renderableData.data<FScene::VISIBLE_MASK>();
-    Culler::intersects(
-            visibleArray + range.first,
-            frustum,
-            worldAABBCenter + range.first,
-            worldAABBExtent + range.first,
-            range.size(),
-            VISIBLE_DYN_SHADOW_RENDERABLE_BIT);
-
-    // update their visibility mask
-    uint8_t const* layers = renderableData.data<FScene::LAYERS>();
-    auto const* visibility = renderableData.data<FScene::VISIBILITY_STATE>();
-    updateSpotVisibilityMasks(
-            view.getVisibleLayers(),
-            layers + range.first,
-            visibility + range.first,
-            visibleArray + range.first,
-            range.size());
+    cullSpotShadowCasters(frustum, view.getVisibleLayers(), renderableData, range, visibleMasks);
 
     // update the shadow map frustum/camera
+    const uint32_t mapSize = getShadowMapSize(view, *options);
     const ShadowMap::ShadowMapInfo shadowMapInfo{
             .atlasDimension      = mTextureAtlasRequirements.size,
-            .textureDimension    = uint16_t(options->mapSize),
-            .shadowDimension     = uint16_t(options->mapSize - 2u),
+            .textureDimension    = uint16_t(mapSize),
+            .shadowDimension     = uint16_t(mapSize - 2u),
             .textureSpaceFlipped = engine.getBackend() == Backend::METAL ||
                                    engine.getBackend() == Backend::VULKAN,
             .vsm                 = view.hasVSM()
@@ -680,107 +815,82 @@ void ShadowMapManager::prepareSpotShadowMap(ShadowMap& shadowMap,
 
     // and if we need to generate it, update all the UBO data
     if (shadowMap.hasVisibleShadows()) {
-        const size_t shadowIndex = shadowMap.getShadowIndex();
-        const float wsTexelSizeAtOneMeter = shaderParameters.texelSizeAtOneMeterWs;
-        // note: normalBias is set to zero for VSM
-        const float normalBias = shadowMapInfo.vsm ? 0.0f : options->normalBias;
-
-        auto& s = mShadowUb.edit();
-        const double n = shadowMap.getCamera().getNear();
-        const double f = shadowMap.getCamera().getCullingFar();
-        s.shadows[shadowIndex].layer = shadowMap.getLayer();
-        s.shadows[shadowIndex].lightFromWorldMatrix = shaderParameters.lightSpace;
-        s.shadows[shadowIndex].scissorNormalized = shaderParameters.scissorNormalized;
-        s.shadows[shadowIndex].normalBias = normalBias * wsTexelSizeAtOneMeter;
-        s.shadows[shadowIndex].lightFromWorldZ = shaderParameters.lightFromWorldZ;
-        s.shadows[shadowIndex].texelSizeAtOneMeter = wsTexelSizeAtOneMeter;
-        s.shadows[shadowIndex].nearOverFarMinusNear = float(n / (f - n));
-        s.shadows[shadowIndex].elvsm = options->vsm.elvsm;
-        s.shadows[shadowIndex].bulbRadiusLs =
-                mSoftShadowOptions.penumbraScale * options->shadowBulbRadius
-                        / wsTexelSizeAtOneMeter;
+        updateShadowData(shadowUib.shadows[shadowMap.getShadowIndex()], shadowMap,
+                shaderParameters, shadowMapInfo.vsm, mSoftShadowOptions);
+    }
+}
+
+void ShadowMapManager::cullPointShadowCasters(float3 position, float radius,
+        uint8_t visibleLayers,
+        FScene::RenderableSoa const& renderableData, utils::Range<uint32_t> range,
+        FScene::VisibleMaskType* UTILS_RESTRICT visibleMasks) noexcept {
+    using Type = FScene::VisibleMaskType;
+    constexpr Type ALL_FACES = 0x3F;
+
+    float3 const* const UTILS_RESTRICT worldAABBCenter =
+            renderableData.data<FScene::WORLD_AABB_CENTER>();
+    float3 const* const UTILS_RESTRICT worldAABBExtent =
+            renderableData.data<FScene::WORLD_AABB_EXTENT>();
+    uint8_t const* const UTILS_RESTRICT layers = renderableData.data<FScene::LAYERS>();
+    auto const* const UTILS_RESTRICT visibility = renderableData.data<FScene::VISIBILITY_STATE>();
+
+    for (uint32_t i = range.first; i < range.last; i++) {
+        // the box, relative to the light
+        float3 const c = worldAABBCenter[i] - position;
+        float3 const e = worldAABBExtent[i];
+        float3 const lo = c - e;
+        float3 const hi = c + e;
+
+        // the box intersects the light's sphere if its closest point is within the radius
+        float3 const d = max(abs(c) - e, float3(0));
+        bool const inSphere = dot(d, d) <= radius * radius;
+
+        // The frustum of a face, e.g. +X, is bounded by the planes x = ±y and x = ±z, so the
+        // box overlaps it if max(x) >= max(min(y), -max(y), min(z), -max(z)); faces are
+        // ordered +X, -X, +Y, -Y, +Z, -Z like TextureCubemapFace.
+        Type faces = 0;
+        for (size_t a = 0; a < 3; a++) {
+            size_t const u = (a + 1) % 3;
+            size_t const v = (a + 2) % 3;
+            float const m = std::max(std::max(lo[u], -hi[u]), std::max(lo[v], -hi[v]));
+            faces |= Type(hi[a] >= m) << (2 * a);
+            faces |= Type(-lo[a] >= m) << (2 * a + 1);
+        }
 
+        FRenderableManager::Visibility const v = visibility[i];
+        bool const isCaster = v.castShadows && (layers[i] & visibleLayers);
+        Type const culledFaces = v.culling ? (inSphere ? faces : Type(0)) : ALL_FACES;
+        visibleMasks[i] = isCaster ? culledFaces : Type(0);
     }
 }
 
 void ShadowMapManager::preparePointShadowMap(ShadowMap& shadowMap,
-        FEngine& engine, FView& view, CameraInfo const& mainCameraInfo,
-        FScene::RenderableSoa& renderableData, utils::Range<uint32_t> range,
-        FScene::LightSoa& lightData,
-        ShadowMap::SceneInfo const& sceneInfo) noexcept {
+        FEngine& engine, FView const& view, CameraInfo const& mainCameraInfo,
+        utils::Range<uint32_t> range, FScene::LightSoa const& lightData,
+        FScene::VisibleMaskType const* visibleMasks, ShadowUib& shadowUib) const noexcept {
 
     const uint8_t face = shadowMap.getFace();
     const size_t lightIndex = shadowMap.getLightIndex();
     FLightManager::ShadowOptions const* const options = shadowMap.getShadowOptions();
 
-    // compute the frustum for this light
-    // for spotlights, we cull shadow casters first because we already know the frustum,
-    // this will help us find better near/far plane later
-    const auto position = lightData.elementAt<FScene::POSITION_RADIUS>(lightIndex).xyz;
-    const auto radius = lightData.elementAt<FScene::POSITION_RADIUS>(lightIndex).w;
-
-    // compute shadow map frustum for culling
-    const mat4f Mv = ShadowMap::getPointLightViewMatrix(TextureCubemapFace(face), position);
-    const mat4f Mp = mat4f::perspective(90.0f, 1.0f, 0.01f, radius);
-    const Frustum frustum{ math::highPrecisionMultiply(Mp, Mv) };
-
-    // Cull shadow casters
-    float3 const* worldAABBCenter = renderableData.data<FScene::WORLD_AABB_CENTER>();
-    float3 const* worldAABBExtent = renderableData.data<FScene::WORLD_AABB_EXTENT>();
-    FScene::VisibleMaskType* visibleArray = renderableData.data<FScene::VISIBLE_MASK>();
-    Culler::intersects(
-            visibleArray + range.first,
-            frustum,
-            worldAABBCenter + range.first,
-            worldAABBExtent + range.first,
-            range.size(),
-            VISIBLE_DYN_SHADOW_RENDERABLE_BIT);
-
-    // update their visibility mask
-    uint8_t const* layers = renderableData.data<FScene::LAYERS>();
-    auto const* visibility = renderableData.data<FScene::VISIBILITY_STATE>();
-    updateSpotVisibilityMasks(
-            view.getVisibleLayers(),
-            layers + range.first,
-            visibility + range.first,
-            visibleArray + range.first,
-            range.size());
-
     // update the shadow map frustum/camera
+    const uint32_t mapSize = getShadowMapSize(view, *options);
     const ShadowMap::ShadowMapInfo shadowMapInfo{
             .atlasDimension      = mTextureAtlasRequirements.size,
-            .textureDimension    = uint16_t(options->mapSize),
-            .shadowDimension     = uint16_t(options->mapSize), // point-lights don't have a border
+            .textureDimension    = uint16_t(mapSize),
+            .shadowDimension     = uint16_t(mapSize), // point-lights don't have a border
             .textureSpaceFlipped = engine.getBackend() == Backend::METAL ||
                                    engine.getBackend() == Backend::VULKAN,
             .vsm                 = view.hasVSM()
     };
 
     auto shaderParameters = shadowMap.updatePoint(mEngine, lightData, lightIndex,
-            mainCameraInfo, shadowMapInfo, *view.getScene(), face);
-
+            mainCameraInfo, shadowMapInfo, visibleMasks, range, face);
 
     // and if we need to generate it, update all the UBO data
     if (shadowMap.hasVisibleShadows()) {
-        const size_t shadowIndex = shadowMap.getShadowIndex();
-        const float wsTexelSizeAtOneMeter = shaderParameters.texelSizeAtOneMeterWs;
-        // note: normalBias is set to zero for VSM
-        const float normalBias = shadowMapInfo.vsm ? 0.0f : options->normalBias;
-
-        auto& s = mShadowUb.edit();
-        const double n = shadowMap.getCamera().getNear();
-        const double f = shadowMap.getCamera().getCullingFar();
-        s.shadows[shadowIndex].layer = shadowMap.getLayer();
-        s.shadows[shadowIndex].lightFromWorldMatrix = shaderParameters.lightSpace;
-        s.shadows[shadowIndex].scissorNormalized = shaderParameters.scissorNormalized;
-        s.shadows[shadowIndex].normalBias = normalBias * wsTexelSizeAtOneMeter;
-        s.shadows[shadowIndex].lightFromWorldZ = shaderParameters.lightFromWorldZ;
-        s.shadows[shadowIndex].texelSizeAtOneMeter = wsTexelSizeAtOneMeter;
-        s.shadows[shadowIndex].nearOverFarMinusNear = float(n / (f - n));
-        s.shadows[shadowIndex].elvsm = options->vsm.elvsm;
-        s.shadows[shadowIndex].bulbRadiusLs =
-                mSoftShadowOptions.penumbraScale * options->shadowBulbRadius
-                        / wsTexelSizeAtOneMeter;
+        updateShadowData(shadowUib.shadows[shadowMap.getShadowIndex()], shadowMap,
+                shaderParameters, shadowMapInfo.vsm, mSoftShadowOptions);
     }
 }
 
@@ -824,6 +934,14 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::updateSpotShadowMaps(FEngine
     return shadowTechnique;
 }
 
+uint32_t ShadowMapManager::getShadowMapSize(FView const& view,
+        FLightManager::ShadowOptions const& options) noexcept {
+    const uint8_t reduction = view.getQualityGovernor().getReduction(
+            QualityGovernor::Effect::SHADOWS);
+    // don't go below 64 texels, unless that's what was asked
+    return std::max(options.mapSize >> reduction, std::min(options.mapSize, 64u));
+}
+
 void ShadowMapManager::calculateTextureRequirements(FEngine&, FView& view,
         FScene::LightSoa const&) noexcept {
 
@@ -836,13 +954,13 @@ void ShadowMapManager::calculateTextureRequirements(FEngine&, FView& view,
     for (auto* pShadowMap : mCascadeShadowMaps) {
         // Shadow map size should be the same for all cascades.
         auto const& options = pShadowMap->getShadowOptions();
-        maxDimension = std::max(maxDimension, options->mapSize);
+        maxDimension = std::max(maxDimension, getShadowMapSize(view, *options));
         elvsm = elvsm || options->vsm.elvsm;
         pShadowMap->setLayer(layer++);
     }
     for (auto& pShadowMap : mSpotShadowMaps) {
         auto const& options = pShadowMap->getShadowOptions();
-        maxDimension = std::max(maxDimension, options->mapSize);
+        maxDimension = std::max(maxDimension, getShadowMapSize(view, *options));
         elvsm = elvsm || options->vsm.elvsm;
         pShadowMap->setLayer(layer++);
     }
@@ -17,6 +17,7 @@
 #ifndef TNT_FILAMENT_DETAILS_SHADOWMAPMANAGER_H
 #define TNT_FILAMENT_DETAILS_SHADOWMAPMANAGER_H
 
+#include <filament/Frustum.h>
 #include <filament/Viewport.h>
 
 #include "ShadowMap.h"
@@ -37,6 +38,7 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 namespace filament {
 
@@ -118,16 +120,40 @@ private:
     void calculateTextureRequirements(FEngine&, FView& view,
             FScene::LightSoa const&) noexcept;
 
+    // These update the shadow map and its entry in shadowUib. prepareSpotShadowMap() also culls
+    // the shadow casters in range into visibleMasks (this shadow map's visibility, indexed like
+    // renderableData), point lights are culled once for their six faces by
+    // cullPointShadowCasters(). They don't modify any shared state, so shadow maps can be
+    // prepared concurrently.
     void prepareSpotShadowMap(ShadowMap& shadowMap,
-            FEngine& engine, FView& view, CameraInfo const& mainCameraInfo,
-            FScene::RenderableSoa& renderableData, utils::Range<uint32_t> range,
-            FScene::LightSoa& lightData, ShadowMap::SceneInfo const& sceneInfo) noexcept;
+            FEngine& engine, FView const& view, CameraInfo const& mainCameraInfo,
+            FScene::RenderableSoa const& renderableData, utils::Range<uint32_t> range,
+            FScene::LightSoa const& lightData, ShadowMap::SceneInfo const& sceneInfo,
+            FScene::VisibleMaskType* visibleMasks, ShadowUib& shadowUib) const noexcept;
 
     void preparePointShadowMap(ShadowMap& map,
-            FEngine& engine, FView& view, CameraInfo const& mainCameraInfo,
-            FScene::RenderableSoa& renderableData, utils::Range<uint32_t> range,
-            FScene::LightSoa& lightData,
-            ShadowMap::SceneInfo const& sceneInfo) noexcept;
+            FEngine& engine, FView const& view, CameraInfo const& mainCameraInfo,
+            utils::Range<uint32_t> range, FScene::LightSoa const& lightData,
+            FScene::VisibleMaskType const* visibleMasks, ShadowUib& shadowUib) const noexcept;
+
+    // Culls the shadow casters in range against the point light's sphere of influence and
+    // stores in visibleMasks the faces each one overlaps, i.e. bit N is set for face N.
+    static void cullPointShadowCasters(math::float3 position, float radius,
+            uint8_t visibleLayers,
+            FScene::RenderableSoa const& renderableData, utils::Range<uint32_t> range,
+            FScene::VisibleMaskType* visibleMasks) noexcept;
+
+    static void cullSpotShadowCasters(Frustum const& frustum, uint8_t visibleLayers,
+            FScene::RenderableSoa const& renderableData, utils::Range<uint32_t> range,
+            FScene::VisibleMaskType* visibleMasks) noexcept;
+
+    // the shadow map size requested by the light, reduced by the View's quality governor
+    static uint32_t getShadowMapSize(FView const& view,
+            FLightManager::ShadowOptions const& options) noexcept;
+
+    static void updateShadowData(ShadowUib::ShadowData& shadowData, ShadowMap const& shadowMap,
+            ShadowMap::ShaderParameters const& shaderParameters, bool vsm,
+            SoftShadowOptions const& softShadowOptions) noexcept;
 
     static void updateSpotVisibilityMasks(
             uint8_t visibleLayers,
@@ -196,6 +222,10 @@ private:
 
     ShadowMap::SceneInfo mSceneInfo;
 
+    // Out-of-band visibility of the renderables for each spot/point shadow map, consumed by
+    // their RenderPass. Only valid during the "Prepare Shadow Pass", kept to avoid reallocations.
+    std::vector<FScene::VisibleMaskType> mSpotVisibleMasks;
+
     utils::FixedCapacityVector<ShadowMap*> mCascadeShadowMaps{
             utils::FixedCapacityVector<ShadowMap*>::with_capacity(
                     CONFIG_MAX_SHADOW_CASCADES) };
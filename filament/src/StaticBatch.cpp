@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "details/StaticBatch.h"
+
+namespace filament {
+
+size_t StaticBatch::getEntityCount() const noexcept {
+    return downcast(this)->getEntityCount();
+}
+
+utils::Entity const* StaticBatch::getEntities() const noexcept {
+    return downcast(this)->getEntities();
+}
+
+size_t StaticBatch::getMeshCount() const noexcept {
+    return downcast(this)->getMeshCount();
+}
+
+} // namespace filament
@@ -17,13 +17,19 @@
 #ifndef TNT_FILAMENT_TYPEDUNIFORMBUFFER_H
 #define TNT_FILAMENT_TYPEDUNIFORMBUFFER_H
 
+#include "DirtyRangeSet.h"
+
 #include "private/backend/DriverApi.h"
 
 #include <utils/compiler.h>
 
 #include <backend/BufferDescriptor.h>
+#include <backend/Handle.h>
+
+#include <algorithm>
 
 #include <stddef.h>
+#include <string.h>
 
 namespace filament {
 
@@ -66,8 +72,39 @@ public:
         return p;
     }
 
+    // Upload the parts of the UBO that changed since the last commit, or the whole UBO if
+    // `partial` is false, and cleans the dirty bits. Nothing is uploaded if nothing changed.
+    // Returns the number of bytes uploaded.
+    // Fields are modified through references (see edit()), so the changes are found by comparing
+    // the buffer with the last committed copy, one vec4 at a time.
+    size_t commit(backend::DriverApi& driver,
+            backend::Handle<backend::HwBufferObject> handle, bool partial) const noexcept {
+        constexpr size_t size = sizeof(T) * N;
+        char const* const data = reinterpret_cast<char const*>(mBuffer);
+        DirtyRangeSet ranges;
+        if (UTILS_UNLIKELY(!mHasCommitted)) {
+            ranges.add(0, uint32_t(size));
+            mHasCommitted = true;
+        } else {
+            for (size_t i = 0; i < size; i += 16) {
+                size_t const n = std::min(size_t(16), size - i);
+                if (memcmp(data + i, mCommitted + i, n) != 0) {
+                    ranges.add(uint32_t(i), uint32_t(i + n));
+                }
+            }
+        }
+        for (auto const& r : ranges) {
+            memcpy(mCommitted + r.begin, data + r.begin, r.end - r.begin);
+        }
+        clean();
+        return ranges.empty() ? 0 : ranges.upload(driver, handle, data, size, partial);
+    }
+
 private:
     T mBuffer[N];
+    // copy of the data as of the last commit()
+    alignas(T) mutable char mCommitted[sizeof(T) * N];
+    mutable bool mHasCommitted = false;
     mutable bool mSomethingDirty = false;
 };
 
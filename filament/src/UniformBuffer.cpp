@@ -25,18 +25,18 @@ namespace filament {
 
 UniformBuffer::UniformBuffer(size_t size) noexcept
         : mBuffer(mStorage),
-          mSize(uint32_t(size)),
-          mSomethingDirty(true) {
+          mSize(uint32_t(size)) {
     if (UTILS_LIKELY(size > sizeof(mStorage))) {
         mBuffer = UniformBuffer::alloc(size);
     }
     memset(mBuffer, 0, size);
+    mDirtyRanges.add(0, mSize);
 }
 
 UniformBuffer::UniformBuffer(UniformBuffer&& rhs) noexcept
         : mBuffer(rhs.mBuffer),
           mSize(rhs.mSize),
-          mSomethingDirty(rhs.mSomethingDirty) {
+          mDirtyRanges(rhs.mDirtyRanges) {
     if (UTILS_LIKELY(rhs.isLocalStorage())) {
         mBuffer = mStorage;
         memcpy(mBuffer, rhs.mBuffer, mSize);
@@ -47,7 +47,7 @@ UniformBuffer::UniformBuffer(UniformBuffer&& rhs) noexcept
 
 UniformBuffer& UniformBuffer::operator=(UniformBuffer&& rhs) noexcept {
     if (this != &rhs) {
-        mSomethingDirty = rhs.mSomethingDirty;
+        mDirtyRanges = rhs.mDirtyRanges;
         if (UTILS_LIKELY(rhs.isLocalStorage())) {
             mBuffer = mStorage;
             mSize = rhs.mSize;
@@ -158,7 +158,8 @@ void UniformBuffer::setUniform(void* addr, size_t offset, const math::mat3f& v)
 
 template<>
 void UniformBuffer::setUniform(size_t offset, const math::mat3f& v) noexcept {
-    setUniform(invalidateUniforms(offset, sizeof(v)), 0, v);
+    // std140 stores each column as a vec4, the last one ends after its third float
+    setUniform(invalidateUniforms(offset, sizeof(math::float4) * 2 + sizeof(math::float3)), 0, v);
 }
 
 #if !defined(NDEBUG)
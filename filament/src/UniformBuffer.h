@@ -19,6 +19,8 @@
 
 #include <algorithm>
 
+#include "DirtyRangeSet.h"
+
 #include "private/backend/DriverApi.h"
 
 #include <utils/Allocator.h>
@@ -27,6 +29,7 @@
 #include <utils/debug.h>
 
 #include <backend/BufferDescriptor.h>
+#include <backend/Handle.h>
 
 #include <math/mat3.h>
 #include <math/mat4.h>
@@ -69,7 +72,7 @@ public:
     // invalidate a range of uniforms and return a pointer to it. offset and size given in bytes
     void* invalidateUniforms(size_t offset, size_t size) {
         assert_invariant(offset + size <= mSize);
-        mSomethingDirty = true;
+        mDirtyRanges.add(uint32_t(offset), uint32_t(offset + size));
         return static_cast<char*>(mBuffer) + offset;
     }
 
@@ -84,10 +87,13 @@ public:
     size_t getSize() const noexcept { return mSize; }
 
     // return if any uniform has been changed
-    bool isDirty() const noexcept { return mSomethingDirty; }
+    bool isDirty() const noexcept { return !mDirtyRanges.empty(); }
+
+    // the ranges of bytes modified since the last upload or clean()
+    DirtyRangeSet const& getDirtyRanges() const noexcept { return mDirtyRanges; }
 
     // mark the whole buffer as clean (no modified uniforms)
-    void clean() const noexcept { mSomethingDirty = false; }
+    void clean() const noexcept { mDirtyRanges.clear(); }
 
     /*
      * -----------------------------------------------
@@ -177,6 +183,16 @@ public:
         return p;
     }
 
+    // upload the modified ranges of the UBO at `offset` in `handle`, or the whole UBO if
+    // `partial` is false, and cleans the dirty bits. Returns the number of bytes uploaded.
+    size_t commit(backend::DriverApi& driver, backend::Handle<backend::HwBufferObject> handle,
+            bool partial, uint32_t offset = 0) const noexcept {
+        size_t const size = mDirtyRanges.upload(driver, handle, getBuffer(), getSize(),
+                partial, offset);
+        clean();
+        return size;
+    }
+
     // set uniform of known types to the proper offset (e.g.: use offsetof())
     template<size_t Size>
     void setUniformUntyped(size_t offset, void const* UTILS_RESTRICT v) noexcept;
@@ -203,7 +219,7 @@ private:
     char mStorage[96];
     void *mBuffer = nullptr;
     uint32_t mSize = 0;
-    mutable bool mSomethingDirty = false;
+    mutable DirtyRangeSet mDirtyRanges;
 };
 
 // specialization for mat3f (which has a different alignment, see std140 layout rules)
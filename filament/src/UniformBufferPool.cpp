@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "UniformBufferPool.h"
+
+#include <backend/DriverEnums.h>
+
+#include <utils/compiler.h>
+#include <utils/debug.h>
+
+namespace filament {
+
+using namespace backend;
+
+UniformBufferPool::UniformBufferPool() noexcept
+        : mFreeLists(BUFFER_SIZE / ALIGNMENT) {
+}
+
+UniformBufferPool::~UniformBufferPool() noexcept {
+    assert_invariant(mBuffers.empty());
+}
+
+void UniformBufferPool::terminate(DriverApi& driver) noexcept {
+    for (auto handle : mBuffers) {
+        driver.destroyBufferObject(handle);
+    }
+    mBuffers.clear();
+    for (auto& list : mFreeLists) {
+        list.clear();
+    }
+    for (auto const& frame : mInFlight) {
+        driver.destroySync(frame.sync);
+    }
+    mInFlight.clear();
+    mRetired.clear();
+    mOffset = BUFFER_SIZE;
+    mLargeBlockCount = 0;
+    mLargeBlockSize = 0;
+}
+
+UniformBufferPool::Allocation UniformBufferPool::allocate(
+        DriverApi& driver, uint32_t size) noexcept {
+    assert_invariant(size);
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    if (UTILS_UNLIKELY(size > BUFFER_SIZE)) {
+        mLargeBlockCount++;
+        mLargeBlockSize += size;
+        return { driver.createBufferObject(size,
+                BufferObjectBinding::UNIFORM, BufferUsage::DYNAMIC), 0, size };
+    }
+
+    auto& list = mFreeLists[size / ALIGNMENT - 1];
+    if (!list.empty()) {
+        Allocation const allocation = list.back();
+        list.pop_back();
+        return allocation;
+    }
+
+    if (mOffset + size > BUFFER_SIZE) {
+        mBuffers.push_back(driver.createBufferObject(BUFFER_SIZE,
+                BufferObjectBinding::UNIFORM, BufferUsage::DYNAMIC));
+        mOffset = 0;
+    }
+    Allocation const allocation{ mBuffers.back(), mOffset, size };
+    mOffset += size;
+    return allocation;
+}
+
+void UniformBufferPool::free(DriverApi& driver, Allocation const& allocation) noexcept {
+    if (!allocation.handle) {
+        return;
+    }
+    if (UTILS_UNLIKELY(allocation.size > BUFFER_SIZE)) {
+        assert_invariant(mLargeBlockCount && mLargeBlockSize >= allocation.size);
+        mLargeBlockCount--;
+        mLargeBlockSize -= allocation.size;
+        driver.destroyBufferObject(allocation.handle);
+        return;
+    }
+    mRetired.push_back(allocation);
+}
+
+void UniformBufferPool::orphan(DriverApi& driver, Allocation& allocation) noexcept {
+    assert_invariant(isPooled(allocation));
+    Allocation const old = allocation;
+    allocation = allocate(driver, old.size);
+    free(driver, old);
+}
+
+void UniformBufferPool::endFrame(DriverApi& driver) noexcept {
+    // recycle the blocks of the frames completed by the GPU, in order
+    auto pos = mInFlight.begin();
+    for (; pos != mInFlight.end(); ++pos) {
+        SyncStatus const status = driver.getSyncStatus(pos->sync);
+        if (status == SyncStatus::NOT_SIGNALED) {
+            break;
+        }
+        // if the sync failed, wait until MAX_FRAMES_IN_FLIGHT frames are in flight instead, the
+        // oldest one is then complete.
+        if (status == SyncStatus::ERROR && mInFlight.size() < MAX_FRAMES_IN_FLIGHT) {
+            break;
+        }
+        driver.destroySync(pos->sync);
+        for (Allocation const& allocation : pos->blocks) {
+            mFreeLists[allocation.size / ALIGNMENT - 1].push_back(allocation);
+        }
+    }
+    mInFlight.erase(mInFlight.begin(), pos);
+
+    // guard the blocks freed during this frame, unless too many frames are already in flight,
+    // in which case they're guarded by the sync of a later frame.
+    if (!mRetired.empty() && mInFlight.size() < MAX_FRAMES_IN_FLIGHT) {
+        mInFlight.push_back({ driver.createSync(), std::move(mRetired) });
+        mRetired.clear();
+    }
+}
+
+} // namespace filament
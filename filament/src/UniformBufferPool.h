@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_UNIFORMBUFFERPOOL_H
+#define TNT_FILAMENT_UNIFORMBUFFERPOOL_H
+
+#include <backend/Handle.h>
+
+#include <private/backend/DriverApi.h>
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * Sub-allocates small uniform blocks (e.g. the MaterialInstance parameters) from a few large
+ * buffer objects, which are then bound with bindBufferRange().
+ *
+ * A block can still be read by the GPU after it's freed, so it's retired: the blocks freed during
+ * a frame are guarded by a sync created at the end of that frame, and are recycled through
+ * per-size free lists only once the sync is signaled. As a result, a block returned by allocate()
+ * is never in use by the GPU and can be written without synchronization; orphan() relies on this
+ * to update a block without stalling on the frames that read its previous content.
+ * The buffer objects themselves are only destroyed in terminate().
+ */
+class UniformBufferPool {
+public:
+    // Offsets of bound ranges must be a multiple of the backend's uniform buffer offset
+    // alignment, which is at most 256 bytes in practice (see also PerRenderableData).
+    static constexpr uint32_t ALIGNMENT = 256;
+
+    // Size of each pooled buffer object, larger blocks get their own buffer object.
+    static constexpr uint32_t BUFFER_SIZE = 64 * 1024;
+
+    // Maximum number of frames whose retired blocks are waiting for their sync. When more
+    // frames are in flight, the blocks freed meanwhile wait for the sync of a later frame.
+    static constexpr size_t MAX_FRAMES_IN_FLIGHT = 8;
+
+    struct Allocation {
+        backend::Handle<backend::HwBufferObject> handle;
+        uint32_t offset = 0;
+        uint32_t size = 0;  // size of the block, a multiple of ALIGNMENT
+    };
+
+    UniformBufferPool() noexcept;
+    ~UniformBufferPool() noexcept;
+
+    UniformBufferPool(UniformBufferPool const& rhs) = delete;
+    UniformBufferPool(UniformBufferPool&& rhs) noexcept = delete;
+    UniformBufferPool& operator=(UniformBufferPool const& rhs) = delete;
+    UniformBufferPool& operator=(UniformBufferPool&& rhs) noexcept = delete;
+
+    void terminate(backend::DriverApi& driver) noexcept;
+
+    // allocates a block of at least `size` bytes
+    Allocation allocate(backend::DriverApi& driver, uint32_t size) noexcept;
+
+    // returns a block to the pool, it's recycled once the GPU is done with the current frame
+    void free(backend::DriverApi& driver, Allocation const& allocation) noexcept;
+
+    // replaces a pooled block by one that isn't in use by the GPU, the content of the new block
+    // is undefined and it must be written entirely
+    void orphan(backend::DriverApi& driver, Allocation& allocation) noexcept;
+
+    // true if the block is sub-allocated from a pooled buffer object
+    static bool isPooled(Allocation const& allocation) noexcept {
+        return allocation.size <= BUFFER_SIZE;
+    }
+
+    // must be called at the end of each frame, after its commands are issued: recycles the
+    // blocks whose frame has completed on the GPU and guards the blocks freed since the last call.
+    void endFrame(backend::DriverApi& driver) noexcept;
+
+    // number of pooled buffer objects
+    size_t getBufferCount() const noexcept { return mBuffers.size(); }
+
+    // number and total size of the buffer objects held by the pool, including the blocks larger
+    // than BUFFER_SIZE, which have their own buffer object
+    size_t getBufferObjectCount() const noexcept { return mBuffers.size() + mLargeBlockCount; }
+    size_t getBufferObjectSize() const noexcept {
+        return mBuffers.size() * BUFFER_SIZE + mLargeBlockSize;
+    }
+
+private:
+    std::vector<backend::Handle<backend::HwBufferObject>> mBuffers;
+    // free blocks, indexed by size / ALIGNMENT - 1
+    std::vector<std::vector<Allocation>> mFreeLists;
+    // blocks freed since the last endFrame()
+    std::vector<Allocation> mRetired;
+    // blocks waiting for the frames that may read them to complete, oldest first
+    struct InFlight {
+        backend::Handle<backend::HwSync> sync;
+        std::vector<Allocation> blocks;
+    };
+    std::vector<InFlight> mInFlight;
+    // first unused byte of the last pooled buffer
+    uint32_t mOffset = BUFFER_SIZE;
+    // blocks larger than BUFFER_SIZE currently allocated
+    size_t mLargeBlockCount = 0;
+    size_t mLargeBlockSize = 0;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_UNIFORMBUFFERPOOL_H
@@ -155,6 +155,14 @@ View::DynamicResolutionOptions View::getDynamicResolutionOptions() const noexcep
     return downcast(this)->getDynamicResolutionOptions();
 }
 
+void View::setQualityGovernorOptions(const QualityGovernorOptions& options) noexcept {
+    downcast(this)->setQualityGovernorOptions(options);
+}
+
+View::QualityGovernorOptions View::getQualityGovernorOptions() const noexcept {
+    return downcast(this)->getQualityGovernorOptions();
+}
+
 void View::setRenderQuality(const RenderQuality& renderQuality) noexcept {
     downcast(this)->setRenderQuality(renderQuality);
 }
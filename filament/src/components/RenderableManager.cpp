@@ -33,10 +33,19 @@
 
 #include <backend/DriverEnums.h>
 
+#include <utils/FixedCapacityVector.h>
 #include <utils/Log.h>
 #include <utils/Panic.h>
 #include <utils/debug.h>
 
+#include <tsl/robin_map.h>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include <stdlib.h>
+
 
 using namespace filament::math;
 using namespace utils;
@@ -236,8 +245,16 @@ RenderableManager::Builder& RenderableManager::Builder::globalBlendOrderEnabled(
 }
 
 RenderableManager::Builder::Result RenderableManager::Builder::build(Engine& engine, Entity entity) {
+    return build(engine, &entity, 1);
+}
+
+RenderableManager::Builder::Result RenderableManager::Builder::build(Engine& engine,
+        Entity const* entities, size_t count) {
     bool isEmpty = true;
 
+    // the entity is only used in error messages
+    Entity const entity = count ? entities[0] : Entity{};
+
     ASSERT_PRECONDITION(mImpl->mSkinningBoneCount <= CONFIG_MAX_BONE_COUNT,
             "bone count > %u", CONFIG_MAX_BONE_COUNT);
 
@@ -296,7 +313,7 @@ RenderableManager::Builder::Result RenderableManager::Builder::build(Engine& eng
             "[entity=%u] AABB can't be empty, unless culling is disabled and "
                     "the object is not a shadow caster/receiver", entity.getId());
 
-    downcast(engine).createRenderable(*this, entity);
+    downcast(engine).createRenderables(*this, entities, count);
     return Success;
 }
 
@@ -317,145 +334,227 @@ FRenderableManager::~FRenderableManager() {
     assert_invariant(mManager.getComponentCount() == 0);
 }
 
+/*
+ * The primitives and morph targets of a renderable live in a single allocation, which is shared
+ * by all the renderables created together by one call to create(). Each renderable's arrays are
+ * preceded by a pointer to the allocation's header, which counts the renderables still using it.
+ */
+struct FRenderableManager::StorageHeader {
+    size_t refs;
+};
+
+struct FRenderableManager::ComponentHeader {
+    StorageHeader* storage;
+};
+
+static_assert(sizeof(FRenderPrimitive) % alignof(FRenderableManager::MorphTargets) == 0);
+static_assert(alignof(FRenderPrimitive) <= alignof(std::max_align_t));
+
+size_t FRenderableManager::getComponentStorageSize(size_t primitiveCount) noexcept {
+    return sizeof(ComponentHeader) +
+           primitiveCount * (sizeof(FRenderPrimitive) + sizeof(MorphTargets));
+}
+
+void FRenderableManager::releaseComponentStorage(FRenderPrimitive* primitives) noexcept {
+    ComponentHeader const* const header = reinterpret_cast<ComponentHeader const*>(primitives) - 1;
+    StorageHeader* const storage = header->storage;
+    if (--storage->refs == 0) {
+        free(storage);
+    }
+}
+
 void FRenderableManager::create(
         const RenderableManager::Builder& UTILS_RESTRICT builder, Entity entity) {
+    create(builder, &entity, 1);
+}
+
+void FRenderableManager::create(
+        const RenderableManager::Builder& UTILS_RESTRICT builder,
+        Entity const* entities, size_t count) {
     FEngine& engine = mEngine;
     auto& manager = mManager;
     FEngine::DriverApi& driver = engine.getDriverApi();
 
-    if (UTILS_UNLIKELY(manager.hasComponent(entity))) {
-        destroy(entity);
+    if (UTILS_UNLIKELY(!count)) {
+        return;
+    }
+    manager.reserve(count);
+
+    // All the renderables share the same geometry, so we only need to create (or find) each
+    // render primitive once, and add a reference for each other renderable.
+    Builder::Entry const * const entries = builder->mEntries.data();
+    const size_t entryCount = builder->mEntries.size();
+    auto& factory = mHwRenderPrimitiveFactory;
+    FixedCapacityVector<FRenderPrimitive> primitives(entryCount);
+    for (size_t i = 0; i < entryCount; ++i) {
+        primitives[i].init(factory, driver, entries[i]);
+        if (primitives[i].getHwHandle() && count > 1) {
+            factory.retain(primitives[i].getHwHandle(), uint32_t(count - 1));
+        }
     }
-    Instance const ci = manager.addComponent(entity);
-    assert_invariant(ci);
 
-    if (ci) {
-        // create and initialize all needed RenderPrimitives
-        using size_type = Slice<FRenderPrimitive>::size_type;
-        Builder::Entry const * const entries = builder->mEntries.data();
-        const size_t entryCount = builder->mEntries.size();
-        FRenderPrimitive* rp = new FRenderPrimitive[entryCount];
-        auto& factory = mHwRenderPrimitiveFactory;
-        for (size_t i = 0; i < entryCount; ++i) {
-            rp[i].init(factory, driver, entries[i]);
+    // the primitives and morph targets of all the renderables are allocated at once
+    const size_t componentStorageSize = getComponentStorageSize(entryCount);
+    StorageHeader* const storage = static_cast<StorageHeader*>(
+            malloc(sizeof(StorageHeader) + count * componentStorageSize));
+    ASSERT_POSTCONDITION(storage, "Out of memory creating %zu renderables", count);
+    storage->refs = count;
+
+    const bool hasSkinningOrMorphing =
+            builder->mSkinningBoneCount > 0 || builder->mMorphTargetCount > 0;
+    uint8_t* p = reinterpret_cast<uint8_t*>(storage + 1);
+    for (size_t i = 0; i < count; i++, p += componentStorageSize) {
+        new(p) ComponentHeader{ storage };
+        FRenderPrimitive* const rp = reinterpret_cast<FRenderPrimitive*>(
+                p + sizeof(ComponentHeader));
+        MorphTargets* const morphTargets = reinterpret_cast<MorphTargets*>(rp + entryCount);
+        std::uninitialized_copy_n(primitives.data(), entryCount, rp);
+        std::uninitialized_fill_n(morphTargets, entryCount,
+                MorphTargets{ mEngine.getDummyMorphTargetBuffer(), 0, 0 });
+
+        // an existing component is destroyed first, this also handles duplicate entities
+        if (UTILS_UNLIKELY(manager.hasComponent(entities[i]))) {
+            destroy(entities[i]);
         }
-        setPrimitives(ci, { rp, size_type(entryCount) });
-
-        setAxisAlignedBoundingBox(ci, builder->mAABB);
-        setLayerMask(ci, builder->mLayerMask);
-        setPriority(ci, builder->mPriority);
-        setChannel(ci, builder->mCommandChannel);
-        setCastShadows(ci, builder->mCastShadows);
-        setReceiveShadows(ci, builder->mReceiveShadows);
-        setScreenSpaceContactShadows(ci, builder->mScreenSpaceContactShadows);
-        setCulling(ci, builder->mCulling);
-        setSkinning(ci, false);
-        setMorphing(ci, builder->mMorphTargetCount);
-        mManager[ci].channels = builder->mLightChannels;
-        mManager[ci].instanceCount = builder->mInstanceCount;
-
-        const uint32_t boneCount = builder->mSkinningBoneCount;
-        const uint32_t targetCount = builder->mMorphTargetCount;
-        if (builder->mSkinningBufferMode) {
-            if (builder->mSkinningBuffer) {
-                setSkinning(ci, boneCount > 0);
-                Bones& bones = manager[ci].bones;
-                bones = Bones{
-                        .handle = builder->mSkinningBuffer->getHwHandle(),
-                        .count = (uint16_t)boneCount,
-                        .offset = (uint16_t)builder->mSkinningBufferOffset,
-                        .skinningBufferMode = true };
-            }
-        } else {
-            if (UTILS_UNLIKELY(boneCount > 0 || targetCount > 0)) {
-                setSkinning(ci, boneCount > 0);
-                Bones& bones = manager[ci].bones;
-                // Note that we are sizing the bones UBO according to CONFIG_MAX_BONE_COUNT rather than
-                // mSkinningBoneCount. According to the OpenGL ES 3.2 specification in 7.6.3 Uniform
-                // Buffer Object Bindings:
-                //
-                //     the uniform block must be populated with a buffer object with a size no smaller
-                //     than the minimum required size of the uniform block (the value of
-                //     UNIFORM_BLOCK_DATA_SIZE).
-                //
-                // This unfortunately means that we are using a large memory footprint for skinned
-                // renderables. In the future we could try addressing this by implementing a paging
-                // system such that multiple skinned renderables will share regions within a single
-                // large block of bones.
-                bones = Bones{
-                        .handle = driver.createBufferObject(
-                                sizeof(PerRenderableBoneUib),
-                                BufferObjectBinding::UNIFORM,
-                                backend::BufferUsage::DYNAMIC),
-                        .count = (uint16_t)boneCount,
-                        .offset = 0,
-                        .skinningBufferMode = false };
-
-                if (boneCount) {
-                    if (builder->mUserBones) {
-                        FSkinningBuffer::setBones(mEngine, bones.handle,
-                                builder->mUserBones, boneCount, 0);
-                    } else if (builder->mUserBoneMatrices) {
-                        FSkinningBuffer::setBones(mEngine, bones.handle,
-                                builder->mUserBoneMatrices, boneCount, 0);
-                    } else {
-                        // initialize the bones to identity
-                        auto* out = driver.allocatePod<PerRenderableBoneUib::BoneData>(boneCount);
-                        std::uninitialized_fill_n(out, boneCount, FSkinningBuffer::makeBone({}));
-                        driver.updateBufferObject(bones.handle, {
-                                out, boneCount * sizeof(PerRenderableBoneUib::BoneData) }, 0);
-                    }
-                }
-                else {
-                    // When boneCount is 0, do an initialization for the bones uniform array to avoid crash on adreno gpu.
-                    if (UTILS_UNLIKELY(driver.isWorkaroundNeeded(Workaround::ADRENO_UNIFORM_ARRAY_CRASH))) {
-                        auto *initBones = driver.allocatePod<PerRenderableBoneUib::BoneData>(1);
-                        std::uninitialized_fill_n(initBones, 1, FSkinningBuffer::makeBone({}));
-                        driver.updateBufferObject(bones.handle, {
-                                initBones, sizeof(PerRenderableBoneUib::BoneData) }, 0);
-                    }
-                }
-            }
+        Instance const ci = manager.addComponent(entities[i]);
+        assert_invariant(ci);
+        if (UTILS_UNLIKELY(!ci)) {
+            // null entity, give back the references this renderable would have held
+            Slice<FRenderPrimitive> unused{ rp, Slice<FRenderPrimitive>::size_type(entryCount) };
+            destroyComponentPrimitives(factory, driver, unused);
+            releaseComponentStorage(rp);
+            continue;
         }
+        initComponent(ci, builder, rp, morphTargets);
 
-        // Create and initialize all needed MorphTargets. It's required to avoid branches in hot loops.
-        MorphTargets* morphTargets = new MorphTargets[entryCount];
-        for (size_t i = 0; i < entryCount; ++i) {
-            morphTargets[i] = { mEngine.getDummyMorphTargetBuffer(), 0, 0 };
+        // renderables with skinning or morphing issue driver commands of their own
+        if (UTILS_UNLIKELY(hasSkinningOrMorphing)) {
+            engine.flushIfNeeded();
         }
-        mManager[ci].morphTargets = { morphTargets, size_type(entryCount) };
+    }
+    engine.flushIfNeeded();
+}
 
-        // Even morphing isn't enabled, we should create morphig resources.
-        // Because morphing shader code is generated when skinning is enabled.
-        // You can see more detail at Variant::SKINNING_OR_MORPHING.
+void FRenderableManager::initComponent(Instance ci,
+        const RenderableManager::Builder& UTILS_RESTRICT builder,
+        FRenderPrimitive* rp, MorphTargets* morphTargets) {
+    auto& manager = mManager;
+    FEngine::DriverApi& driver = mEngine.getDriverApi();
+
+    using size_type = Slice<FRenderPrimitive>::size_type;
+    const size_t entryCount = builder->mEntries.size();
+    setPrimitives(ci, { rp, size_type(entryCount) });
+
+    setAxisAlignedBoundingBox(ci, builder->mAABB);
+    setLayerMask(ci, builder->mLayerMask);
+    setPriority(ci, builder->mPriority);
+    setChannel(ci, builder->mCommandChannel);
+    setCastShadows(ci, builder->mCastShadows);
+    setReceiveShadows(ci, builder->mReceiveShadows);
+    setScreenSpaceContactShadows(ci, builder->mScreenSpaceContactShadows);
+    setCulling(ci, builder->mCulling);
+    setSkinning(ci, false);
+    setMorphing(ci, builder->mMorphTargetCount);
+    mManager[ci].channels = builder->mLightChannels;
+    mManager[ci].instanceCount = builder->mInstanceCount;
+
+    const uint32_t boneCount = builder->mSkinningBoneCount;
+    const uint32_t targetCount = builder->mMorphTargetCount;
+    if (builder->mSkinningBufferMode) {
+        if (builder->mSkinningBuffer) {
+            setSkinning(ci, boneCount > 0);
+            Bones& bones = manager[ci].bones;
+            bones = Bones{
+                    .handle = builder->mSkinningBuffer->getHwHandle(),
+                    .count = (uint16_t)boneCount,
+                    .offset = (uint16_t)builder->mSkinningBufferOffset,
+                    .skinningBufferMode = true };
+        }
+    } else {
         if (UTILS_UNLIKELY(boneCount > 0 || targetCount > 0)) {
-            // Instead of using a UBO per primitive, we could also have a single UBO for all primitives
-            // and use bindUniformBufferRange which might be more efficient.
-            MorphWeights& morphWeights = manager[ci].morphWeights;
-            morphWeights = MorphWeights {
-                .handle = driver.createBufferObject(
-                        sizeof(PerRenderableMorphingUib),
-                        BufferObjectBinding::UNIFORM,
-                        backend::BufferUsage::DYNAMIC),
-                .count = targetCount };
-
-            for (size_t i = 0; i < entryCount; ++i) {
-                const auto& morphing = builder->mEntries[i].morphing;
-                if (!morphing.buffer) {
-                    continue;
+            setSkinning(ci, boneCount > 0);
+            Bones& bones = manager[ci].bones;
+            // Note that we are sizing the bones UBO according to CONFIG_MAX_BONE_COUNT rather than
+            // mSkinningBoneCount. According to the OpenGL ES 3.2 specification in 7.6.3 Uniform
+            // Buffer Object Bindings:
+            //
+            //     the uniform block must be populated with a buffer object with a size no smaller
+            //     than the minimum required size of the uniform block (the value of
+            //     UNIFORM_BLOCK_DATA_SIZE).
+            //
+            // This unfortunately means that we are using a large memory footprint for skinned
+            // renderables. In the future we could try addressing this by implementing a paging
+            // system such that multiple skinned renderables will share regions within a single
+            // large block of bones.
+            bones = Bones{
+                    .handle = driver.createBufferObject(
+                            sizeof(PerRenderableBoneUib),
+                            BufferObjectBinding::UNIFORM,
+                            backend::BufferUsage::DYNAMIC),
+                    .count = (uint16_t)boneCount,
+                    .offset = 0,
+                    .skinningBufferMode = false };
+
+            if (boneCount) {
+                if (builder->mUserBones) {
+                    FSkinningBuffer::setBones(mEngine, bones.handle,
+                            builder->mUserBones, boneCount, 0);
+                } else if (builder->mUserBoneMatrices) {
+                    FSkinningBuffer::setBones(mEngine, bones.handle,
+                            builder->mUserBoneMatrices, boneCount, 0);
+                } else {
+                    // initialize the bones to identity
+                    auto* out = driver.allocatePod<PerRenderableBoneUib::BoneData>(boneCount);
+                    std::uninitialized_fill_n(out, boneCount, FSkinningBuffer::makeBone({}));
+                    driver.updateBufferObject(bones.handle, {
+                            out, boneCount * sizeof(PerRenderableBoneUib::BoneData) }, 0);
                 }
-                morphTargets[i] = { downcast(morphing.buffer), (uint32_t)morphing.offset,
-                                    (uint32_t)morphing.count };
             }
-            
-            // When targetCount equal 0, boneCount>0 in this case, do an initialization for the morphWeights uniform array to avoid crash on adreno gpu.
-            if (UTILS_UNLIKELY(targetCount == 0 && driver.isWorkaroundNeeded(Workaround::ADRENO_UNIFORM_ARRAY_CRASH))) {
-                float initWeights[1] = {0};
-                setMorphWeights(ci, initWeights, 1, 0);
+            else {
+                // When boneCount is 0, do an initialization for the bones uniform array to avoid crash on adreno gpu.
+                if (UTILS_UNLIKELY(driver.isWorkaroundNeeded(Workaround::ADRENO_UNIFORM_ARRAY_CRASH))) {
+                    auto *initBones = driver.allocatePod<PerRenderableBoneUib::BoneData>(1);
+                    std::uninitialized_fill_n(initBones, 1, FSkinningBuffer::makeBone({}));
+                    driver.updateBufferObject(bones.handle, {
+                            initBones, sizeof(PerRenderableBoneUib::BoneData) }, 0);
+                }
             }
         }
     }
-    engine.flushIfNeeded();
+
+    // All the MorphTargets are initialized with the dummy buffer by the caller.
+    // It's required to avoid branches in hot loops.
+    mManager[ci].morphTargets = { morphTargets, size_type(entryCount) };
+
+    // Even morphing isn't enabled, we should create morphig resources.
+    // Because morphing shader code is generated when skinning is enabled.
+    // You can see more detail at Variant::SKINNING_OR_MORPHING.
+    if (UTILS_UNLIKELY(boneCount > 0 || targetCount > 0)) {
+        // Instead of using a UBO per primitive, we could also have a single UBO for all primitives
+        // and use bindUniformBufferRange which might be more efficient.
+        MorphWeights& morphWeights = manager[ci].morphWeights;
+        morphWeights = MorphWeights {
+            .handle = driver.createBufferObject(
+                    sizeof(PerRenderableMorphingUib),
+                    BufferObjectBinding::UNIFORM,
+                    backend::BufferUsage::DYNAMIC),
+            .count = targetCount };
+
+        for (size_t i = 0; i < entryCount; ++i) {
+            const auto& morphing = builder->mEntries[i].morphing;
+            if (!morphing.buffer) {
+                continue;
+            }
+            morphTargets[i] = { downcast(morphing.buffer), (uint32_t)morphing.offset,
+                                (uint32_t)morphing.count };
+        }
+        
+        // When targetCount equal 0, boneCount>0 in this case, do an initialization for the morphWeights uniform array to avoid crash on adreno gpu.
+        if (UTILS_UNLIKELY(targetCount == 0 && driver.isWorkaroundNeeded(Workaround::ADRENO_UNIFORM_ARRAY_CRASH))) {
+            float initWeights[1] = {0};
+            setMorphWeights(ci, initWeights, 1, 0);
+        }
+    }
 }
 
 // this destroys a single component from an entity
@@ -467,6 +566,32 @@ void FRenderableManager::destroy(utils::Entity e) noexcept {
     }
 }
 
+void FRenderableManager::destroy(utils::Entity const* entities, size_t count) noexcept {
+    // Renderables created together share their render primitives, so the references they hold
+    // are counted first, then given back to the factory once per render primitive.
+    auto& manager = mManager;
+    tsl::robin_map<backend::HandleBase::HandleId, uint32_t> references;
+    for (size_t i = 0; i < count; i++) {
+        Instance const ci = getInstance(entities[i]);
+        if (!ci) {
+            continue;
+        }
+        Slice<FRenderPrimitive> const& primitives = manager[ci].primitives;
+        for (FRenderPrimitive const& primitive : primitives) {
+            if (primitive.getHwHandle()) {
+                references[primitive.getHwHandle().getId()]++;
+            }
+        }
+        destroyComponentStorage(ci);
+        manager.removeComponent(entities[i]);
+    }
+
+    FEngine::DriverApi& driver = mEngine.getDriverApi();
+    for (auto const& [id, refs] : references) {
+        mHwRenderPrimitiveFactory.destroy(driver, backend::RenderPrimitiveHandle{ id }, refs);
+    }
+}
+
 // this destroys all components in this manager
 void FRenderableManager::terminate() noexcept {
     auto& manager = mManager;
@@ -490,14 +615,20 @@ void FRenderableManager::gc(utils::EntityManager& em) noexcept {
 
 // This is basically a Renderable's destructor.
 void FRenderableManager::destroyComponent(Instance ci) noexcept {
-    auto& manager = mManager;
-    FEngine& engine = mEngine;
+    FEngine::DriverApi& driver = mEngine.getDriverApi();
+    Slice<FRenderPrimitive>& primitives = mManager[ci].primitives;
+    destroyComponentPrimitives(mHwRenderPrimitiveFactory, driver, primitives);
+    destroyComponentStorage(ci);
+}
 
-    FEngine::DriverApi& driver = engine.getDriverApi();
+// Destroys everything a Renderable owns but its render primitives.
+void FRenderableManager::destroyComponentStorage(Instance ci) noexcept {
+    auto& manager = mManager;
+    FEngine::DriverApi& driver = mEngine.getDriverApi();
 
-    // See create(RenderableManager::Builder&, Entity)
-    destroyComponentPrimitives(mHwRenderPrimitiveFactory, driver, manager[ci].primitives);
-    destroyComponentMorphTargets(engine, manager[ci].morphTargets);
+    // See create(RenderableManager::Builder&, Entity const*, size_t)
+    Slice<FRenderPrimitive>& primitives = manager[ci].primitives;
+    releaseComponentStorage(primitives.data());
 
     // destroy the bones structures if any
     Bones const& bones = manager[ci].bones;
@@ -518,12 +649,6 @@ void FRenderableManager::destroyComponentPrimitives(
     for (auto& primitive : primitives) {
         primitive.terminate(factory, driver);
     }
-    delete[] primitives.data();
-}
-
-void FRenderableManager::destroyComponentMorphTargets(FEngine&,
-        utils::Slice<MorphTargets>& morphTargets) noexcept {
-    delete[] morphTargets.data();
 }
 
 void FRenderableManager::setMaterialInstanceAt(Instance instance, uint8_t level,
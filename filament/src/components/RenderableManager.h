@@ -94,8 +94,14 @@ public:
 
     void create(const RenderableManager::Builder& builder, utils::Entity entity);
 
+    // creates the same renderable for all the given entities
+    void create(const RenderableManager::Builder& builder,
+            utils::Entity const* entities, size_t count);
+
     void destroy(utils::Entity e) noexcept;
 
+    void destroy(utils::Entity const* entities, size_t count) noexcept;
+
     inline void setAxisAlignedBoundingBox(Instance instance, const Box& aabb) noexcept;
 
     inline void setLayerMask(Instance instance, uint8_t select, uint8_t values) noexcept;
@@ -180,12 +186,18 @@ public:
     inline utils::Slice<MorphTargets>& getMorphTargets(Instance instance, uint8_t level) noexcept;
 
 private:
+    struct StorageHeader;
+    struct ComponentHeader;
+
+    void initComponent(Instance ci, const RenderableManager::Builder& builder,
+            FRenderPrimitive* primitives, MorphTargets* morphTargets);
     void destroyComponent(Instance ci) noexcept;
+    void destroyComponentStorage(Instance ci) noexcept;
     static void destroyComponentPrimitives(
             HwRenderPrimitiveFactory& factory, backend::DriverApi& driver,
             utils::Slice<FRenderPrimitive>& primitives) noexcept;
-    static void destroyComponentMorphTargets(FEngine& engine,
-            utils::Slice<MorphTargets>& morphTargets) noexcept;
+    static size_t getComponentStorageSize(size_t primitiveCount) noexcept;
+    static void releaseComponentStorage(FRenderPrimitive* primitives) noexcept;
 
     struct Bones {
         backend::Handle<backend::HwBufferObject> handle;
@@ -30,6 +30,7 @@
 #include "details/Scene.h"
 #include "details/SkinningBuffer.h"
 #include "details/Skybox.h"
+#include "details/StaticBatch.h"
 #include "details/Stream.h"
 #include "details/SwapChain.h"
 #include "details/Texture.h"
@@ -53,6 +54,9 @@
 
 #include <algorithm>
 #include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "generated/resources/materials.h"
 
@@ -268,7 +272,10 @@ void FEngine::init() {
 
     slog.i << "FEngine feature level: " << int(driverApi.getFeatureLevel()) << io::endl;
 
-    mResourceAllocator = new ResourceAllocator(driverApi);
+    mResourceAllocator = new ResourceAllocator(driverApi, {
+            .cacheCapacity = mConfig.resourceAllocatorCacheSizeMB * MiB,
+            .cacheMaxAge = mConfig.resourceAllocatorCacheMaxAge,
+            .sizeGranularity = mConfig.resourceAllocatorSizeGranularity });
 
     mFullScreenTriangleVb = downcast(VertexBuffer::Builder()
             .vertexCount(3)
@@ -446,6 +453,8 @@ void FEngine::shutdown() {
     // this must be done after Skyboxes and before materials
     destroy(mSkyboxMaterial);
 
+    // this must be done before the buffers, which static batches own
+    cleanupResourceList(std::move(mStaticBatches));
     cleanupResourceList(std::move(mBufferObjects));
     cleanupResourceList(std::move(mIndexBuffers));
     cleanupResourceList(std::move(mMorphTargetBuffers));
@@ -458,6 +467,9 @@ void FEngine::shutdown() {
         cleanupResourceList(std::move(item.second));
     }
 
+    // this must be done after MaterialInstances
+    mUniformBufferPool.terminate(driver);
+
     cleanupResourceListLocked(mFenceListLock, std::move(mFences));
 
     driver.destroyTexture(mDummyOneTexture);
@@ -532,6 +544,179 @@ void FEngine::gc() {
     mCameraManager.gc(em);
 }
 
+// -----------------------------------------------------------------------------------------------
+// Memory accounting
+// -----------------------------------------------------------------------------------------------
+
+Engine::MemoryReport::Usage FEngine::getMemoryUsage(MemoryCategory category) const noexcept {
+    MemoryReport::Usage usage;
+    switch (category) {
+        case MemoryCategory::TEXTURE:
+            mTextures.forEach([&usage](FTexture const* p) {
+                usage.size += p->getMemorySize();
+            });
+            usage.count = mTextures.size();
+            break;
+        case MemoryCategory::VERTEX_BUFFER:
+            mVertexBuffers.forEach([&usage](FVertexBuffer const* p) {
+                usage.size += p->getByteCount();
+            });
+            usage.count = mVertexBuffers.size();
+            break;
+        case MemoryCategory::INDEX_BUFFER:
+            mIndexBuffers.forEach([&usage](FIndexBuffer const* p) {
+                usage.size += p->getByteCount();
+            });
+            usage.count = mIndexBuffers.size();
+            break;
+        case MemoryCategory::BUFFER_OBJECT:
+            mBufferObjects.forEach([&usage](FBufferObject const* p) {
+                usage.size += p->getByteCount();
+            });
+            usage.count = mBufferObjects.size();
+            break;
+        case MemoryCategory::RENDER_TARGET:
+            usage.size = mResourceAllocator->getInUseSize();
+            usage.count = mResourceAllocator->getInUseCount();
+            break;
+        case MemoryCategory::RENDER_TARGET_CACHE:
+            usage.size = mResourceAllocator->getCacheSize();
+            usage.count = mResourceAllocator->getCacheCount();
+            break;
+        case MemoryCategory::PROGRAM:
+            // drivers don't tell us how large programs are
+            mMaterials.forEach([&usage](FMaterial const* p) {
+                usage.count += p->getProgramCount();
+            });
+            break;
+        case MemoryCategory::COMMAND_BUFFER:
+            usage.size = getCommandBufferSize();
+            usage.count = 1;
+            break;
+        case MemoryCategory::ARENA:
+            usage.size = getPerRenderPassArenaSize() + getRequestedDriverHandleArenaSize();
+            usage.count = getRequestedDriverHandleArenaSize() ? 2 : 1;
+            break;
+        case MemoryCategory::UNIFORM_BUFFER_POOL:
+            usage.size = mUniformBufferPool.getBufferObjectSize();
+            usage.count = mUniformBufferPool.getBufferObjectCount();
+            break;
+        case MemoryCategory::DRIVER_CACHE: {
+            // drivers don't tell us how large these are either
+            DriverCacheCounts const counts = getDriver().getDriverCacheCounts();
+            usage.count = counts.descriptorPools + counts.pipelines;
+            break;
+        }
+    }
+    return usage;
+}
+
+void FEngine::getMemoryReport(MemoryReport& report) const noexcept {
+    for (size_t i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+        report.categories[i] = getMemoryUsage(MemoryCategory(i));
+    }
+}
+
+void FEngine::forEachMemoryOwner(utils::Invocable<void(MemoryCategory category,
+        const char* owner, MemoryReport::Usage const& usage)>&& functor) const noexcept {
+
+    // categories without finer grained information are reported under a single owner
+    functor(MemoryCategory::TEXTURE, "Texture", getMemoryUsage(MemoryCategory::TEXTURE));
+    functor(MemoryCategory::VERTEX_BUFFER, "VertexBuffer",
+            getMemoryUsage(MemoryCategory::VERTEX_BUFFER));
+    functor(MemoryCategory::INDEX_BUFFER, "IndexBuffer",
+            getMemoryUsage(MemoryCategory::INDEX_BUFFER));
+    functor(MemoryCategory::BUFFER_OBJECT, "BufferObject",
+            getMemoryUsage(MemoryCategory::BUFFER_OBJECT));
+
+    // render targets are grouped by their framegraph resource name
+    using Owners = std::vector<std::pair<std::string_view, MemoryReport::Usage>>;
+    Owners inUse;
+    Owners cached;
+    mResourceAllocator->forEachTexture([&](const char* name, size_t size, bool isCached) {
+        Owners& owners = isCached ? cached : inUse;
+        std::string_view const key{ name ? name : "" };
+        auto pos = std::find_if(owners.begin(), owners.end(),
+                [key](auto const& owner) { return owner.first == key; });
+        if (pos == owners.end()) {
+            pos = owners.insert(owners.end(), { key, {}});
+        }
+        pos->second.size += size;
+        pos->second.count++;
+    });
+    // the names are string literals, so they're null terminated
+    for (auto const& [name, usage] : inUse) {
+        functor(MemoryCategory::RENDER_TARGET, name.data(), usage);
+    }
+    for (auto const& [name, usage] : cached) {
+        functor(MemoryCategory::RENDER_TARGET_CACHE, name.data(), usage);
+    }
+
+    mMaterials.forEach([&functor](FMaterial const* p) {
+        size_t const count = p->getProgramCount();
+        if (count) {
+            const char* const name = p->getName().c_str_safe();
+            functor(MemoryCategory::PROGRAM, name, MemoryReport::Usage{ 0, count });
+        }
+    });
+
+    functor(MemoryCategory::COMMAND_BUFFER, "CommandBufferQueue",
+            MemoryReport::Usage{ getCommandBufferSize(), 1 });
+    functor(MemoryCategory::ARENA, "PerRenderPassArena",
+            MemoryReport::Usage{ getPerRenderPassArenaSize(), 1 });
+    if (getRequestedDriverHandleArenaSize()) {
+        functor(MemoryCategory::ARENA, "DriverHandleArena",
+                MemoryReport::Usage{ getRequestedDriverHandleArenaSize(), 1 });
+    }
+
+    functor(MemoryCategory::UNIFORM_BUFFER_POOL, "UniformBufferPool",
+            getMemoryUsage(MemoryCategory::UNIFORM_BUFFER_POOL));
+
+    DriverCacheCounts const driverCacheCounts = getDriver().getDriverCacheCounts();
+    if (driverCacheCounts.descriptorPools) {
+        functor(MemoryCategory::DRIVER_CACHE, "DescriptorPool",
+                MemoryReport::Usage{ 0, driverCacheCounts.descriptorPools });
+    }
+    if (driverCacheCounts.pipelines) {
+        functor(MemoryCategory::DRIVER_CACHE, "Pipeline",
+                MemoryReport::Usage{ 0, driverCacheCounts.pipelines });
+    }
+}
+
+void FEngine::setMemoryBudget(MemoryCategory category, size_t budget,
+        MemoryBudgetCallback&& callback) noexcept {
+    MemoryBudget& entry = mMemoryBudgets[size_t(category)];
+    entry.budget = budget;
+    entry.callback = std::move(callback);
+    entry.overBudget = false;
+}
+
+void FEngine::checkMemoryBudgets() noexcept {
+    for (size_t i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+        MemoryBudget& entry = mMemoryBudgets[i];
+        if (UTILS_LIKELY(!entry.budget)) {
+            continue;
+        }
+
+        MemoryCategory const category = MemoryCategory(i);
+        if (category == MemoryCategory::RENDER_TARGET_CACHE) {
+            // we can handle this one ourselves
+            mResourceAllocator->evict(entry.budget);
+        }
+
+        MemoryReport::Usage const usage = getMemoryUsage(category);
+        bool const counted = category == MemoryCategory::PROGRAM ||
+                category == MemoryCategory::DRIVER_CACHE;
+        size_t const used = counted ? usage.count : usage.size;
+        bool const overBudget = used > entry.budget;
+        if (overBudget && !entry.overBudget && entry.callback) {
+            // only notify when we go over budget, not every frame
+            entry.callback(category, usage, entry.budget);
+        }
+        entry.overBudget = overBudget;
+    }
+}
+
 void FEngine::flush() {
     // flush the command buffer
     flushCommandBuffer(mCommandBufferQueue);
@@ -703,6 +888,10 @@ FMorphTargetBuffer* FEngine::createMorphTargetBuffer(const MorphTargetBuffer::Bu
     return create(mMorphTargetBuffers, builder);
 }
 
+FStaticBatch* FEngine::createStaticBatch(const StaticBatch::Builder& builder) noexcept {
+    return create(mStaticBatches, builder);
+}
+
 FTexture* FEngine::createTexture(const Texture::Builder& builder) noexcept {
     return create(mTextures, builder);
 }
@@ -824,12 +1013,15 @@ void FEngine::destroyCameraComponent(utils::Entity entity) noexcept {
 }
 
 
-void FEngine::createRenderable(const RenderableManager::Builder& builder, Entity entity) {
-    mRenderableManager.create(builder, entity);
+void FEngine::createRenderables(const RenderableManager::Builder& builder,
+        Entity const* entities, size_t count) {
+    mRenderableManager.create(builder, entities, count);
     auto& tcm = mTransformManager;
-    // if this entity doesn't have a transform component, add one.
-    if (!tcm.hasComponent(entity)) {
-        tcm.create(entity, 0, mat4f());
+    // if an entity doesn't have a transform component, add one.
+    for (size_t i = 0; i < count; i++) {
+        if (!tcm.hasComponent(entities[i])) {
+            tcm.create(entities[i], 0, mat4f());
+        }
     }
 }
 
@@ -937,6 +1129,11 @@ bool FEngine::destroy(const FMorphTargetBuffer* p) {
     return terminateAndDestroy(p, mMorphTargetBuffers);
 }
 
+UTILS_NOINLINE
+bool FEngine::destroy(const FStaticBatch* p) {
+    return terminateAndDestroy(p, mStaticBatches);
+}
+
 UTILS_NOINLINE
 bool FEngine::destroy(const FRenderer* p) {
     return terminateAndDestroy(p, mRenderers);
@@ -23,6 +23,7 @@
 #include "DFG.h"
 #include "PostProcessManager.h"
 #include "ResourceList.h"
+#include "UniformBufferPool.h"
 
 #include "components/CameraManager.h"
 #include "components/LightManager.h"
@@ -39,6 +40,7 @@
 #include "details/SkinningBuffer.h"
 #include "details/MorphTargetBuffer.h"
 #include "details/Skybox.h"
+#include "details/StaticBatch.h"
 
 #include "private/backend/CommandBufferQueue.h"
 #include "private/backend/CommandStream.h"
@@ -73,6 +75,7 @@ using MaterialKey = uint32_t;
 #include <utils/JobSystem.h>
 #include <utils/CountDownLatch.h>
 
+#include <array>
 #include <chrono>
 #include <memory>
 #include <new>
@@ -219,6 +222,13 @@ public:
         return mBackend;
     }
 
+    // Vulkan and Metal stage buffer updates on the GPU timeline, so updating a few ranges of a
+    // buffer in use is cheaper than uploading all of it. OpenGL instead stalls or copies the
+    // buffer on partial updates, unless the whole buffer is orphaned.
+    bool prefersPartialBufferUpdates() const noexcept {
+        return mBackend == Backend::VULKAN || mBackend == Backend::METAL;
+    }
+
     Platform* getPlatform() const noexcept {
         return mPlatform;
     }
@@ -228,6 +238,10 @@ public:
         return *mResourceAllocator;
     }
 
+    UniformBufferPool& getUniformBufferPool() noexcept {
+        return mUniformBufferPool;
+    }
+
     void* streamAlloc(size_t size, size_t alignment) noexcept;
 
     Epoch getEngineEpoch() const { return mEngineEpoch; }
@@ -247,6 +261,7 @@ public:
     FIndexBuffer* createIndexBuffer(const IndexBuffer::Builder& builder) noexcept;
     FSkinningBuffer* createSkinningBuffer(const SkinningBuffer::Builder& builder) noexcept;
     FMorphTargetBuffer* createMorphTargetBuffer(const MorphTargetBuffer::Builder& builder) noexcept;
+    FStaticBatch* createStaticBatch(const StaticBatch::Builder& builder) noexcept;
     FIndirectLight* createIndirectLight(const IndirectLight::Builder& builder) noexcept;
     FMaterial* createMaterial(const Material::Builder& builder) noexcept;
     FTexture* createTexture(const Texture::Builder& builder) noexcept;
@@ -255,7 +270,8 @@ public:
     FStream* createStream(const Stream::Builder& builder) noexcept;
     FRenderTarget* createRenderTarget(const RenderTarget::Builder& builder) noexcept;
 
-    void createRenderable(const RenderableManager::Builder& builder, utils::Entity entity);
+    void createRenderables(const RenderableManager::Builder& builder,
+            utils::Entity const* entities, size_t count);
     void createLight(const LightManager::Builder& builder, utils::Entity entity);
 
     FRenderer* createRenderer() noexcept;
@@ -279,6 +295,7 @@ public:
     bool destroy(const FIndexBuffer* p);
     bool destroy(const FSkinningBuffer* p);
     bool destroy(const FMorphTargetBuffer* p);
+    bool destroy(const FStaticBatch* p);
     bool destroy(const FIndirectLight* p);
     bool destroy(const FMaterial* p);
     bool destroy(const FMaterialInstance* p);
@@ -321,6 +338,19 @@ public:
     void prepare();
     void gc();
 
+    // memory accounting, see Engine::getMemoryReport()
+    void getMemoryReport(MemoryReport& report) const noexcept;
+    void forEachMemoryOwner(utils::Invocable<void(MemoryCategory category, const char* owner,
+            MemoryReport::Usage const& usage)>&& functor) const noexcept;
+    void setMemoryBudget(MemoryCategory category, size_t budget,
+            MemoryBudgetCallback&& callback) noexcept;
+    size_t getMemoryBudget(MemoryCategory category) const noexcept {
+        return mMemoryBudgets[size_t(category)].budget;
+    }
+    // checks the memory budgets, evicting or calling the callbacks if needed.
+    // called once per frame.
+    void checkMemoryBudgets() noexcept;
+
     using ShaderContent = utils::FixedCapacityVector<uint8_t>;
 
     ShaderContent& getVertexShaderContent() const noexcept {
@@ -424,6 +454,7 @@ private:
     FLightManager mLightManager;
     FCameraManager mCameraManager;
     ResourceAllocator* mResourceAllocator = nullptr;
+    UniformBufferPool mUniformBufferPool;
 
     ResourceList<FBufferObject> mBufferObjects{ "BufferObject" };
     ResourceList<FRenderer> mRenderers{ "Renderer" };
@@ -434,6 +465,7 @@ private:
     ResourceList<FIndexBuffer> mIndexBuffers{ "IndexBuffer" };
     ResourceList<FSkinningBuffer> mSkinningBuffers{ "SkinningBuffer" };
     ResourceList<FMorphTargetBuffer> mMorphTargetBuffers{ "MorphTargetBuffer" };
+    ResourceList<FStaticBatch> mStaticBatches{ "StaticBatch" };
     ResourceList<FVertexBuffer> mVertexBuffers{ "VertexBuffer" };
     ResourceList<FIndirectLight> mIndirectLights{ "IndirectLight" };
     ResourceList<FMaterial> mMaterials{ "Material" };
@@ -495,6 +527,15 @@ private:
     // Creation parameters
     Config mConfig;
 
+    MemoryReport::Usage getMemoryUsage(MemoryCategory category) const noexcept;
+
+    struct MemoryBudget {
+        size_t budget = 0;
+        MemoryBudgetCallback callback;
+        bool overBudget = false;
+    };
+    std::array<MemoryBudget, MEMORY_CATEGORY_COUNT> mMemoryBudgets;
+
 public:
     // these are the debug properties used by FDebug. They're accessed directly by modules who need them.
     struct {
@@ -505,6 +546,9 @@ public:
             bool tightly_bound_scene = true;
             float dzn = -1.0f;
             float dzf =  1.0f;
+            // shadow map render passes and draw commands of the last rendered view (read-only)
+            int pass_count = 0;
+            int draw_count = 0;
         } shadowmap;
         struct {
             bool camera_at_origin = true;
@@ -519,6 +563,8 @@ public:
             // capture to file. At the moment, only supported by the Metal backend.
             bool doFrameCapture = false;
             bool disable_buffer_padding = false;
+            // draw commands of the color pass of the last rendered view (read-only)
+            int color_draw_count = 0;
         } renderer;
         matdbg::DebugServer* server = nullptr;
     } debug;
@@ -27,9 +27,6 @@ namespace filament {
 
 using namespace backend;
 
-utils::Mutex FFence::sLock;
-utils::Condition FFence::sCondition;
-
 static const constexpr uint64_t PUMP_INTERVAL_MILLISECONDS = 1;
 
 using ms = std::chrono::milliseconds;
@@ -116,27 +113,27 @@ FenceStatus FFence::wait(Mode mode, uint64_t timeout) noexcept {
 
 UTILS_NOINLINE
 void FFence::FenceSignal::signal(State s) noexcept {
-    std::lock_guard<utils::Mutex> lock(FFence::sLock);
+    std::lock_guard<utils::Mutex> lock(mLock);
     mState = s;
-    FFence::sCondition.notify_all();
+    mCondition.notify_all();
 }
 
 UTILS_NOINLINE
 Fence::FenceStatus FFence::FenceSignal::wait(uint64_t timeout) noexcept {
-    std::unique_lock<utils::Mutex> lock(FFence::sLock);
+    std::unique_lock<utils::Mutex> lock(mLock);
     while (mState == UNSIGNALED) {
-        if (mState == DESTROYED) {
-            return FenceStatus::ERROR;
-        }
         if (timeout == FENCE_WAIT_FOR_EVER) {
-            FFence::sCondition.wait(lock);
+            mCondition.wait(lock);
         } else {
             if (timeout == 0 ||
-                    sCondition.wait_for(lock, ns(timeout)) == std::cv_status::timeout) {
+                    mCondition.wait_for(lock, ns(timeout)) == std::cv_status::timeout) {
                 return FenceStatus::TIMEOUT_EXPIRED;
             }
         }
     }
+    if (mState == DESTROYED) {
+        return FenceStatus::ERROR;
+    }
     return FenceStatus::CONDITION_SATISFIED;
 }
 
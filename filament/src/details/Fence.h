@@ -48,11 +48,8 @@ public:
     static FenceStatus waitAndDestroy(FFence* fence, Mode mode) noexcept;
 
 private:
-    // We assume we don't have a lot of contention of fence and have all of them
-    // share a single lock/condition
-    static utils::Mutex sLock;
-    static utils::Condition sCondition;
-
+    // Each fence has its own lock/condition, so that signaling a fence only wakes up the
+    // threads waiting on that fence.
     struct FenceSignal {
         explicit FenceSignal(Type type) noexcept : mType(type) { }
         enum State : uint8_t { UNSIGNALED, SIGNALED, DESTROYED };
@@ -60,6 +57,8 @@ private:
         // much smaller (since it needs to be multiple of 8 on 64 bits architectures)
         const Type mType;
         State mState = UNSIGNALED;
+        utils::Mutex mLock;
+        utils::Condition mCondition;
         void signal(State s = SIGNALED) noexcept;
         FenceStatus wait(uint64_t timeout) noexcept;
     };
@@ -52,7 +52,9 @@ IndexBuffer* IndexBuffer::Builder::build(Engine& engine) {
 // ------------------------------------------------------------------------------------------------
 
 FIndexBuffer::FIndexBuffer(FEngine& engine, const IndexBuffer::Builder& builder)
-        : mIndexCount(builder->mIndexCount) {
+        : mIndexCount(builder->mIndexCount),
+          mByteCount(builder->mIndexCount *
+                (builder->mIndexType == IndexType::USHORT ? sizeof(uint16_t) : sizeof(uint32_t))) {
     FEngine::DriverApi& driver = engine.getDriverApi();
     mHandle = driver.createIndexBuffer(
             (backend::ElementType)builder->mIndexType,
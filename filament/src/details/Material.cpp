@@ -530,6 +530,26 @@ void FMaterial::createAndCacheProgram(Program&& p, Variant variant) const noexce
     mCachedPrograms[variant.key] = program;
 }
 
+bool FMaterial::isProgramReadySlow(Variant variant) const noexcept {
+    auto const program = mCachedPrograms[variant.key];
+    assert_invariant(program);
+    bool const ready = mEngine.getDriverApi().isProgramReady(program);
+    if (ready) {
+        mReadyPrograms.set(variant.key);
+    }
+    return ready;
+}
+
+bool FMaterial::isReady() const noexcept {
+    for (Variant::type_t k = 0, n = VARIANT_COUNT; k < n; ++k) {
+        const Variant variant(k);
+        if (mCachedPrograms[k] && !isProgramReady(variant)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 size_t FMaterial::getParameters(ParameterInfo* parameters, size_t count) const noexcept {
     count = std::min(count, getParameterCount());
 
@@ -586,6 +606,7 @@ void FMaterial::applyPendingEdits() noexcept {
     for (auto& program : mCachedPrograms) {
         program.clear();
     }
+    mReadyPrograms.reset();
     delete mMaterialParser;
     mMaterialParser = mPendingEdits;
     mPendingEdits = nullptr;
@@ -637,4 +658,21 @@ void FMaterial::destroyPrograms(FEngine& engine) {
     }
 }
 
+size_t FMaterial::getProgramCount() const noexcept {
+    size_t count = 0;
+    auto const& cachedPrograms = mCachedPrograms;
+    for (Variant::type_t k = 0, n = VARIANT_COUNT; k < n; ++k) {
+        const Variant variant(k);
+        if (!mIsDefaultMaterial) {
+            // same as destroyPrograms(), we don't own the shared depth variants
+            bool const isSharedVariant = Variant::isValidDepthVariant(variant) && !mHasCustomDepthShader;
+            if (isSharedVariant) {
+                continue;
+            }
+        }
+        count += cachedPrograms[k] ? 1 : 0;
+    }
+    return count;
+}
+
 } // namespace filament
@@ -29,6 +29,7 @@
 #include <private/filament/Variant.h>
 #include <private/filament/ConstantInfo.h>
 
+#include <utils/bitset.h>
 #include <utils/compiler.h>
 #include <utils/Mutex.h>
 
@@ -100,6 +101,19 @@ public:
         return mCachedPrograms[variant.key];
     }
 
+    // isProgramReady returns whether the backend is done compiling the program for the given
+    // variant, programs may compile in the background. Must be called after prepareProgram().
+    bool isProgramReady(Variant variant) const noexcept {
+        // once a program is ready it stays ready, so we only ask the backend until then.
+        if (UTILS_LIKELY(mReadyPrograms[variant.key])) {
+            return true;
+        }
+        return isProgramReadySlow(variant);
+    }
+
+    // whether all the programs created so far are ready
+    bool isReady() const noexcept;
+
     bool isVariantLit() const noexcept { return mIsVariantLit; }
 
     const utils::CString& getName() const noexcept { return mName; }
@@ -149,6 +163,10 @@ public:
 
     void destroyPrograms(FEngine& engine);
 
+    // number of programs created for this material, excluding those shared with the
+    // default material
+    size_t getProgramCount() const noexcept;
+
 #if FILAMENT_ENABLE_MATDBG
     void applyPendingEdits() noexcept;
 
@@ -183,6 +201,7 @@ public:
 
 private:
     void prepareProgramSlow(Variant variant) const noexcept;
+    bool isProgramReadySlow(Variant variant) const noexcept;
     void getSurfaceProgramSlow(Variant variant) const noexcept;
     void getPostProcessProgramSlow(Variant variant) const noexcept;
     backend::Program getProgramWithVariants(Variant variant, Variant vertexVariant,
@@ -194,6 +213,8 @@ private:
 
     // try to order by frequency of use
     mutable std::array<backend::Handle<backend::HwProgram>, VARIANT_COUNT> mCachedPrograms;
+    mutable utils::bitset128 mReadyPrograms;
+    static_assert(VARIANT_COUNT <= utils::bitset128::BIT_COUNT);
 
     backend::RasterState mRasterState;
     BlendingMode mRenderBlendingMode = BlendingMode::OPAQUE;
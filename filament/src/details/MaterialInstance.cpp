@@ -67,8 +67,8 @@ FMaterialInstance::FMaterialInstance(FEngine& engine,
 
     if (!material->getUniformInterfaceBlock().isEmpty()) {
         mUniforms.setUniforms(other->getUniformBuffer());
-        mUbHandle = driver.createBufferObject(mUniforms.getSize(),
-                BufferObjectBinding::UNIFORM, backend::BufferUsage::DYNAMIC);
+        mUbAllocation = engine.getUniformBufferPool().allocate(driver,
+                uint32_t(mUniforms.getSize()));
     }
 
     if (!material->getSamplerInterfaceBlock().isEmpty()) {
@@ -109,8 +109,8 @@ void FMaterialInstance::initDefaultInstance(FEngine& engine, FMaterial const* ma
 
     if (!material->getUniformInterfaceBlock().isEmpty()) {
         mUniforms = UniformBuffer(material->getUniformInterfaceBlock().getSize());
-        mUbHandle = driver.createBufferObject(mUniforms.getSize(),
-                BufferObjectBinding::UNIFORM, backend::BufferUsage::STATIC);
+        mUbAllocation = engine.getUniformBufferPool().allocate(driver,
+                uint32_t(mUniforms.getSize()));
     }
 
     if (!material->getSamplerInterfaceBlock().isEmpty()) {
@@ -155,14 +155,23 @@ FMaterialInstance::~FMaterialInstance() noexcept = default;
 
 void FMaterialInstance::terminate(FEngine& engine) {
     FEngine::DriverApi& driver = engine.getDriverApi();
-    driver.destroyBufferObject(mUbHandle);
+    engine.getUniformBufferPool().free(driver, mUbAllocation);
     driver.destroySamplerGroup(mSbHandle);
 }
 
 void FMaterialInstance::commitSlow(DriverApi& driver) const {
     // update uniforms if needed
     if (mUniforms.isDirty()) {
-        driver.updateBufferObject(mUbHandle, mUniforms.toBufferDescriptor(driver), 0);
+        if (UniformBufferPool::isPooled(mUbAllocation)) {
+            // The block may still be read by the frames in flight, and writing into a buffer the
+            // GPU is using would stall. Instead, write all the uniforms into a fresh block.
+            mMaterial->getEngine().getUniformBufferPool().orphan(driver, mUbAllocation);
+            driver.updateBufferObjectUnsynchronized(mUbAllocation.handle,
+                    mUniforms.toBufferDescriptor(driver), mUbAllocation.offset);
+        } else {
+            mUniforms.commit(driver, mUbAllocation.handle,
+                    mMaterial->getEngine().prefersPartialBufferUpdates(), mUbAllocation.offset);
+        }
     }
     if (mSamplers.isDirty()) {
         driver.updateSamplerGroup(mSbHandle, mSamplers.toBufferDescriptor(driver));
@@ -177,11 +186,10 @@ void FMaterialInstance::setParameter(std::string_view name,
     mSamplers.setSampler(index, { texture, params });
 }
 
-void FMaterialInstance::setParameterImpl(std::string_view name,
-        FTexture const* texture, TextureSampler const& sampler) {
-
 #ifndef NDEBUG
-    // Per GLES3.x specification, depth texture can't be filtered unless in compare mode.
+// Per GLES3.x specification, depth texture can't be filtered unless in compare mode.
+static void checkDepthSampler(FMaterial const* material, std::string_view name,
+        FTexture const* texture, TextureSampler const& sampler) {
     if (texture && isDepthFormat(texture->getFormat())) {
         if (sampler.getCompareMode() == SamplerCompareMode::NONE) {
             SamplerMinFilter const minFilter = sampler.getMinFilter();
@@ -194,10 +202,18 @@ void FMaterialInstance::setParameterImpl(std::string_view name,
                 PANIC_LOG("Depth textures can't be sampled with a linear filter "
                           "unless the comparison mode is set to COMPARE_TO_TEXTURE. "
                           "(material: \"%s\", parameter: \"%.*s\")",
-                          getMaterial()->getName().c_str(), name.size(), name.data());
+                          material->getName().c_str(), name.size(), name.data());
             }
         }
     }
+}
+#endif
+
+void FMaterialInstance::setParameterImpl(std::string_view name,
+        FTexture const* texture, TextureSampler const& sampler) {
+
+#ifndef NDEBUG
+    checkDepthSampler(getMaterial(), name, texture, sampler);
 #endif
 
     Handle<HwTexture> handle{};
@@ -207,6 +223,74 @@ void FMaterialInstance::setParameterImpl(std::string_view name,
     setParameter(name, handle, sampler.getSamplerParams());
 }
 
+void FMaterialInstance::setParameterImpl(ParameterHandle handle,
+        FTexture const* texture, TextureSampler const& sampler) {
+    checkSamplerParameterHandle(handle);
+    if (UTILS_UNLIKELY(!handle.isValid())) {
+        return;
+    }
+
+#ifndef NDEBUG
+    for (auto const& info : mMaterial->getSamplerInterfaceBlock().getSamplerInfoList()) {
+        if (info.offset == handle.offset) {
+            checkDepthSampler(getMaterial(), info.name.c_str(), texture, sampler);
+        }
+    }
+#endif
+
+    Handle<HwTexture> th{};
+    if (UTILS_LIKELY(texture)) {
+        th = texture->getHwHandle();
+    }
+    mSamplers.setSampler(handle.offset, { th, sampler.getSamplerParams() });
+}
+
+void FMaterialInstance::checkSamplerParameterHandle(ParameterHandle handle) const {
+    if (UTILS_UNLIKELY(!handle.isValid())) {
+        return;
+    }
+    // offsets are only meaningful for the material the handle was looked up from
+    ASSERT_PRECONDITION(handle.material == mMaterial,
+            "parameter handle from another material used on an instance of material \"%s\"",
+            mMaterial->getName().c_str());
+    ASSERT_PRECONDITION(handle.sampler && handle.offset < mSamplers.getSize(),
+            "parameter handle isn't a sampler of material \"%s\"",
+            mMaterial->getName().c_str());
+}
+
+void FMaterialInstance::checkUniformParameterHandle(ParameterHandle handle,
+        bool compatible, size_t size) const {
+    if (UTILS_UNLIKELY(!handle.isValid())) {
+        return;
+    }
+    ASSERT_PRECONDITION(handle.material == mMaterial,
+            "parameter handle from another material used on an instance of material \"%s\"",
+            mMaterial->getName().c_str());
+    ASSERT_PRECONDITION(!handle.sampler && compatible,
+            "value type doesn't match the parameter of material \"%s\"",
+            mMaterial->getName().c_str());
+    ASSERT_PRECONDITION(handle.offset + size <= mUniforms.getSize(),
+            "parameter handle out of the uniforms of material \"%s\"",
+            mMaterial->getName().c_str());
+}
+
+MaterialInstance::ParameterHandle FMaterialInstance::getParameterHandle(
+        std::string_view name) const {
+    BufferInterfaceBlock const& uib = mMaterial->getUniformInterfaceBlock();
+    if (uib.hasField(name)) {
+        auto const* info = uib.getFieldInfo(name);
+        return { mMaterial, uint32_t(info->getBufferOffset()),
+                 uint16_t(std::max(1u, info->size)), info->type, false };
+    }
+    SamplerInterfaceBlock const& sib = mMaterial->getSamplerInterfaceBlock();
+    if (!ASSERT_PRECONDITION_NON_FATAL(sib.hasSampler(name),
+            "parameter named \"%.*s\" not found in material \"%s\"",
+            name.size(), name.data(), mMaterial->getName().c_str())) {
+        return {};
+    }
+    return { mMaterial, sib.getSamplerInfo(name)->offset, 1, {}, true };
+}
+
 void FMaterialInstance::setMaskThreshold(float threshold) noexcept {
     setParameter("_maskThreshold", math::saturate(threshold));
     mMaskThreshold = math::saturate(threshold);
@@ -19,6 +19,7 @@
 
 #include "downcast.h"
 #include "UniformBuffer.h"
+#include "UniformBufferPool.h"
 #include "details/Engine.h"
 
 #include "private/backend/DriverApi.h"
@@ -55,8 +56,12 @@ public:
     }
 
     void use(FEngine::DriverApi& driver) const {
-        if (mUbHandle) {
-            driver.bindUniformBuffer(+UniformBindingPoints::PER_MATERIAL_INSTANCE, mUbHandle);
+        if (mUbAllocation.handle) {
+            // The uniforms live in a buffer shared with other instances, so switching instances
+            // always binds a new range. Only the GL state cache skips binding the same range.
+            driver.bindBufferRange(backend::BufferObjectBinding::UNIFORM,
+                    +UniformBindingPoints::PER_MATERIAL_INSTANCE,
+                    mUbAllocation.handle, mUbAllocation.offset, uint32_t(mUniforms.getSize()));
         }
         if (mSbHandle) {
             driver.bindSamplers(+SamplerBindingPoints::PER_MATERIAL_INSTANCE, mSbHandle);
@@ -208,6 +213,14 @@ public:
 
     using MaterialInstance::setParameter;
 
+    ParameterHandle getParameterHandle(std::string_view name) const;
+
+    // Panic if a valid handle wasn't looked up from this instance's material, or isn't a sampler
+    // (resp. a uniform). For uniforms, `compatible` tells whether the type of the value matches
+    // the parameter, and `size` is the number of bytes written at the handle's offset.
+    void checkSamplerParameterHandle(ParameterHandle handle) const;
+    void checkUniformParameterHandle(ParameterHandle handle, bool compatible, size_t size) const;
+
 private:
     friend class FMaterial;
     friend class MaterialInstance;
@@ -224,6 +237,21 @@ private:
     template<typename T>
     void setParameterImpl(std::string_view name, const T* value, size_t count);
 
+    template<size_t Size>
+    void setParameterUntypedImpl(ParameterHandle handle, const void* value);
+
+    template<size_t Size>
+    void setParameterUntypedImpl(ParameterHandle handle, const void* value, size_t count);
+
+    template<typename T>
+    void setParameterImpl(ParameterHandle handle, T const& value);
+
+    template<typename T>
+    void setParameterImpl(ParameterHandle handle, const T* value, size_t count);
+
+    void setParameterImpl(ParameterHandle handle,
+            FTexture const* texture, TextureSampler const& sampler);
+
     void setParameterImpl(std::string_view name,
             FTexture const* texture, TextureSampler const& sampler);
 
@@ -235,7 +263,8 @@ private:
     // keep these grouped, they're accessed together in the render-loop
     FMaterial const* mMaterial = nullptr;
 
-    backend::Handle<backend::HwBufferObject> mUbHandle;
+    // mutable because commit() moves the uniforms to a new block on each update
+    mutable UniformBufferPool::Allocation mUbAllocation;
     backend::Handle<backend::HwSamplerGroup> mSbHandle;
     UniformBuffer mUniforms;
     backend::SamplerGroup mSamplers;
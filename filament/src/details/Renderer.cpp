@@ -70,6 +70,8 @@ FRenderer::FRenderer(FEngine& engine) :
             &engine.debug.renderer.doFrameCapture);
     debugRegistry.registerProperty("d.renderer.disable_buffer_padding",
             &engine.debug.renderer.disable_buffer_padding);
+    debugRegistry.registerProperty("d.renderer.color_draw_count",
+            &engine.debug.renderer.color_draw_count);
 
     DriverApi& driver = engine.getDriverApi();
 
@@ -288,6 +290,7 @@ void FRenderer::endFrame() {
 
     mFrameInfoManager.endFrame(driver);
     mFrameSkipper.endFrame(driver);
+    engine.getUniformBufferPool().endFrame(driver);
 
     if (mSwapChain) {
         mSwapChain->commit(driver);
@@ -307,6 +310,7 @@ void FRenderer::endFrame() {
 
     // do this before engine.flush()
     engine.getResourceAllocator().gc();
+    engine.checkMemoryBudgets();
 
     // Run the component managers' GC in parallel
     // WARNING: while doing this we can't access any component manager
@@ -407,6 +411,7 @@ void FRenderer::renderStandaloneView(FView const* view) {
 
         renderInternal(view);
 
+        engine.getUniformBufferPool().endFrame(driver);
         driver.endFrame(mFrameId);
     }
 }
@@ -454,6 +459,43 @@ void FRenderer::renderInternal(FView const* view) {
     js.runAndWait(rootJob);
 }
 
+void FRenderer::applyQualityReductions(QualityGovernor const& governor,
+        AmbientOcclusionOptions& aoOptions, DepthOfFieldOptions& dofOptions,
+        ScreenSpaceReflectionsOptions& ssReflectionsOptions,
+        BloomOptions& bloomOptions) noexcept {
+    using Effect = QualityGovernor::Effect;
+
+    const uint8_t ao = governor.getReduction(Effect::AMBIENT_OCCLUSION);
+    if (ao >= 1) {
+        aoOptions.resolution = std::min(aoOptions.resolution, 0.5f);
+    }
+    if (ao >= 2) {
+        aoOptions.quality = QualityLevel::LOW;
+        aoOptions.ssct.sampleCount = std::min(aoOptions.ssct.sampleCount, uint8_t(2));
+    }
+
+    const uint8_t dof = governor.getReduction(Effect::DEPTH_OF_FIELD);
+    if (dof) {
+        auto reduceRingCount = [dof](uint8_t& count) {
+            const uint8_t c = count ? count : PostProcessManager::getDefaultDofRingCount();
+            count = uint8_t(std::max(int(c) - int(dof), 2));
+        };
+        dofOptions.nativeResolution = false;
+        reduceRingCount(dofOptions.foregroundRingCount);
+        reduceRingCount(dofOptions.backgroundRingCount);
+        reduceRingCount(dofOptions.fastGatherRingCount);
+    }
+
+    if (governor.getReduction(Effect::SCREEN_SPACE_REFLECTIONS)) {
+        ssReflectionsOptions.enabled = false;
+    }
+
+    // the bloom pass reduces the number of levels as needed
+    const uint32_t bloomResolution = bloomOptions.resolution;
+    bloomOptions.resolution = std::max(bloomResolution >> governor.getReduction(Effect::BLOOM),
+            std::min(bloomResolution, 32u));
+}
+
 void FRenderer::renderJob(ArenaScope& arena, FView& view) {
     FEngine& engine = mEngine;
     JobSystem& js = engine.getJobSystem();
@@ -492,6 +534,22 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
         scale = 1.0f;
     }
 
+    if (view.getQualityGovernorOptions().enabled) {
+        // Let the governor see which effects are used, and lower the quality of the ones it
+        // picked. Shadows are handled by the ShadowMapManager.
+        using Effect = QualityGovernor::Effect;
+        QualityGovernor::EffectMask active;
+        active.set(size_t(Effect::AMBIENT_OCCLUSION), aoOptions.enabled);
+        active.set(size_t(Effect::SHADOWS), view.needsShadowMap());
+        active.set(size_t(Effect::DEPTH_OF_FIELD), dofOptions.enabled);
+        active.set(size_t(Effect::SCREEN_SPACE_REFLECTIONS), ssReflectionsOptions.enabled);
+        active.set(size_t(Effect::BLOOM), bloomOptions.enabled);
+        view.updateQualityGovernor(mFrameInfoManager.getLastFrameInfo(),
+                mFrameInfoManager.getFrameTimeCount(), mFrameRateOptions, mDisplayInfo, active);
+        applyQualityReductions(view.getQualityGovernor(),
+                aoOptions, dofOptions, ssReflectionsOptions, bloomOptions);
+    }
+
     const bool blendModeTranslucent = view.getBlendMode() == BlendMode::TRANSLUCENT;
     // If the swap-chain is transparent or if we blend into it, we need to allocate our intermediate
     // buffers with an alpha channel.
@@ -865,6 +923,7 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
     pass.setVariant(variant);
     pass.appendCommands(engine, RenderPass::COLOR);
     pass.sortCommands(engine);
+    engine.debug.renderer.color_draw_count = int(pass.end() - pass.begin());
 
     FrameGraphTexture::Descriptor const desc = {
             .width = config.physicalViewport.width,
@@ -23,6 +23,7 @@
 #include "FrameInfo.h"
 #include "FrameSkipper.h"
 #include "PostProcessManager.h"
+#include "QualityGovernor.h"
 #include "RenderPass.h"
 
 #include "details/SwapChain.h"
@@ -32,6 +33,7 @@
 #include <fg/FrameGraphId.h>
 #include <fg/FrameGraphTexture.h>
 
+#include <filament/Options.h>
 #include <filament/Renderer.h>
 #include <filament/Viewport.h>
 
@@ -127,6 +129,14 @@ public:
         mClearOptions = options;
     }
 
+    float getLastFrameGpuTime() const noexcept {
+        return mFrameInfoManager.getLastFrameTime().count();
+    }
+
+    uint32_t getFrameGpuTimeCount() const noexcept {
+        return mFrameInfoManager.getFrameTimeCount();
+    }
+
 private:
     friend class Renderer;
     using Command = RenderPass::Command;
@@ -160,6 +170,10 @@ private:
 
     void renderInternal(FView const* view);
     void renderJob(ArenaScope& arena, FView& view);
+    static void applyQualityReductions(QualityGovernor const& governor,
+            AmbientOcclusionOptions& aoOptions, DepthOfFieldOptions& dofOptions,
+            ScreenSpaceReflectionsOptions& ssReflectionsOptions,
+            BloomOptions& bloomOptions) noexcept;
 
     // keep a reference to our engine
     FEngine& mEngine;
@@ -127,17 +127,13 @@ void FScene::prepare(utils::JobSystem& js,
      * Evaluate the capacity needed for the renderable and light SoAs
      */
 
-    // we need the capacity to be multiple of 16 for SIMD loops
+    // the SoAs round the capacity up to a multiple of 16 for SIMD loops
     // we need 1 extra entry at the end for the summed primitive count
-    size_t renderableDataCapacity = entities.size();
-    renderableDataCapacity = (renderableDataCapacity + 0xFu) & ~0xFu;
-    renderableDataCapacity = renderableDataCapacity + 1;
+    size_t const renderableDataCapacity = entities.size() + 1;
 
     // The light data list will always contain at least one entry for the
     // dominating directional light, even if there are no entities.
-    // we need the capacity to be multiple of 16 for SIMD loops
-    size_t lightDataCapacity = std::max<size_t>(DIRECTIONAL_LIGHTS_COUNT, entities.size());
-    lightDataCapacity = (lightDataCapacity + 0xFu) & ~0xFu;
+    size_t const lightDataCapacity = std::max<size_t>(DIRECTIONAL_LIGHTS_COUNT, entities.size());
 
     /*
      * Now resize the SoAs if needed
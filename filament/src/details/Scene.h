@@ -31,6 +31,7 @@
 #include <filament/Box.h>
 #include <filament/Scene.h>
 
+#include <utils/architecture.h>
 #include <utils/compiler.h>
 #include <utils/Entity.h>
 #include <utils/Slice.h>
@@ -88,6 +89,12 @@ public:
 
     using VisibleMaskType = Culler::result_type;
 
+    // Our SoAs are processed by SIMD loops: each array is cache-line aligned, and the capacity
+    // is a multiple of 16 elements, so these loops can always process paddedSize() elements.
+    static constexpr size_t SOA_FIELD_ALIGNMENT = utils::CACHELINE_SIZE;
+    static constexpr size_t SOA_CAPACITY_MULTIPLE = 16;
+    static_assert(SOA_CAPACITY_MULTIPLE % Culler::MODULO == 0);
+
     enum {
         RENDERABLE_INSTANCE,    //   4 | instance of the Renderable component
         WORLD_TRANSFORM,        //  16 | instance of the Transform component
@@ -112,7 +119,8 @@ public:
         USER_DATA,              //   4 | user data currently used to store the scale
     };
 
-    using RenderableSoa = utils::StructureOfArrays<
+    using RenderableSoa = utils::AlignedStructureOfArrays<
+            SOA_FIELD_ALIGNMENT, SOA_CAPACITY_MULTIPLE,
             utils::EntityInstance<RenderableManager>,   // RENDERABLE_INSTANCE
             math::mat4f,                                // WORLD_TRANSFORM
             FRenderableManager::Visibility,             // VISIBILITY_STATE
@@ -168,7 +176,8 @@ public:
         SHADOW_INFO
     };
 
-    using LightSoa = utils::StructureOfArrays<
+    using LightSoa = utils::AlignedStructureOfArrays<
+            SOA_FIELD_ALIGNMENT, SOA_CAPACITY_MULTIPLE,
             math::float4,
             math::float3,
             FLightManager::Instance,
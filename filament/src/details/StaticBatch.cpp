@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "details/StaticBatch.h"
+
+#include "components/RenderableManager.h"
+#include "components/TransformManager.h"
+
+#include "details/Engine.h"
+#include "details/IndexBuffer.h"
+#include "details/VertexBuffer.h"
+
+#include "FilamentAPI-impl.h"
+
+#include <filament/Box.h>
+
+#include <utils/EntityManager.h>
+#include <utils/Panic.h>
+
+#include <math/norm.h>
+#include <math/quat.h>
+
+#include <tsl/robin_map.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <stdlib.h>
+
+namespace filament {
+
+using namespace backend;
+using namespace math;
+
+struct StaticBatch::BuilderDetails {
+    std::vector<Mesh> mMeshes;
+    uint32_t mMaxChunkTriangleCount = 8192;
+    bool mCastShadows = false;
+    bool mReceiveShadows = true;
+};
+
+using BuilderType = StaticBatch;
+BuilderType::Builder::Builder() noexcept = default;
+BuilderType::Builder::~Builder() noexcept = default;
+BuilderType::Builder::Builder(BuilderType::Builder const& rhs) noexcept = default;
+BuilderType::Builder::Builder(BuilderType::Builder&& rhs) noexcept = default;
+BuilderType::Builder& BuilderType::Builder::operator=(BuilderType::Builder const& rhs) noexcept = default;
+BuilderType::Builder& BuilderType::Builder::operator=(BuilderType::Builder&& rhs) noexcept = default;
+
+StaticBatch::Builder& StaticBatch::Builder::mesh(Mesh const& mesh) noexcept {
+    mImpl->mMeshes.push_back(mesh);
+    return *this;
+}
+
+StaticBatch::Builder& StaticBatch::Builder::maxChunkTriangleCount(uint32_t count) noexcept {
+    mImpl->mMaxChunkTriangleCount = count;
+    return *this;
+}
+
+StaticBatch::Builder& StaticBatch::Builder::castShadows(bool enable) noexcept {
+    mImpl->mCastShadows = enable;
+    return *this;
+}
+
+StaticBatch::Builder& StaticBatch::Builder::receiveShadows(bool enable) noexcept {
+    mImpl->mReceiveShadows = enable;
+    return *this;
+}
+
+StaticBatch* StaticBatch::Builder::build(Engine& engine) {
+    auto const& meshes = mImpl->mMeshes;
+    ASSERT_PRECONDITION(!meshes.empty(), "StaticBatch has no meshes");
+    ASSERT_PRECONDITION(mImpl->mMaxChunkTriangleCount > 0, "maxChunkTriangleCount cannot be 0");
+
+    const bool hasTangents = meshes[0].tangents;
+    const bool hasUv0 = meshes[0].uv0;
+    size_t vertexCount = 0;
+    for (size_t i = 0, c = meshes.size(); i < c; i++) {
+        Mesh const& mesh = meshes[i];
+        ASSERT_PRECONDITION(mesh.materialInstance, "mesh %zu has no material instance", i);
+        ASSERT_PRECONDITION(mesh.positions && mesh.vertexCount, "mesh %zu has no vertices", i);
+        ASSERT_PRECONDITION(mesh.indices && mesh.indexCount && mesh.indexCount % 3 == 0,
+                "mesh %zu doesn't have a valid triangle list", i);
+        ASSERT_PRECONDITION(bool(mesh.tangents) == hasTangents && bool(mesh.uv0) == hasUv0,
+                "mesh %zu doesn't have the same vertex attributes as the first mesh", i);
+        ASSERT_PRECONDITION(std::all_of(mesh.indices, mesh.indices + mesh.indexCount,
+                [n = mesh.vertexCount](uint32_t index) { return index < n; }),
+                "mesh %zu has out of range indices", i);
+        vertexCount += mesh.vertexCount;
+    }
+    ASSERT_PRECONDITION(vertexCount <= std::numeric_limits<uint32_t>::max(),
+            "StaticBatch has too many vertices (%zu)", vertexCount);
+
+    return downcast(engine).createStaticBatch(*this);
+}
+
+// ------------------------------------------------------------------------------------------------
+
+namespace {
+
+struct Chunk {
+    MaterialInstance const* materialInstance;
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    uint32_t minIndex;
+    uint32_t maxIndex;
+    Aabb bounds;
+};
+
+void freeBuffer(void* buffer, size_t, void*) {
+    free(buffer);
+}
+
+} // anonymous namespace
+
+FStaticBatch::FStaticBatch(FEngine& engine, const Builder& builder)
+        : mMeshCount(builder->mMeshes.size()) {
+    auto const& meshes = builder->mMeshes;
+    const bool hasTangents = meshes[0].tangents;
+    const bool hasUv0 = meshes[0].uv0;
+
+    // world space bounds of each mesh, and of the whole batch
+    std::vector<Aabb> bounds(meshes.size());
+    Aabb batchBounds;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (size_t i = 0, c = meshes.size(); i < c; i++) {
+        Mesh const& mesh = meshes[i];
+        Aabb local;
+        for (size_t v = 0; v < mesh.vertexCount; v++) {
+            local.min = min(local.min, mesh.positions[v]);
+            local.max = max(local.max, mesh.positions[v]);
+        }
+        bounds[i] = Aabb::transform(mesh.transform.upperLeft(), mesh.transform[3].xyz, local);
+        batchBounds.min = min(batchBounds.min, bounds[i].min);
+        batchBounds.max = max(batchBounds.max, bounds[i].max);
+        vertexCount += mesh.vertexCount;
+        indexCount += mesh.indexCount;
+    }
+
+    // Meshes are grouped by material instance, in order of first appearance, and sorted along a
+    // Morton curve within each group so that the chunks are spatially coherent.
+    tsl::robin_map<MaterialInstance const*, uint32_t> groups;
+    std::vector<std::pair<uint64_t, uint32_t>> order(meshes.size());
+    const float3 extent = max(batchBounds.max - batchBounds.min,
+            float3{ std::numeric_limits<float>::min() });
+    for (size_t i = 0, c = meshes.size(); i < c; i++) {
+        const uint32_t group = groups.try_emplace(meshes[i].materialInstance,
+                uint32_t(groups.size())).first->second;
+        const float3 p = (bounds[i].center() - batchBounds.min) / extent;
+        order[i] = { (uint64_t(group) << 32u) | getMortonCode(p), uint32_t(i) };
+    }
+    std::sort(order.begin(), order.end());
+
+    // copy the meshes in that order, which makes each chunk a contiguous range of indices
+    const bool shortIndices = vertexCount <= 65536;
+    auto* const positions = static_cast<float3*>(malloc(vertexCount * sizeof(float3)));
+    auto* const tangents = static_cast<short4*>(
+            hasTangents ? malloc(vertexCount * sizeof(short4)) : nullptr);
+    auto* const uv0 = static_cast<float2*>(hasUv0 ? malloc(vertexCount * sizeof(float2)) : nullptr);
+    void* const indices = malloc(indexCount * (shortIndices ? sizeof(uint16_t) : sizeof(uint32_t)));
+    ASSERT_POSTCONDITION(positions && indices && (!hasTangents || tangents) && (!hasUv0 || uv0),
+            "Out of memory creating a StaticBatch of %zu vertices", vertexCount);
+
+    const size_t maxChunkIndexCount = size_t(builder->mMaxChunkTriangleCount) * 3;
+    std::vector<Chunk> chunks;
+    uint32_t vertexBase = 0;
+    uint32_t indexBase = 0;
+    for (auto const& [key, i] : order) {
+        Mesh const& mesh = meshes[i];
+
+        // start a new chunk when the material instance changes or the current chunk is full
+        if (chunks.empty() || chunks.back().materialInstance != mesh.materialInstance ||
+                chunks.back().indexCount + mesh.indexCount > maxChunkIndexCount) {
+            chunks.push_back({ mesh.materialInstance, indexBase, 0, vertexBase, 0, {} });
+        }
+        Chunk& chunk = chunks.back();
+        chunk.indexCount += uint32_t(mesh.indexCount);
+        chunk.maxIndex = vertexBase + uint32_t(mesh.vertexCount) - 1;
+        chunk.bounds.min = min(chunk.bounds.min, bounds[i].min);
+        chunk.bounds.max = max(chunk.bounds.max, bounds[i].max);
+
+        const mat3f m = mesh.transform.upperLeft();
+        const float3 t = mesh.transform[3].xyz;
+        for (size_t v = 0; v < mesh.vertexCount; v++) {
+            positions[vertexBase + v] = m * mesh.positions[v] + t;
+        }
+        if (hasTangents) {
+            const mat3f normalMatrix = transpose(inverse(m));
+            for (size_t v = 0; v < mesh.vertexCount; v++) {
+                tangents[vertexBase + v] = transformTangentFrame(m, normalMatrix, mesh.tangents[v]);
+            }
+        }
+        if (hasUv0) {
+            std::copy_n(mesh.uv0, mesh.vertexCount, uv0 + vertexBase);
+        }
+        // a reflection turns front faces into back faces, unless the winding is reversed
+        const bool flipWinding = det(m) < 0.0f;
+        if (shortIndices) {
+            copyTriangles(static_cast<uint16_t*>(indices) + indexBase,
+                    mesh.indices, mesh.indexCount, vertexBase, flipWinding);
+        } else {
+            copyTriangles(static_cast<uint32_t*>(indices) + indexBase,
+                    mesh.indices, mesh.indexCount, vertexBase, flipWinding);
+        }
+
+        vertexBase += uint32_t(mesh.vertexCount);
+        indexBase += uint32_t(mesh.indexCount);
+    }
+
+    // one vertex buffer and one index buffer for the whole batch
+    VertexBuffer::Builder vbb;
+    vbb.vertexCount(uint32_t(vertexCount))
+            .bufferCount(uint8_t(1 + hasTangents + hasUv0))
+            .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT3);
+    uint8_t const tangentsBuffer = 1;
+    uint8_t const uv0Buffer = hasTangents ? 2 : 1;
+    if (hasTangents) {
+        vbb.attribute(VertexAttribute::TANGENTS, tangentsBuffer,
+                        VertexBuffer::AttributeType::SHORT4)
+                .normalized(VertexAttribute::TANGENTS);
+    }
+    if (hasUv0) {
+        vbb.attribute(VertexAttribute::UV0, uv0Buffer, VertexBuffer::AttributeType::FLOAT2);
+    }
+    mVertexBuffer = downcast(vbb.build(engine));
+    mVertexBuffer->setBufferAt(engine, 0,
+            { positions, vertexCount * sizeof(float3), freeBuffer });
+    if (hasTangents) {
+        mVertexBuffer->setBufferAt(engine, tangentsBuffer,
+                { tangents, vertexCount * sizeof(short4), freeBuffer });
+    }
+    if (hasUv0) {
+        mVertexBuffer->setBufferAt(engine, uv0Buffer,
+                { uv0, vertexCount * sizeof(float2), freeBuffer });
+    }
+
+    mIndexBuffer = downcast(IndexBuffer::Builder()
+            .indexCount(uint32_t(indexCount))
+            .bufferType(shortIndices ? IndexBuffer::IndexType::USHORT : IndexBuffer::IndexType::UINT)
+            .build(engine));
+    mIndexBuffer->setBuffer(engine, { indices,
+            indexCount * (shortIndices ? sizeof(uint16_t) : sizeof(uint32_t)), freeBuffer });
+
+    // and one renderable, i.e. one draw call, per chunk
+    mEntities = utils::FixedCapacityVector<utils::Entity>(chunks.size());
+    utils::EntityManager::get().create(mEntities.size(), mEntities.data());
+    for (size_t i = 0, c = chunks.size(); i < c; i++) {
+        Chunk const& chunk = chunks[i];
+        RenderableManager::Builder(1)
+                .geometry(0, RenderableManager::PrimitiveType::TRIANGLES,
+                        mVertexBuffer, mIndexBuffer,
+                        chunk.indexOffset, chunk.minIndex, chunk.maxIndex, chunk.indexCount)
+                .material(0, chunk.materialInstance)
+                .boundingBox(Box().set(chunk.bounds.min, chunk.bounds.max))
+                .castShadows(builder->mCastShadows)
+                .receiveShadows(builder->mReceiveShadows)
+                .build(engine, mEntities[i]);
+    }
+}
+
+void FStaticBatch::terminate(FEngine& engine) {
+    engine.getRenderableManager().destroy(mEntities.data(), mEntities.size());
+    FTransformManager& tcm = engine.getTransformManager();
+    for (utils::Entity e : mEntities) {
+        tcm.destroy(e);
+    }
+    utils::EntityManager::get().destroy(mEntities.size(), mEntities.data());
+    engine.destroy(mVertexBuffer);
+    engine.destroy(mIndexBuffer);
+}
+
+short4 FStaticBatch::transformTangentFrame(mat3f const& m, mat3f const& normalMatrix,
+        short4 tangentFrame) noexcept {
+    const quatf q{ unpackSnorm16(tangentFrame) };
+    const mat3f frame{ q };
+    // packTangentFrame() stores the handedness of the bitangent in the sign of w
+    const float3 b = q.w < 0.0f ? cross(frame[2], frame[0]) : cross(frame[0], frame[2]);
+    const float3 n = normalize(normalMatrix * frame[2]);
+    float3 t = m * frame[0];
+    t = normalize(t - n * dot(n, t));
+    return packSnorm16(mat3f::packTangentFrame({ t, m * b, n }).xyzw);
+}
+
+uint32_t FStaticBatch::getMortonCode(float3 p) noexcept {
+    // spreads the 10 low bits of v so that there are two zero bits between each of them
+    auto expandBits = [](uint32_t v) {
+        v = (v * 0x00010001u) & 0xFF0000FFu;
+        v = (v * 0x00000101u) & 0x0F00F00Fu;
+        v = (v * 0x00000011u) & 0xC30C30C3u;
+        v = (v * 0x00000005u) & 0x49249249u;
+        return v;
+    };
+    const float3 q = clamp(p * 1023.0f, 0.0f, 1023.0f);
+    return (expandBits(uint32_t(q.x)) << 2u) |
+           (expandBits(uint32_t(q.y)) << 1u) |
+            expandBits(uint32_t(q.z));
+}
+
+} // namespace filament
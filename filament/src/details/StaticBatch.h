@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_DETAILS_STATICBATCH_H
+#define TNT_FILAMENT_DETAILS_STATICBATCH_H
+
+#include "downcast.h"
+
+#include <filament/StaticBatch.h>
+
+#include <utils/Entity.h>
+#include <utils/FixedCapacityVector.h>
+
+#include <math/mat3.h>
+#include <math/vec4.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+class FEngine;
+class FIndexBuffer;
+class FVertexBuffer;
+
+class FStaticBatch : public StaticBatch {
+public:
+    FStaticBatch(FEngine& engine, const Builder& builder);
+
+    // destroys the renderables and frees driver resources, object becomes invalid
+    void terminate(FEngine& engine);
+
+    size_t getEntityCount() const noexcept { return mEntities.size(); }
+    utils::Entity const* getEntities() const noexcept { return mEntities.data(); }
+    size_t getMeshCount() const noexcept { return mMeshCount; }
+
+    // Transforms a tangent frame by the linear part of a transform, which may have a
+    // non-uniform scale or a reflection. normalMatrix is the inverse transpose of m.
+    static math::short4 transformTangentFrame(math::mat3f const& m, math::mat3f const& normalMatrix,
+            math::short4 tangentFrame) noexcept;
+
+    // Copies a triangle list offset by vertexBase. The winding of each triangle is reversed when
+    // flipWinding is set, i.e. when the transform of the mesh is a reflection, so that its front
+    // faces stay front faces.
+    template<typename T>
+    static void copyTriangles(T* dst, uint32_t const* indices, size_t indexCount,
+            uint32_t vertexBase, bool flipWinding) noexcept {
+        for (size_t i = 0; i < indexCount; i += 3) {
+            dst[i] = T(vertexBase + indices[i]);
+            dst[i + 1] = T(vertexBase + indices[i + (flipWinding ? 2 : 1)]);
+            dst[i + 2] = T(vertexBase + indices[i + (flipWinding ? 1 : 2)]);
+        }
+    }
+
+    // Position of p, normalized to [0, 1], along a 30-bits Morton curve.
+    static uint32_t getMortonCode(math::float3 p) noexcept;
+
+private:
+    FVertexBuffer* mVertexBuffer = nullptr;
+    FIndexBuffer* mIndexBuffer = nullptr;
+    utils::FixedCapacityVector<utils::Entity> mEntities;
+    size_t mMeshCount = 0;
+};
+
+FILAMENT_DOWNCAST(StaticBatch)
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_DETAILS_STATICBATCH_H
@@ -392,6 +392,9 @@ void FTexture::generateMipmaps(FEngine& engine) const noexcept {
         return;
     }
 
+    // Fallback for backends that can't generate mipmaps themselves, it blits each miplevel of
+    // each layer through a pair of render targets. All the backends in the tree currently
+    // implement generateMipmaps() and never get here.
     auto generateMipsForLayer = [this, &engine](TargetBufferInfo proto) {
         FEngine::DriverApi& driver = engine.getDriverApi();
 
@@ -474,6 +477,31 @@ size_t FTexture::getFormatSize(InternalFormat format) noexcept {
     return backend::getFormatSize(format);
 }
 
+size_t FTexture::computeMemorySize(Sampler target, uint8_t levels, InternalFormat format,
+        uint8_t samples, uint32_t width, uint32_t height, uint32_t depth) noexcept {
+    if (target == Sampler::SAMPLER_EXTERNAL) {
+        return 0;
+    }
+
+    // for compressed formats, getFormatSize() is the size of a block
+    size_t const formatSize = getFormatSize(format);
+    size_t const blockWidth = std::max(size_t(1), backend::getBlockWidth(format));
+    size_t const blockHeight = std::max(size_t(1), backend::getBlockHeight(format));
+    bool const isCubemap =
+            target == Sampler::SAMPLER_CUBEMAP || target == Sampler::SAMPLER_CUBEMAP_ARRAY;
+    size_t const faces = isCubemap ? 6 : 1;
+
+    size_t size = 0;
+    for (uint8_t level = 0, n = std::max(uint8_t(1), levels); level < n; level++) {
+        size_t const w = valueForLevel(level, width);
+        size_t const h = valueForLevel(level, height);
+        // only 3D textures have their depth reduced with each level
+        size_t const d = target == Sampler::SAMPLER_3D ? valueForLevel(level, depth) : depth;
+        size += ((w + blockWidth - 1) / blockWidth) * ((h + blockHeight - 1) / blockHeight) * d;
+    }
+    return size * formatSize * faces * std::max(uint8_t(1), samples);
+}
+
 
 void FTexture::generatePrefilterMipmap(FEngine& engine,
         PixelBufferDescriptor&& buffer, const FaceOffsets& faceOffsets,
@@ -92,6 +92,17 @@ public:
     // Size a of a pixel in bytes for the given format
     static size_t getFormatSize(InternalFormat format) noexcept;
 
+    // Estimated GPU memory needed by a texture with the given characteristics, including all
+    // its mipmap levels. Returns 0 for external textures, which we don't own.
+    static size_t computeMemorySize(Sampler target, uint8_t levels, InternalFormat format,
+            uint8_t samples, uint32_t width, uint32_t height, uint32_t depth) noexcept;
+
+    // Estimated GPU memory used by this texture
+    size_t getMemorySize() const noexcept {
+        return computeMemorySize(mTarget, mLevelCount, mFormat, mSampleCount,
+                mWidth, mHeight, mDepth);
+    }
+
     // Returns the with or height for a given mipmap level from the base value.
     static inline size_t valueForLevel(uint8_t level, size_t baseLevelValue) {
         return std::max(size_t(1), baseLevelValue >> level);
@@ -49,6 +49,10 @@ public:
 
     size_t getVertexCount() const noexcept;
 
+    // size of the buffer objects owned by this VertexBuffer, i.e. 0 when buffer objects are
+    // enabled, since they're owned by the application.
+    size_t getByteCount() const noexcept { return mByteCount; }
+
     AttributeBitset getDeclaredAttributes() const noexcept {
         return mDeclaredAttributes;
     }
@@ -72,6 +76,7 @@ private:
     std::array<BufferObjectHandle, backend::MAX_VERTEX_BUFFER_COUNT> mBufferObjects;
     AttributeBitset mDeclaredAttributes;
     uint32_t mVertexCount = 0;
+    uint32_t mByteCount = 0;
     uint8_t mBufferCount = 0;
     bool mBufferObjectsEnabled = false;
 };
@@ -35,6 +35,7 @@
 #include <private/filament/UibStructs.h>
 
 #include <utils/Profiler.h>
+#include <utils/soa_algorithm.h>
 #include <utils/Slice.h>
 #include <utils/Systrace.h>
 #include <utils/debug.h>
@@ -43,7 +44,12 @@
 #include <math/scalar.h>
 #include <math/fast.h>
 
+#include <algorithm>
+#include <array>
+#include <iterator>
 #include <memory>
+#include <type_traits>
+#include <utility>
 
 using namespace utils;
 
@@ -146,6 +152,61 @@ void FView::setDynamicResolutionOptions(DynamicResolutionOptions const& options)
     }
 }
 
+void FView::setQualityGovernorOptions(QualityGovernorOptions const& options) noexcept {
+    QualityGovernorOptions& governor = mQualityGovernorOptions;
+    governor = options;
+
+    // like dynamic resolution, the governor needs the GPU frame time
+    governor.enabled = governor.enabled && mIsDynamicResolutionSupported;
+    governor.frameBudget = std::max(governor.frameBudget, 0.0f);
+    governor.hysteresis = clamp(governor.hysteresis, 0.0f, 0.5f);
+    governor.frameCount = std::max(governor.frameCount, uint8_t(1));
+
+    if (!governor.enabled) {
+        // back to full quality
+        mQualityGovernor.reset();
+    }
+}
+
+void FView::updateQualityGovernor(FrameInfo const& info, uint32_t frameTimeCount,
+        Renderer::FrameRateOptions const& frameRateOptions,
+        Renderer::DisplayInfo const& displayInfo,
+        QualityGovernor::EffectMask active) noexcept {
+    QualityGovernorOptions const& options = mQualityGovernorOptions;
+    if (!options.enabled || !info.valid) {
+        return;
+    }
+
+    // the same frame time is returned until a new one is measured, don't count it twice
+    if (frameTimeCount == mQualityGovernorFrameTimeCount) {
+        return;
+    }
+    mQualityGovernorFrameTimeCount = frameTimeCount;
+
+    using Effect = QualityGovernor::Effect;
+    QualityGovernor::Config config;
+    if (options.frameBudget > 0.0f) {
+        config.budget = options.frameBudget;
+    } else {
+        // same target as dynamic resolution, all values in ms
+        const float target = (1000.0f * float(frameRateOptions.interval)) / displayInfo.refreshRate;
+        config.budget = target * (1.0f - frameRateOptions.headRoomRatio);
+    }
+    config.hysteresis = options.hysteresis;
+    config.frameCount = options.frameCount;
+    config.priorities[size_t(Effect::AMBIENT_OCCLUSION)] = options.ambientOcclusionPriority;
+    config.priorities[size_t(Effect::SHADOWS)] = options.shadowsPriority;
+    config.priorities[size_t(Effect::DEPTH_OF_FIELD)] = options.depthOfFieldPriority;
+    config.priorities[size_t(Effect::SCREEN_SPACE_REFLECTIONS)] =
+            options.screenSpaceReflectionsPriority;
+    config.priorities[size_t(Effect::BLOOM)] = options.bloomPriority;
+    mQualityGovernor.setConfig(config);
+
+    using std::chrono::duration;
+    float const measured = duration<float, std::milli>{ info.denoisedFrameTime }.count();
+    mQualityGovernor.update(measured, active);
+}
+
 void FView::setDynamicLightingOptions(float zLightNear, float zLightFar) noexcept {
     mFroxelizer.setOptions(zLightNear, zLightFar);
 }
@@ -553,8 +614,9 @@ void FView::prepare(FEngine& engine, DriverApi& driver, ArenaScope& arena,
          * contain punctual light shadow casters as well. The fourth group contains *only* punctual
          * shadow casters.
          *
-         * This operation is somewhat heavy as it sorts the whole SoA. We use std::partition instead
-         * of sort(), which gives us O(4.N) instead of O(N.log(N)) application of swap().
+         * This operation is somewhat heavy as it reorders the whole SoA. The order of each group
+         * is computed with soa::filter() on the visibility masks, then each array of the SoA is
+         * reordered once with soa::gather(), instead of 4 std::partition() swapping all arrays.
          */
 
         // TODO: we need to compare performance of doing this partitioning vs not doing it.
@@ -568,36 +630,18 @@ void FView::prepare(FEngine& engine, DriverApi& driver, ArenaScope& arena,
         computeVisibilityMasks(getVisibleLayers(), layers, visibility, cullingMask.begin(),
                 renderableData.size());
 
-        auto const beginRenderables = renderableData.begin();
-
-        auto beginDirCasters = partition(beginRenderables, renderableData.end(),
-                VISIBLE_RENDERABLE | VISIBLE_DIR_SHADOW_RENDERABLE,
-                VISIBLE_RENDERABLE);
-
-        auto beginDirCastersOnly = partition(beginDirCasters, renderableData.end(),
-                VISIBLE_RENDERABLE | VISIBLE_DIR_SHADOW_RENDERABLE,
-                VISIBLE_RENDERABLE | VISIBLE_DIR_SHADOW_RENDERABLE);
-
-        auto endDirCastersOnly = partition(beginDirCastersOnly, renderableData.end(),
-                VISIBLE_RENDERABLE | VISIBLE_DIR_SHADOW_RENDERABLE,
-                VISIBLE_DIR_SHADOW_RENDERABLE);
+        auto const [beginDirCasters, beginDirCastersOnly, endDirCastersOnly,
+                endPotentialSpotCastersOnly] = partitionByVisibility(arena, renderableData);
 
-        auto endPotentialSpotCastersOnly = partition(endDirCastersOnly, renderableData.end(),
-                VISIBLE_DYN_SHADOW_RENDERABLE,
-                VISIBLE_DYN_SHADOW_RENDERABLE);
+        mVisibleRenderables = { 0, beginDirCastersOnly };
 
-        // convert to indices
-        mVisibleRenderables = { 0, uint32_t(beginDirCastersOnly - beginRenderables) };
+        mVisibleDirectionalShadowCasters = { beginDirCasters, endDirCastersOnly };
 
-        mVisibleDirectionalShadowCasters = {
-                uint32_t(beginDirCasters - beginRenderables),
-                uint32_t(endDirCastersOnly - beginRenderables)};
-
-        merged = { 0, uint32_t(endPotentialSpotCastersOnly - beginRenderables) };
+        merged = { 0, endPotentialSpotCastersOnly };
         if (!mShadowMapManager.hasSpotShadows()) {
             // we know we don't have spot shadows, we can reduce the range to not even include
             // the potential spot casters
-            merged = { 0, uint32_t(endDirCastersOnly - beginRenderables) };
+            merged = { 0, endDirCastersOnly };
         }
 
         mSpotLightShadowCasters = merged;
@@ -668,7 +712,7 @@ void FView::computeVisibilityMasks(
     // __restrict__ seems to only be taken into account as function parameters. This is very
     // important here, otherwise, this loop doesn't get vectorized.
     // This is vectorized 16x.
-    count = (count + 0xFu) & ~0xFu; // capacity guaranteed to be multiple of 16
+    count = FScene::RenderableSoa::getPaddedSize(count); // always within the SoA's capacity
     for (size_t i = 0; i < count; ++i) {
         const Culler::result_type mask = visibleMask[i];
         const FRenderableManager::Visibility v = visibility[i];
@@ -692,15 +736,51 @@ void FView::computeVisibilityMasks(
 }
 
 UTILS_NOINLINE
-/* static */ FScene::RenderableSoa::iterator FView::partition(
-        FScene::RenderableSoa::iterator begin,
-        FScene::RenderableSoa::iterator end,
-        Culler::result_type mask, Culler::result_type value) noexcept {
-    return std::partition(begin, end, [mask, value](auto it) {
-        // Mask VISIBLE_MASK to ignore higher bits related to spot shadows. We only partition based
-        // on renderable and directional shadow visibility.
-        return (it.template get<FScene::VISIBLE_MASK>() & mask) == value;
+/* static */ std::array<uint32_t, 4> FView::partitionByVisibility(ArenaScope& arena,
+        FScene::RenderableSoa& renderableData) noexcept {
+    using Type = Culler::result_type;
+    constexpr Type RENDERABLE_OR_DIR = VISIBLE_RENDERABLE | VISIBLE_DIR_SHADOW_RENDERABLE;
+    constexpr Type ANY = RENDERABLE_OR_DIR | VISIBLE_DYN_SHADOW_RENDERABLE;
+
+    // (mask, value) selecting each group, in order. The first three groups ignore the higher
+    // bits related to spot shadows, the last one is everything else.
+    constexpr std::pair<Type, Type> groups[] = {
+            { RENDERABLE_OR_DIR,    VISIBLE_RENDERABLE },
+            { RENDERABLE_OR_DIR,    RENDERABLE_OR_DIR },
+            { RENDERABLE_OR_DIR,    VISIBLE_DIR_SHADOW_RENDERABLE },
+            { ANY,                  VISIBLE_DYN_SHADOW_RENDERABLE },
+            { ANY,                  0 },
+    };
+
+    ArenaScope scratch(arena.getAllocator());
+
+    // soa::filter() can write up to `count` indices past the ones it keeps
+    size_t const count = renderableData.size();
+    uint32_t* const order = scratch.allocate<uint32_t>(2 * count);
+
+    Type const* const masks = renderableData.data<FScene::VISIBLE_MASK>();
+    std::array<uint32_t, 4> ends{};
+    size_t n = 0;
+    for (size_t i = 0; i < std::size(groups); i++) {
+        n += soa::filter(order + n, masks, groups[i].first, groups[i].second, 0, count);
+        if (i < ends.size()) {
+            ends[i] = uint32_t(n);
+        }
+    }
+    assert_invariant(n == count);
+
+    renderableData.forEach([&scratch, order, count](auto* p) {
+        using T = std::remove_pointer_t<decltype(p)>;
+        static_assert(std::is_trivially_copyable_v<T>);
+        if constexpr (!std::is_same_v<T, PerRenderableData>) {
+            // the UBO data is only computed after partitioning, by prepareVisibleRenderables()
+            ArenaScope arrayScratch(scratch.getAllocator());
+            T* const tmp = arrayScratch.allocate<T>(count);
+            soa::gather(tmp, p, order, count);
+            std::copy_n(tmp, count, p);
+        }
     });
+    return ends;
 }
 
 void FView::prepareUpscaler(float2 scale) const noexcept {
@@ -860,13 +940,17 @@ void FView::prepareVisibleLights(FLightManager const& lcm, ArenaScope& rootArena
         }
     }
 
-    // Partition array such that all visible lights appear first
-    UTILS_UNUSED_IN_RELEASE auto last =
-            std::partition(lightData.begin() + FScene::DIRECTIONAL_LIGHTS_COUNT, lightData.end(),
-                    [](auto const& it) {
-                        return it.template get<FScene::VISIBILITY>() != 0;
-                    });
-    assert_invariant(visibleLightCount == size_t(last - lightData.begin()));
+    // Compact the light arrays such that only the visible lights remain, and the directional
+    // light stays first.
+    ArenaScope arena(rootArena.getAllocator());
+    {
+        visibleArray[0] = 1; // the directional light is always visible
+        uint32_t* const indices = arena.allocate<uint32_t>(lightData.size(), CACHELINE_SIZE);
+        UTILS_UNUSED_IN_RELEASE size_t const count =
+                soa::filter(indices, visibleArray, 0, lightData.size());
+        assert_invariant(count == visibleLightCount);
+        soa::compact(lightData, indices, visibleLightCount);
+    }
 
 
     /*
@@ -880,7 +964,6 @@ void FView::prepareVisibleLights(FLightManager const& lcm, ArenaScope& rootArena
      * - This helps our limited numbers of spot-shadow as well.
      */
 
-    ArenaScope arena(rootArena.getAllocator());
     size_t const size = visibleLightCount;
     // number of point/spotlights
     size_t const positionalLightCount = size - FScene::DIRECTIONAL_LIGHTS_COUNT;
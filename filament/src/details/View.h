@@ -29,6 +29,7 @@
 #include "Froxelizer.h"
 #include "PerViewUniforms.h"
 #include "PIDController.h"
+#include "QualityGovernor.h"
 #include "ShadowMap.h"
 #include "ShadowMapManager.h"
 #include "TypedUniformBuffer.h"
@@ -53,6 +54,8 @@
 #include <math/scalar.h>
 #include <math/mat4.h>
 
+#include <array>
+
 namespace utils {
 class JobSystem;
 } // namespace utils;
@@ -279,6 +282,25 @@ public:
         return mDynamicResolution;
     }
 
+    // Feeds the last frame time to the quality governor, `active` is the set of effects that are
+    // enabled. `frameTimeCount` is the number of frame times measured so far, the frame time is
+    // only fed once. Does nothing if the governor is disabled or the frame time is unknown.
+    void updateQualityGovernor(FrameInfo const& info, uint32_t frameTimeCount,
+            Renderer::FrameRateOptions const& frameRateOptions,
+            Renderer::DisplayInfo const& displayInfo,
+            QualityGovernor::EffectMask active) noexcept;
+
+    void setQualityGovernorOptions(QualityGovernorOptions const& options) noexcept;
+
+    QualityGovernorOptions getQualityGovernorOptions() const noexcept {
+        return mQualityGovernorOptions;
+    }
+
+    // the quality reductions to apply to this view, all 0 when the governor is disabled
+    QualityGovernor const& getQualityGovernor() const noexcept {
+        return mQualityGovernor;
+    }
+
     void setRenderQuality(RenderQuality const& renderQuality) noexcept {
         mRenderQuality = renderQuality;
     }
@@ -459,12 +481,10 @@ private:
     // being terminated.
     void drainFrameHistory(FEngine& engine) noexcept;
 
-    // we don't inline this one, because the function is quite large and there is not much to
-    // gain from inlining.
-    static FScene::RenderableSoa::iterator partition(
-            FScene::RenderableSoa::iterator begin,
-            FScene::RenderableSoa::iterator end,
-            Culler::result_type mask, Culler::result_type value) noexcept;
+    // Reorders the renderables by visibility groups (see prepare()), and returns the end of
+    // each of the first four groups.
+    static std::array<uint32_t, 4> partitionByVisibility(ArenaScope& arena,
+            FScene::RenderableSoa& renderableData) noexcept;
 
     // these are accessed in the render loop, keep together
     backend::Handle<backend::HwBufferObject> mLightUbh;
@@ -513,6 +533,10 @@ private:
     math::float2 mScale = 1.0f;
     bool mIsDynamicResolutionSupported = false;
 
+    QualityGovernor mQualityGovernor;
+    QualityGovernorOptions mQualityGovernorOptions;
+    uint32_t mQualityGovernorFrameTimeCount = 0;
+
     RenderQuality mRenderQuality;
 
     mutable PerViewUniforms mPerViewUniforms;
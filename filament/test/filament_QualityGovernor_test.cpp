@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "QualityGovernor.h"
+
+#include <array>
+#include <vector>
+
+using namespace filament;
+
+using Effect = QualityGovernor::Effect;
+
+namespace {
+
+// A synthetic GPU: the frame time is a base time plus the cost of each effect at its current
+// quality, costs[effect][reduction].
+struct SyntheticFrame {
+    float base = 10.0f;
+    std::array<std::array<float, 3>, QualityGovernor::EFFECT_COUNT> costs = {};
+    QualityGovernor::EffectMask active;
+
+    SyntheticFrame() noexcept {
+        for (size_t i = 0; i < QualityGovernor::EFFECT_COUNT; i++) {
+            active.set(i);
+        }
+    }
+
+    float frameTime(QualityGovernor const& governor) const noexcept {
+        float t = base;
+        for (size_t i = 0; i < QualityGovernor::EFFECT_COUNT; i++) {
+            if (active[i]) {
+                t += costs[i][governor.getReduction(Effect(i))];
+            }
+        }
+        return t;
+    }
+};
+
+// runs `frames` frames and returns the number of changes
+size_t run(QualityGovernor& governor, SyntheticFrame const& frame, size_t frames,
+        std::vector<Effect>* changes = nullptr) {
+    size_t count = 0;
+    for (size_t i = 0; i < frames; i++) {
+        std::array<uint8_t, QualityGovernor::EFFECT_COUNT> before{};
+        for (size_t e = 0; e < QualityGovernor::EFFECT_COUNT; e++) {
+            before[e] = governor.getReduction(Effect(e));
+        }
+        if (governor.update(frame.frameTime(governor), frame.active)) {
+            count++;
+            for (size_t e = 0; e < QualityGovernor::EFFECT_COUNT; e++) {
+                if (changes && before[e] != governor.getReduction(Effect(e))) {
+                    changes->push_back(Effect(e));
+                }
+            }
+        }
+    }
+    return count;
+}
+
+QualityGovernor::Config makeConfig() {
+    QualityGovernor::Config config;
+    config.budget = 16.0f;
+    config.hysteresis = 0.1f;
+    config.frameCount = 4;
+    config.priorities[size_t(Effect::AMBIENT_OCCLUSION)] = 3;
+    config.priorities[size_t(Effect::SHADOWS)] = 4;
+    config.priorities[size_t(Effect::DEPTH_OF_FIELD)] = 2;
+    config.priorities[size_t(Effect::SCREEN_SPACE_REFLECTIONS)] = 1;
+    config.priorities[size_t(Effect::BLOOM)] = 1;
+    return config;
+}
+
+} // anonymous namespace
+
+TEST(QualityGovernor, NothingChangesWithinBudget) {
+    QualityGovernor governor;
+    governor.setConfig(makeConfig());
+    SyntheticFrame frame;
+    frame.base = 15.0f;
+    EXPECT_EQ(run(governor, frame, 100), 0);
+    for (size_t e = 0; e < QualityGovernor::EFFECT_COUNT; e++) {
+        EXPECT_EQ(governor.getReduction(Effect(e)), 0);
+    }
+}
+
+TEST(QualityGovernor, ReducesInPriorityOrder) {
+    QualityGovernor governor;
+    governor.setConfig(makeConfig());
+
+    SyntheticFrame frame;
+    frame.costs[size_t(Effect::SCREEN_SPACE_REFLECTIONS)] = { 2.0f, 0.0f, 0.0f };
+    frame.costs[size_t(Effect::BLOOM)] = { 1.0f, 0.5f, 0.25f };
+    frame.costs[size_t(Effect::DEPTH_OF_FIELD)] = { 2.0f, 1.5f, 1.0f };
+    frame.costs[size_t(Effect::AMBIENT_OCCLUSION)] = { 3.0f, 1.5f, 1.0f };
+    frame.costs[size_t(Effect::SHADOWS)] = { 2.0f, 1.0f, 0.5f };
+    // 20ms at full quality, 13.75ms fully reduced, the budget is 16ms
+
+    std::vector<Effect> changes;
+    run(governor, frame, 200, &changes);
+
+    // SSR and bloom have the same priority, SSR comes first; then DoF, then AO
+    std::vector<Effect> const expected = {
+            Effect::SCREEN_SPACE_REFLECTIONS,   // 18ms
+            Effect::BLOOM,                      // 17.5ms
+            Effect::BLOOM,                      // 17.25ms
+            Effect::DEPTH_OF_FIELD,             // 16.75ms
+            Effect::DEPTH_OF_FIELD,             // 16.25ms
+            Effect::AMBIENT_OCCLUSION,          // 14.75ms
+    };
+    EXPECT_EQ(changes, expected);
+    EXPECT_LE(frame.frameTime(governor), 16.0f);
+    EXPECT_EQ(governor.getReduction(Effect::SHADOWS), 0);
+
+    // the cost of each step was measured
+    EXPECT_FLOAT_EQ(governor.getStepCost(Effect::SCREEN_SPACE_REFLECTIONS, 1), 2.0f);
+    EXPECT_FLOAT_EQ(governor.getStepCost(Effect::BLOOM, 2), 0.25f);
+    EXPECT_FLOAT_EQ(governor.getStepCost(Effect::AMBIENT_OCCLUSION, 1), 1.5f);
+    EXPECT_LT(governor.getStepCost(Effect::AMBIENT_OCCLUSION, 2), 0.0f);
+}
+
+TEST(QualityGovernor, SkipsInactiveAndExcludedEffects) {
+    QualityGovernor::Config config = makeConfig();
+    config.priorities[size_t(Effect::BLOOM)] = 0;
+    QualityGovernor governor;
+    governor.setConfig(config);
+
+    SyntheticFrame frame;
+    frame.base = 20.0f;
+    frame.active.unset(size_t(Effect::SCREEN_SPACE_REFLECTIONS));
+
+    // the budget can never be met, everything that can be reduced is
+    run(governor, frame, 200);
+    EXPECT_EQ(governor.getReduction(Effect::SCREEN_SPACE_REFLECTIONS), 0);
+    EXPECT_EQ(governor.getReduction(Effect::BLOOM), 0);
+    EXPECT_EQ(governor.getReduction(Effect::DEPTH_OF_FIELD),
+            QualityGovernor::getMaxReduction(Effect::DEPTH_OF_FIELD));
+    EXPECT_EQ(governor.getReduction(Effect::AMBIENT_OCCLUSION),
+            QualityGovernor::getMaxReduction(Effect::AMBIENT_OCCLUSION));
+    EXPECT_EQ(governor.getReduction(Effect::SHADOWS),
+            QualityGovernor::getMaxReduction(Effect::SHADOWS));
+    EXPECT_EQ(run(governor, frame, 200), 0);
+}
+
+TEST(QualityGovernor, DoesNotOscillate) {
+    QualityGovernor governor;
+
+    // reducing AO brings us well under the lower threshold (14.4ms), restoring it would bring
+    // us over the budget.
+    SyntheticFrame frame;
+    frame.base = 12.0f;
+    frame.costs[size_t(Effect::AMBIENT_OCCLUSION)] = { 5.0f, 1.0f, 1.0f };
+    QualityGovernor::Config config = makeConfig();
+    config.priorities = {};
+    config.priorities[size_t(Effect::AMBIENT_OCCLUSION)] = 1;
+    governor.setConfig(config);
+
+    EXPECT_EQ(run(governor, frame, 4), 1);
+    EXPECT_EQ(governor.getReduction(Effect::AMBIENT_OCCLUSION), 1);
+
+    // the step is measured in the next window, after which the governor must hold steady
+    EXPECT_EQ(run(governor, frame, 1000), 0);
+    EXPECT_FLOAT_EQ(governor.getStepCost(Effect::AMBIENT_OCCLUSION, 1), 4.0f);
+}
+
+TEST(QualityGovernor, RestoresInReverseOrder) {
+    QualityGovernor governor;
+    governor.setConfig(makeConfig());
+
+    SyntheticFrame frame;
+    frame.costs[size_t(Effect::SCREEN_SPACE_REFLECTIONS)] = { 1.0f, 0.0f, 0.0f };
+    frame.costs[size_t(Effect::DEPTH_OF_FIELD)] = { 2.0f, 1.0f, 0.0f };
+    frame.costs[size_t(Effect::AMBIENT_OCCLUSION)] = { 2.0f, 1.0f, 0.0f };
+    frame.costs[size_t(Effect::SHADOWS)] = { 1.0f, 0.5f, 0.0f };
+
+    // heavy load, everything gets reduced
+    frame.base = 30.0f;
+    run(governor, frame, 400);
+    for (auto e : { Effect::SCREEN_SPACE_REFLECTIONS, Effect::DEPTH_OF_FIELD,
+            Effect::AMBIENT_OCCLUSION, Effect::SHADOWS, Effect::BLOOM }) {
+        EXPECT_EQ(governor.getReduction(e), QualityGovernor::getMaxReduction(e));
+    }
+
+    // the load goes away, quality is restored from the highest priority down
+    frame.base = 5.0f;
+    std::vector<Effect> changes;
+    run(governor, frame, 400, &changes);
+    std::vector<Effect> const expected = {
+            Effect::SHADOWS, Effect::SHADOWS,
+            Effect::AMBIENT_OCCLUSION, Effect::AMBIENT_OCCLUSION,
+            Effect::DEPTH_OF_FIELD, Effect::DEPTH_OF_FIELD,
+            Effect::BLOOM, Effect::BLOOM,
+            Effect::SCREEN_SPACE_REFLECTIONS,
+    };
+    EXPECT_EQ(changes, expected);
+    EXPECT_EQ(frame.frameTime(governor), 11.0f);
+
+    // reset() goes back to full quality
+    frame.base = 30.0f;
+    run(governor, frame, 40);
+    governor.reset();
+    for (size_t e = 0; e < QualityGovernor::EFFECT_COUNT; e++) {
+        EXPECT_EQ(governor.getReduction(Effect(e)), 0);
+    }
+}
+
+TEST(QualityGovernor, PartialRestoreStaysWithinBudget) {
+    QualityGovernor governor;
+    governor.setConfig(makeConfig());
+
+    SyntheticFrame frame;
+    frame.costs[size_t(Effect::DEPTH_OF_FIELD)] = { 3.0f, 2.0f, 1.0f };
+    frame.costs[size_t(Effect::AMBIENT_OCCLUSION)] = { 3.0f, 2.0f, 1.0f };
+
+    // 22ms, DoF then AO are fully reduced to reach 18ms, still over budget
+    frame.base = 16.0f;
+    run(governor, frame, 200);
+    EXPECT_EQ(governor.getReduction(Effect::DEPTH_OF_FIELD), 2);
+    EXPECT_EQ(governor.getReduction(Effect::AMBIENT_OCCLUSION), 2);
+
+    // the load drops to 13ms, AO is restored one step at a time, which takes us to 15ms. This
+    // is within the hysteresis band, so DoF stays reduced.
+    frame.base = 11.0f;
+    run(governor, frame, 400);
+    EXPECT_EQ(governor.getReduction(Effect::AMBIENT_OCCLUSION), 0);
+    EXPECT_EQ(governor.getReduction(Effect::DEPTH_OF_FIELD), 2);
+    EXPECT_LE(frame.frameTime(governor), 16.0f);
+    EXPECT_EQ(run(governor, frame, 1000), 0);
+}
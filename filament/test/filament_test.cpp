@@ -15,7 +15,9 @@
  */
 
 #include <iostream>
+#include <algorithm>
 #include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -23,6 +25,8 @@
 #include <math/vec4.h>
 #include <math/mat3.h>
 #include <math/mat4.h>
+#include <math/norm.h>
+#include <math/quat.h>
 #include <math/scalar.h>
 
 #include <filament/Box.h>
@@ -31,6 +35,13 @@
 #include <filament/Frustum.h>
 #include <filament/Material.h>
 #include <filament/Engine.h>
+#include <filament/IndexBuffer.h>
+#include <filament/RenderableManager.h>
+#include <filament/StaticBatch.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+
+#include <utils/EntityManager.h>
 
 #include <private/filament/BufferInterfaceBlock.h>
 #include <private/filament/UibStructs.h>
@@ -39,11 +50,17 @@
 #include "Allocators.h"
 #include "details/Material.h"
 #include "details/Camera.h"
+#include "Culler.h"
+#include "DirtyRangeSet.h"
 #include "Froxelizer.h"
+#include "ResourceAllocator.h"
 #include "details/Engine.h"
+#include "details/StaticBatch.h"
 #include "components/RenderableManager.h"
 #include "components/TransformManager.h"
+#include "RenderPrimitive.h"
 #include "UniformBuffer.h"
+#include "UniformBufferPool.h"
 
 using namespace filament;
 using namespace filament::math;
@@ -515,6 +532,118 @@ TEST(FilamentTest, UniformBufferSize2) {
     buffer.invalidate();
 }
 
+TEST(FilamentTest, UniformBufferDirtyRanges) {
+    auto ranges = [](DirtyRangeSet const& set) {
+        std::vector<std::pair<uint32_t, uint32_t>> result;
+        for (auto const& r : set) {
+            result.emplace_back(r.begin, r.end);
+        }
+        return result;
+    };
+    using Ranges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+    DirtyRangeSet set;
+    EXPECT_TRUE(set.empty());
+
+    // close ranges are merged
+    set.add(0, 4);
+    set.add(32, 36);
+    EXPECT_EQ(ranges(set), (Ranges{{ 0, 36 }}));
+
+    // distant ranges are kept sorted and separate
+    set.clear();
+    set.add(0, 4);
+    set.add(200, 204);
+    set.add(100, 104);
+    EXPECT_EQ(ranges(set), (Ranges{{ 0, 4 }, { 100, 104 }, { 200, 204 }}));
+    EXPECT_EQ(set.getByteCount(), 12u);
+
+    // a range spanning others absorbs them
+    set.add(90, 210);
+    EXPECT_EQ(ranges(set), (Ranges{{ 0, 4 }, { 90, 210 }}));
+
+    // past the capacity, the two closest ranges are merged
+    set.clear();
+    set.add(0, 4);
+    set.add(100, 104);
+    set.add(300, 304);
+    set.add(500, 504);
+    set.add(700, 704);
+    EXPECT_EQ(ranges(set), (Ranges{{ 0, 104 }, { 300, 304 }, { 500, 504 }, { 700, 704 }}));
+
+    // setting a uniform only dirties its bytes
+    UniformBuffer buffer(1024);
+    EXPECT_TRUE(buffer.isDirty());
+    buffer.clean();
+    EXPECT_FALSE(buffer.isDirty());
+    buffer.setUniform(512, 1.0f);
+    EXPECT_TRUE(buffer.isDirty());
+    EXPECT_EQ(ranges(buffer.getDirtyRanges()), (Ranges{{ 512, 516 }}));
+
+    // a mat3 is stored as three vec4 columns, all its floats are dirty
+    buffer.clean();
+    buffer.setUniform(256, mat3f{});
+    EXPECT_EQ(ranges(buffer.getDirtyRanges()), (Ranges{{ 256, 256 + 44 }}));
+}
+
+TEST(FilamentTest, UniformBufferPool) {
+    constexpr uint32_t ALIGNMENT = UniformBufferPool::ALIGNMENT;
+
+    Engine* engine = Engine::create(Engine::Backend::NOOP);
+    FEngine::DriverApi& driver = downcast(engine)->getDriverApi();
+
+    UniformBufferPool pool;
+    auto a = pool.allocate(driver, 100);
+    auto b = pool.allocate(driver, 300);
+    auto c = pool.allocate(driver, 100);
+
+    // small blocks are sub-allocated from the same buffer, at aligned offsets
+    EXPECT_EQ(pool.getBufferCount(), 1u);
+    EXPECT_EQ(a.handle, b.handle);
+    EXPECT_EQ(a.handle, c.handle);
+    EXPECT_EQ(a.size, ALIGNMENT);
+    EXPECT_EQ(b.size, 2 * ALIGNMENT);
+    EXPECT_EQ(b.offset, a.offset + a.size);
+    EXPECT_EQ(c.offset, b.offset + b.size);
+
+    // freed blocks are reused only once the frames that may read them are done
+    pool.free(driver, a);
+    auto d = pool.allocate(driver, 200);
+    EXPECT_EQ(d.offset, c.offset + c.size);
+    pool.endFrame(driver);  // a is guarded by this frame's sync
+    auto h = pool.allocate(driver, 200);
+    EXPECT_EQ(h.offset, d.offset + d.size);
+    pool.endFrame(driver);  // the NOOP backend's syncs are always signaled
+    auto f = pool.allocate(driver, 200);
+    EXPECT_EQ(f.handle, a.handle);
+    EXPECT_EQ(f.offset, a.offset);
+
+    // orphaning replaces a block by one that's not in use
+    auto g = f;
+    pool.orphan(driver, g);
+    EXPECT_EQ(g.size, f.size);
+    EXPECT_NE(g.offset, f.offset);
+
+    // a full buffer spills into a new one
+    std::vector<UniformBufferPool::Allocation> allocations;
+    for (size_t i = 0; i < UniformBufferPool::BUFFER_SIZE / ALIGNMENT; i++) {
+        allocations.push_back(pool.allocate(driver, ALIGNMENT));
+    }
+    EXPECT_EQ(pool.getBufferCount(), 2u);
+    EXPECT_NE(allocations.back().handle, a.handle);
+
+    // large blocks get their own buffer
+    auto e = pool.allocate(driver, UniformBufferPool::BUFFER_SIZE + 1);
+    EXPECT_EQ(e.offset, 0u);
+    EXPECT_EQ(pool.getBufferCount(), 2u);
+    pool.free(driver, e);
+
+    pool.terminate(driver);
+    EXPECT_EQ(pool.getBufferCount(), 0u);
+
+    Engine::destroy(&engine);
+}
+
 TEST(FilamentTest, BoxCulling) {
     Frustum frustum(mat4f::frustum(-1, 1, -1, 1, 1, 100));
 
@@ -595,6 +724,54 @@ TEST(FilamentTest, SphereCulling) {
     EXPECT_TRUE(frustum.intersects({ 0, 200 }));
 }
 
+TEST(FilamentTest, CullerInstructionSets) {
+    Frustum frustum(mat4f::perspective(45.0f, 1.0f, 0.1f, 100.0f));
+
+    // an odd multiple of Culler::MODULO, so the vectorized paths also process a remainder
+    constexpr size_t count = 1028;
+    std::default_random_engine gen; // NOLINT
+    std::uniform_real_distribution<float> rand(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.1f, 25.0f);
+    std::vector<float3> centers(count);
+    std::vector<float3> extents(count);
+    std::vector<float4> spheres(count);
+    for (size_t i = 0; i < count; i++) {
+        centers[i] = { rand(gen), rand(gen), rand(gen) };
+        extents[i] = { size(gen), size(gen), size(gen) };
+        spheres[i] = { centers[i], size(gen) };
+    }
+
+    std::vector<Culler::result_type> expectedBoxes(count, 0xFFFE);
+    std::vector<Culler::result_type> expectedSpheres(count);
+    Culler::Test::intersects(Culler::Isa::GENERIC,
+            expectedBoxes.data(), frustum, centers.data(), extents.data(), count);
+    Culler::Test::intersects(Culler::Isa::GENERIC,
+            expectedSpheres.data(), frustum, spheres.data(), count);
+
+    // bits other than the one we're testing are preserved
+    EXPECT_TRUE(std::all_of(expectedBoxes.begin(), expectedBoxes.end(),
+            [](auto r) { return (r & 0xFFFE) == 0xFFFE; }));
+
+    // the data above has both visible and invisible objects
+    size_t const visibleCount = std::count(expectedSpheres.begin(), expectedSpheres.end(), 1);
+    EXPECT_GT(visibleCount, 0);
+    EXPECT_LT(visibleCount, count);
+
+    for (auto isa : { Culler::Isa::NEON, Culler::Isa::AVX2, Culler::Isa::AVX512 }) {
+        if (!Culler::Test::isSupported(isa)) {
+            continue;
+        }
+        std::vector<Culler::result_type> boxes(count, 0xFFFE);
+        std::vector<Culler::result_type> results(count);
+        Culler::Test::intersects(isa,
+                boxes.data(), frustum, centers.data(), extents.data(), count);
+        Culler::Test::intersects(isa,
+                results.data(), frustum, spheres.data(), count);
+        EXPECT_EQ(expectedBoxes, boxes) << Culler::Test::getName(isa);
+        EXPECT_EQ(expectedSpheres, results) << Culler::Test::getName(isa);
+    }
+}
+
 TEST(FilamentTest, ColorConversion) {
     // Linear to Gamma
     // 0.0 stays 0.0
@@ -741,6 +918,285 @@ TEST(FilamentTest, FroxelData) {
     Engine::destroy((Engine **)&engine);
 }
 
+TEST(FilamentTest, MemoryReport) {
+    using MemoryCategory = Engine::MemoryCategory;
+
+    Engine* engine = Engine::create(Engine::Backend::NOOP);
+
+    Engine::MemoryReport before;
+    engine->getMemoryReport(before);
+
+    Texture* texture = Texture::Builder()
+            .width(256).height(256).levels(9)
+            .format(Texture::InternalFormat::RGBA8)
+            .build(*engine);
+    IndexBuffer* indexBuffer = IndexBuffer::Builder()
+            .indexCount(300)
+            .bufferType(IndexBuffer::IndexType::USHORT)
+            .build(*engine);
+
+    Engine::MemoryReport after;
+    engine->getMemoryReport(after);
+
+    // 256x256 RGBA8 with the full mip chain
+    EXPECT_EQ(after[MemoryCategory::TEXTURE].count, before[MemoryCategory::TEXTURE].count + 1);
+    EXPECT_EQ(after[MemoryCategory::TEXTURE].size,
+            before[MemoryCategory::TEXTURE].size + 4 * (256 * 256 * 4 - 1) / 3);
+    EXPECT_EQ(after[MemoryCategory::INDEX_BUFFER].size,
+            before[MemoryCategory::INDEX_BUFFER].size + 300 * sizeof(uint16_t));
+
+    // blocks larger than a pooled buffer get their own buffer object, which is also accounted for
+    UniformBufferPool& pool = downcast(engine)->getUniformBufferPool();
+    UniformBufferPool::Allocation const block =
+            pool.allocate(downcast(engine)->getDriverApi(), UniformBufferPool::BUFFER_SIZE + 1);
+    engine->getMemoryReport(after);
+    EXPECT_EQ(after[MemoryCategory::UNIFORM_BUFFER_POOL].count,
+            before[MemoryCategory::UNIFORM_BUFFER_POOL].count + 1);
+    EXPECT_EQ(after[MemoryCategory::UNIFORM_BUFFER_POOL].size,
+            before[MemoryCategory::UNIFORM_BUFFER_POOL].size + block.size);
+    pool.free(downcast(engine)->getDriverApi(), block);
+    engine->getMemoryReport(after);
+    EXPECT_EQ(after[MemoryCategory::UNIFORM_BUFFER_POOL].size,
+            before[MemoryCategory::UNIFORM_BUFFER_POOL].size);
+
+    // the noop backend doesn't cache anything
+    EXPECT_EQ(after[MemoryCategory::DRIVER_CACHE].count, 0);
+
+    size_t callbackCount = 0;
+    engine->setMemoryBudget(MemoryCategory::TEXTURE, 1024,
+            [&](MemoryCategory category, Engine::MemoryReport::Usage const& usage, size_t budget) {
+                EXPECT_EQ(category, MemoryCategory::TEXTURE);
+                EXPECT_EQ(budget, 1024);
+                EXPECT_GT(usage.size, budget);
+                callbackCount++;
+            });
+    EXPECT_EQ(engine->getMemoryBudget(MemoryCategory::TEXTURE), 1024);
+
+    // we're only notified when going over budget
+    downcast(engine)->checkMemoryBudgets();
+    downcast(engine)->checkMemoryBudgets();
+    EXPECT_EQ(callbackCount, 1);
+
+    engine->setMemoryBudget(MemoryCategory::TEXTURE, 0);
+    downcast(engine)->checkMemoryBudgets();
+    EXPECT_EQ(callbackCount, 1);
+
+    engine->destroy(texture);
+    engine->destroy(indexBuffer);
+    Engine::destroy(&engine);
+}
+
+TEST(FilamentTest, ResourceAllocatorCache) {
+    using namespace backend;
+
+    Engine::Config config;
+    config.resourceAllocatorCacheSizeMB = 1;
+    config.resourceAllocatorCacheMaxAge = 2;
+    config.resourceAllocatorSizeGranularity = 64;
+    Engine* engine = Engine::create(Engine::Backend::NOOP, nullptr, nullptr, &config);
+    ResourceAllocator& allocator = downcast(engine)->getResourceAllocator();
+
+    auto createTexture = [&allocator](uint32_t width, uint32_t height, TextureUsage usage) {
+        using TS = TextureSwizzle;
+        return allocator.createTexture("test", SamplerType::SAMPLER_2D, 1,
+                TextureFormat::RGBA8, 1, width, height, 1,
+                { TS::CHANNEL_0, TS::CHANNEL_1, TS::CHANNEL_2, TS::CHANNEL_3 }, usage);
+    };
+
+    constexpr TextureUsage sampled = TextureUsage::COLOR_ATTACHMENT | TextureUsage::SAMPLEABLE;
+    ResourceAllocator::Stats const initial = allocator.getStats();
+
+    // released textures are reused
+    TextureHandle const t0 = createTexture(256, 256, sampled);
+    allocator.destroyTexture(t0);
+    TextureHandle const t1 = createTexture(256, 256, sampled);
+    EXPECT_EQ(t0.getId(), t1.getId());
+    EXPECT_EQ(allocator.getStats().hits, initial.hits + 1);
+    EXPECT_EQ(allocator.getStats().misses, initial.misses + 1);
+    allocator.destroyTexture(t1);
+
+    // sampled textures have their exact size
+    TextureHandle const t2 = createTexture(250, 256, sampled);
+    EXPECT_NE(t1.getId(), t2.getId());
+    EXPECT_EQ(allocator.getStats().misses, initial.misses + 2);
+    allocator.destroyTexture(t2);
+
+    // but textures that are never sampled are rounded up to the size granularity
+    TextureHandle const d0 = createTexture(250, 250, TextureUsage::DEPTH_ATTACHMENT);
+    allocator.destroyTexture(d0);
+    TextureHandle const d1 = createTexture(256, 200, TextureUsage::DEPTH_ATTACHMENT);
+    EXPECT_EQ(d0.getId(), d1.getId());
+    EXPECT_EQ(allocator.getStats().hits, initial.hits + 2);
+    allocator.destroyTexture(d1);
+
+    // old textures are evicted, one per gc()
+    EXPECT_EQ(allocator.getCacheCount(), 3);
+    for (size_t i = 0; i < 2; i++) {
+        allocator.gc();
+    }
+    EXPECT_EQ(allocator.getCacheCount(), 3);
+    allocator.gc();
+    EXPECT_EQ(allocator.getCacheCount(), 2);
+    for (size_t i = 0; i < 2; i++) {
+        allocator.gc();
+    }
+    EXPECT_EQ(allocator.getCacheCount(), 0);
+    EXPECT_EQ(allocator.getStats().evictions, initial.evictions + 3);
+
+    // the cache never stays above its capacity, 512x512 RGBA8 is 1 MiB
+    TextureHandle const l0 = createTexture(512, 512, sampled);
+    TextureHandle const l1 = createTexture(512, 512, sampled);
+    allocator.destroyTexture(l0);
+    allocator.destroyTexture(l1);
+    EXPECT_EQ(allocator.getCacheSize(), 2u << 20u);
+    allocator.gc();
+    EXPECT_EQ(allocator.getCacheSize(), 1u << 20u);
+    // the least recently used texture went first
+    EXPECT_EQ(createTexture(512, 512, sampled).getId(), l1.getId());
+    allocator.destroyTexture(l1);
+
+    Engine::destroy(&engine);
+}
+
+TEST(FilamentTest, BulkRenderables) {
+    Engine* engine = Engine::create(Engine::Backend::NOOP);
+    FRenderableManager& rcm = downcast(engine)->getRenderableManager();
+    TransformManager& tcm = engine->getTransformManager();
+
+    VertexBuffer* vertexBuffer = VertexBuffer::Builder()
+            .vertexCount(3)
+            .bufferCount(1)
+            .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT3)
+            .build(*engine);
+    IndexBuffer* indexBuffer = IndexBuffer::Builder()
+            .indexCount(3)
+            .bufferType(IndexBuffer::IndexType::USHORT)
+            .build(*engine);
+
+    constexpr size_t count = 16;
+    Entity entities[count];
+    EntityManager::get().create(count, entities);
+
+    // one entity already has a renderable, it's replaced
+    RenderableManager::Builder(1)
+            .geometry(0, RenderableManager::PrimitiveType::POINTS, vertexBuffer, indexBuffer)
+            .boundingBox({{ 0, 0, 0 }, { 1, 1, 1 }})
+            .build(*engine, entities[3]);
+
+    auto result = RenderableManager::Builder(2)
+            .geometry(0, RenderableManager::PrimitiveType::TRIANGLES, vertexBuffer, indexBuffer)
+            .geometry(1, RenderableManager::PrimitiveType::LINES, vertexBuffer, indexBuffer)
+            .boundingBox({{ 0, 0, 0 }, { 2, 2, 2 }})
+            .priority(5)
+            .build(*engine, entities, count);
+    EXPECT_EQ(result, RenderableManager::Builder::Success);
+
+    // all the renderables share their render primitives, but not their storage
+    auto first = rcm.getInstance(entities[0]);
+    auto const& primitives = rcm.getRenderPrimitives(first, 0);
+    for (Entity e : entities) {
+        auto ci = rcm.getInstance(e);
+        ASSERT_TRUE(ci);
+        EXPECT_TRUE(tcm.hasComponent(e));
+        EXPECT_EQ(rcm.getPrimitiveCount(ci, 0), 2);
+        EXPECT_EQ(rcm.getPriority(ci), 5);
+        EXPECT_EQ(rcm.getAABB(ci).halfExtent, float3(2));
+        auto const& p = rcm.getRenderPrimitives(ci, 0);
+        EXPECT_EQ(p[0].getHwHandle(), primitives[0].getHwHandle());
+        EXPECT_EQ(p[1].getHwHandle(), primitives[1].getHwHandle());
+        EXPECT_NE(p[0].getHwHandle(), p[1].getHwHandle());
+        if (ci != first) {
+            EXPECT_NE(p.data(), primitives.data());
+        }
+    }
+
+    // renderables can be destroyed individually or in bulk
+    rcm.destroy(entities[5]);
+    EXPECT_FALSE(rcm.hasComponent(entities[5]));
+    EXPECT_TRUE(rcm.hasComponent(entities[6]));
+    engine->getRenderableManager().destroy(entities, count);
+    for (Entity e : entities) {
+        EXPECT_FALSE(rcm.hasComponent(e));
+        tcm.destroy(e);
+    }
+
+    EntityManager::get().destroy(count, entities);
+    engine->destroy(vertexBuffer);
+    engine->destroy(indexBuffer);
+    Engine::destroy(&engine);
+}
+
+TEST(FilamentTest, StaticBatch) {
+    Engine* engine = Engine::create(Engine::Backend::NOOP);
+    FRenderableManager& rcm = downcast(engine)->getRenderableManager();
+    Material const* material = engine->getDefaultMaterial();
+    MaterialInstance const* instances[2] = {
+            material->getDefaultInstance(), material->createInstance() };
+
+    // 100 triangles on a 10x10 grid, alternating between two material instances
+    const float3 positions[3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } };
+    const uint32_t indices[3] = { 0, 1, 2 };
+    StaticBatch::Builder builder;
+    for (size_t i = 0; i < 100; i++) {
+        builder.mesh({
+                .materialInstance = instances[i % 2],
+                .transform = mat4f::translation(float3{ float(2 * (i % 10)), float(2 * (i / 10)), 0 }),
+                .positions = positions,
+                .vertexCount = 3,
+                .indices = indices,
+                .indexCount = 3 });
+    }
+    StaticBatch* batch = builder.maxChunkTriangleCount(10).build(*engine);
+
+    // each material instance has 50 triangles, in chunks of 10
+    ASSERT_EQ(batch->getEntityCount(), 10);
+    EXPECT_EQ(batch->getMeshCount(), 100);
+    size_t chunkCounts[2] = {};
+    for (size_t i = 0; i < batch->getEntityCount(); i++) {
+        auto ci = rcm.getInstance(batch->getEntities()[i]);
+        ASSERT_TRUE(ci);
+        ASSERT_EQ(rcm.getPrimitiveCount(ci, 0), 1);
+        auto const* mi = rcm.getRenderPrimitives(ci, 0)[0].getMaterialInstance();
+        chunkCounts[mi == instances[1]]++;
+
+        // chunks are spatially coherent, each covers less than half of the 19x19 grid
+        Box const& box = rcm.getAABB(ci);
+        EXPECT_LT(4.0f * box.halfExtent.x * box.halfExtent.y, 19.0f * 19.0f / 2.0f);
+        EXPECT_GE(box.getMin().x, 0.0f);
+        EXPECT_LE(box.getMax().y, 19.0f);
+    }
+    EXPECT_EQ(chunkCounts[0], 5);
+    EXPECT_EQ(chunkCounts[1], 5);
+
+    // the tangent frames follow the transform of the mesh
+    const short4 identity = packSnorm16(
+            mat3f::packTangentFrame({ float3{ 1, 0, 0 }, float3{ 0, 1, 0 }, float3{ 0, 0, 1 } }).xyzw);
+    const mat3f rotation = mat3f::rotation(F_PI_2, float3{ 0, 0, 1 });
+    const short4 rotated = FStaticBatch::transformTangentFrame(rotation, rotation, identity);
+    const mat3f frame{ quatf{ unpackSnorm16(rotated) }};
+    EXPECT_TRUE(vec3eq(round(frame[0]), float3{ 0, 1, 0 }));
+    EXPECT_TRUE(vec3eq(round(frame[2]), float3{ 0, 0, 1 }));
+
+    // a reflection reverses the winding of the triangles
+    const uint32_t triangles[6] = { 0, 1, 2, 3, 4, 5 };
+    uint16_t copy[6];
+    FStaticBatch::copyTriangles(copy, triangles, 6, 10, false);
+    EXPECT_EQ(std::vector<uint16_t>(copy, copy + 6),
+            std::vector<uint16_t>({ 10, 11, 12, 13, 14, 15 }));
+    FStaticBatch::copyTriangles(copy, triangles, 6, 10,
+            det(mat4f::scaling(float3{ -1, 1, 1 }).upperLeft()) < 0.0f);
+    EXPECT_EQ(std::vector<uint16_t>(copy, copy + 6),
+            std::vector<uint16_t>({ 10, 12, 11, 13, 15, 14 }));
+
+    // the renderables are destroyed with the batch
+    Entity const first = batch->getEntities()[0];
+    engine->destroy(batch);
+    EXPECT_FALSE(rcm.hasComponent(first));
+
+    engine->destroy(instances[1]);
+    Engine::destroy(&engine);
+}
+
 TEST(FilamentTest, GoogleLineDirective) {
     {
         char s[512] = "#line 10 \"foobar\"";
@@ -16,6 +16,9 @@
 
 #include <fstream>
 #include <iostream>
+#include <vector>
+
+#include <string.h>
 
 #include <gtest/gtest.h>
 
@@ -41,6 +44,34 @@ TEST(MaterialParser, Parse) {
             "See instructions in filament_test_material_parser.cpp" << std::endl;
 }
 
+// The parser keeps a copy of the package without the shaders of the other backends, shaders must
+// still be found in that copy, and in a full copy when the package isn't aligned.
+TEST(MaterialParser, ResidentCopy) {
+    const uint8_t* data = FILAMENT_TEST_RESOURCES_TEST_MATERIAL_DATA;
+    const size_t size = FILAMENT_TEST_RESOURCES_TEST_MATERIAL_SIZE;
+    std::vector<uint8_t> misaligned(size + 1);
+    memcpy(misaligned.data() + 1, data, size);
+
+    for (const uint8_t* package : { data, (const uint8_t*)misaligned.data() + 1 }) {
+        MaterialParser parser(backend::Backend::OPENGL, package, size);
+        ASSERT_EQ(parser.parse(), MaterialParser::ParseResult::SUCCESS);
+
+        utils::CString name;
+        EXPECT_TRUE(parser.getName(&name));
+
+        uint32_t shaderModels = 0;
+        ASSERT_TRUE(parser.getShaderModels(&shaderModels));
+        const auto shaderModel =
+                (shaderModels & (1u << uint32_t(backend::ShaderModel::MOBILE))) ?
+                backend::ShaderModel::MOBILE : backend::ShaderModel::DESKTOP;
+        filaflat::ShaderContent shader;
+        EXPECT_TRUE(parser.getShader(shader, shaderModel, Variant{},
+                backend::ShaderStage::VERTEX));
+        EXPECT_GT(shader.size(), 0);
+        EXPECT_GT(parser.getResidentSize(), 0);
+    }
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
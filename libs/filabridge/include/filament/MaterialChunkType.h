@@ -87,6 +87,10 @@ enum UTILS_PUBLIC ChunkType : uint64_t {
 
     DictionaryText = charTo64bitNum("DIC_TEXT"),
     DictionarySpirv = charTo64bitNum("DIC_SPIR"),
+
+    // A chunk compressed with zstd. It contains the type of the original chunk (uint64), its
+    // uncompressed size (uint32), followed by the compressed content of the chunk.
+    CompressedZstd = charTo64bitNum("CMP_ZSTD"),
 };
 
 } // namespace filamat
@@ -34,6 +34,10 @@ using BlobDictionary = utils::FixedCapacityVector<ShaderContent>;
 class Unflattener;
 
 // Allows to build a map of chunks in a Package and get direct individual access based on chunk ID.
+//
+// Chunks compressed with zstd (ChunkType::CompressedZstd) are indexed under the type of the chunk
+// they contain, and are decompressed the first time they are accessed, so chunks that are never
+// used are never decompressed. This makes the accessors below not thread-safe.
 class UTILS_PUBLIC ChunkContainer {
 public:
     using Type = filamat::ChunkType;
@@ -63,7 +67,9 @@ public:
     Chunk getChunk(size_t index) const noexcept {
         auto it = mChunks.begin();
         std::advance(it, index);
-        return { it->first, it->second };
+        ChunkDesc const* pChunkDesc = nullptr;
+        hasChunk(it->first, &pChunkDesc);
+        return { it->first, pChunkDesc ? *pChunkDesc : ChunkDesc{} };
     }
 
     std::pair<uint8_t const*, uint8_t const*> getChunkRange(Type type) const noexcept {
@@ -80,6 +86,12 @@ public:
         auto pos = chunks.find(type);
         if (pos != chunks.end()) {
             if (pChunkDesc) {
+                if (UTILS_UNLIKELY(!pos->second.start && pos->second.size)) {
+                    // this chunk is compressed and hasn't been accessed yet
+                    if (!decompress(type, pos.value())) {
+                        return false;
+                    }
+                }
                 *pChunkDesc = &pos.value();
             }
             return true;
@@ -87,16 +99,37 @@ public:
         return false;
     }
 
+    // Returns whether a chunk is stored compressed in the package.
+    bool isCompressed(Type type) const noexcept {
+        return mCompressedChunks.find(type) != mCompressedChunks.end();
+    }
+
+    // Frees the memory used by a decompressed chunk, it'll be decompressed again if accessed.
+    void releaseDecompressedChunk(Type type) noexcept;
+
+    // Size in bytes of the chunks currently decompressed.
+    size_t getDecompressedSize() const noexcept;
+
     void const* getData() const { return mData; }
 
     size_t getSize() const { return mSize; }
 
 private:
+    struct CompressedChunk {
+        const uint8_t* start;
+        uint32_t size;
+        uint32_t uncompressedSize;
+        ShaderContent content;
+    };
+
     bool parseChunk(Unflattener& unflattener);
+    bool decompress(Type type, ChunkDesc& desc) const noexcept;
 
     void const* mData;
     size_t mSize;
-    tsl::robin_map<Type, ChunkContainer::ChunkDesc> mChunks;
+    // compressed chunks are recorded here with a null start until they're decompressed
+    mutable tsl::robin_map<Type, ChunkContainer::ChunkDesc> mChunks;
+    mutable tsl::robin_map<Type, CompressedChunk> mCompressedChunks;
 };
 
 } // namespace filaflat
@@ -18,6 +18,8 @@
 
 #include <filaflat/Unflattener.h>
 
+#include <zstd.h>
+
 namespace filaflat {
 
 ChunkContainer::~ChunkContainer() noexcept = default;
@@ -41,11 +43,58 @@ bool ChunkContainer::parseChunk(Unflattener& unflattener) {
         return false;
     }
 
-    mChunks[Type(type)] = { cursor, size };
+    if (UTILS_UNLIKELY(type == Type::CompressedZstd)) {
+        // Index the chunk under its original type, it's decompressed when first accessed.
+        Unflattener header(cursor, cursor + size);
+        uint64_t originalType;
+        uint32_t uncompressedSize;
+        if (!header.read(&originalType) || !header.read(&uncompressedSize)) {
+            return false;
+        }
+        const uint8_t* const start = header.getCursor();
+        mCompressedChunks[Type(originalType)] = {
+                start, uint32_t(cursor + size - start), uncompressedSize, {} };
+        mChunks[Type(originalType)] = { nullptr, uncompressedSize };
+    } else {
+        mChunks[Type(type)] = { cursor, size };
+    }
     unflattener.setCursor(cursor + size);
     return true;
 }
 
+bool ChunkContainer::decompress(Type type, ChunkDesc& desc) const noexcept {
+    auto pos = mCompressedChunks.find(type);
+    if (UTILS_UNLIKELY(pos == mCompressedChunks.end())) {
+        return false;
+    }
+    CompressedChunk& chunk = pos.value();
+    ShaderContent content(chunk.uncompressedSize);
+    const size_t result = ZSTD_decompress(content.data(), content.size(),
+            chunk.start, chunk.size);
+    if (UTILS_UNLIKELY(ZSTD_isError(result) || result != chunk.uncompressedSize)) {
+        return false;
+    }
+    chunk.content = std::move(content);
+    desc = { chunk.content.data(), chunk.content.size() };
+    return true;
+}
+
+void ChunkContainer::releaseDecompressedChunk(Type type) noexcept {
+    auto pos = mCompressedChunks.find(type);
+    if (pos != mCompressedChunks.end()) {
+        pos.value().content = {};
+        mChunks[type].start = nullptr;
+    }
+}
+
+size_t ChunkContainer::getDecompressedSize() const noexcept {
+    size_t size = 0;
+    for (auto const& [type, chunk] : mCompressedChunks) {
+        size += chunk.content.size();
+    }
+    return size;
+}
+
 bool ChunkContainer::parse() noexcept {
     Unflattener unflattener((uint8_t *)mData, (uint8_t *)mData + mSize);
     do {
@@ -135,6 +135,7 @@ protected:
     Optimization mOptimization = Optimization::PERFORMANCE;
     bool mPrintShaders = false;
     bool mGenerateDebugInfo = false;
+    bool mCompression = false;
     utils::bitset32 mShaderModels;
     struct CodeGenParams {
         ShaderModel shaderModel;
@@ -566,6 +567,13 @@ public:
     //! If true, will include debugging information in generated SPIRV.
     MaterialBuilder& generateDebugInfo(bool generateDebugInfo) noexcept;
 
+    /**
+     * If true, the shader and dictionary chunks of the package are compressed with zstd, which
+     * makes the package smaller. They're decompressed on demand when the material is loaded,
+     * the chunks that are never used are never decompressed.
+     */
+    MaterialBuilder& compression(bool compression) noexcept;
+
     //! Specifies a list of variants that should be filtered out during code generation.
     MaterialBuilder& variantFilter(filament::UserVariantFilterMask variantFilter) noexcept;
 
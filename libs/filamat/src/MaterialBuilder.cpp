@@ -497,6 +497,11 @@ MaterialBuilder& MaterialBuilder::generateDebugInfo(bool generateDebugInfo) noex
     return *this;
 }
 
+MaterialBuilder& MaterialBuilder::compression(bool compression) noexcept {
+    mCompression = compression;
+    return *this;
+}
+
 MaterialBuilder& MaterialBuilder::variantFilter(UserVariantFilterMask variantFilter) noexcept {
     mVariantFilter = variantFilter;
     return *this;
@@ -1152,6 +1157,10 @@ error:
         goto error;
     }
 
+    if (mCompression) {
+        container.compress();
+    }
+
     // Flatten all chunks in the container into a Package.
     Package package(container.getSize());
     Flattener f{ package.getData() };
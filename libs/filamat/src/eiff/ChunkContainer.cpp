@@ -15,6 +15,7 @@
  */
 
 #include "ChunkContainer.h"
+#include "CompressedChunk.h"
 #include "Flattener.h"
 
 namespace filamat {
@@ -27,6 +28,27 @@ size_t ChunkContainer::getSize() const {
     return flatten(Flattener::getDryRunner());
 }
 
+void ChunkContainer::compress() {
+    for (auto& chunk : mChildren) {
+        switch (chunk->getType()) {
+            case ChunkType::MaterialGlsl:
+            case ChunkType::MaterialSpirv:
+            case ChunkType::MaterialMetal:
+            case ChunkType::DictionaryText:
+            case ChunkType::DictionarySpirv: {
+                ChunkPtr compressed = CompressedChunk::compress(*chunk);
+                if (compressed) {
+                    chunk = std::move(compressed);
+                }
+                break;
+            }
+            default:
+                // the other chunks are small and some are read before the material is created
+                break;
+        }
+    }
+}
+
 size_t ChunkContainer::flatten(Flattener& f) const {
     for (const auto& chunk: mChildren) {
         f.writeUint64(static_cast<uint64_t>(chunk->getType()));
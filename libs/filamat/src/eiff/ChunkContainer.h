@@ -49,6 +49,9 @@ public:
         return push<SimpleFieldChunk<T>>(std::forward<Args>(args)...);
     }
 
+    // Replaces the shader and dictionary chunks by their compressed version, when it's smaller.
+    void compress();
+
     size_t getSize() const;
     size_t flatten(Flattener& f) const;
 
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CompressedChunk.h"
+
+#include <zstd.h>
+
+#include <memory>
+
+namespace filamat {
+
+CompressedChunk::CompressedChunk(ChunkType originalType, uint32_t uncompressedSize,
+        std::vector<uint8_t> data) noexcept
+        : Chunk(ChunkType::CompressedZstd),
+          mOriginalType(originalType), mUncompressedSize(uncompressedSize), mData(std::move(data)) {
+}
+
+std::unique_ptr<Chunk> CompressedChunk::compress(Chunk& chunk) {
+    Flattener dryRunner{ nullptr };
+    chunk.flatten(dryRunner);
+    const size_t size = dryRunner.getBytesWritten();
+
+    std::vector<uint8_t> content(size);
+    Flattener f{ content.data() };
+    chunk.flatten(f);
+
+    // Like for uber archives, materials are compressed at build time so we can afford the
+    // maximum compression level, except in debug builds where it's too slow. The minimum level
+    // barely compresses shaders, so we use the fastest regular level instead.
+#ifdef NDEBUG
+    const int compressionLevel = ZSTD_maxCLevel();
+#else
+    const int compressionLevel = 1;
+#endif
+
+    std::vector<uint8_t> data(ZSTD_compressBound(size));
+    const size_t result = ZSTD_compress(data.data(), data.size(), content.data(), size,
+            compressionLevel);
+
+    // the type and uncompressed size take 12 bytes
+    if (ZSTD_isError(result) || result + 12 >= size) {
+        return nullptr;
+    }
+    data.resize(result);
+    return std::unique_ptr<Chunk>(
+            new CompressedChunk(chunk.getType(), uint32_t(size), std::move(data)));
+}
+
+void CompressedChunk::flatten(Flattener& f) {
+    f.writeUint64(static_cast<uint64_t>(mOriginalType));
+    f.writeUint32(mUncompressedSize);
+    f.writeRaw(mData.data(), mData.size());
+}
+
+} // namespace filamat
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMAT_COMPRESSED_CHUNK_H
+#define TNT_FILAMAT_COMPRESSED_CHUNK_H
+
+#include "Chunk.h"
+
+#include <memory>
+#include <vector>
+
+#include <stdint.h>
+
+namespace filamat {
+
+// A chunk holding the zstd-compressed content of another chunk. The content is flattened on its
+// own, so that any alignment it contains is relative to the start of the chunk's content, which
+// is how it is laid out once decompressed.
+class CompressedChunk final : public Chunk {
+public:
+    // Compresses `chunk`, returns nullptr if that doesn't make it smaller.
+    static std::unique_ptr<Chunk> compress(Chunk& chunk);
+
+    ~CompressedChunk() override = default;
+
+private:
+    CompressedChunk(ChunkType originalType, uint32_t uncompressedSize,
+            std::vector<uint8_t> data) noexcept;
+
+    void flatten(Flattener& f) override;
+
+    const ChunkType mOriginalType;
+    const uint32_t mUncompressedSize;
+    const std::vector<uint8_t> mData;
+};
+
+} // namespace filamat
+
+#endif // TNT_FILAMAT_COMPRESSED_CHUNK_H
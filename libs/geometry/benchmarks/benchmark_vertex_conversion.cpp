@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <geometry/VertexConversion.h>
+
+#include <math/half.h>
+#include <math/vec2.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <random>
+#include <vector>
+
+using namespace filament::geometry;
+using namespace filament::math;
+
+using Isa = VertexConversion::Isa;
+
+// number of values converted per iteration, about the size of a typical mesh attribute
+static constexpr size_t COUNT = 64 * 1024;
+
+static std::vector<float> makeInput() {
+    std::default_random_engine gen; // NOLINT
+    std::uniform_real_distribution<float> rand(-1.0f, 1.0f);
+    std::vector<float> data(COUNT);
+    for (float& v : data) {
+        v = rand(gen);
+    }
+    return data;
+}
+
+// Args: { instruction set }
+static void isaArgs(benchmark::internal::Benchmark* b) {
+    for (Isa isa : { Isa::GENERIC, Isa::SSE2, Isa::AVX2, Isa::NEON }) {
+        b->Arg(int(isa));
+    }
+}
+
+// runs `convert` with the kernels of the instruction set selected by the benchmark arguments
+template<typename F>
+static void run(benchmark::State& state, F convert) {
+    Isa const isa = Isa(state.range(0));
+    if (!VertexConversion::Test::isSupported(isa)) {
+        state.SkipWithError("instruction set not supported");
+        // the benchmark loop must still be entered, it ends immediately
+        for (auto _ : state) {
+        }
+        return;
+    }
+    state.SetLabel(VertexConversion::Test::getName(isa));
+    VertexConversion::Kernels const& kernels = VertexConversion::Test::getKernels(isa);
+    for (auto _ : state) {
+        convert(kernels);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * COUNT);
+}
+
+static void floatToHalf(benchmark::State& state) {
+    std::vector<float> const in = makeInput();
+    std::vector<half> out(COUNT);
+    run(state, [&](auto const& k) { k.floatToHalf(out.data(), in.data(), COUNT); });
+}
+
+static void halfToFloat(benchmark::State& state) {
+    std::vector<float> const tmp = makeInput();
+    std::vector<half> in(COUNT);
+    VertexConversion::floatToHalf(in.data(), tmp.data(), COUNT);
+    std::vector<float> out(COUNT);
+    run(state, [&](auto const& k) { k.halfToFloat(out.data(), in.data(), COUNT); });
+}
+
+static void packSnorm8(benchmark::State& state) {
+    std::vector<float> const in = makeInput();
+    std::vector<int8_t> out(COUNT);
+    run(state, [&](auto const& k) { k.packSnorm8(out.data(), in.data(), COUNT); });
+}
+
+static void packUnorm8(benchmark::State& state) {
+    std::vector<float> const in = makeInput();
+    std::vector<uint8_t> out(COUNT);
+    run(state, [&](auto const& k) { k.packUnorm8(out.data(), in.data(), COUNT); });
+}
+
+static void packSnorm16(benchmark::State& state) {
+    std::vector<float> const in = makeInput();
+    std::vector<int16_t> out(COUNT);
+    run(state, [&](auto const& k) { k.packSnorm16(out.data(), in.data(), COUNT); });
+}
+
+static void packUnorm16(benchmark::State& state) {
+    std::vector<float> const in = makeInput();
+    std::vector<uint16_t> out(COUNT);
+    run(state, [&](auto const& k) { k.packUnorm16(out.data(), in.data(), COUNT); });
+}
+
+static void unpackSnorm8(benchmark::State& state) {
+    std::vector<float> const tmp = makeInput();
+    std::vector<int8_t> in(COUNT);
+    VertexConversion::packSnorm8(in.data(), tmp.data(), COUNT);
+    std::vector<float> out(COUNT);
+    run(state, [&](auto const& k) { k.unpackSnorm8(out.data(), in.data(), COUNT); });
+}
+
+static void unpackSnorm16(benchmark::State& state) {
+    std::vector<float> const tmp = makeInput();
+    std::vector<int16_t> in(COUNT);
+    VertexConversion::packSnorm16(in.data(), tmp.data(), COUNT);
+    std::vector<float> out(COUNT);
+    run(state, [&](auto const& k) { k.unpackSnorm16(out.data(), in.data(), COUNT); });
+}
+
+static void unpackUnorm16(benchmark::State& state) {
+    std::vector<float> const tmp = makeInput();
+    std::vector<uint16_t> in(COUNT);
+    VertexConversion::packUnorm16(in.data(), tmp.data(), COUNT);
+    std::vector<float> out(COUNT);
+    run(state, [&](auto const& k) { k.unpackUnorm16(out.data(), in.data(), COUNT); });
+}
+
+// extracts the normals of an interleaved { float3 position, float3 normal, float2 uv } buffer
+static void gatherNormals(benchmark::State& state) {
+    struct Vertex {
+        float3 position;
+        float3 normal;
+        float2 uv;
+    };
+    std::vector<Vertex> const in(COUNT / 3);
+    std::vector<float3> out(in.size());
+    for (auto _ : state) {
+        VertexConversion::gather(out.data(), &in[0].normal,
+                sizeof(float3), sizeof(Vertex), in.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * in.size());
+}
+
+BENCHMARK(floatToHalf)->Apply(isaArgs);
+BENCHMARK(halfToFloat)->Apply(isaArgs);
+BENCHMARK(packSnorm8)->Apply(isaArgs);
+BENCHMARK(packUnorm8)->Apply(isaArgs);
+BENCHMARK(packSnorm16)->Apply(isaArgs);
+BENCHMARK(packUnorm16)->Apply(isaArgs);
+BENCHMARK(unpackSnorm8)->Apply(isaArgs);
+BENCHMARK(unpackSnorm16)->Apply(isaArgs);
+BENCHMARK(unpackUnorm16)->Apply(isaArgs);
+BENCHMARK(gatherNormals);
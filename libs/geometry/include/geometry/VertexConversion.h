@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_GEOMETRY_VERTEXCONVERSION_H
+#define TNT_GEOMETRY_VERTEXCONVERSION_H
+
+#include <utils/compiler.h>
+
+#include <math/half.h>
+#include <math/quat.h>
+#include <math/vec4.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+namespace geometry {
+
+/**
+ * Bulk conversions of vertex attribute data.
+ *
+ * Each function converts `count` tightly packed values and produces exactly the same bits as the
+ * corresponding scalar function of the math library (math::half, and packSnorm16(),
+ * unpackUnorm8(), etc. from math/norm.h), but processes several values at a time with the
+ * SIMD instruction set available on the CPU. The instruction set is chosen at runtime, the first
+ * time a conversion is performed (see getIsa()).
+ *
+ * Input and output arrays must not overlap. The result of packing a NaN is undefined.
+ *
+ * Usage Example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * using filament::geometry::VertexConversion;
+ *
+ * // positions is an array of float3, written as half4 (with w = 1) into the vertex buffer
+ * std::vector<float4> tmp(vertexCount);
+ * VertexConversion::gather(tmp.data(), positions, sizeof(float3), 0, vertexCount);
+ * VertexConversion::floatToHalf(out, &tmp[0].x, vertexCount * 4);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class UTILS_PUBLIC VertexConversion {
+public:
+    /**
+     * Instruction sets the conversions are implemented with.
+     */
+    enum class Isa : uint8_t {
+        GENERIC,    //!< portable C++
+        SSE2,       //!< 4-wide, x86-64 baseline
+        AVX2,       //!< 8-wide, x86-64 AVX2 and F16C
+        NEON,       //!< 4-wide, ARMv8 NEON
+    };
+
+    /**
+     * Returns the instruction set used by the conversions on this CPU.
+     */
+    static Isa getIsa() noexcept;
+
+    /** Converts floats to half-floats, rounding like math::half. */
+    static void floatToHalf(math::half* out, float const* in, size_t count) noexcept;
+
+    /** Converts half-floats to floats. */
+    static void halfToFloat(float* out, math::half const* in, size_t count) noexcept;
+
+    /** Same as math::packSnorm8(), i.e.: maps [-1, 1] to [-127, 127]. */
+    static void packSnorm8(int8_t* out, float const* in, size_t count) noexcept;
+
+    /** Same as math::packUnorm8(), i.e.: maps [0, 1] to [0, 255]. */
+    static void packUnorm8(uint8_t* out, float const* in, size_t count) noexcept;
+
+    /** Same as math::packSnorm16(), i.e.: maps [-1, 1] to [-32767, 32767]. */
+    static void packSnorm16(int16_t* out, float const* in, size_t count) noexcept;
+
+    /** Same as math::packUnorm16(), i.e.: maps [0, 1] to [0, 65535]. */
+    static void packUnorm16(uint16_t* out, float const* in, size_t count) noexcept;
+
+    /** Same as math::unpackSnorm8(), -128 is clamped to -1. */
+    static void unpackSnorm8(float* out, int8_t const* in, size_t count) noexcept;
+
+    /** Same as math::unpackUnorm8(). */
+    static void unpackUnorm8(float* out, uint8_t const* in, size_t count) noexcept;
+
+    /** Same as math::unpackSnorm16(), -32768 is clamped to -1. */
+    static void unpackSnorm16(float* out, int16_t const* in, size_t count) noexcept;
+
+    /** Same as math::unpackUnorm16(). */
+    static void unpackUnorm16(float* out, uint16_t const* in, size_t count) noexcept;
+
+    /**
+     * Copies `count` elements of `elementSize` bytes, read every `stride` bytes from `in`, into
+     * the tightly packed array `out`. This is typically used to extract one attribute from an
+     * interleaved vertex buffer before converting it with one of the functions above.
+     * If stride is 0, the input is assumed tightly packed.
+     */
+    static void gather(void* out, void const* in,
+            size_t elementSize, size_t stride, size_t count) noexcept;
+
+    /**
+     * Packs tangent frame quaternions (e.g. from SurfaceOrientation) into SHORT4 attributes,
+     * same as math::packSnorm16() on each quaternion.
+     */
+    static void packTangentFrames(math::short4* out, math::quatf const* in, size_t count) noexcept;
+
+    /**
+     * Packs tangent frame quaternions (e.g. from SurfaceOrientation) into HALF4 attributes,
+     * same as constructing a math::quath from each quaternion.
+     */
+    static void packTangentFrames(math::quath* out, math::quatf const* in, size_t count) noexcept;
+
+    /**
+     * The implementation of the conversions for one instruction set.
+     */
+    struct Kernels {
+        void (*floatToHalf)(math::half*, float const*, size_t) noexcept;
+        void (*halfToFloat)(float*, math::half const*, size_t) noexcept;
+        void (*packSnorm8)(int8_t*, float const*, size_t) noexcept;
+        void (*packUnorm8)(uint8_t*, float const*, size_t) noexcept;
+        void (*packSnorm16)(int16_t*, float const*, size_t) noexcept;
+        void (*packUnorm16)(uint16_t*, float const*, size_t) noexcept;
+        void (*unpackSnorm8)(float*, int8_t const*, size_t) noexcept;
+        void (*unpackUnorm8)(float*, uint8_t const*, size_t) noexcept;
+        void (*unpackSnorm16)(float*, int16_t const*, size_t) noexcept;
+        void (*unpackUnorm16)(float*, uint16_t const*, size_t) noexcept;
+    };
+
+    /**
+     * For testing and benchmarking.
+     */
+    struct UTILS_PUBLIC Test {
+        // whether the given instruction set can be used on this CPU
+        static bool isSupported(Isa isa) noexcept;
+
+        // the conversions implemented with the given instruction set, which must be supported
+        static Kernels const& getKernels(Isa isa) noexcept;
+
+        static const char* getName(Isa isa) noexcept;
+    };
+};
+
+} // namespace geometry
+} // namespace filament
+
+#endif // TNT_GEOMETRY_VERTEXCONVERSION_H
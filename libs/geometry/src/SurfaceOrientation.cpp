@@ -15,6 +15,7 @@
  */
 
 #include <geometry/SurfaceOrientation.h>
+#include <geometry/VertexConversion.h>
 
 #include <utils/Panic.h>
 #include <utils/debug.h>
@@ -334,6 +335,10 @@ void SurfaceOrientation::getQuats(short4* out, size_t quatCount, size_t stride)
     const vector<quatf>& in = mImpl->quaternions;
     quatCount = std::min(quatCount, in.size());
     stride = stride ? stride : sizeof(decltype(*out));
+    if (stride == sizeof(decltype(*out))) {
+        VertexConversion::packTangentFrames(out, in.data(), quatCount);
+        return;
+    }
     for (size_t i = 0; i < quatCount; ++i) {
         *out = packSnorm16(in[i].xyzw);
         out = (decltype(out)) (((uint8_t*) out) + stride);
@@ -344,6 +349,10 @@ void SurfaceOrientation::getQuats(quath* out, size_t quatCount, size_t stride) c
     const vector<quatf>& in = mImpl->quaternions;
     quatCount = std::min(quatCount, in.size());
     stride = stride ? stride : sizeof(decltype(*out));
+    if (stride == sizeof(decltype(*out))) {
+        VertexConversion::packTangentFrames(out, in.data(), quatCount);
+        return;
+    }
     for (size_t i = 0; i < quatCount; ++i) {
         *out = quath(in[i]);
         out = (decltype(out)) (((uint8_t*) out) + stride);
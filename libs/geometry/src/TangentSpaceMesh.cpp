@@ -15,6 +15,7 @@
  */
 
 #include <geometry/TangentSpaceMesh.h>
+#include <geometry/VertexConversion.h>
 
 #include "MikktspaceImpl.h"
 #include "TangentSpaceMeshInternal.h"
@@ -574,6 +575,10 @@ void TangentSpaceMesh::getQuats(short4* out, size_t stride) const noexcept {
     stride = stride ? stride : sizeof(decltype((*out)));
     auto tangentSpace = mOutput->tangentSpace.get();
     size_t const vertexCount = mOutput->vertexCount;
+    if (stride == sizeof(decltype((*out)))) {
+        VertexConversion::packTangentFrames(out, tangentSpace, vertexCount);
+        return;
+    }
     for (size_t i = 0; i < vertexCount; ++i) {
         *out = packSnorm16(tangentSpace[i].xyzw);
         takeStride(out, stride);
@@ -584,6 +589,10 @@ void TangentSpaceMesh::getQuats(quath* out, size_t stride) const noexcept {
     stride = stride ? stride : sizeof(decltype((*out)));
     auto tangentSpace = mOutput->tangentSpace.get();
     size_t const vertexCount = mOutput->vertexCount;
+    if (stride == sizeof(decltype((*out)))) {
+        VertexConversion::packTangentFrames(out, tangentSpace, vertexCount);
+        return;
+    }
     for (size_t i = 0; i < vertexCount; ++i) {
         *out = quath(tangentSpace[i].xyzw);
         takeStride(out, stride);
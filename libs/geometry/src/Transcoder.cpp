@@ -15,6 +15,7 @@
  */
 
 #include <geometry/Transcoder.h>
+#include <geometry/VertexConversion.h>
 
 #include <math/half.h>
 
@@ -179,6 +180,10 @@ size_t Transcoder::operator()(float* UTILS_RESTRICT target, void const* UTILS_RE
         }
         case ComponentType::HALF: {
             const uint32_t stride = mConfig.inputStrideBytes ? mConfig.inputStrideBytes : (2 * comp);
+            if (stride == 2 * comp) {
+                VertexConversion::halfToFloat(target, (half const*) source, count * comp);
+                return required;
+            }
             uint8_t const* srcBytes = (uint8_t const*) source;
             for (size_t i = 0; i < count; ++i, target += comp, srcBytes += stride) {
                 half const* src = (half const*) srcBytes;
@@ -191,15 +196,7 @@ size_t Transcoder::operator()(float* UTILS_RESTRICT target, void const* UTILS_RE
         case ComponentType::FLOAT: {
             const uint32_t srcStride =
                     mConfig.inputStrideBytes ? mConfig.inputStrideBytes : (4 * comp);
-            uint8_t const* srcBytes = (uint8_t const*) source;
-            for (size_t i = 0; i < count; ++i, target += comp, srcBytes += srcStride) {
-                // This will never break alignment rules because the glTF spec stipulates that the
-                // stride must be a multiple of the component size.
-                float const* src = (float const*) srcBytes;
-                for (int n = 0; n < comp; ++n) {
-                    target[n] = src[n];
-                }
-            }
+            VertexConversion::gather(target, source, 4 * comp, srcStride, count);
             return required;
         }
     }
@@ -0,0 +1,910 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <geometry/VertexConversion.h>
+
+#include <utils/debug.h>
+
+#include <math/norm.h>
+
+#include <initializer_list>
+
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__clang__) || defined(__GNUC__))
+#   define GEOMETRY_CONVERSION_HAS_X86 1
+#   include <immintrin.h>
+#   define GEOMETRY_CONVERSION_TARGET(isa) __attribute__((target(isa)))
+#else
+#   define GEOMETRY_CONVERSION_HAS_X86 0
+#endif
+
+// The NEON kernels need the double precision and the rounding conversions of ARMv8.
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#   define GEOMETRY_CONVERSION_HAS_NEON 1
+#   include <arm_neon.h>
+#else
+#   define GEOMETRY_CONVERSION_HAS_NEON 0
+#endif
+
+// Note: this file must not be compiled with -ffast-math (see CMakeLists.txt), the results of all
+// the kernels must match the scalar functions of math/norm.h and math/half.h bit for bit.
+
+namespace filament {
+namespace geometry {
+
+using namespace math;
+
+using Isa = VertexConversion::Isa;
+using Kernels = VertexConversion::Kernels;
+
+// ------------------------------------------------------------------------------------------------
+// Generic implementation
+// ------------------------------------------------------------------------------------------------
+
+static void floatToHalfGeneric(half* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = half(in[i]);
+    }
+}
+
+static void halfToFloatGeneric(float* UTILS_RESTRICT out, half const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = float(in[i]);
+    }
+}
+
+static void packSnorm8Generic(int8_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = math::packSnorm8(in[i]);
+    }
+}
+
+static void packUnorm8Generic(uint8_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = math::packUnorm8(in[i]);
+    }
+}
+
+static void packSnorm16Generic(int16_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = math::packSnorm16(in[i]);
+    }
+}
+
+static void packUnorm16Generic(uint16_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = math::packUnorm16(in[i]);
+    }
+}
+
+static void unpackSnorm8Generic(float* UTILS_RESTRICT out, int8_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = math::unpackSnorm8(in[i]);
+    }
+}
+
+static void unpackUnorm8Generic(float* UTILS_RESTRICT out, uint8_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = math::unpackUnorm8(in[i]);
+    }
+}
+
+static void unpackSnorm16Generic(float* UTILS_RESTRICT out, int16_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = math::unpackSnorm16(in[i]);
+    }
+}
+
+static void unpackUnorm16Generic(float* UTILS_RESTRICT out, uint16_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = math::unpackUnorm16(in[i]);
+    }
+}
+
+#if GEOMETRY_CONVERSION_HAS_X86
+
+// ------------------------------------------------------------------------------------------------
+// SSE2 implementation
+//
+// math::half is not the IEEE conversion (it rounds ties away from zero), so float to half is
+// done with the same integer steps as math::half::fromf() rather than with F16C.
+// std::round() rounds ties away from zero too, which neither SSE2 nor AVX2 can do in one
+// instruction: the 16-bit packs truncate and then correct by one when the fraction is >= 0.5,
+// the 8-bit packs are computed in double precision (like math::packSnorm8()), where adding
+// +/-0.5 before truncating is exact.
+// ------------------------------------------------------------------------------------------------
+
+// std::round() of floats in the int32 range
+static inline __m128i roundSse2(__m128 x) noexcept {
+    __m128i const t = _mm_cvttps_epi32(x);
+    __m128 const d = _mm_sub_ps(x, _mm_cvtepi32_ps(t));
+    __m128 const away = _mm_cmpge_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), d), _mm_set1_ps(0.5f));
+    // +1 or -1 depending on the sign of x
+    __m128i const one = _mm_or_si128(_mm_srai_epi32(_mm_castps_si128(x), 31), _mm_set1_epi32(1));
+    return _mm_add_epi32(t, _mm_and_si128(_mm_castps_si128(away), one));
+}
+
+// std::round() of two doubles with less than 32 significant bits, in the two low lanes
+static inline __m128i roundSse2(__m128d x) noexcept {
+    __m128d const h = _mm_or_pd(_mm_and_pd(x, _mm_set1_pd(-0.0)), _mm_set1_pd(0.5));
+    return _mm_cvttpd_epi32(_mm_add_pd(x, h));
+}
+
+// packs the low 16 bits of each lane of a and b, without saturation
+static inline __m128i packLow16Sse2(__m128i a, __m128i b) noexcept {
+    a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+    b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+    return _mm_packs_epi32(a, b);
+}
+
+// 4 floats scaled by s in double precision and rounded to int32
+static inline __m128i scaleAndRoundSse2(__m128 x, double s) noexcept {
+    __m128d const scale = _mm_set1_pd(s);
+    __m128i const lo = roundSse2(_mm_mul_pd(_mm_cvtps_pd(x), scale));
+    __m128i const hi = roundSse2(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(x, x)), scale));
+    return _mm_unpacklo_epi64(lo, hi);
+}
+
+static inline __m128i floatToHalfSse2(__m128 x) noexcept {
+    __m128i const bits = _mm_castps_si128(x);
+    __m128i const sign = _mm_and_si128(bits, _mm_set1_epi32(int(0x80000000u)));
+    __m128i const abs = _mm_xor_si128(bits, sign);
+
+    // infinities and NaNs
+    __m128i const infnan = _mm_cmpgt_epi32(abs, _mm_set1_epi32(0x7F7FFFFF));
+    __m128i const nan = _mm_cmpgt_epi32(abs, _mm_set1_epi32(0x7F800000));
+    __m128i const special = _mm_or_si128(_mm_set1_epi32(0x7C00),
+            _mm_and_si128(nan, _mm_set1_epi32(0x200)));
+
+    // finite values, see math::half::fromf()
+    __m128i r = _mm_and_si128(abs, _mm_set1_epi32(~0xFFF));
+    r = _mm_add_epi32(r, _mm_set1_epi32(0x1000));
+    r = _mm_castps_si128(_mm_mul_ps(_mm_castsi128_ps(r),
+            _mm_castsi128_ps(_mm_set1_epi32(15 << 23))));
+    __m128i const inf = _mm_set1_epi32(31 << 23);
+    __m128i const lt = _mm_cmplt_epi32(r, inf);
+    r = _mm_or_si128(_mm_and_si128(lt, r), _mm_andnot_si128(lt, inf));
+    r = _mm_srli_epi32(r, 13);
+
+    r = _mm_or_si128(_mm_and_si128(infnan, special), _mm_andnot_si128(infnan, r));
+    return _mm_or_si128(r, _mm_srli_epi32(sign, 16));
+}
+
+static inline __m128 halfToFloatSse2(__m128i h) noexcept {
+    // see math::half::tof()
+    __m128i const e = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7FFF)), 13);
+    __m128 const f = _mm_mul_ps(_mm_castsi128_ps(e),
+            _mm_castsi128_ps(_mm_set1_epi32((0xFE - 15) << 23)));
+    __m128 const infnan = _mm_cmpge_ps(f, _mm_castsi128_ps(_mm_set1_epi32((0x80 + 15) << 23)));
+    __m128i r = _mm_castps_si128(f);
+    r = _mm_or_si128(r, _mm_and_si128(_mm_castps_si128(infnan), _mm_set1_epi32(0xFF << 23)));
+    r = _mm_or_si128(r, _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16));
+    return _mm_castsi128_ps(r);
+}
+
+static void floatToHalfSse2(half* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        __m128i const a = floatToHalfSse2(_mm_loadu_ps(in + i));
+        __m128i const b = floatToHalfSse2(_mm_loadu_ps(in + i + 4));
+        _mm_storeu_si128((__m128i*)(out + i), packLow16Sse2(a, b));
+    }
+    floatToHalfGeneric(out + n, in + n, count - n);
+}
+
+static void halfToFloatSse2(float* UTILS_RESTRICT out, half const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        __m128i const h = _mm_loadu_si128((__m128i const*)(in + i));
+        __m128i const zero = _mm_setzero_si128();
+        _mm_storeu_ps(out + i, halfToFloatSse2(_mm_unpacklo_epi16(h, zero)));
+        _mm_storeu_ps(out + i + 4, halfToFloatSse2(_mm_unpackhi_epi16(h, zero)));
+    }
+    halfToFloatGeneric(out + n, in + n, count - n);
+}
+
+template<bool SIGNED>
+static inline __m128i packNorm8Sse2(float const* in) noexcept {
+    __m128 const lo = _mm_set1_ps(SIGNED ? -1.0f : 0.0f);
+    __m128 const hi = _mm_set1_ps(1.0f);
+    double const scale = SIGNED ? 127.0 : 255.0;
+    __m128i r[4];
+    for (size_t j = 0; j < 4; j++) {
+        __m128 const x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + j * 4), lo), hi);
+        r[j] = scaleAndRoundSse2(x, scale);
+    }
+    __m128i const a = _mm_packs_epi32(r[0], r[1]);
+    __m128i const b = _mm_packs_epi32(r[2], r[3]);
+    return SIGNED ? _mm_packs_epi16(a, b) : _mm_packus_epi16(a, b);
+}
+
+static void packSnorm8Sse2(int8_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(15);
+    for (size_t i = 0; i < n; i += 16) {
+        _mm_storeu_si128((__m128i*)(out + i), packNorm8Sse2<true>(in + i));
+    }
+    packSnorm8Generic(out + n, in + n, count - n);
+}
+
+static void packUnorm8Sse2(uint8_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(15);
+    for (size_t i = 0; i < n; i += 16) {
+        _mm_storeu_si128((__m128i*)(out + i), packNorm8Sse2<false>(in + i));
+    }
+    packUnorm8Generic(out + n, in + n, count - n);
+}
+
+template<bool SIGNED>
+static inline __m128i packNorm16Sse2(float const* in) noexcept {
+    __m128 const lo = _mm_set1_ps(SIGNED ? -1.0f : 0.0f);
+    __m128 const hi = _mm_set1_ps(1.0f);
+    __m128 const scale = _mm_set1_ps(SIGNED ? 32767.0f : 65535.0f);
+    __m128 const x0 = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in), lo), hi);
+    __m128 const x1 = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + 4), lo), hi);
+    return packLow16Sse2(roundSse2(_mm_mul_ps(x0, scale)), roundSse2(_mm_mul_ps(x1, scale)));
+}
+
+static void packSnorm16Sse2(int16_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        _mm_storeu_si128((__m128i*)(out + i), packNorm16Sse2<true>(in + i));
+    }
+    packSnorm16Generic(out + n, in + n, count - n);
+}
+
+static void packUnorm16Sse2(uint16_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        _mm_storeu_si128((__m128i*)(out + i), packNorm16Sse2<false>(in + i));
+    }
+    packUnorm16Generic(out + n, in + n, count - n);
+}
+
+// converts 4 int32 to float, divides by `scale` and clamps to -1 when signed
+template<bool SIGNED>
+static inline void unpackNormSse2(float* out, __m128i v, float scale) noexcept {
+    __m128 x = _mm_div_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(scale));
+    if (SIGNED) {
+        x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+    }
+    _mm_storeu_ps(out, x);
+}
+
+static void unpackSnorm8Sse2(float* UTILS_RESTRICT out, int8_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(15);
+    for (size_t i = 0; i < n; i += 16) {
+        __m128i const v = _mm_loadu_si128((__m128i const*)(in + i));
+        // sign extension to 16 and then 32 bits
+        __m128i const lo = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+        __m128i const hi = _mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8);
+        unpackNormSse2<true>(out + i,      _mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16), 127.0f);
+        unpackNormSse2<true>(out + i + 4,  _mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16), 127.0f);
+        unpackNormSse2<true>(out + i + 8,  _mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16), 127.0f);
+        unpackNormSse2<true>(out + i + 12, _mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16), 127.0f);
+    }
+    unpackSnorm8Generic(out + n, in + n, count - n);
+}
+
+static void unpackUnorm8Sse2(float* UTILS_RESTRICT out, uint8_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(15);
+    __m128i const zero = _mm_setzero_si128();
+    for (size_t i = 0; i < n; i += 16) {
+        __m128i const v = _mm_loadu_si128((__m128i const*)(in + i));
+        __m128i const lo = _mm_unpacklo_epi8(v, zero);
+        __m128i const hi = _mm_unpackhi_epi8(v, zero);
+        unpackNormSse2<false>(out + i,      _mm_unpacklo_epi16(lo, zero), 255.0f);
+        unpackNormSse2<false>(out + i + 4,  _mm_unpackhi_epi16(lo, zero), 255.0f);
+        unpackNormSse2<false>(out + i + 8,  _mm_unpacklo_epi16(hi, zero), 255.0f);
+        unpackNormSse2<false>(out + i + 12, _mm_unpackhi_epi16(hi, zero), 255.0f);
+    }
+    unpackUnorm8Generic(out + n, in + n, count - n);
+}
+
+static void unpackSnorm16Sse2(float* UTILS_RESTRICT out, int16_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        __m128i const v = _mm_loadu_si128((__m128i const*)(in + i));
+        unpackNormSse2<true>(out + i,     _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16), 32767.0f);
+        unpackNormSse2<true>(out + i + 4, _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16), 32767.0f);
+    }
+    unpackSnorm16Generic(out + n, in + n, count - n);
+}
+
+static void unpackUnorm16Sse2(float* UTILS_RESTRICT out, uint16_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    __m128i const zero = _mm_setzero_si128();
+    for (size_t i = 0; i < n; i += 8) {
+        __m128i const v = _mm_loadu_si128((__m128i const*)(in + i));
+        unpackNormSse2<false>(out + i,     _mm_unpacklo_epi16(v, zero), 65535.0f);
+        unpackNormSse2<false>(out + i + 4, _mm_unpackhi_epi16(v, zero), 65535.0f);
+    }
+    unpackUnorm16Generic(out + n, in + n, count - n);
+}
+
+// ------------------------------------------------------------------------------------------------
+// AVX2 implementation
+//
+// Same algorithms as the SSE2 version, 8-wide. Half to float uses F16C, which only differs from
+// math::half in that it quiets signaling NaNs; we restore their payload.
+// ------------------------------------------------------------------------------------------------
+
+#define GEOMETRY_CONVERSION_AVX2 GEOMETRY_CONVERSION_TARGET("avx2,f16c")
+
+GEOMETRY_CONVERSION_AVX2
+static inline __m256i roundAvx2(__m256 x) noexcept {
+    __m256i const t = _mm256_cvttps_epi32(x);
+    __m256 const d = _mm256_sub_ps(x, _mm256_cvtepi32_ps(t));
+    __m256 const away = _mm256_cmp_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), d),
+            _mm256_set1_ps(0.5f), _CMP_GE_OQ);
+    __m256i const one = _mm256_or_si256(_mm256_srai_epi32(_mm256_castps_si256(x), 31),
+            _mm256_set1_epi32(1));
+    return _mm256_add_epi32(t, _mm256_and_si256(_mm256_castps_si256(away), one));
+}
+
+// 4 floats scaled by s in double precision and rounded to int32
+GEOMETRY_CONVERSION_AVX2
+static inline __m128i scaleAndRoundAvx2(__m128 x, double s) noexcept {
+    __m256d const d = _mm256_mul_pd(_mm256_cvtps_pd(x), _mm256_set1_pd(s));
+    __m256d const h = _mm256_or_pd(_mm256_and_pd(d, _mm256_set1_pd(-0.0)), _mm256_set1_pd(0.5));
+    return _mm256_cvttpd_epi32(_mm256_add_pd(d, h));
+}
+
+// packs 8 int32 in [0, 65535] into 8 uint16, in order
+GEOMETRY_CONVERSION_AVX2
+static inline __m128i packUnsigned16Avx2(__m256i v) noexcept {
+    return _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+// packs 8 int32 in [-32768, 32767] into 8 int16, in order
+GEOMETRY_CONVERSION_AVX2
+static inline __m128i packSigned16Avx2(__m256i v) noexcept {
+    return _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+GEOMETRY_CONVERSION_AVX2
+static void floatToHalfAvx2(half* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        __m256i const bits = _mm256_castps_si256(_mm256_loadu_ps(in + i));
+        __m256i const sign = _mm256_and_si256(bits, _mm256_set1_epi32(int(0x80000000u)));
+        __m256i const abs = _mm256_xor_si256(bits, sign);
+
+        // infinities and NaNs
+        __m256i const infnan = _mm256_cmpgt_epi32(abs, _mm256_set1_epi32(0x7F7FFFFF));
+        __m256i const nan = _mm256_cmpgt_epi32(abs, _mm256_set1_epi32(0x7F800000));
+        __m256i const special = _mm256_or_si256(_mm256_set1_epi32(0x7C00),
+                _mm256_and_si256(nan, _mm256_set1_epi32(0x200)));
+
+        // finite values, see math::half::fromf()
+        __m256i r = _mm256_and_si256(abs, _mm256_set1_epi32(~0xFFF));
+        r = _mm256_add_epi32(r, _mm256_set1_epi32(0x1000));
+        r = _mm256_castps_si256(_mm256_mul_ps(_mm256_castsi256_ps(r),
+                _mm256_castsi256_ps(_mm256_set1_epi32(15 << 23))));
+        r = _mm256_min_epi32(r, _mm256_set1_epi32(31 << 23));
+        r = _mm256_srli_epi32(r, 13);
+
+        r = _mm256_blendv_epi8(r, special, infnan);
+        r = _mm256_or_si256(r, _mm256_srli_epi32(sign, 16));
+        _mm_storeu_si128((__m128i*)(out + i), packUnsigned16Avx2(r));
+    }
+    floatToHalfGeneric(out + n, in + n, count - n);
+}
+
+GEOMETRY_CONVERSION_AVX2
+static void halfToFloatAvx2(float* UTILS_RESTRICT out, half const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        __m128i const h = _mm_loadu_si128((__m128i const*)(in + i));
+        __m256 f = _mm256_cvtph_ps(h);
+        // F16C sets the quiet bit of NaNs, math::half keeps the original mantissa
+        __m256i const nan = _mm256_castps_si256(_mm256_cmp_ps(f, f, _CMP_UNORD_Q));
+        __m256i const quiet = _mm256_slli_epi32(
+                _mm256_and_si256(_mm256_cvtepu16_epi32(h), _mm256_set1_epi32(0x200)), 13);
+        __m256i r = _mm256_castps_si256(f);
+        r = _mm256_andnot_si256(_mm256_and_si256(nan, _mm256_set1_epi32(0x400000)), r);
+        r = _mm256_or_si256(r, _mm256_and_si256(nan, quiet));
+        _mm256_storeu_ps(out + i, _mm256_castsi256_ps(r));
+    }
+    halfToFloatGeneric(out + n, in + n, count - n);
+}
+
+template<bool SIGNED>
+GEOMETRY_CONVERSION_AVX2
+static inline __m128i packNorm8Avx2(float const* in) noexcept {
+    __m256 const lo = _mm256_set1_ps(SIGNED ? -1.0f : 0.0f);
+    __m256 const hi = _mm256_set1_ps(1.0f);
+    double const scale = SIGNED ? 127.0 : 255.0;
+    __m128i r[4];
+    for (size_t j = 0; j < 2; j++) {
+        __m256 const x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + j * 8), lo), hi);
+        r[j * 2 + 0] = scaleAndRoundAvx2(_mm256_castps256_ps128(x), scale);
+        r[j * 2 + 1] = scaleAndRoundAvx2(_mm256_extractf128_ps(x, 1), scale);
+    }
+    __m128i const a = _mm_packs_epi32(r[0], r[1]);
+    __m128i const b = _mm_packs_epi32(r[2], r[3]);
+    return SIGNED ? _mm_packs_epi16(a, b) : _mm_packus_epi16(a, b);
+}
+
+GEOMETRY_CONVERSION_AVX2
+static void packSnorm8Avx2(int8_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(15);
+    for (size_t i = 0; i < n; i += 16) {
+        _mm_storeu_si128((__m128i*)(out + i), packNorm8Avx2<true>(in + i));
+    }
+    packSnorm8Generic(out + n, in + n, count - n);
+}
+
+GEOMETRY_CONVERSION_AVX2
+static void packUnorm8Avx2(uint8_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(15);
+    for (size_t i = 0; i < n; i += 16) {
+        _mm_storeu_si128((__m128i*)(out + i), packNorm8Avx2<false>(in + i));
+    }
+    packUnorm8Generic(out + n, in + n, count - n);
+}
+
+template<bool SIGNED>
+GEOMETRY_CONVERSION_AVX2
+static inline __m256i packNorm16Avx2(float const* in) noexcept {
+    __m256 const lo = _mm256_set1_ps(SIGNED ? -1.0f : 0.0f);
+    __m256 const hi = _mm256_set1_ps(1.0f);
+    __m256 const scale = _mm256_set1_ps(SIGNED ? 32767.0f : 65535.0f);
+    __m256 const x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in), lo), hi);
+    return roundAvx2(_mm256_mul_ps(x, scale));
+}
+
+GEOMETRY_CONVERSION_AVX2
+static void packSnorm16Avx2(int16_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        _mm_storeu_si128((__m128i*)(out + i), packSigned16Avx2(packNorm16Avx2<true>(in + i)));
+    }
+    packSnorm16Generic(out + n, in + n, count - n);
+}
+
+GEOMETRY_CONVERSION_AVX2
+static void packUnorm16Avx2(uint16_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        _mm_storeu_si128((__m128i*)(out + i), packUnsigned16Avx2(packNorm16Avx2<false>(in + i)));
+    }
+    packUnorm16Generic(out + n, in + n, count - n);
+}
+
+// converts 8 int32 to float, divides by `scale` and clamps to -1 when signed
+template<bool SIGNED>
+GEOMETRY_CONVERSION_AVX2
+static inline void unpackNormAvx2(float* out, __m256i v, float scale) noexcept {
+    __m256 x = _mm256_div_ps(_mm256_cvtepi32_ps(v), _mm256_set1_ps(scale));
+    if (SIGNED) {
+        x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+    }
+    _mm256_storeu_ps(out, x);
+}
+
+GEOMETRY_CONVERSION_AVX2
+static void unpackSnorm8Avx2(float* UTILS_RESTRICT out, int8_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(15);
+    for (size_t i = 0; i < n; i += 16) {
+        __m128i const v = _mm_loadu_si128((__m128i const*)(in + i));
+        unpackNormAvx2<true>(out + i, _mm256_cvtepi8_epi32(v), 127.0f);
+        unpackNormAvx2<true>(out + i + 8, _mm256_cvtepi8_epi32(_mm_unpackhi_epi64(v, v)), 127.0f);
+    }
+    unpackSnorm8Generic(out + n, in + n, count - n);
+}
+
+GEOMETRY_CONVERSION_AVX2
+static void unpackUnorm8Avx2(float* UTILS_RESTRICT out, uint8_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(15);
+    for (size_t i = 0; i < n; i += 16) {
+        __m128i const v = _mm_loadu_si128((__m128i const*)(in + i));
+        unpackNormAvx2<false>(out + i, _mm256_cvtepu8_epi32(v), 255.0f);
+        unpackNormAvx2<false>(out + i + 8, _mm256_cvtepu8_epi32(_mm_unpackhi_epi64(v, v)), 255.0f);
+    }
+    unpackUnorm8Generic(out + n, in + n, count - n);
+}
+
+GEOMETRY_CONVERSION_AVX2
+static void unpackSnorm16Avx2(float* UTILS_RESTRICT out, int16_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        __m128i const v = _mm_loadu_si128((__m128i const*)(in + i));
+        unpackNormAvx2<true>(out + i, _mm256_cvtepi16_epi32(v), 32767.0f);
+    }
+    unpackSnorm16Generic(out + n, in + n, count - n);
+}
+
+GEOMETRY_CONVERSION_AVX2
+static void unpackUnorm16Avx2(float* UTILS_RESTRICT out, uint16_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        __m128i const v = _mm_loadu_si128((__m128i const*)(in + i));
+        unpackNormAvx2<false>(out + i, _mm256_cvtepu16_epi32(v), 65535.0f);
+    }
+    unpackUnorm16Generic(out + n, in + n, count - n);
+}
+
+#endif // GEOMETRY_CONVERSION_HAS_X86
+
+#if GEOMETRY_CONVERSION_HAS_NEON
+
+// ------------------------------------------------------------------------------------------------
+// NEON implementation
+//
+// On ARM, math::half is __fp16, whose conversions are the same as the NEON ones. vcvta rounds
+// ties away from zero, exactly like std::round().
+// ------------------------------------------------------------------------------------------------
+
+static void floatToHalfNeon(half* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        float16x4_t const a = vcvt_f16_f32(vld1q_f32(in + i));
+        float16x4_t const b = vcvt_f16_f32(vld1q_f32(in + i + 4));
+        vst1q_u16((uint16_t*)(out + i),
+                vcombine_u16(vreinterpret_u16_f16(a), vreinterpret_u16_f16(b)));
+    }
+    floatToHalfGeneric(out + n, in + n, count - n);
+}
+
+static void halfToFloatNeon(float* UTILS_RESTRICT out, half const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        uint16x8_t const h = vld1q_u16((uint16_t const*)(in + i));
+        vst1q_f32(out + i, vcvt_f32_f16(vreinterpret_f16_u16(vget_low_u16(h))));
+        vst1q_f32(out + i + 4, vcvt_f32_f16(vreinterpret_f16_u16(vget_high_u16(h))));
+    }
+    halfToFloatGeneric(out + n, in + n, count - n);
+}
+
+// 4 floats scaled by s in double precision and rounded to int32
+static inline int32x4_t scaleAndRoundNeon(float32x4_t x, double s) noexcept {
+    int64x2_t const lo = vcvtaq_s64_f64(vmulq_n_f64(vcvt_f64_f32(vget_low_f32(x)), s));
+    int64x2_t const hi = vcvtaq_s64_f64(vmulq_n_f64(vcvt_high_f64_f32(x), s));
+    return vcombine_s32(vmovn_s64(lo), vmovn_s64(hi));
+}
+
+template<bool SIGNED>
+static inline int16x8_t packNorm8Neon(float const* in) noexcept {
+    float32x4_t const lo = vdupq_n_f32(SIGNED ? -1.0f : 0.0f);
+    float32x4_t const hi = vdupq_n_f32(1.0f);
+    double const scale = SIGNED ? 127.0 : 255.0;
+    float32x4_t const x0 = vminq_f32(vmaxq_f32(vld1q_f32(in), lo), hi);
+    float32x4_t const x1 = vminq_f32(vmaxq_f32(vld1q_f32(in + 4), lo), hi);
+    return vcombine_s16(vmovn_s32(scaleAndRoundNeon(x0, scale)),
+            vmovn_s32(scaleAndRoundNeon(x1, scale)));
+}
+
+static void packSnorm8Neon(int8_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        vst1_s8(out + i, vmovn_s16(packNorm8Neon<true>(in + i)));
+    }
+    packSnorm8Generic(out + n, in + n, count - n);
+}
+
+static void packUnorm8Neon(uint8_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        vst1_u8(out + i, vmovn_u16(vreinterpretq_u16_s16(packNorm8Neon<false>(in + i))));
+    }
+    packUnorm8Generic(out + n, in + n, count - n);
+}
+
+static void packSnorm16Neon(int16_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(3);
+    float32x4_t const lo = vdupq_n_f32(-1.0f);
+    float32x4_t const hi = vdupq_n_f32(1.0f);
+    for (size_t i = 0; i < n; i += 4) {
+        float32x4_t const x = vminq_f32(vmaxq_f32(vld1q_f32(in + i), lo), hi);
+        vst1_s16(out + i, vmovn_s32(vcvtaq_s32_f32(vmulq_n_f32(x, 32767.0f))));
+    }
+    packSnorm16Generic(out + n, in + n, count - n);
+}
+
+static void packUnorm16Neon(uint16_t* UTILS_RESTRICT out, float const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(3);
+    float32x4_t const lo = vdupq_n_f32(0.0f);
+    float32x4_t const hi = vdupq_n_f32(1.0f);
+    for (size_t i = 0; i < n; i += 4) {
+        float32x4_t const x = vminq_f32(vmaxq_f32(vld1q_f32(in + i), lo), hi);
+        vst1_u16(out + i, vmovn_u32(vcvtaq_u32_f32(vmulq_n_f32(x, 65535.0f))));
+    }
+    packUnorm16Generic(out + n, in + n, count - n);
+}
+
+// converts 4 int32 to float, divides by `scale` and clamps to -1 when signed
+template<bool SIGNED>
+static inline void unpackNormNeon(float* out, int32x4_t v, float scale) noexcept {
+    float32x4_t x = vdivq_f32(vcvtq_f32_s32(v), vdupq_n_f32(scale));
+    if (SIGNED) {
+        x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(-1.0f)), vdupq_n_f32(1.0f));
+    }
+    vst1q_f32(out, x);
+}
+
+static void unpackSnorm8Neon(float* UTILS_RESTRICT out, int8_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        int16x8_t const v = vmovl_s8(vld1_s8(in + i));
+        unpackNormNeon<true>(out + i, vmovl_s16(vget_low_s16(v)), 127.0f);
+        unpackNormNeon<true>(out + i + 4, vmovl_s16(vget_high_s16(v)), 127.0f);
+    }
+    unpackSnorm8Generic(out + n, in + n, count - n);
+}
+
+static void unpackUnorm8Neon(float* UTILS_RESTRICT out, uint8_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8) {
+        uint16x8_t const v = vmovl_u8(vld1_u8(in + i));
+        unpackNormNeon<false>(out + i,
+                vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(v))), 255.0f);
+        unpackNormNeon<false>(out + i + 4,
+                vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(v))), 255.0f);
+    }
+    unpackUnorm8Generic(out + n, in + n, count - n);
+}
+
+static void unpackSnorm16Neon(float* UTILS_RESTRICT out, int16_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(3);
+    for (size_t i = 0; i < n; i += 4) {
+        unpackNormNeon<true>(out + i, vmovl_s16(vld1_s16(in + i)), 32767.0f);
+    }
+    unpackSnorm16Generic(out + n, in + n, count - n);
+}
+
+static void unpackUnorm16Neon(float* UTILS_RESTRICT out, uint16_t const* UTILS_RESTRICT in,
+        size_t count) noexcept {
+    size_t const n = count & ~size_t(3);
+    for (size_t i = 0; i < n; i += 4) {
+        unpackNormNeon<false>(out + i, vreinterpretq_s32_u32(vmovl_u16(vld1_u16(in + i))),
+                65535.0f);
+    }
+    unpackUnorm16Generic(out + n, in + n, count - n);
+}
+
+#endif // GEOMETRY_CONVERSION_HAS_NEON
+
+// ------------------------------------------------------------------------------------------------
+// Runtime dispatch
+// ------------------------------------------------------------------------------------------------
+
+namespace {
+
+bool isIsaSupported(Isa isa) noexcept {
+    switch (isa) {
+        case Isa::GENERIC:
+            return true;
+        case Isa::SSE2:
+            return GEOMETRY_CONVERSION_HAS_X86;
+        case Isa::AVX2:
+#if GEOMETRY_CONVERSION_HAS_X86
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+#else
+            return false;
+#endif
+        case Isa::NEON:
+            return GEOMETRY_CONVERSION_HAS_NEON;
+    }
+    return false;
+}
+
+Kernels const& getKernels(Isa isa) noexcept {
+    static constexpr Kernels generic = {
+            floatToHalfGeneric, halfToFloatGeneric,
+            packSnorm8Generic, packUnorm8Generic, packSnorm16Generic, packUnorm16Generic,
+            unpackSnorm8Generic, unpackUnorm8Generic, unpackSnorm16Generic, unpackUnorm16Generic
+    };
+    switch (isa) {
+#if GEOMETRY_CONVERSION_HAS_X86
+        case Isa::SSE2: {
+            static constexpr Kernels sse2 = {
+                    floatToHalfSse2, halfToFloatSse2,
+                    packSnorm8Sse2, packUnorm8Sse2, packSnorm16Sse2, packUnorm16Sse2,
+                    unpackSnorm8Sse2, unpackUnorm8Sse2, unpackSnorm16Sse2, unpackUnorm16Sse2
+            };
+            return sse2;
+        }
+        case Isa::AVX2: {
+            static constexpr Kernels avx2 = {
+                    floatToHalfAvx2, halfToFloatAvx2,
+                    packSnorm8Avx2, packUnorm8Avx2, packSnorm16Avx2, packUnorm16Avx2,
+                    unpackSnorm8Avx2, unpackUnorm8Avx2, unpackSnorm16Avx2, unpackUnorm16Avx2
+            };
+            return avx2;
+        }
+#endif
+#if GEOMETRY_CONVERSION_HAS_NEON
+        case Isa::NEON: {
+            static constexpr Kernels neon = {
+                    floatToHalfNeon, halfToFloatNeon,
+                    packSnorm8Neon, packUnorm8Neon, packSnorm16Neon, packUnorm16Neon,
+                    unpackSnorm8Neon, unpackUnorm8Neon, unpackSnorm16Neon, unpackUnorm16Neon
+            };
+            return neon;
+        }
+#endif
+        default:
+            return generic;
+    }
+}
+
+Isa selectIsa() noexcept {
+    for (Isa isa : { Isa::AVX2, Isa::SSE2, Isa::NEON }) {
+        if (isIsaSupported(isa)) {
+            return isa;
+        }
+    }
+    return Isa::GENERIC;
+}
+
+Kernels const& getKernels() noexcept {
+    static Kernels const& kernels = getKernels(VertexConversion::getIsa());
+    return kernels;
+}
+
+template<size_t N>
+void gatherFixed(uint8_t* UTILS_RESTRICT out, uint8_t const* UTILS_RESTRICT in,
+        size_t stride, size_t count) noexcept {
+    for (size_t i = 0; i < count; i++, out += N, in += stride) {
+        memcpy(out, in, N);
+    }
+}
+
+} // anonymous namespace
+
+VertexConversion::Isa VertexConversion::getIsa() noexcept {
+    static const Isa isa = selectIsa();
+    return isa;
+}
+
+void VertexConversion::floatToHalf(half* out, float const* in, size_t count) noexcept {
+    getKernels().floatToHalf(out, in, count);
+}
+
+void VertexConversion::halfToFloat(float* out, half const* in, size_t count) noexcept {
+    getKernels().halfToFloat(out, in, count);
+}
+
+void VertexConversion::packSnorm8(int8_t* out, float const* in, size_t count) noexcept {
+    getKernels().packSnorm8(out, in, count);
+}
+
+void VertexConversion::packUnorm8(uint8_t* out, float const* in, size_t count) noexcept {
+    getKernels().packUnorm8(out, in, count);
+}
+
+void VertexConversion::packSnorm16(int16_t* out, float const* in, size_t count) noexcept {
+    getKernels().packSnorm16(out, in, count);
+}
+
+void VertexConversion::packUnorm16(uint16_t* out, float const* in, size_t count) noexcept {
+    getKernels().packUnorm16(out, in, count);
+}
+
+void VertexConversion::unpackSnorm8(float* out, int8_t const* in, size_t count) noexcept {
+    getKernels().unpackSnorm8(out, in, count);
+}
+
+void VertexConversion::unpackUnorm8(float* out, uint8_t const* in, size_t count) noexcept {
+    getKernels().unpackUnorm8(out, in, count);
+}
+
+void VertexConversion::unpackSnorm16(float* out, int16_t const* in, size_t count) noexcept {
+    getKernels().unpackSnorm16(out, in, count);
+}
+
+void VertexConversion::unpackUnorm16(float* out, uint16_t const* in, size_t count) noexcept {
+    getKernels().unpackUnorm16(out, in, count);
+}
+
+void VertexConversion::gather(void* out, void const* in,
+        size_t elementSize, size_t stride, size_t count) noexcept {
+    if (stride == 0 || stride == elementSize) {
+        memcpy(out, in, elementSize * count);
+        return;
+    }
+    uint8_t* const dst = (uint8_t*)out;
+    uint8_t const* const src = (uint8_t const*)in;
+    // fixed sizes let the compiler replace memcpy with a few moves
+    switch (elementSize) {
+        case 2:     gatherFixed<2>(dst, src, stride, count);    break;
+        case 4:     gatherFixed<4>(dst, src, stride, count);    break;
+        case 8:     gatherFixed<8>(dst, src, stride, count);    break;
+        case 12:    gatherFixed<12>(dst, src, stride, count);   break;
+        case 16:    gatherFixed<16>(dst, src, stride, count);   break;
+        default:
+            for (size_t i = 0; i < count; i++) {
+                memcpy(dst + i * elementSize, src + i * stride, elementSize);
+            }
+            break;
+    }
+}
+
+void VertexConversion::packTangentFrames(short4* out, quatf const* in, size_t count) noexcept {
+    static_assert(sizeof(short4) == 4 * sizeof(int16_t));
+    static_assert(sizeof(quatf) == 4 * sizeof(float));
+    getKernels().packSnorm16(&out->x, &in->x, count * 4);
+}
+
+void VertexConversion::packTangentFrames(quath* out, quatf const* in, size_t count) noexcept {
+    static_assert(sizeof(quath) == 4 * sizeof(half));
+    getKernels().floatToHalf(&out->x, &in->x, count * 4);
+}
+
+// For testing...
+
+bool VertexConversion::Test::isSupported(Isa isa) noexcept {
+    return isIsaSupported(isa);
+}
+
+VertexConversion::Kernels const& VertexConversion::Test::getKernels(Isa isa) noexcept {
+    assert_invariant(isSupported(isa));
+    return geometry::getKernels(isa);
+}
+
+const char* VertexConversion::Test::getName(Isa isa) noexcept {
+    switch (isa) {
+        case Isa::GENERIC:  return "generic";
+        case Isa::SSE2:     return "sse2";
+        case Isa::AVX2:     return "avx2";
+        case Isa::NEON:     return "neon";
+    }
+    return "unknown";
+}
+
+} // namespace geometry
+} // namespace filament
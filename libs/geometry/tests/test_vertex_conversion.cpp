@@ -0,0 +1,297 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <geometry/VertexConversion.h>
+
+#include <math/half.h>
+#include <math/norm.h>
+#include <math/quat.h>
+#include <math/vec3.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <string.h>
+
+using namespace filament::math;
+using filament::geometry::VertexConversion;
+
+using Isa = VertexConversion::Isa;
+
+class VertexConversionTest : public testing::Test {};
+
+static constexpr Isa ALL_ISAS[] = { Isa::GENERIC, Isa::SSE2, Isa::AVX2, Isa::NEON };
+
+static uint32_t bits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static float fromBits(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// Values around each quantization threshold of a pack to `scale`, plus a few special values.
+// The count is odd, so that the vectorized kernels also process a remainder.
+static std::vector<float> makeNormInputs(float scale) {
+    std::vector<float> values = {
+            0.0f, -0.0f, 1.0f, -1.0f, 2.0f, -2.0f, 1e-30f, -1e-30f,
+            std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+            std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::max(),
+    };
+    for (int k = -int(scale) - 1; k <= int(scale); k++) {
+        float v = float((k + 0.5) / double(scale));
+        for (int j = 0; j < 4; j++) {
+            v = std::nextafter(v, -2.0f);
+        }
+        for (int j = 0; j < 9; j++) {
+            values.push_back(v);
+            v = std::nextafter(v, 2.0f);
+        }
+    }
+    std::default_random_engine gen; // NOLINT
+    std::uniform_real_distribution<float> rand(-1.25f, 1.25f);
+    for (size_t i = 0; i < 10000; i++) {
+        values.push_back(rand(gen));
+    }
+    if (values.size() % 2 == 0) {
+        values.push_back(0.5f);
+    }
+    return values;
+}
+
+TEST_F(VertexConversionTest, HalfToFloat) {
+    std::vector<half> in(65536);
+    std::vector<float> expected(in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        in[i] = makeHalf(uint16_t(i));
+        expected[i] = float(in[i]);
+    }
+    // odd count, so that the vectorized kernels also process a remainder
+    size_t const count = in.size() - 3;
+    for (Isa isa : ALL_ISAS) {
+        if (!VertexConversion::Test::isSupported(isa)) {
+            continue;
+        }
+        std::vector<float> out(in.size(), 42.0f);
+        VertexConversion::Test::getKernels(isa).halfToFloat(out.data(), in.data(), count);
+        for (size_t i = 0; i < count; i++) {
+            ASSERT_EQ(bits(out[i]), bits(expected[i]))
+                    << VertexConversion::Test::getName(isa) << " half 0x" << std::hex << i;
+        }
+        EXPECT_EQ(out[count], 42.0f) << VertexConversion::Test::getName(isa);
+    }
+}
+
+TEST_F(VertexConversionTest, FloatToHalf) {
+    std::vector<float> in;
+    // every half, the floats around it and halfway to the next half
+    for (uint32_t i = 0; i < 65536; i++) {
+        uint32_t const f = bits(float(makeHalf(uint16_t(i))));
+        for (uint32_t d : { 0u, 1u, 0xFFFu, 0x1000u, 0x1001u }) {
+            in.push_back(fromBits(f + d));
+            in.push_back(fromBits(f - d));
+        }
+    }
+    std::default_random_engine gen; // NOLINT
+    std::uniform_int_distribution<uint32_t> rand;
+    for (size_t i = 0; i < 100001; i++) {
+        in.push_back(fromBits(rand(gen)));
+    }
+    std::vector<half> expected(in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        expected[i] = half(in[i]);
+    }
+    for (Isa isa : ALL_ISAS) {
+        if (!VertexConversion::Test::isSupported(isa)) {
+            continue;
+        }
+        std::vector<half> out(in.size());
+        VertexConversion::Test::getKernels(isa).floatToHalf(out.data(), in.data(), in.size());
+        for (size_t i = 0; i < in.size(); i++) {
+            ASSERT_EQ(getBits(out[i]), getBits(expected[i]))
+                    << VertexConversion::Test::getName(isa) << " float 0x" << std::hex
+                    << bits(in[i]);
+        }
+    }
+}
+
+TEST_F(VertexConversionTest, PackNorm) {
+    for (Isa isa : ALL_ISAS) {
+        if (!VertexConversion::Test::isSupported(isa)) {
+            continue;
+        }
+        auto const& kernels = VertexConversion::Test::getKernels(isa);
+        const char* const name = VertexConversion::Test::getName(isa);
+
+        std::vector<float> in = makeNormInputs(127.0f);
+        std::vector<int8_t> snorm8(in.size());
+        kernels.packSnorm8(snorm8.data(), in.data(), in.size());
+        for (size_t i = 0; i < in.size(); i++) {
+            ASSERT_EQ(snorm8[i], packSnorm8(in[i])) << name << " " << in[i];
+        }
+
+        in = makeNormInputs(255.0f);
+        std::vector<uint8_t> unorm8(in.size());
+        kernels.packUnorm8(unorm8.data(), in.data(), in.size());
+        for (size_t i = 0; i < in.size(); i++) {
+            ASSERT_EQ(unorm8[i], packUnorm8(in[i])) << name << " " << in[i];
+        }
+
+        in = makeNormInputs(32767.0f);
+        std::vector<int16_t> snorm16(in.size());
+        kernels.packSnorm16(snorm16.data(), in.data(), in.size());
+        for (size_t i = 0; i < in.size(); i++) {
+            ASSERT_EQ(snorm16[i], packSnorm16(in[i])) << name << " " << in[i];
+        }
+
+        in = makeNormInputs(65535.0f);
+        std::vector<uint16_t> unorm16(in.size());
+        kernels.packUnorm16(unorm16.data(), in.data(), in.size());
+        for (size_t i = 0; i < in.size(); i++) {
+            ASSERT_EQ(unorm16[i], packUnorm16(in[i])) << name << " " << in[i];
+        }
+    }
+}
+
+TEST_F(VertexConversionTest, UnpackNorm) {
+    // every possible value, in an odd count
+    std::vector<int8_t> snorm8(257);
+    std::vector<uint8_t> unorm8(257);
+    std::vector<int16_t> snorm16(65537);
+    std::vector<uint16_t> unorm16(65537);
+    for (size_t i = 0; i < snorm8.size(); i++) {
+        snorm8[i] = int8_t(i);
+        unorm8[i] = uint8_t(i);
+    }
+    for (size_t i = 0; i < snorm16.size(); i++) {
+        snorm16[i] = int16_t(i);
+        unorm16[i] = uint16_t(i);
+    }
+
+    for (Isa isa : ALL_ISAS) {
+        if (!VertexConversion::Test::isSupported(isa)) {
+            continue;
+        }
+        auto const& kernels = VertexConversion::Test::getKernels(isa);
+        const char* const name = VertexConversion::Test::getName(isa);
+        std::vector<float> out(65537);
+
+        kernels.unpackSnorm8(out.data(), snorm8.data(), snorm8.size());
+        for (size_t i = 0; i < snorm8.size(); i++) {
+            ASSERT_EQ(bits(out[i]), bits(unpackSnorm8(snorm8[i]))) << name << " " << i;
+        }
+
+        kernels.unpackUnorm8(out.data(), unorm8.data(), unorm8.size());
+        for (size_t i = 0; i < unorm8.size(); i++) {
+            ASSERT_EQ(bits(out[i]), bits(unpackUnorm8(unorm8[i]))) << name << " " << i;
+        }
+
+        kernels.unpackSnorm16(out.data(), snorm16.data(), snorm16.size());
+        for (size_t i = 0; i < snorm16.size(); i++) {
+            ASSERT_EQ(bits(out[i]), bits(unpackSnorm16(snorm16[i]))) << name << " " << i;
+        }
+
+        kernels.unpackUnorm16(out.data(), unorm16.data(), unorm16.size());
+        for (size_t i = 0; i < unorm16.size(); i++) {
+            ASSERT_EQ(bits(out[i]), bits(unpackUnorm16(unorm16[i]))) << name << " " << i;
+        }
+    }
+
+    // unpacking what was packed round-trips exactly
+    std::vector<float> values(65536);
+    std::vector<int16_t> packed(values.size());
+    VertexConversion::unpackSnorm16(values.data(), snorm16.data() + 1, values.size());
+    VertexConversion::packSnorm16(packed.data(), values.data(), values.size());
+    for (size_t i = 0; i < packed.size(); i++) {
+        EXPECT_EQ(packed[i], std::max(snorm16[i + 1], int16_t(-32767)));
+    }
+}
+
+TEST_F(VertexConversionTest, Gather) {
+    struct Vertex {
+        float3 position;
+        half normal[3];
+        uint8_t color[4];
+    };
+    std::vector<Vertex> vertices(11);
+    for (size_t i = 0; i < vertices.size(); i++) {
+        vertices[i].position = float3{ float(i), float(i) + 0.25f, float(i) + 0.5f };
+        vertices[i].normal[0] = half(float(i) / 11.0f);
+        vertices[i].normal[1] = half(-float(i) / 11.0f);
+        vertices[i].normal[2] = half(1.0f);
+        memcpy(vertices[i].color, &i, 4);
+    }
+
+    std::vector<float3> positions(vertices.size());
+    VertexConversion::gather(positions.data(), &vertices[0].position,
+            sizeof(float3), sizeof(Vertex), vertices.size());
+
+    std::vector<half> normals(vertices.size() * 3);
+    VertexConversion::gather(normals.data(), &vertices[0].normal,
+            3 * sizeof(half), sizeof(Vertex), vertices.size());
+
+    std::vector<uint32_t> colors(vertices.size());
+    VertexConversion::gather(colors.data(), &vertices[0].color,
+            sizeof(uint32_t), sizeof(Vertex), vertices.size());
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        EXPECT_EQ(positions[i], vertices[i].position);
+        for (size_t j = 0; j < 3; j++) {
+            EXPECT_EQ(getBits(normals[i * 3 + j]), getBits(vertices[i].normal[j]));
+        }
+        EXPECT_EQ(colors[i], uint32_t(i));
+    }
+
+    // tightly packed input
+    std::vector<float3> copy(positions.size());
+    VertexConversion::gather(copy.data(), positions.data(), sizeof(float3), 0, positions.size());
+    EXPECT_EQ(copy, positions);
+}
+
+TEST_F(VertexConversionTest, PackTangentFrames) {
+    std::default_random_engine gen; // NOLINT
+    std::uniform_real_distribution<float> rand(-1.0f, 1.0f);
+    std::vector<quatf> in(333);
+    for (auto& q : in) {
+        q = normalize(quatf{ rand(gen), rand(gen), rand(gen), rand(gen) });
+    }
+
+    std::vector<short4> shorts(in.size());
+    VertexConversion::packTangentFrames(shorts.data(), in.data(), in.size());
+    std::vector<quath> halfs(in.size());
+    VertexConversion::packTangentFrames(halfs.data(), in.data(), in.size());
+
+    for (size_t i = 0; i < in.size(); i++) {
+        EXPECT_EQ(shorts[i], packSnorm16(in[i].xyzw));
+        quath const expected(in[i]);
+        for (size_t j = 0; j < 4; j++) {
+            EXPECT_EQ(getBits(halfs[i][j]), getBits(expected[j]));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include <ibl/Cubemap.h>
+#include <ibl/CubemapSH.h>
+#include <ibl/CubemapUtils.h>
+#include <ibl/Image.h>
+
+#include <utils/JobSystem.h>
+
+#include <math/vec3.h>
+
+using namespace filament::ibl;
+using namespace filament::math;
+using namespace utils;
+
+static void fill(Cubemap& cm) {
+    const size_t dim = cm.getDimensions();
+    for (size_t f = 0; f < 6; f++) {
+        Image& image = cm.getImageForFace(Cubemap::Face(f));
+        for (size_t y = 0; y < dim; y++) {
+            for (size_t x = 0; x < dim; x++) {
+                const float3 s = cm.getDirectionFor(Cubemap::Face(f), x, y);
+                Cubemap::writeAt(image.getPixelRef(x, y), Cubemap::Texel{ s * 0.5f + 0.5f });
+            }
+        }
+    }
+}
+
+// Args: { cubemap dimension, number of bands }
+static void computeSHArgs(benchmark::internal::Benchmark* b) {
+    for (int dim : { 64, 256, 1024 }) {
+        for (int numBands : { 3, 5 }) {
+            b->Args({ dim, numBands });
+        }
+    }
+}
+
+static void computeSH(benchmark::State& state) {
+    JobSystem js;
+    js.adopt();
+
+    Image image;
+    Cubemap cm = CubemapUtils::create(image, size_t(state.range(0)));
+    fill(cm);
+    const size_t numBands = size_t(state.range(1));
+
+    for (auto _ : state) {
+        auto sh = CubemapSH::computeSH(js, cm, numBands, true);
+        benchmark::DoNotOptimize(sh);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * 6 * state.range(0) * state.range(0));
+
+    js.emancipate();
+}
+
+static void computeSHReference(benchmark::State& state) {
+    Image image;
+    Cubemap cm = CubemapUtils::create(image, size_t(state.range(0)));
+    fill(cm);
+    const size_t numBands = size_t(state.range(1));
+
+    for (auto _ : state) {
+        auto sh = CubemapSH::computeSHReference(cm, numBands, true);
+        benchmark::DoNotOptimize(sh);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * 6 * state.range(0) * state.range(0));
+}
+
+BENCHMARK(computeSH)->Apply(computeSHArgs)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(computeSHReference)->Apply(computeSHArgs)->Unit(benchmark::kMillisecond);
@@ -43,10 +43,19 @@ public:
     /**
      * Spherical Harmonics decomposition of the given cubemap
      * Optionally calculates irradiance by convolving with truncated cos.
+     * The work is split in blocks of rows which are reduced in a fixed order, so the result
+     * doesn't depend on the number of threads of the JobSystem.
      */
     static std::unique_ptr<math::float3[]> computeSH(
             utils::JobSystem& js, const Cubemap& cm, size_t numBands, bool irradiance);
 
+    /**
+     * Straightforward single-threaded version of computeSH(), evaluating the SH basis one texel
+     * at a time. It is much slower and only meant as a reference for validating computeSH().
+     */
+    static std::unique_ptr<math::float3[]> computeSHReference(
+            const Cubemap& cm, size_t numBands, bool irradiance);
+
     /**
      * Render given spherical harmonics into a cubemap
      */
@@ -101,6 +110,17 @@ private:
 
     static void computeShBasis(float* SHb, size_t numBands, const math::float3& s);
 
+    // number of directions processed at once by the version of computeShBasis() below
+    static constexpr size_t SH_BASIS_LANES = 8;
+
+    // Computes the SH basis of SH_BASIS_LANES directions given as separate x, y, z arrays.
+    // SHb[i * SH_BASIS_LANES + j] receives the i-th coefficient of the j-th direction.
+    static void computeShBasis(float* SHb, size_t numBands,
+            float const* x, float const* y, float const* z);
+
+    // applies the K scaling factors and, optionally, the truncated cos convolution
+    static void scaleSH(math::float3* sh, size_t numBands, bool irradiance);
+
     static float Kml(ssize_t m, size_t l);
 
     static std::vector<float> Ki(size_t numBands);
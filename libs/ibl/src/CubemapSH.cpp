@@ -204,6 +204,93 @@ void CubemapSH::computeShBasis(
     }
 }
 
+void CubemapSH::computeShBasis(
+        float* UTILS_RESTRICT SHb,
+        size_t numBands,
+        float const* UTILS_RESTRICT x,
+        float const* UTILS_RESTRICT y,
+        float const* UTILS_RESTRICT z)
+{
+    // This is the same computation as above, but each step is done on N directions at once,
+    // which lets the compiler vectorize the inner loops.
+    constexpr size_t N = SH_BASIS_LANES;
+    auto coef = [SHb](size_t i) { return SHb + i * N; };
+
+    float Pml_2[N];
+    float Pml_1[N];
+
+    // handle m=0 separately, since it produces only one coefficient
+    for (size_t j = 0; j < N; j++) {
+        Pml_2[j] = 0;
+        Pml_1[j] = 1;
+        coef(0)[j] = 1;
+    }
+    for (size_t l = 1; l < numBands; l++) {
+        float* UTILS_RESTRICT out = coef(SHindex(0, l));
+        for (size_t j = 0; j < N; j++) {
+            float Pml = ((2*l-1.0f)*Pml_1[j]*z[j] - (l-1.0f)*Pml_2[j]) / l;
+            Pml_2[j] = Pml_1[j];
+            Pml_1[j] = Pml;
+            out[j] = Pml;
+        }
+    }
+
+    // Pmm doesn't depend on the direction
+    float Pmm = 1;
+    for (size_t m = 1; m < numBands; m++) {
+        Pmm = (1.0f - 2*m) * Pmm;      // See [1], divide by sqrt(1 - s.z*s.z);
+        for (size_t j = 0; j < N; j++) {
+            Pml_2[j] = Pmm;
+            Pml_1[j] = (2*m + 1.0f)*Pmm*z[j];
+            // l == m
+            coef(SHindex(-m, m))[j] = Pmm;
+            coef(SHindex( m, m))[j] = Pmm;
+        }
+        if (m + 1 < numBands) {
+            // l == m+1
+            for (size_t j = 0; j < N; j++) {
+                coef(SHindex(-m, m+1))[j] = Pml_1[j];
+                coef(SHindex( m, m+1))[j] = Pml_1[j];
+            }
+            for (size_t l = m + 2; l < numBands; l++) {
+                float* UTILS_RESTRICT neg = coef(SHindex(-m, l));
+                float* UTILS_RESTRICT pos = coef(SHindex( m, l));
+                for (size_t j = 0; j < N; j++) {
+                    float Pml = ((2*l - 1.0f)*Pml_1[j]*z[j] - (l + m - 1.0f)*Pml_2[j]) / (l-m);
+                    Pml_2[j] = Pml_1[j];
+                    Pml_1[j] = Pml;
+                    neg[j] = Pml;
+                    pos[j] = Pml;
+                }
+            }
+        }
+    }
+
+    // ( cos(m*phi), sin(m*phi) ) recursion, see above
+    float Cm[N];
+    float Sm[N];
+    for (size_t j = 0; j < N; j++) {
+        Cm[j] = x[j];
+        Sm[j] = y[j];
+    }
+    for (size_t m = 1; m < numBands; m++) {
+        for (size_t l = m; l < numBands; l++) {
+            float* UTILS_RESTRICT neg = coef(SHindex(-m, l));
+            float* UTILS_RESTRICT pos = coef(SHindex( m, l));
+            for (size_t j = 0; j < N; j++) {
+                neg[j] *= Sm[j];
+                pos[j] *= Cm[j];
+            }
+        }
+        for (size_t j = 0; j < N; j++) {
+            float Cm1 = Cm[j] * x[j] - Sm[j] * y[j];
+            float Sm1 = Sm[j] * x[j] + Cm[j] * y[j];
+            Cm[j] = Cm1;
+            Sm[j] = Sm1;
+        }
+    }
+}
+
 
 /*
  * utilities to rotate very low order spherical harmonics (up to 3rd band)
@@ -507,50 +594,166 @@ void CubemapSH::windowSH(std::unique_ptr<float3[]>& sh, size_t numBands, float c
     }
 }
 
+/*
+ * Area of the sphere quadrant (-1,1)-(x,y), see CubemapUtils::solidAngle()
+ */
+static inline float sphereQuadrantArea(float x, float y) {
+    return std::atan2(x*y, std::sqrt(x*x + y*y + 1));
+}
+
 std::unique_ptr<float3[]> CubemapSH::computeSH(JobSystem& js, const Cubemap& cm, size_t numBands, bool irradiance) {
+    constexpr size_t N = SH_BASIS_LANES;
+    constexpr size_t ROWS_PER_BLOCK = 16;
 
     const size_t numCoefs = numBands * numBands;
-    std::unique_ptr<float3[]> SH(new float3[numCoefs]{});
+    const size_t dim = cm.getDimensions();
+    const size_t blocksPerFace = (dim + ROWS_PER_BLOCK - 1) / ROWS_PER_BLOCK;
+    const size_t blockCount = 6 * blocksPerFace;
+
+    // Each block of rows accumulates into its own partial sums, which are reduced below in
+    // block order. This way the result doesn't depend on how the jobs were scheduled.
+    std::unique_ptr<float3[]> partials(new float3[blockCount * numCoefs]{});
+
+    auto processBlock = [&](size_t block) {
+        const Cubemap::Face f = Cubemap::Face(block / blocksPerFace);
+        const size_t y0 = (block % blocksPerFace) * ROWS_PER_BLOCK;
+        const size_t y1 = std::min(y0 + ROWS_PER_BLOCK, dim);
+        Image const& image = cm.getImageForFace(f);
+
+        // SHb[i * N + j] is the i-th basis of the j-th texel of a group, and
+        // sums[(i * 3 + c) * N + j] the running sum of channel c of the i-th coefficient.
+        std::vector<float> SHb(numCoefs * N);
+        std::vector<float> sums(numCoefs * 3 * N);
+
+        // The solid angle of a texel is computed from the area of the sphere quadrants at its
+        // corners, the same way CubemapUtils::solidAngle() does; here the corner areas of a
+        // row are shared with its neighbors.
+        const float iDim = 1.0f / dim;
+        std::vector<float> top(dim + 1);
+        std::vector<float> bottom(dim + 1);
+        auto cornerAreas = [dim, iDim](std::vector<float>& areas, size_t y) {
+            const float t = y * 2 * iDim - 1;
+            for (size_t x = 0; x <= dim; x++) {
+                areas[x] = sphereQuadrantArea(x * 2 * iDim - 1, t);
+            }
+        };
+
+        float sx[N], sy[N], sz[N];
+        float r[N], g[N], b[N];
+
+        cornerAreas(top, y0);
+        for (size_t y = y0; y < y1; y++) {
+            cornerAreas(bottom, y + 1);
+            Cubemap::Texel const* data =
+                    static_cast<Cubemap::Texel const*>(image.getPixelRef(0, y));
+            for (size_t x = 0; x < dim; x += N) {
+                // the last group of a row is padded with texels that have a null weight
+                const size_t n = std::min(N, dim - x);
+                for (size_t j = 0; j < N; j++) {
+                    const size_t u = x + std::min(j, n - 1);
+                    const float3 s(cm.getDirectionFor(f, u, y));
+                    const float solidAngle = j < n ?
+                            top[u] - bottom[u] - top[u + 1] + bottom[u + 1] : 0.0f;
+                    const float3 color(Cubemap::sampleAt(data + u) * solidAngle);
+                    sx[j] = s.x;
+                    sy[j] = s.y;
+                    sz[j] = s.z;
+                    r[j] = color.r;
+                    g[j] = color.g;
+                    b[j] = color.b;
+                }
 
-    struct State {
-        State() = default;
-        explicit State(size_t numCoefs) : numCoefs(numCoefs) { }
+                computeShBasis(SHb.data(), numBands, sx, sy, sz);
+
+                // apply coefficients to the sampled colors
+                for (size_t i = 0; i < numCoefs; i++) {
+                    float const* UTILS_RESTRICT basis = SHb.data() + i * N;
+                    float* UTILS_RESTRICT sr = sums.data() + (i * 3 + 0) * N;
+                    float* UTILS_RESTRICT sg = sums.data() + (i * 3 + 1) * N;
+                    float* UTILS_RESTRICT sb = sums.data() + (i * 3 + 2) * N;
+                    for (size_t j = 0; j < N; j++) {
+                        sr[j] += r[j] * basis[j];
+                        sg[j] += g[j] * basis[j];
+                        sb[j] += b[j] * basis[j];
+                    }
+                }
+            }
+            std::swap(top, bottom);
+        }
+
+        float3* UTILS_RESTRICT out = partials.get() + block * numCoefs;
+        for (size_t i = 0; i < numCoefs; i++) {
+            for (size_t j = 0; j < N; j++) {
+                out[i] += float3{
+                        sums[(i * 3 + 0) * N + j],
+                        sums[(i * 3 + 1) * N + j],
+                        sums[(i * 3 + 2) * N + j] };
+            }
+        }
+    };
 
-        State& operator=(State const & rhs) {
-            SH.reset(new float3[rhs.numCoefs]{}); // NOLINT(modernize-make-unique)
-            SHb.reset(new float[rhs.numCoefs]{}); // NOLINT(modernize-make-unique)
-            return *this;
+    auto parallelJobTask = [&processBlock](size_t start, size_t count) {
+        for (size_t block = start; block < start + count; block++) {
+            processBlock(block);
         }
-        size_t numCoefs = 0;
-        std::unique_ptr<float3[]> SH;
-        std::unique_ptr<float[]> SHb;
-    } prototype(numCoefs);
+    };
+
+    auto job = jobs::parallel_for(js, nullptr, 0, uint32_t(blockCount),
+            std::ref(parallelJobTask), jobs::CountSplitter<1, 8>());
+    js.runAndWait(job);
+
+    std::unique_ptr<float3[]> SH(new float3[numCoefs]{});
+    for (size_t block = 0; block < blockCount; block++) {
+        float3 const* partial = partials.get() + block * numCoefs;
+        for (size_t i = 0; i < numCoefs; i++) {
+            SH[i] += partial[i];
+        }
+    }
+
+    scaleSH(SH.get(), numBands, irradiance);
+    return SH;
+}
+
+std::unique_ptr<float3[]> CubemapSH::computeSHReference(
+        const Cubemap& cm, size_t numBands, bool irradiance) {
+
+    const size_t numCoefs = numBands * numBands;
+    const size_t dim = cm.getDimensions();
+    std::unique_ptr<float3[]> SH(new float3[numCoefs]{});
+    std::vector<float> SHb(numCoefs);
 
-    CubemapUtils::process<State>(const_cast<Cubemap&>(cm), js,
-            [&](State& state, size_t y, Cubemap::Face f, Cubemap::Texel const* data, size_t dim) {
-        for (size_t x=0 ; x<dim ; ++x, ++data) {
+    for (size_t faceIndex = 0; faceIndex < 6; faceIndex++) {
+        const Cubemap::Face f = (Cubemap::Face)faceIndex;
+        Image const& image = cm.getImageForFace(f);
+        for (size_t y = 0; y < dim; y++) {
+            Cubemap::Texel const* data =
+                    static_cast<Cubemap::Texel const*>(image.getPixelRef(0, y));
+            for (size_t x = 0; x < dim; ++x, ++data) {
 
-            float3 s(cm.getDirectionFor(f, x, y));
+                float3 s(cm.getDirectionFor(f, x, y));
 
-            // sample a color
-            float3 color(Cubemap::sampleAt(data));
+                // sample a color
+                float3 color(Cubemap::sampleAt(data));
 
-            // take solid angle into account
-            color *= CubemapUtils::solidAngle(dim, x, y);
+                // take solid angle into account
+                color *= CubemapUtils::solidAngle(dim, x, y);
 
-            computeShBasis(state.SHb.get(), numBands, s);
+                computeShBasis(SHb.data(), numBands, s);
 
-            // apply coefficients to the sampled color
-            for (size_t i=0 ; i<numCoefs ; i++) {
-                state.SH[i] += color * state.SHb[i];
+                // apply coefficients to the sampled color
+                for (size_t i = 0; i < numCoefs; i++) {
+                    SH[i] += color * SHb[i];
+                }
             }
         }
-    },
-    [&](State& state) {
-        for (size_t i=0 ; i<numCoefs ; i++) {
-            SH[i] += state.SH[i];
-        }
-    }, prototype);
+    }
+
+    scaleSH(SH.get(), numBands, irradiance);
+    return SH;
+}
+
+void CubemapSH::scaleSH(float3* sh, size_t numBands, bool irradiance) {
+    const size_t numCoefs = numBands * numBands;
 
     // precompute the scaling factor K
     std::vector<float> K = Ki(numBands);
@@ -569,43 +772,42 @@ std::unique_ptr<float3[]> CubemapSH::computeSH(JobSystem& js, const Cubemap& cm,
 
     // apply all the scale factors
     for (size_t i = 0; i < numCoefs; i++) {
-        SH[i] *= K[i];
+        sh[i] *= K[i];
     }
-    return SH;
 }
 
 void CubemapSH::renderSH(JobSystem& js, Cubemap& cm,
         const std::unique_ptr<float3[]>& sh, size_t numBands) {
+    constexpr size_t N = SH_BASIS_LANES;
     const size_t numCoefs = numBands * numBands;
 
     // precompute the scaling factor K
     const std::vector<float> K = Ki(numBands);
 
-    struct State {
-        // we compute the min just for debugging -- it's not actually needed.
-        float3 min = std::numeric_limits<float>::max();
-    } prototype;
-
-    CubemapUtils::process<State>(cm, js,
-            [&](State& state, size_t y,
+    CubemapUtils::process<CubemapUtils::EmptyState>(cm, js,
+            [&](CubemapUtils::EmptyState&, size_t y,
                     Cubemap::Face f, Cubemap::Texel* data, size_t dim) {
-                std::vector<float> SHb(numCoefs);
-                for (size_t x = 0; x < dim; ++x, ++data) {
-                    float3 s(cm.getDirectionFor(f, x, y));
-                    computeShBasis(SHb.data(), numBands, s);
-                    float3 c = 0;
-                    for (size_t i = 0; i < numCoefs; i++) {
-                        c += sh[i] * (K[i] * SHb[i]);
+                std::vector<float> SHb(numCoefs * N);
+                float sx[N], sy[N], sz[N];
+                for (size_t x = 0; x < dim; x += N) {
+                    const size_t n = std::min(N, dim - x);
+                    for (size_t j = 0; j < N; j++) {
+                        const float3 s(cm.getDirectionFor(f, x + std::min(j, n - 1), y));
+                        sx[j] = s.x;
+                        sy[j] = s.y;
+                        sz[j] = s.z;
+                    }
+                    computeShBasis(SHb.data(), numBands, sx, sy, sz);
+                    for (size_t j = 0; j < n; j++) {
+                        float3 c = 0;
+                        for (size_t i = 0; i < numCoefs; i++) {
+                            c += sh[i] * (K[i] * SHb[i * N + j]);
+                        }
+                        c *= F_1_PI;
+                        Cubemap::writeAt(data + x + j, Cubemap::Texel(c));
                     }
-                    c *= F_1_PI;
-                    state.min = min(c, state.min);
-                    Cubemap::writeAt(data, Cubemap::Texel(c));
                 }
-            },
-            [&](State& state) {
-                prototype.min = min(prototype.min, state.min);
-            }, prototype);
-    //slog.d << prototype.min << io::endl;
+            });
 }
 
 /*
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <ibl/Cubemap.h>
+#include <ibl/CubemapSH.h>
+#include <ibl/CubemapUtils.h>
+#include <ibl/Image.h>
+
+#include <utils/JobSystem.h>
+
+#include <math/vec3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+using namespace filament::ibl;
+using namespace filament::math;
+using namespace utils;
+
+namespace {
+
+// fills the cubemap with a mix of low and high frequencies, so that all bands are exercised
+void fill(Cubemap& cm) {
+    const size_t dim = cm.getDimensions();
+    for (size_t f = 0; f < 6; f++) {
+        Image& image = cm.getImageForFace(Cubemap::Face(f));
+        for (size_t y = 0; y < dim; y++) {
+            for (size_t x = 0; x < dim; x++) {
+                const float3 s = cm.getDirectionFor(Cubemap::Face(f), x, y);
+                const float noise = float((x * 7 + y * 13 + f * 29) % 17) / 17.0f;
+                Cubemap::writeAt(image.getPixelRef(x, y), Cubemap::Texel{
+                        0.5f + 0.5f * s.x,
+                        s.y * s.y + 0.25f * noise,
+                        std::max(0.0f, s.z) * 4.0f });
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(CubemapSH, MatchesReference) {
+    JobSystem js;
+    js.adopt();
+
+    // these sizes exercise partial blocks of rows and partial groups of texels
+    for (size_t dim : { 1, 7, 32, 65 }) {
+        Image image;
+        Cubemap cm = CubemapUtils::create(image, dim);
+        fill(cm);
+        for (size_t numBands : { 1, 3, 5 }) {
+            for (bool irradiance : { false, true }) {
+                auto sh = CubemapSH::computeSH(js, cm, numBands, irradiance);
+                auto ref = CubemapSH::computeSHReference(cm, numBands, irradiance);
+                for (size_t i = 0; i < numBands * numBands; i++) {
+                    for (size_t c = 0; c < 3; c++) {
+                        const float tolerance = 1e-4f * std::max(1.0f, std::abs(ref[i][c]));
+                        EXPECT_NEAR(sh[i][c], ref[i][c], tolerance)
+                                << "dim=" << dim << " bands=" << numBands << " i=" << i;
+                    }
+                }
+            }
+        }
+    }
+
+    js.emancipate();
+}
+
+TEST(CubemapSH, Deterministic) {
+    // the result must not depend on the number of threads
+    JobSystem js1(1);
+    JobSystem jsN;
+    js1.adopt();
+
+    Image image;
+    Cubemap cm = CubemapUtils::create(image, 64);
+    fill(cm);
+
+    auto sh1 = CubemapSH::computeSH(js1, cm, 3, false);
+    js1.emancipate();
+
+    jsN.adopt();
+    auto shN = CubemapSH::computeSH(jsN, cm, 3, false);
+    auto shN2 = CubemapSH::computeSH(jsN, cm, 3, false);
+    jsN.emancipate();
+
+    for (size_t i = 0; i < 9; i++) {
+        for (size_t c = 0; c < 3; c++) {
+            EXPECT_EQ(sh1[i][c], shN[i][c]);
+            EXPECT_EQ(shN[i][c], shN2[i][c]);
+        }
+    }
+}
+
+TEST(CubemapSH, RenderSH) {
+    JobSystem js;
+    js.adopt();
+
+    Image image;
+    Cubemap cm = CubemapUtils::create(image, 16);
+    fill(cm);
+    auto sh = CubemapSH::computeSH(js, cm, 3, true);
+
+    // renderSH() must agree with the polynomial form used by the shaders
+    Image renderedImage;
+    Cubemap rendered = CubemapUtils::create(renderedImage, 13);
+    CubemapSH::renderSH(js, rendered, sh, 3);
+
+    Image expectedImage;
+    Cubemap expected = CubemapUtils::create(expectedImage, 13);
+    CubemapSH::preprocessSHForShader(sh);
+    CubemapSH::renderPreScaledSH3Bands(js, expected, sh);
+
+    for (size_t f = 0; f < 6; f++) {
+        Image const& a = rendered.getImageForFace(Cubemap::Face(f));
+        Image const& b = expected.getImageForFace(Cubemap::Face(f));
+        for (size_t y = 0; y < 13; y++) {
+            for (size_t x = 0; x < 13; x++) {
+                const float3 ca = Cubemap::sampleAt(a.getPixelRef(x, y));
+                const float3 cb = Cubemap::sampleAt(b.getPixelRef(x, y));
+                for (size_t c = 0; c < 3; c++) {
+                    EXPECT_NEAR(ca[c], cb[c], 1e-4f * std::max(1.0f, std::abs(cb[c])));
+                }
+            }
+        }
+    }
+
+    js.emancipate();
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
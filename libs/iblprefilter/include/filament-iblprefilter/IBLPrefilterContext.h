@@ -20,10 +20,14 @@
 #include <utils/compiler.h>
 #include <utils/Entity.h>
 
+#include <filament/MaterialInstance.h>
 #include <filament/Texture.h>
 
+#include <vector>
+
 namespace filament {
 class Engine;
+class RenderTarget;
 class View;
 class Scene;
 class Renderer;
@@ -154,6 +158,17 @@ public:
             bool generateMipmap = true;  //!< set to false if the environment map already has mipmaps
         };
 
+        /**
+         * Statistics about the last invocation of the filter.
+         *
+         * cpuTimeMs only measures the time the calling thread spent issuing the passes. The GPU
+         * executes them asynchronously, so their GPU cost isn't included and can be much higher.
+         */
+        struct Stats {
+            uint32_t passCount = 0;     //!< passes rendered, each pass renders 3 faces of a level
+            float cpuTimeMs = 0.0f;     //!< CPU time spent issuing these passes (not GPU time)
+        };
+
         /**
          * Creates a SpecularFilter processor.
          * @param context IBLPrefilterContext to use
@@ -212,17 +227,69 @@ public:
                 filament::Texture const* environmentCubemap,
                 filament::Texture* outReflectionsTexture = nullptr);
 
-        // TODO: option for progressive filtering
+        /**
+         * Generates a prefiltered cubemap progressively, so that the cost of refreshing a dynamic
+         * environment can be spread over several frames.
+         *
+         * Each level of the output is rendered in two passes (positive and negative faces).
+         * Every call renders at most maxPassCount passes, starting where the previous call
+         * stopped; outReflectionsTexture is complete when update() returns true, and the next
+         * call starts over from the first level. Options.generateMipmap is only honored by
+         * the first pass.
+         *
+         * @param options                   Options for this environment
+         * @param environmentCubemap        Environment cubemap (input), see operator()
+         * @param outReflectionsTexture     Output prefiltered texture. Can't be null.
+         *                                  Same requirements as for operator().
+         * @param maxPassCount              Maximum number of passes to render, at least 1
+         * @return true if the last pass of outReflectionsTexture was rendered by this call
+         */
+        bool update(Options options,
+                filament::Texture const* environmentCubemap,
+                filament::Texture* outReflectionsTexture,
+                uint8_t maxPassCount = 1);
+
+        /**
+         * Returns statistics about the last call to operator() or update().
+         */
+        Stats const& getStats() const noexcept { return mStats; }
+
+        /**
+         * The render targets of the output texture are kept from one invocation to the next,
+         * until a different output texture is used or the filter is destroyed. This releases
+         * them now, and abandons a progressive update().
+         *
+         * This must be called before destroying an output texture given to operator() or
+         * update() if this filter is going to be used again. It isn't needed when the output
+         * texture is always created by operator().
+         */
+        void releaseRenderTargets() noexcept;
 
         // TODO: add a callback for when the processing is done?
 
     private:
         filament::Texture* createReflectionsTexture();
+        void checkTextures(filament::Texture const* environmentCubemap,
+                filament::Texture const* outReflectionsTexture) const;
+        void render(Options const& options,
+                filament::Texture const* environmentCubemap,
+                filament::Texture* outReflectionsTexture,
+                uint8_t firstPass, uint8_t passCount);
         IBLPrefilterContext& mContext;
         filament::Material* mKernelMaterial = nullptr;
         filament::Texture* mKernelTexture = nullptr;
         uint32_t mSampleCount = 0u;
         uint8_t mLevelCount = 1u;
+        uint8_t mNextPass = 0u;
+        Stats mStats;
+        // render targets of mRenderTargetTexture, indexed by pass (2 * level + side), created
+        // the first time the pass is rendered
+        std::vector<filament::RenderTarget*> mRenderTargets;
+        filament::Texture const* mRenderTargetTexture = nullptr;
+        filament::MaterialInstance::ParameterHandle mSampleCountParam;
+        filament::MaterialInstance::ParameterHandle mAttachmentLevelParam;
+        filament::MaterialInstance::ParameterHandle mLodOffsetParam;
+        filament::MaterialInstance::ParameterHandle mSideParam;
     };
 
 private:
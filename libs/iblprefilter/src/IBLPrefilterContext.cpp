@@ -36,6 +36,9 @@
 #include <math/mat3.h>
 #include <math/vec3.h>
 
+#include <algorithm>
+#include <chrono>
+
 #include "generated/resources/iblprefilter_materials.h"
 
 using namespace filament::math;
@@ -314,6 +317,14 @@ IBLPrefilterContext::SpecularFilter::SpecularFilter(IBLPrefilterContext& context
     renderer->renderStandaloneView(view);
 
     engine.destroy(rt);
+
+    // these are set for every pass
+    MaterialInstance const* const integration =
+            mContext.mIntegrationMaterial->getDefaultInstance();
+    mSampleCountParam = integration->getParameterHandle("sampleCount");
+    mAttachmentLevelParam = integration->getParameterHandle("attachmentLevel");
+    mLodOffsetParam = integration->getParameterHandle("lodOffset");
+    mSideParam = integration->getParameterHandle("side");
 }
 
 UTILS_NOINLINE
@@ -323,6 +334,7 @@ IBLPrefilterContext::SpecularFilter::SpecularFilter(IBLPrefilterContext& context
 
 IBLPrefilterContext::SpecularFilter::~SpecularFilter() noexcept {
     Engine& engine = mContext.mEngine;
+    releaseRenderTargets();
     engine.destroy(mKernelTexture);
     engine.destroy(mKernelMaterial);
 }
@@ -338,8 +350,16 @@ IBLPrefilterContext::SpecularFilter::operator=(SpecularFilter&& rhs) noexcept {
     if (this != & rhs) {
         swap(mKernelMaterial, rhs.mKernelMaterial);
         swap(mKernelTexture, rhs.mKernelTexture);
+        swap(mRenderTargets, rhs.mRenderTargets);
+        swap(mRenderTargetTexture, rhs.mRenderTargetTexture);
         mSampleCount = rhs.mSampleCount;
         mLevelCount = rhs.mLevelCount;
+        mNextPass = rhs.mNextPass;
+        mStats = rhs.mStats;
+        mSampleCountParam = rhs.mSampleCountParam;
+        mAttachmentLevelParam = rhs.mAttachmentLevelParam;
+        mLodOffsetParam = rhs.mLodOffsetParam;
+        mSideParam = rhs.mSideParam;
     }
     return *this;
 }
@@ -373,10 +393,73 @@ Texture* IBLPrefilterContext::SpecularFilter::operator()(
         Texture const* environmentCubemap, Texture* outReflectionsTexture) {
 
     SYSTRACE_CALL();
-    using namespace backend;
 
     ASSERT_PRECONDITION(environmentCubemap != nullptr, "environmentCubemap is null!");
 
+    if (outReflectionsTexture == nullptr) {
+        outReflectionsTexture = createReflectionsTexture();
+        // A texture we just created can't have render targets yet, but it could have the
+        // address of a destroyed texture that still has some.
+        releaseRenderTargets();
+    }
+
+    checkTextures(environmentCubemap, outReflectionsTexture);
+
+    const uint8_t passCount = uint8_t(2u * outReflectionsTexture->getLevels());
+    render(options, environmentCubemap, outReflectionsTexture, 0, passCount);
+
+    // a complete render restarts any progressive update
+    mNextPass = 0;
+
+    return outReflectionsTexture;
+}
+
+bool IBLPrefilterContext::SpecularFilter::update(
+        IBLPrefilterContext::SpecularFilter::Options options,
+        Texture const* environmentCubemap, Texture* outReflectionsTexture,
+        uint8_t maxPassCount) {
+
+    SYSTRACE_CALL();
+
+    ASSERT_PRECONDITION(environmentCubemap != nullptr, "environmentCubemap is null!");
+    ASSERT_PRECONDITION(outReflectionsTexture != nullptr, "outReflectionsTexture is null!");
+    ASSERT_PRECONDITION(maxPassCount > 0, "maxPassCount must be at least 1.");
+
+    checkTextures(environmentCubemap, outReflectionsTexture);
+
+    if (outReflectionsTexture != mRenderTargetTexture) {
+        // a new output starts over
+        releaseRenderTargets();
+    }
+
+    const uint8_t totalPassCount = uint8_t(2u * outReflectionsTexture->getLevels());
+    const uint8_t firstPass = mNextPass;
+    const uint8_t passCount = std::min(maxPassCount, uint8_t(totalPassCount - firstPass));
+
+    options.generateMipmap = options.generateMipmap && firstPass == 0;
+    render(options, environmentCubemap, outReflectionsTexture, firstPass, passCount);
+
+    mNextPass = uint8_t(firstPass + passCount);
+    if (mNextPass == totalPassCount) {
+        mNextPass = 0;
+        return true;
+    }
+    return false;
+}
+
+void IBLPrefilterContext::SpecularFilter::releaseRenderTargets() noexcept {
+    Engine& engine = mContext.mEngine;
+    for (RenderTarget* rt : mRenderTargets) {
+        engine.destroy(rt); // it's okay for rt to be null
+    }
+    mRenderTargets.clear();
+    mRenderTargetTexture = nullptr;
+    mNextPass = 0;
+}
+
+void IBLPrefilterContext::SpecularFilter::checkTextures(Texture const* environmentCubemap,
+        Texture const* outReflectionsTexture) const {
+
     ASSERT_PRECONDITION(environmentCubemap->getTarget() == Texture::Sampler::SAMPLER_CUBEMAP,
             "environmentCubemap must be a cubemap.");
 
@@ -386,16 +469,22 @@ Texture* IBLPrefilterContext::SpecularFilter::operator()(
     ASSERT_PRECONDITION(environmentCubemap->getLevels() == maxLevelCount,
             "environmentCubemap must have %u mipmap levels allocated.", +maxLevelCount);
 
-    if (outReflectionsTexture == nullptr) {
-        outReflectionsTexture = createReflectionsTexture();
-    }
-
     ASSERT_PRECONDITION(outReflectionsTexture->getTarget() == Texture::Sampler::SAMPLER_CUBEMAP,
             "outReflectionsTexture must be a cubemap.");
 
     ASSERT_PRECONDITION(mLevelCount <= outReflectionsTexture->getLevels(),
             "outReflectionsTexture has %u levels but %u are requested.",
             +outReflectionsTexture->getLevels(), +mLevelCount);
+}
+
+void IBLPrefilterContext::SpecularFilter::render(Options const& options,
+        Texture const* environmentCubemap, Texture* outReflectionsTexture,
+        uint8_t firstPass, uint8_t passCount) {
+
+    SYSTRACE_CALL();
+    using namespace backend;
+
+    const auto startTime = std::chrono::steady_clock::now();
 
     const TextureCubemapFace faces[2][3] = {
             { TextureCubemapFace::POSITIVE_X, TextureCubemapFace::POSITIVE_Y, TextureCubemapFace::POSITIVE_Z },
@@ -415,7 +504,7 @@ Texture* IBLPrefilterContext::SpecularFilter::operator()(
     const float linear = options.hdrLinear;
     const float compress = options.hdrMax;
     const uint8_t levels = outReflectionsTexture->getLevels();
-    uint32_t dim = outReflectionsTexture->getWidth();
+    const uint32_t dim = outReflectionsTexture->getWidth();
     const float omegaP = (4.0f * f::PI) / float(6 * dim * dim);
 
     TextureSampler environmentSampler;
@@ -425,52 +514,59 @@ Texture* IBLPrefilterContext::SpecularFilter::operator()(
     mi->setParameter("environment", environmentCubemap, environmentSampler);
     mi->setParameter("kernel", mKernelTexture, TextureSampler{ SamplerMagFilter::NEAREST });
     mi->setParameter("compress", float2{ linear, compress });
-    mi->setParameter("lodOffset", options.lodOffset - log4(omegaP));
 
     if (options.generateMipmap) {
         // We need mipmaps for prefiltering
         environmentCubemap->generateMipmaps(engine);
     }
 
-    RenderTarget::Builder builder;
-    builder.texture(RenderTarget::AttachmentPoint::COLOR0, outReflectionsTexture)
-           .texture(RenderTarget::AttachmentPoint::COLOR1, outReflectionsTexture)
-           .texture(RenderTarget::AttachmentPoint::COLOR2, outReflectionsTexture);
+    // The render targets only depend on the output texture and level, so they're created the
+    // first time a pass is rendered and kept until a different output texture is used.
+    if (outReflectionsTexture != mRenderTargetTexture) {
+        releaseRenderTargets();
+        mRenderTargets.resize(2u * levels, nullptr);
+        mRenderTargetTexture = outReflectionsTexture;
+    }
 
-    for (size_t lod = 0; lod < levels; lod++) {
+    for (size_t pass = firstPass; pass < size_t(firstPass + passCount); pass++) {
         SYSTRACE_NAME("executeFilterLOD");
 
-        mi->setParameter("sampleCount", uint32_t(lod == 0 ? 1u : sampleCount));
-        mi->setParameter("attachmentLevel", uint32_t(lod));
-
-        if (lod == levels - 1) {
-            // this is the last lod, use a more aggressive filtering because this level is also
-            // used for the diffuse brdf by filament, and we need it to be very smooth.
-            // So we set the lod offset to at least 2.
-            mi->setParameter("lodOffset", std::max(2.0f, options.lodOffset) - log4(omegaP));
+        const size_t lod = pass / 2;
+        const size_t i = pass % 2;
+
+        // the last lod uses a more aggressive filtering because this level is also
+        // used for the diffuse brdf by filament, and we need it to be very smooth.
+        // So we set the lod offset to at least 2.
+        const float lodOffset = lod == levels - 1u ?
+                std::max(2.0f, options.lodOffset) : options.lodOffset;
+
+        mi->setParameter(mSampleCountParam, uint32_t(lod == 0 ? 1u : sampleCount));
+        mi->setParameter(mAttachmentLevelParam, uint32_t(lod));
+        mi->setParameter(mLodOffsetParam, lodOffset - log4(omegaP));
+        mi->setParameter(mSideParam, i == 0 ? 1.0f : -1.0f);
+
+        RenderTarget*& rt = mRenderTargets[pass];
+        if (UTILS_UNLIKELY(!rt)) {
+            rt = RenderTarget::Builder()
+                    .texture(RenderTarget::AttachmentPoint::COLOR0, outReflectionsTexture)
+                    .texture(RenderTarget::AttachmentPoint::COLOR1, outReflectionsTexture)
+                    .texture(RenderTarget::AttachmentPoint::COLOR2, outReflectionsTexture)
+                    .mipLevel(RenderTarget::AttachmentPoint::COLOR0, lod)
+                    .mipLevel(RenderTarget::AttachmentPoint::COLOR1, lod)
+                    .mipLevel(RenderTarget::AttachmentPoint::COLOR2, lod)
+                    .face(RenderTarget::AttachmentPoint::COLOR0, faces[i][0])
+                    .face(RenderTarget::AttachmentPoint::COLOR1, faces[i][1])
+                    .face(RenderTarget::AttachmentPoint::COLOR2, faces[i][2])
+                    .build(engine);
         }
 
-        builder.mipLevel(RenderTarget::AttachmentPoint::COLOR0, lod)
-               .mipLevel(RenderTarget::AttachmentPoint::COLOR1, lod)
-               .mipLevel(RenderTarget::AttachmentPoint::COLOR2, lod);
-
-        view->setViewport({ 0, 0, dim, dim });
-
-        for (size_t i = 0; i < 2; i++) {
-            mi->setParameter("side", i == 0 ? 1.0f : -1.0f);
-
-            builder.face(RenderTarget::AttachmentPoint::COLOR0, faces[i][0])
-                   .face(RenderTarget::AttachmentPoint::COLOR1, faces[i][1])
-                   .face(RenderTarget::AttachmentPoint::COLOR2, faces[i][2]);
-
-            RenderTarget* const rt = builder.build(engine);
-            view->setRenderTarget(rt);
-            renderer->renderStandaloneView(view);
-            engine.destroy(rt);
-        }
-
-        dim >>= 1;
+        const uint32_t levelDim = std::max(1u, dim >> lod);
+        view->setViewport({ 0, 0, levelDim, levelDim });
+        view->setRenderTarget(rt);
+        renderer->renderStandaloneView(view);
     }
 
-    return outReflectionsTexture;
+    mStats.passCount = passCount;
+    mStats.cpuTimeMs = std::chrono::duration<float, std::milli>(
+            std::chrono::steady_clock::now() - startTime).count();
 }
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <filament-iblprefilter/IBLPrefilterContext.h>
+
+#include <filament/Engine.h>
+#include <filament/RenderTarget.h>
+#include <filament/Renderer.h>
+#include <filament/Texture.h>
+
+#include <backend/PixelBufferDescriptor.h>
+
+#include <vector>
+
+using namespace filament;
+using namespace backend;
+
+class SpecularFilterTest : public testing::Test {
+protected:
+    static constexpr uint32_t ENVIRONMENT_SIZE = 16;
+    static constexpr uint8_t ENVIRONMENT_LEVELS = 5; // all the levels are required
+    static constexpr uint32_t REFLECTIONS_SIZE = 16;
+    static constexpr uint8_t REFLECTIONS_LEVELS = 3;
+
+    Engine* mEngine = nullptr;
+    Renderer* mRenderer = nullptr;
+    IBLPrefilterContext* mContext = nullptr;
+    Texture* mEnvironment = nullptr;
+
+    void SetUp() override {
+        mEngine = Engine::create();
+        mRenderer = mEngine->createRenderer();
+        mContext = new IBLPrefilterContext(*mEngine);
+        mEnvironment = createEnvironment();
+    }
+
+    void TearDown() override {
+        mEngine->destroy(mEnvironment);
+        delete mContext;
+        mEngine->destroy(mRenderer);
+        Engine::destroy(&mEngine);
+    }
+
+    IBLPrefilterContext::SpecularFilter createFilter() {
+        return { *mContext, { .sampleCount = 16, .levelCount = REFLECTIONS_LEVELS }};
+    }
+
+    // each face gets a different gradient, so that the filter has something to blur
+    Texture* createEnvironment() {
+        Texture* const texture = Texture::Builder()
+                .sampler(Texture::Sampler::SAMPLER_CUBEMAP)
+                .format(Texture::InternalFormat::RGBA8)
+                .usage(Texture::Usage::COLOR_ATTACHMENT | Texture::Usage::SAMPLEABLE |
+                       Texture::Usage::UPLOADABLE)
+                .width(ENVIRONMENT_SIZE).height(ENVIRONMENT_SIZE).levels(ENVIRONMENT_LEVELS)
+                .build(*mEngine);
+
+        size_t const faceSize = ENVIRONMENT_SIZE * ENVIRONMENT_SIZE * 4;
+        auto* const data = new uint8_t[6 * faceSize];
+        for (size_t face = 0; face < 6; face++) {
+            uint8_t* const pixels = data + face * faceSize;
+            for (size_t y = 0; y < ENVIRONMENT_SIZE; y++) {
+                for (size_t x = 0; x < ENVIRONMENT_SIZE; x++) {
+                    uint8_t* const p = pixels + (y * ENVIRONMENT_SIZE + x) * 4;
+                    p[0] = uint8_t(face * 40);
+                    p[1] = uint8_t(x * 255 / (ENVIRONMENT_SIZE - 1));
+                    p[2] = uint8_t(y * 255 / (ENVIRONMENT_SIZE - 1));
+                    p[3] = 0xff;
+                }
+            }
+        }
+        texture->setImage(*mEngine, 0,
+                Texture::PixelBufferDescriptor(data, 6 * faceSize,
+                        Texture::Format::RGBA, Texture::Type::UBYTE,
+                        [](void* buffer, size_t, void*) { delete[] (uint8_t*)buffer; }),
+                Texture::FaceOffsets(faceSize));
+        return texture;
+    }
+
+    Texture* createReflections() {
+        return Texture::Builder()
+                .sampler(Texture::Sampler::SAMPLER_CUBEMAP)
+                .format(Texture::InternalFormat::RGBA16F)
+                .usage(Texture::Usage::COLOR_ATTACHMENT | Texture::Usage::SAMPLEABLE)
+                .width(REFLECTIONS_SIZE).height(REFLECTIONS_SIZE).levels(REFLECTIONS_LEVELS)
+                .build(*mEngine);
+    }
+
+    std::vector<float> readFace(Texture* texture, uint8_t level, TextureCubemapFace face) {
+        RenderTarget* const rt = RenderTarget::Builder()
+                .texture(RenderTarget::AttachmentPoint::COLOR0, texture)
+                .mipLevel(RenderTarget::AttachmentPoint::COLOR0, level)
+                .face(RenderTarget::AttachmentPoint::COLOR0, face)
+                .build(*mEngine);
+
+        uint32_t const dim = REFLECTIONS_SIZE >> level;
+        std::vector<float> pixels(dim * dim * 4);
+        bool done = false;
+        mRenderer->readPixels(rt, 0, 0, dim, dim,
+                PixelBufferDescriptor(pixels.data(), pixels.size() * sizeof(float),
+                        PixelDataFormat::RGBA, PixelDataType::FLOAT,
+                        [](void*, size_t, void* user) { *(bool*)user = true; }, &done));
+
+        // Note: this is where the readPixels() callback will be called.
+        mEngine->flushAndWait();
+        EXPECT_TRUE(done);
+
+        mEngine->destroy(rt);
+        return pixels;
+    }
+
+    void expectSameContent(Texture* a, Texture* b) {
+        for (uint8_t level = 0; level < REFLECTIONS_LEVELS; level++) {
+            for (size_t face = 0; face < 6; face++) {
+                EXPECT_EQ(readFace(a, level, TextureCubemapFace(face)),
+                        readFace(b, level, TextureCubemapFace(face)))
+                        << "level " << +level << ", face " << face;
+            }
+        }
+    }
+};
+
+TEST_F(SpecularFilterTest, ProgressiveUpdateMatchesOneShot) {
+    IBLPrefilterContext::SpecularFilter filter = createFilter();
+    Texture* const oneShot = createReflections();
+    Texture* const progressive = createReflections();
+
+    filter(mEnvironment, oneShot);
+    EXPECT_EQ(filter.getStats().passCount, 2u * REFLECTIONS_LEVELS);
+
+    // one pass per call, the last one completes the texture
+    size_t updateCount = 0;
+    bool complete = false;
+    while (!complete && updateCount < 2u * REFLECTIONS_LEVELS) {
+        complete = filter.update({}, mEnvironment, progressive);
+        EXPECT_EQ(filter.getStats().passCount, 1u);
+        updateCount++;
+    }
+    EXPECT_TRUE(complete);
+    EXPECT_EQ(updateCount, 2u * REFLECTIONS_LEVELS);
+
+    expectSameContent(oneShot, progressive);
+
+    filter.releaseRenderTargets();
+    mEngine->destroy(oneShot);
+    mEngine->destroy(progressive);
+}
+
+TEST_F(SpecularFilterTest, UpdateStartsOverOnceComplete) {
+    IBLPrefilterContext::SpecularFilter filter = createFilter();
+    Texture* const oneShot = createReflections();
+    Texture* const progressive = createReflections();
+
+    filter(mEnvironment, oneShot);
+
+    // three passes per call
+    EXPECT_FALSE(filter.update({}, mEnvironment, progressive, 3));
+    EXPECT_TRUE(filter.update({}, mEnvironment, progressive, 3));
+    EXPECT_EQ(filter.getStats().passCount, 3u);
+
+    // the next update renders the whole texture again, with the render targets it kept
+    EXPECT_TRUE(filter.update({}, mEnvironment, progressive, 2u * REFLECTIONS_LEVELS));
+    EXPECT_EQ(filter.getStats().passCount, 2u * REFLECTIONS_LEVELS);
+
+    expectSameContent(oneShot, progressive);
+
+    filter.releaseRenderTargets();
+    mEngine->destroy(oneShot);
+    mEngine->destroy(progressive);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -128,6 +128,14 @@ public:
     // This invalidates all pointers components.
     inline Instance removeComponent(Entity e);
 
+    // Makes room for `count` more components, so that adding them doesn't grow the arrays or
+    // the entity map more than once.
+    // This invalidates all pointers components.
+    void reserve(size_t count) {
+        mData.ensureCapacity(mData.size() + count);
+        mInstanceMap.reserve(mInstanceMap.size() + count);
+    }
+
     // trigger one round of garbage collection. this is intended to be called on a regular
     // basis. This gc gives up after it cannot randomly free 'ratio' component in a row.
     void gc(const EntityManager& em, size_t ratio = 4) noexcept {
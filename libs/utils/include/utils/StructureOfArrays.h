@@ -35,13 +35,37 @@
 
 namespace utils {
 
-template <typename Allocator, typename ... Elements>
+/*
+ * Memory layout options of a StructureOfArraysBase.
+ *
+ * FIELD_ALIGNMENT   minimum alignment in bytes of each array, e.g. 32 or 64 so that SIMD loops
+ *                   can use aligned loads and stores.
+ *
+ * CAPACITY_MULTIPLE the capacity is always rounded up to a multiple of this value, which
+ *                   guarantees that arrays can be processed up to getPaddedSize() elements
+ *                   without bounds checks.
+ */
+template<size_t FIELD_ALIGNMENT = alignof(std::max_align_t), size_t CAPACITY_MULTIPLE = 1>
+struct StructureOfArraysLayout {
+    static_assert(FIELD_ALIGNMENT && !(FIELD_ALIGNMENT & (FIELD_ALIGNMENT - 1)),
+            "FIELD_ALIGNMENT must be a power of two");
+    static_assert(CAPACITY_MULTIPLE && !(CAPACITY_MULTIPLE & (CAPACITY_MULTIPLE - 1)),
+            "CAPACITY_MULTIPLE must be a power of two");
+    static constexpr size_t fieldAlignment = FIELD_ALIGNMENT;
+    static constexpr size_t capacityMultiple = CAPACITY_MULTIPLE;
+};
+
+template <typename Layout, typename Allocator, typename ... Elements>
 class StructureOfArraysBase {
     // number of elements
     static constexpr const size_t kArrayCount = sizeof...(Elements);
 
+    // alignment of each array
+    static constexpr const size_t kFieldAlignment = std::max(
+            alignof(std::max_align_t), Layout::fieldAlignment);
+
 public:
-    using SoA = StructureOfArraysBase<Allocator, Elements...>;
+    using SoA = StructureOfArraysBase<Layout, Allocator, Elements...>;
 
     using Structure = std::tuple<Elements...>;
 
@@ -57,6 +81,17 @@ public:
         return getOffset(kArrayCount - 1, size) + sizeof(TypeAt<kArrayCount - 1>) * size;
     }
 
+    // Minimum alignment of each array
+    static constexpr size_t getFieldAlignment() noexcept { return kFieldAlignment; }
+
+    // The capacity is always a multiple of this value
+    static constexpr size_t getCapacityMultiple() noexcept { return Layout::capacityMultiple; }
+
+    // Rounds count up to a multiple of getCapacityMultiple()
+    static constexpr size_t getPaddedSize(size_t count) noexcept {
+        return (count + (Layout::capacityMultiple - 1)) & ~(Layout::capacityMultiple - 1);
+    }
+
     // --------------------------------------------------------------------------------------------
 
     class IteratorValue;
@@ -265,15 +300,22 @@ public:
         return mCapacity;
     }
 
+    // return the size rounded up to getCapacityMultiple(), this is always <= capacity().
+    // Elements past size() are not constructed.
+    size_t paddedSize() const noexcept {
+        return getPaddedSize(mSize);
+    }
+
     // set the capacity of the array. the capacity cannot be smaller than the current size,
-    // the call is a no-op in that case.
+    // the call is a no-op in that case. The capacity is rounded up to getCapacityMultiple().
     UTILS_NOINLINE
     void setCapacity(size_t capacity) {
+        capacity = getPaddedSize(capacity);
         // allocate enough space for "capacity" elements of each array
         // capacity cannot change when optional storage is specified
         if (capacity >= mSize) {
             // TODO: not entirely sure if "max" of all alignments is always correct
-            constexpr size_t align = std::max({ std::max(alignof(std::max_align_t), alignof(Elements))... });
+            constexpr size_t align = std::max({ std::max(kFieldAlignment, alignof(Elements))... });
             const size_t sizeNeeded = getNeededSize(capacity);
             void* buffer = mAllocator.alloc(sizeNeeded, align);
             auto const oldBuffer = std::get<0>(mArrays);
@@ -555,8 +597,9 @@ private:
         // compute the required size of each array
         const size_t sizes[] = { (sizeof(Elements) * capacity)... };
 
-        // we align each array to at least the same alignment guaranteed by malloc
-        constexpr size_t const alignments[] = { std::max(alignof(std::max_align_t), alignof(Elements))... };
+        // we align each array to at least the same alignment guaranteed by malloc, or
+        // the layout's field alignment if larger
+        constexpr size_t const alignments[] = { std::max(kFieldAlignment, alignof(Elements))... };
 
         // hopefully most of this gets unrolled and inlined
         std::array<size_t, kArrayCount> offsets;
@@ -643,38 +686,38 @@ private:
 };
 
 
-template<typename Allocator, typename... Elements>
+template<typename Layout, typename Allocator, typename... Elements>
 inline
-typename StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef&
-StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef::operator=(
+typename StructureOfArraysBase<Layout, Allocator, Elements...>::IteratorValueRef&
+StructureOfArraysBase<Layout, Allocator, Elements...>::IteratorValueRef::operator=(
         StructureOfArraysBase::IteratorValueRef const& rhs) {
     return operator=(IteratorValue(rhs));
 }
 
-template<typename Allocator, typename... Elements>
+template<typename Layout, typename Allocator, typename... Elements>
 inline
-typename StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef&
-StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef::operator=(
+typename StructureOfArraysBase<Layout, Allocator, Elements...>::IteratorValueRef&
+StructureOfArraysBase<Layout, Allocator, Elements...>::IteratorValueRef::operator=(
         StructureOfArraysBase::IteratorValueRef&& rhs) noexcept {
     return operator=(IteratorValue(rhs));
 }
 
-template<typename Allocator, typename... Elements>
+template<typename Layout, typename Allocator, typename... Elements>
 template<size_t... Is>
 inline
-typename StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef&
-StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef::assign(
+typename StructureOfArraysBase<Layout, Allocator, Elements...>::IteratorValueRef&
+StructureOfArraysBase<Layout, Allocator, Elements...>::IteratorValueRef::assign(
         StructureOfArraysBase::IteratorValue const& rhs, std::index_sequence<Is...>) {
     // implements IteratorValueRef& IteratorValueRef::operator=(IteratorValue const& rhs)
     auto UTILS_UNUSED l = { (soa->elementAt<Is>(index) = std::get<Is>(rhs.elements), 0)... };
     return *this;
 }
 
-template<typename Allocator, typename... Elements>
+template<typename Layout, typename Allocator, typename... Elements>
 template<size_t... Is>
 inline
-typename StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef&
-StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef::assign(
+typename StructureOfArraysBase<Layout, Allocator, Elements...>::IteratorValueRef&
+StructureOfArraysBase<Layout, Allocator, Elements...>::IteratorValueRef::assign(
         StructureOfArraysBase::IteratorValue&& rhs, std::index_sequence<Is...>) noexcept {
     // implements IteratorValueRef& IteratorValueRef::operator=(IteratorValue&& rhs) noexcept
     auto UTILS_UNUSED l = {
@@ -683,7 +726,13 @@ StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef::assign(
 }
 
 template <typename ... Elements>
-using StructureOfArrays = StructureOfArraysBase<HeapArena<>, Elements ...>;
+using StructureOfArrays = StructureOfArraysBase<StructureOfArraysLayout<>, HeapArena<>, Elements ...>;
+
+// A StructureOfArrays suitable for SIMD processing, each array is aligned to FIELD_ALIGNMENT
+// and the capacity is a multiple of CAPACITY_MULTIPLE.
+template <size_t FIELD_ALIGNMENT, size_t CAPACITY_MULTIPLE, typename ... Elements>
+using AlignedStructureOfArrays = StructureOfArraysBase<
+        StructureOfArraysLayout<FIELD_ALIGNMENT, CAPACITY_MULTIPLE>, HeapArena<>, Elements ...>;
 
 } // namespace utils
 
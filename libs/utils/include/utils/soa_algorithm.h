@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_UTILS_SOA_ALGORITHM_H
+#define TNT_UTILS_SOA_ALGORITHM_H
+
+#include <utils/compiler.h>
+
+#include <type_traits>
+#include <utility>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Bulk operations on the arrays of a StructureOfArrays.
+ *
+ * The loops below are written so that the compiler can vectorize them; in particular the
+ * __restrict__ qualifiers on the parameters matter (clang only honors them on function
+ * parameters).
+ */
+
+namespace utils::soa {
+
+/*
+ * dst[i] = src[indices[i]], for i in [0, count)
+ */
+template<typename T, typename I>
+UTILS_ALWAYS_INLINE inline
+void gather(T* UTILS_RESTRICT dst, T const* UTILS_RESTRICT src,
+        I const* UTILS_RESTRICT indices, size_t count) noexcept {
+    static_assert(std::is_integral_v<I>);
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = src[indices[i]];
+    }
+}
+
+/*
+ * dst[indices[i]] = src[i], for i in [0, count)
+ * indices must not contain duplicates.
+ */
+template<typename T, typename I>
+UTILS_ALWAYS_INLINE inline
+void scatter(T* UTILS_RESTRICT dst, T const* UTILS_RESTRICT src,
+        I const* UTILS_RESTRICT indices, size_t count) noexcept {
+    static_assert(std::is_integral_v<I>);
+    for (size_t i = 0; i < count; i++) {
+        dst[indices[i]] = src[i];
+    }
+}
+
+/*
+ * Stores in `indices` the index of each element in [first, last) for which
+ * (masks[i] & mask) == value, in increasing order. Returns the number of indices written.
+ * `indices` must have room for (last - first) entries.
+ *
+ * This is branchless: every index is written, but only the selected ones are kept.
+ */
+template<typename M, typename I>
+UTILS_ALWAYS_INLINE inline
+size_t filter(I* UTILS_RESTRICT indices, M const* UTILS_RESTRICT masks,
+        M mask, M value, size_t first, size_t last) noexcept {
+    static_assert(std::is_integral_v<I>);
+    size_t count = 0;
+    for (size_t i = first; i < last; i++) {
+        indices[count] = I(i);
+        count += size_t((masks[i] & mask) == value);
+    }
+    return count;
+}
+
+/*
+ * Same as above, but selects the elements for which masks[i] is not zero.
+ */
+template<typename M, typename I>
+UTILS_ALWAYS_INLINE inline
+size_t filter(I* UTILS_RESTRICT indices, M const* UTILS_RESTRICT masks,
+        size_t first, size_t last) noexcept {
+    static_assert(std::is_integral_v<I>);
+    size_t count = 0;
+    for (size_t i = first; i < last; i++) {
+        indices[count] = I(i);
+        count += size_t(masks[i] != M(0));
+    }
+    return count;
+}
+
+/*
+ * In-place stable compaction of an array: data[i] = data[indices[i]], for i in [0, count).
+ * indices must be strictly increasing (e.g. produced by filter()), which guarantees that
+ * indices[i] >= i and that no element is overwritten before it's read.
+ */
+template<typename T, typename I>
+UTILS_ALWAYS_INLINE inline
+void compact(T* data, I const* UTILS_RESTRICT indices, size_t count) noexcept {
+    static_assert(std::is_integral_v<I>);
+    for (size_t i = 0; i < count; i++) {
+        if (size_t(indices[i]) != i) {
+            data[i] = std::move(data[indices[i]]);
+        }
+    }
+}
+
+/*
+ * Stable in-place compaction of all the arrays of a StructureOfArrays, see compact() above.
+ * The StructureOfArrays is then resized to `count` elements.
+ */
+template<typename SoA, typename I>
+inline void compact(SoA& soa, I const* UTILS_RESTRICT indices, size_t count) noexcept {
+    soa.forEach([indices, count](auto* p) {
+        compact(p, indices, count);
+    });
+    soa.resize(count);
+}
+
+/*
+ * Gathers the elements of the E'th array of a StructureOfArrays, see gather() above.
+ */
+template<size_t E, typename SoA, typename I>
+inline void gather(typename SoA::template TypeAt<E>* UTILS_RESTRICT dst, SoA const& soa,
+        I const* UTILS_RESTRICT indices, size_t count) noexcept {
+    gather(dst, soa.template data<E>(), indices, count);
+}
+
+/*
+ * Scatters elements into the E'th array of a StructureOfArrays, see scatter() above.
+ */
+template<size_t E, typename SoA, typename I>
+inline void scatter(SoA& soa, typename SoA::template TypeAt<E> const* UTILS_RESTRICT src,
+        I const* UTILS_RESTRICT indices, size_t count) noexcept {
+    scatter(soa.template data<E>(), src, indices, count);
+}
+
+} // namespace utils::soa
+
+#endif // TNT_UTILS_SOA_ALGORITHM_H
@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 
 #include <utils/StructureOfArrays.h>
+#include <utils/soa_algorithm.h>
 #include <math/vec4.h>
 
 using namespace filament::math;
@@ -173,3 +174,74 @@ TEST(StructureOfArraysTest, Simple) {
     soa.push_back(0.0f, 1.0, std::move(destroyedFloat4));
 }
 
+
+TEST(StructureOfArraysTest, AlignedLayout) {
+    AlignedStructureOfArrays<64, 16, uint8_t, float, double> soa;
+
+    // the capacity is rounded up to a multiple of 16
+    soa.setCapacity(17);
+    EXPECT_EQ(32, soa.capacity());
+
+    soa.resize(5);
+    EXPECT_EQ(5, soa.size());
+    EXPECT_EQ(16, soa.paddedSize());
+    EXPECT_LE(soa.paddedSize(), soa.capacity());
+
+    // each array is aligned to 64 bytes
+    EXPECT_EQ(0, uintptr_t(soa.data<0>()) % 64);
+    EXPECT_EQ(0, uintptr_t(soa.data<1>()) % 64);
+    EXPECT_EQ(0, uintptr_t(soa.data<2>()) % 64);
+
+    // growing keeps the capacity a multiple of 16
+    soa.resize(33);
+    EXPECT_EQ(0, soa.capacity() % 16);
+    EXPECT_EQ(0, uintptr_t(soa.data<2>()) % 64);
+}
+
+TEST(StructureOfArraysTest, GatherScatter) {
+    float const src[] = { 0, 10, 20, 30, 40, 50 };
+    uint32_t const indices[] = { 5, 0, 3 };
+
+    float dst[3] = {};
+    soa::gather(dst, src, indices, 3);
+    EXPECT_EQ(50, dst[0]);
+    EXPECT_EQ(0, dst[1]);
+    EXPECT_EQ(30, dst[2]);
+
+    float out[6] = {};
+    soa::scatter(out, dst, indices, 3);
+    EXPECT_EQ(50, out[5]);
+    EXPECT_EQ(0, out[0]);
+    EXPECT_EQ(30, out[3]);
+    EXPECT_EQ(0, out[1]);
+}
+
+TEST(StructureOfArraysTest, FilterCompact) {
+    StructureOfArrays<uint16_t, float> soa;
+    soa.resize(8);
+    for (size_t i = 0; i < 8; i++) {
+        soa.elementAt<0>(i) = uint16_t(i & 1u ? 0x3 : 0x1);
+        soa.elementAt<1>(i) = float(i);
+    }
+
+    uint32_t indices[8];
+    size_t count = soa::filter(indices, soa.data<0>(), uint16_t(0x2), uint16_t(0x2), 0, 8);
+    EXPECT_EQ(4, count);
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(2 * i + 1, indices[i]);
+    }
+
+    soa::compact(soa, indices, count);
+    EXPECT_EQ(4, soa.size());
+    for (size_t i = 0; i < 4; i++) {
+        EXPECT_EQ(0x3, soa.elementAt<0>(i));
+        EXPECT_EQ(float(2 * i + 1), soa.elementAt<1>(i));
+    }
+
+    // filter on non-zero values
+    uint16_t const masks[] = { 0, 4, 0, 0, 1 };
+    count = soa::filter(indices, masks, 0, 5);
+    EXPECT_EQ(2, count);
+    EXPECT_EQ(1, indices[0]);
+    EXPECT_EQ(4, indices[1]);
+}
@@ -19,6 +19,10 @@
 
 #include <viewer/AutomationSpec.h>
 
+#include <vector>
+
+#include <stdint.h>
+
 namespace filament {
 
 class ColorGrading;
@@ -82,6 +86,29 @@ public:
          * If true, the tick function writes out a settings JSON file before advancing.
          */
         bool exportSettings = false;
+
+        /**
+         * If true, each test first runs for warmupFrameCount frames, then its frame times are
+         * recorded for measuredFrameCount frames, and the tick function writes out a JSON report
+         * with their percentiles before advancing.
+         *
+         * The CPU frame time is the deltaTime given to tick(), i.e. the application's frame
+         * period, which includes any wait for vsync; it doesn't come from the Renderer's own
+         * frame timing. The GPU frame time comes from Renderer::getLastFrameGpuTime() and is
+         * only recorded when a new timing is available, so there can be fewer GPU samples than
+         * measured frames, or none if the backend doesn't support timer queries.
+         */
+        bool exportPerformance = false;
+
+        /**
+         * Number of frames rendered before measuring the performance of a test.
+         */
+        int warmupFrameCount = 30;
+
+        /**
+         * Number of frames over which the performance of a test is measured.
+         */
+        int measuredFrameCount = 120;
     };
 
     /**
@@ -244,6 +271,9 @@ private:
     size_t mCurrentTest;
     float mElapsedTime;
     int mElapsedFrames;
+    std::vector<float> mCpuFrameTimes;  // in milliseconds, for the current test
+    std::vector<float> mGpuFrameTimes;  // in milliseconds, for the current test
+    uint32_t mGpuFrameTimeCount = 0;    // last value of Renderer::getFrameGpuTimeCount()
     bool mIsRunning = false;
     bool mBatchModeEnabled = false;
     bool mRequestStart = false;
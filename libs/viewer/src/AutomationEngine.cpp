@@ -26,9 +26,12 @@
 #include <utils/Log.h>
 #include <utils/Path.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <fstream>
 #include <sstream>
+#include <vector>
 
 using namespace utils;
 
@@ -97,6 +100,54 @@ static void exportScreenshot(View* view, Renderer* renderer, std::string filenam
             std::move(buffer));
 }
 
+// Writes "name": { "mean": ..., "min": ..., "p50": ..., ... } for the given frame times, or
+// "name": null if there are none.
+static void writeFrameTimeStats(std::ostream& out, const char* name, std::vector<float> times) {
+    out << "    \"" << name << "\": ";
+    if (times.empty()) {
+        out << "null";
+        return;
+    }
+    std::sort(times.begin(), times.end());
+    double sum = 0;
+    for (float t : times) {
+        sum += t;
+    }
+    // nearest-rank percentile
+    const auto percentile = [&times](float p) {
+        const size_t rank = size_t(std::ceil(p * float(times.size())));
+        return times[std::min(std::max(rank, size_t(1)), times.size()) - 1];
+    };
+    out << "{ "
+        << "\"mean\": " << sum / double(times.size()) << ", "
+        << "\"min\": " << times.front() << ", "
+        << "\"p50\": " << percentile(0.50f) << ", "
+        << "\"p90\": " << percentile(0.90f) << ", "
+        << "\"p95\": " << percentile(0.95f) << ", "
+        << "\"p99\": " << percentile(0.99f) << ", "
+        << "\"max\": " << times.back() << " }";
+}
+
+static void exportPerformance(const char* filename, const char* name, size_t testIndex,
+        int warmupFrameCount, std::vector<float> const& cpuFrameTimes,
+        std::vector<float> const& gpuFrameTimes) {
+    std::ofstream out(filename);
+    if (!out) {
+        gStatus = "Failed to export performance report.";
+        return;
+    }
+    out << "{\n"
+        << "    \"name\": \"" << name << "\",\n"
+        << "    \"test\": " << testIndex << ",\n"
+        << "    \"warmupFrames\": " << warmupFrameCount << ",\n"
+        << "    \"measuredFrames\": " << cpuFrameTimes.size() << ",\n"
+        << "    \"unit\": \"ms\",\n";
+    writeFrameTimeStats(out, "cpuFrameTime", cpuFrameTimes);
+    out << ",\n";
+    writeFrameTimeStats(out, "gpuFrameTime", gpuFrameTimes);
+    out << "\n}" << std::endl;
+}
+
 AutomationEngine* AutomationEngine::createFromJSON(const char* jsonSpec, size_t size) {
     AutomationSpec* spec = AutomationSpec::generate(jsonSpec, size);
     if (!spec) {
@@ -201,6 +252,8 @@ void AutomationEngine::tick(Engine* engine, const ViewerContent& content, float
     const auto activateTest = [this, engine, content]() {
         mElapsedTime = 0;
         mElapsedFrames = 0;
+        mCpuFrameTimes.clear();
+        mGpuFrameTimes.clear();
         mSpec->get(mCurrentTest, mSettings);
         viewer::applySettings(engine, mSettings->view, content.view);
         for (size_t i = 0; i < content.materialCount; i++) {
@@ -226,10 +279,31 @@ void AutomationEngine::tick(Engine* engine, const ViewerContent& content, float
     mElapsedTime += deltaTime;
     mElapsedFrames++;
 
+    const size_t measuredFrameCount = size_t(std::max(mOptions.measuredFrameCount, 0));
+    const bool measuring = mOptions.exportPerformance &&
+            mCpuFrameTimes.size() < measuredFrameCount;
+    // GPU timings arrive a few frames late and not necessarily every frame, so a sample is
+    // only taken when the renderer has collected a new one.
+    const uint32_t gpuFrameTimeCount = content.renderer->getFrameGpuTimeCount();
+    const bool hasNewGpuFrameTime = gpuFrameTimeCount != mGpuFrameTimeCount;
+    mGpuFrameTimeCount = gpuFrameTimeCount;
+
+    if (measuring && mElapsedFrames > mOptions.warmupFrameCount) {
+        mCpuFrameTimes.push_back(deltaTime * 1000.0f);
+        const float gpuFrameTime = content.renderer->getLastFrameGpuTime();
+        if (hasNewGpuFrameTime && gpuFrameTime > 0.0f) {
+            mGpuFrameTimes.push_back(gpuFrameTime);
+        }
+    }
+
     if (mElapsedTime < mOptions.sleepDuration || mElapsedFrames < mOptions.minFrameCount) {
         return;
     }
 
+    if (mOptions.exportPerformance && mCpuFrameTimes.size() < measuredFrameCount) {
+        return;
+    }
+
     const bool isLastTest = mCurrentTest == mSpec->size() - 1;
 
     const int digits = (int) log10 ((double) mSpec->size()) + 1;
@@ -243,6 +317,12 @@ void AutomationEngine::tick(Engine* engine, const ViewerContent& content, float
         exportSettings(*mSettings, filename.c_str());
     }
 
+    if (mOptions.exportPerformance) {
+        std::string filename = prefix + ".perf.json";
+        exportPerformance(filename.c_str(), mSpec->getName(mCurrentTest), mCurrentTest,
+                mOptions.warmupFrameCount, mCpuFrameTimes, mGpuFrameTimes);
+    }
+
     if (mOptions.exportScreenshots) {
         exportScreenshot(content.view, content.renderer, prefix + ".ppm", isLastTest, this);
     }
@@ -126,6 +126,7 @@ struct App {
     std::string messageBoxText;
     std::string settingsFile;
     std::string batchFile;
+    bool exportPerformance = false;
 
     AutomationSpec* automationSpec = nullptr;
     AutomationEngine* automationEngine = nullptr;
@@ -161,6 +162,9 @@ static void printUsage(char* name) {
         "       Start automation using the given JSON spec, then quit the app\n\n"
         "   --headless, -e\n"
         "       Use a headless swapchain; ignored if --batch is not present\n\n"
+        "   --perf, -p\n"
+        "       Measure the frame times of each test and export them to a JSON report;\n"
+        "       ignored if --batch is not present\n\n"
         "   --ibl=<path>, -i <path>\n"
         "       Override the built-in IBL\n"
         "       path can either be a directory containing IBL data files generated by cmgen,\n"
@@ -197,13 +201,14 @@ static std::ifstream::pos_type getFileSize(const char* filename) {
 }
 
 static int handleCommandLineArguments(int argc, char* argv[], App* app) {
-    static constexpr const char* OPTSTR = "ha:f:i:usc:rt:b:ev";
+    static constexpr const char* OPTSTR = "ha:f:i:usc:rt:b:evp";
     static const struct option OPTIONS[] = {
         { "help",         no_argument,          nullptr, 'h' },
         { "api",          required_argument,    nullptr, 'a' },
         { "feature-level",required_argument,    nullptr, 'f' },
         { "batch",        required_argument,    nullptr, 'b' },
         { "headless",     no_argument,          nullptr, 'e' },
+        { "perf",         no_argument,          nullptr, 'p' },
         { "ibl",          required_argument,    nullptr, 'i' },
         { "ubershader",   no_argument,          nullptr, 'u' },
         { "actual-size",  no_argument,          nullptr, 's' },
@@ -256,6 +261,9 @@ static int handleCommandLineArguments(int argc, char* argv[], App* app) {
             case 'e':
                 app->config.headless = true;
                 break;
+            case 'p':
+                app->exportPerformance = true;
+                break;
             case 'i':
                 app->config.iblDirectory = arg;
                 break;
@@ -621,6 +629,7 @@ int main(int argc, char** argv) {
             options.sleepDuration = 0.0;
             options.exportScreenshots = true;
             options.exportSettings = true;
+            options.exportPerformance = app.exportPerformance;
             app.automationEngine->setOptions(options);
             app.viewer->stopAnimation();
         }
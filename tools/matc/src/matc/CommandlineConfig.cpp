@@ -78,6 +78,8 @@ static void usage(char* name) {
             "           directionalLighting, dynamicLighting, shadowReceiver, skinning, vsm, fog,"
             "           ssr (screen-space reflections)\n"
             "       This variant filter is merged with the filter from the material, if any\n\n"
+            "   --compress, -z\n"
+            "       Compress the shaders, they are decompressed when the material is loaded\n\n"
             "   --version, -v\n"
             "       Print the material version number\n\n"
             "Internal use and debugging only:\n"
@@ -167,7 +169,7 @@ static void parseDefine(std::string defineString, Config::StringReplacementMap&
 }
 
 bool CommandlineConfig::parse() {
-    static constexpr const char* OPTSTR = "hLxo:f:dm:a:l:p:D:T:OSEr:vV:gtw";
+    static constexpr const char* OPTSTR = "hLxo:f:dm:a:l:p:D:T:OSEr:vV:gtwz";
     static const struct option OPTIONS[] = {
             { "help",                    no_argument, nullptr, 'h' },
             { "license",                 no_argument, nullptr, 'L' },
@@ -189,6 +191,7 @@ bool CommandlineConfig::parse() {
             { "print",                   no_argument, nullptr, 't' },
             { "version",                 no_argument, nullptr, 'v' },
             { "raw",                     no_argument, nullptr, 'w' },
+            { "compress",                no_argument, nullptr, 'z' },
             { nullptr, 0, nullptr, 0 }  // termination of the option list
     };
 
@@ -302,6 +305,9 @@ bool CommandlineConfig::parse() {
             case 'w':
                 mRawShaderMode = true;
                 break;
+            case 'z':
+                mCompressed = true;
+                break;
         }
     }
 
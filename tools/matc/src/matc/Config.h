@@ -111,6 +111,10 @@ public:
         return mPrintShaders;
     }
 
+    bool isCompressed() const noexcept {
+        return mCompressed;
+    }
+
     bool rawShaderMode() const noexcept {
         return mRawShaderMode;
     }
@@ -136,6 +140,7 @@ protected:
     bool mIsValid = true;
     bool mPrintShaders = false;
     bool mRawShaderMode = false;
+    bool mCompressed = false;
     Optimization mOptimizationLevel = Optimization::PERFORMANCE;
     Metadata mReflectionTarget = Metadata::NONE;
     Platform mPlatform = Platform::ALL;
@@ -404,6 +404,7 @@ bool MaterialCompiler::run(const Config& config) {
         .optimization(config.getOptimizationLevel())
         .printShaders(config.printShaders())
         .generateDebugInfo(config.isDebug())
+        .compression(config.isCompressed())
         .variantFilter(config.getVariantFilter() | builder.getVariantFilter());
 
     for (const auto& define : config.getDefines()) {